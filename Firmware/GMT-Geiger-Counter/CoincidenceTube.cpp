@@ -6,14 +6,16 @@
 // ================================================================================================
 // Constructor
 // ================================================================================================
-CoincidenceTube::CoincidenceTube(const uint8_t pin, volatile uint16_t *movingAverage, volatile uint8_t &movingAverageIndex):
+CoincidenceTube::CoincidenceTube(const uint8_t pin, volatile uint16_t *movingAverage, volatile uint8_t &movingAverageIndex, volatile uint32_t &movingAverageTickMicroseconds):
 
   // Initialize members
   _pin(pin),
   _movingAverage(movingAverage),
   _movingAverageIndex(movingAverageIndex),
+  _movingAverageTickMicroseconds(movingAverageTickMicroseconds),
   _enabled(false),
   _pulseStartTimeMicroseconds(0),
+  _overflowCounts(0),
   _counts(0)
 
 {}
@@ -28,6 +30,55 @@ void CoincidenceTube::begin() {
 
 }
 
+// ================================================================================================
+// Move the pulses recorded by the ISR into the moving average and the total counts
+// ================================================================================================
+void CoincidenceTube::update() {
+
+  // Pulse variable
+  PulseBuffer::Pulse pulse;
+
+  // For every pulse the ISR has recorded since the last update
+  while (_pulseBuffer.pop(pulse)) {
+
+    // Get a consistent pair of the moving average index and the time it was advanced
+    // If the timer ISR advanced the index in between, read both again
+    uint8_t  index;
+    uint32_t tickMicroseconds;
+
+    do {
+
+      index            = _movingAverageIndex;
+      tickMicroseconds = _movingAverageTickMicroseconds;
+
+    } while (index != _movingAverageIndex);
+
+    // If the pulse happened before the index was advanced, it belongs to the previous element
+    if ((int32_t)(pulse.timeMicroseconds - tickMicroseconds) < 0) { index = (index + 60 - 1) % 60; }
+
+    // Add the counts to the moving average
+    _movingAverage[index] += pulse.counts;
+
+    // Add the counts to the total number of counts
+    _counts += pulse.counts;
+
+  }
+
+  // Get the counts that did not fit into the pulse buffer since the last update
+  uint32_t overflowCounts = _pulseBuffer.getOverflowCounts();
+  uint32_t newCounts      = overflowCounts - _overflowCounts;
+
+  // If there are any, add them to the current element, only their timestamps are lost
+  if (newCounts) {
+
+    _movingAverage[_movingAverageIndex] += newCounts;
+    _counts                             += newCounts;
+    _overflowCounts                      = overflowCounts;
+
+  }
+
+}
+
 // ================================================================================================
 // Enable the tube
 // ================================================================================================
@@ -122,18 +173,18 @@ void IRAM_ATTR CoincidenceTube::_countPulse(void *instancePointer) {
   }else {
 
     // Calculate the pulse length by subtracting the time from the rising edge to now in microseconds
-    uint64_t pulseLengthMicroseconds = micros() - instance->_pulseStartTimeMicroseconds;
+    uint32_t pulseLengthMicroseconds = micros() - instance->_pulseStartTimeMicroseconds;
 
     // Check if the pulse length is longer than the threshold
-    if (pulseLengthMicroseconds > TUBE_COINCIDENCE_THRESHOLD_MICROSECONDS) {
-
-      // Add one count to the moving average
-      instance->_movingAverage[instance->_movingAverageIndex]++;
+    bool counted = pulseLengthMicroseconds > TUBE_COINCIDENCE_THRESHOLD_MICROSECONDS;
 
-      // Add one count to the total number of counts
-      instance->_counts++;
+    // If it is, hand one count to the main loop
+    if (counted) { instance->_pulseBuffer.push(instance->_pulseStartTimeMicroseconds, 1); }
 
-    }
+    // If the pulse capture is enabled in the main configuration file, record the pulse, a pulse rejected as noise is recorded with 0 counts
+    #if ENABLE_PULSE_CAPTURE == 1
+      pulseCapture.capture(PulseCapture::COINCIDENCE_TUBE, instance->_pulseStartTimeMicroseconds, pulseLengthMicroseconds, counted ? 1 : 0);
+    #endif
 
   }
 
@@ -3,6 +3,8 @@
 
 #include "Arduino.h"
 #include "Configuration.h"
+#include "PulseBuffer.h"
+#include "PulseCapture.h"
 
 class CoincidenceTube {
 
@@ -12,9 +14,10 @@ class CoincidenceTube {
   public:
 
     // Constructor
-    CoincidenceTube(const uint8_t pin, volatile uint16_t *movingAverage, volatile uint8_t &movingAverageIndex);
+    CoincidenceTube(const uint8_t pin, volatile uint16_t *movingAverage, volatile uint8_t &movingAverageIndex, volatile uint32_t &movingAverageTickMicroseconds);
 
     void begin();                        // Initialize everything
+    void update();                       // Move the pulses recorded by the ISR into the moving average and the total counts
     void enable();                       // Enable the tube
     void disable();                      // Disable the tube
     void setTubeState(const bool state); // Set the tube state
@@ -26,12 +29,15 @@ class CoincidenceTube {
 
   private:
 
-    const uint8_t     _pin;                        // The pin, the tube is connected to
-    volatile uint16_t *_movingAverage;             // Pointer to the moving average array
-    volatile uint8_t  &_movingAverageIndex;        // Reference to the moving average array index
-    bool              _enabled;                    // Flag for checking if tube is enabled
-    volatile uint64_t _pulseStartTimeMicroseconds; // Timer for measuring the pulse length
-    volatile uint64_t _counts;                     // Total number of counts
+    const uint8_t     _pin;                            // The pin, the tube is connected to
+    volatile uint16_t *_movingAverage;                 // Pointer to the moving average array
+    volatile uint8_t  &_movingAverageIndex;            // Reference to the moving average array index
+    volatile uint32_t &_movingAverageTickMicroseconds; // Reference to the time the moving average index was last advanced
+    bool              _enabled;                        // Flag for checking if tube is enabled
+    volatile uint32_t _pulseStartTimeMicroseconds;     // Timer for measuring the pulse length
+    PulseBuffer       _pulseBuffer;                    // Buffer of pulses handed from the ISR to the main loop
+    uint32_t          _overflowCounts;                 // Last seen overflow counts of the pulse buffer
+    uint64_t          _counts;                         // Total number of counts
 
     // Interrupt service routine for counting pulses
     static void IRAM_ATTR _countPulse(void *instancePointer);
@@ -41,6 +41,24 @@
 // SBM-20: 124 µs
 #define TUBE_MAXIMUM_PULSE_LENGTH_MICROSECONDS 124
 
+// The dead time of a tube in microseconds
+// After each pulse, a tube is blind for this amount of time and misses any particle that passes through it
+// At high count rates this makes the recorded count rate fall short of the true count rate, the dead time correction compensates for that
+// This is not the pulse length the tube driver board generates, but the dead time from the tube's datasheet
+// SBM-20: 190 µs
+#define TUBE_DEAD_TIME_MICROSECONDS 190
+
+// The model used for the dead time correction
+// 0 = No correction
+// 1 = Non-paralyzable, particles during the dead time are missed but do not extend it (typical for a tube with a fast driver)
+// 2 = Paralyzable, particles during the dead time are missed and restart it
+// With a correction selected, the equivalent dose on the display, the buzzer alarm and the microsieverts per hour metric use the corrected count rate
+// The API reports the recorded and the corrected values next to each other, whatever is selected here
+// Below roughly 500 counts per second with an SBM-20 the correction changes the value by less than 10%
+// The Firmware/Tests host build compares both models against known true count rates (TestDeadTime)
+// Default: 0
+#define TUBE_DEAD_TIME_MODEL 0
+
 // Noise threshold, the minimum length in microseconds a pulse must be to count as an actual pulse
 // Anything shorter than that will be ignored as noise
 // This should be around 30% of the minimum pulse length in microseconds
@@ -62,6 +80,28 @@
 // This value should not be changed!
 #define TUBE_COINCIDENCE_THRESHOLD_MICROSECONDS (TUBE_MINIMUM_PULSE_LENGTH_MICROSECONDS * 50 / 100)
 
+// The way the pulses of a tube are counted
+// 0 = Interrupt, every pulse edge triggers an ISR that measures the pulse length (most precise, supports 3 or more tubes)
+// 1 = Hardware pulse counter, the ESP32's PCNT peripheral counts the rising edges without using the CPU (for very high count rates)
+// The hardware pulse counter can not measure pulse lengths and therefore only supports up to 2 tubes, i.e. 1 tube per pin header
+// Default: 0
+#define TUBE_COUNTING_MODE 0
+
+// The glitch filter time of the hardware pulse counter in nanoseconds
+// Pulses shorter than this are ignored as noise, similar to TUBE_NOISE_THRESHOLD_MICROSECONDS
+// The PCNT glitch filter is limited to 1023 APB clock cycles, so it can't go past roughly 12700 ns
+// This value will only be used if TUBE_COUNTING_MODE is set to 1
+// Default: 12000
+#define TUBE_PULSE_COUNTER_GLITCH_FILTER_NANOSECONDS 12000
+
+// The number of pulses each tube can buffer between its ISR and the main loop
+// The ISR only records pulses into this buffer, the main loop collects them and updates the counts
+// If the main loop is stalled for long enough to fill the buffer, counts are still recorded but without their exact timing
+// Must be a power of 2
+// This value should not be changed!
+// Default: 256
+#define TUBE_PULSE_BUFFER_SIZE 256
+
 // Name of the tube type
 // This can be set to an arbitrary string and is only used for logging
 #define TUBE_TYPE_NAME "SBM-20"
@@ -86,10 +126,42 @@
 #define INTEGRATION_TIME_AUTO_LOWER_BOUND     0.65
 #define INTEGRATION_TIME_STEP_SIZE_SECONDS    5
 
+// Automatic integration time estimator
+// 0 = Step-wise, the integration time is moved towards 10, 30 or 60 seconds in steps, depending on the ratio of the 10 and 60 second CPM
+// 1 = Kalman, a Poisson-aware Kalman filter over the per second counts with a CUSUM change point detector
+// The Kalman filter averages over a long time at a steady radiation level and restarts from the latest counts when the level changes
+// It also gives the integration time it is currently equivalent to, which is shown instead of the step-wise integration time
+// The Kalman filter is about half as noisy at a steady level, but takes about twice as long to settle after the rate doubles or halves
+// The Firmware/Tests host build compares both on rate steps (TestIntegrationTime, ctest -L benchmark -V)
+// Default: 0
+#define INTEGRATION_TIME_ESTIMATOR 0
+
+// Kalman filter settings
+// The process noise is the expected variance of the true count rate per second, relative to the count rate
+// A higher value follows slow changes faster but is noisier, the default is equivalent to an integration time of about 60 seconds
+// The change ratio is the factor by which the count rate has to change for the CUSUM detector to look for it
+// The change threshold is the log-likelihood ratio the CUSUM detector needs before it restarts the filter
+// A lower threshold reacts faster to changes but restarts the filter more often by chance
+// The minimum rate in counts per second keeps the filter working when no counts were recorded at all
+// These values should not be changed!
+#define ESTIMATOR_PROCESS_NOISE    0.0003
+#define ESTIMATOR_CHANGE_RATIO     2.0
+#define ESTIMATOR_CHANGE_THRESHOLD 8.0
+#define ESTIMATOR_MINIMUM_RATE_CPS 0.05
+
+// The number of buckets the radiation history keeps for every resolution
+// Every bucket stores the minimum, maximum and mean counts per minute value of its time span
+// The one second samples are consolidated into minutes, the minutes into hours and the hours into days
+// Each bucket takes up 12 bytes, a very large history could lead to memory problems (be carefull)
+// Default: 60 seconds, 120 minutes, 168 hours (1 week), 365 days (1 year)
+#define RADIATION_HISTORY_SECONDS 60
+#define RADIATION_HISTORY_MINUTES 120
+#define RADIATION_HISTORY_HOURS   168
+#define RADIATION_HISTORY_DAYS    365
+
 // The number of minutes the radiation history screen displays
 // For a longer history graph increase the number of minutes
-// A very large history could lead to memory problems (be carefull)
-// Range: 5 - 250 minutes
+// Range: 5 - RADIATION_HISTORY_MINUTES
 // Default: 20 minutes
 #define RADIATION_HISTORY_LENGTH_MINUTES 20
 
@@ -167,6 +239,21 @@
 // Default: 500
 #define DISPLAY_REFRESH_INTERVAL_MILLISECONDS 500
 
+// The size of the square tiles the frame buffer is split into when looking for changed regions
+// After drawing a frame, only the tiles that changed since the last frame are written to the display
+// Smaller tiles write fewer unchanged pixels but need more transfers, it must be even and divide the display width and height
+// Default: 16
+#define DISPLAY_DAMAGE_TILE_SIZE_PIXELS 16
+
+// The core the display task runs on
+// The display task writes a frame to the display while the main loop goes on and draws the next one into a second frame buffer
+// Default: 0
+#define DISPLAY_TASK_CORE 0
+
+// Stack size of the display task in bytes
+// Default: 4096
+#define DISPLAY_TASK_STACK_SIZE_BYTES 4096
+
 // The maximum brightness the RGB LED can reach
 // Range: 0 - 255
 // Default: 128
@@ -202,6 +289,31 @@
 // Default: 60
 #define WIFI_CONNECTION_TIMEOUT_SECONDS 60
 
+// The core the web server task runs on
+// The main loop runs on core 1, so serving files and data doesn't hold up the display and the touchscreen
+// The web server task still handles one HTTP client at a time, a slow client keeps the others waiting
+// Default: 0
+#define WIRELESS_SERVER_TASK_CORE 0
+
+// Stack size of the web server task in bytes
+// The request handlers build their responses in buffers on this stack
+// Default: 8192
+#define WIRELESS_SERVER_TASK_STACK_SIZE_BYTES 8192
+
+// Number of web app files kept in the PSRAM, so they don't have to be read from the SD card on every request
+// Set to 0 to always read the web app files from the SD card
+// Default: 8
+#define WEB_APP_CACHE_FILES 8
+
+// Maximum size of a web app file that is kept in the PSRAM in bytes
+// The compressed web app pages are well below this, larger files are sent straight from the SD card
+// Default: 32768
+#define WEB_APP_CACHE_MAXIMUM_FILE_BYTES 32768
+
+// Size of the pieces a web app file is sent in when it is sent straight from the SD card
+// Default: 1024
+#define WEB_APP_REQUEST_CHUNK_BYTES 1024
+
 // ================================================================================================
 // System setting
 // ================================================================================================
@@ -226,6 +338,13 @@
 #define SD_CARD_LOG_DIRECTORY      SD_CARD_ROOT_DIRECTORY"/Logs"
 #define SD_CARD_WEB_APP_DIRECTORY  SD_CARD_ROOT_DIRECTORY"/Web-App"
 #define SD_CARD_SETTINGS_FILE      SD_CARD_ROOT_DIRECTORY"/Settings.bin"
+#define SD_CARD_LOG_MANIFEST_FILE  SD_CARD_ROOT_DIRECTORY"/LogManifest.bin"
+
+// SD card health check interval in seconds
+// The board has no card detect pin, so the mount state is verified by accessing the root directory
+// This happens on this interval and after a failed file operation, otherwise the last known mount state is used
+// Default: 5
+#define SD_CARD_HEALTH_CHECK_INTERVAL_SECONDS 5
 
 // The maximum log file size in bytes
 // If the log file reaches a size larger than this, it will be split up into parts
@@ -233,6 +352,68 @@
 // Default: 8388608 (8 MiB)
 #define LOG_FILE_MAXIMUM_SIZE_BYTES 8388608
 
+// Maximum number of bytes sent for a single range or incremental (?since=<offset>) log file request
+// Larger log files are fetched with several requests, so a single request doesn't keep the web server busy for long
+// Requests without a range still get the whole log file
+// Default: 65536
+#define LOG_REQUEST_MAXIMUM_BYTES 65536
+
+// Size of the pieces a log file is sent in, other tasks get to run in between
+// The buffer is allocated on the stack of the main loop
+// Default: 1024
+#define LOG_REQUEST_CHUNK_BYTES 1024
+
+// Size of the log buffer in bytes
+// Log messages are collected in memory and written to the SD card in blocks of this size, aligned to the 512 byte sectors of the SD card
+// This avoids opening the log file and walking the file allocation table for every single log message
+// The buffer is allocated in the PSRAM if available
+// Must be a multiple of 512
+// Default: 4096
+#define LOG_BUFFER_SIZE_BYTES 4096
+
+// Maximum time in seconds log messages are kept in the log buffer before they are written to the SD card
+// This is the most that is lost if the power is cut, restarts flush the buffer first
+// Default: 10
+#define LOG_FLUSH_INTERVAL_SECONDS 10
+
+// Maximum size of a single log message in bytes
+// Log messages are constructed in a fixed buffer of this size on the stack instead of on the heap
+// A log message that doesn't fit is dropped
+// Default: 1024
+#define LOG_MESSAGE_MAXIMUM_SIZE_BYTES 1024
+
+// Number of message schemas a binary log file keeps track of
+// Every distinct combination of message type and keys needs its own schema, if there are more the oldest one is defined again when it is used
+// Default: 16
+#define LOG_BINARY_SCHEMAS 16
+
+// Maximum number of values of a single log message
+// A log message with more values is dropped
+// Default: 16
+#define LOG_MESSAGE_MAXIMUM_VALUES 16
+
+// Size of the log queue in bytes
+// Log messages are handed to a separate logging task through this queue, which writes them to the serial console and the SD card
+// This way a slow SD card or a full serial transmit buffer doesn't hold up the main loop
+// Default: 8192
+#define LOG_QUEUE_SIZE_BYTES 8192
+
+// What happens to a log message if the log queue is full
+// Available options:
+// LOG_DROP_NEWEST (the new log message is dropped)
+// LOG_DROP_OLDEST (the oldest log messages in the queue are dropped to make room for the new one)
+// Default: LOG_DROP_OLDEST
+#define LOG_QUEUE_OVERFLOW_POLICY LOG_DROP_OLDEST
+
+// The CPU core the logging task runs on
+// Default: 0
+#define LOG_TASK_CORE 0
+
+// Stack size of the logging task in bytes
+// The task constructs the log messages in a buffer of LOG_MESSAGE_MAXIMUM_SIZE_BYTES on its stack
+// Default: 6144
+#define LOG_TASK_STACK_SIZE_BYTES 6144
+
 // Baud rate for serial communication
 // This value should not be changed!
 // Default: 115200
@@ -261,6 +442,157 @@
 // Default: 524288 (512 KiB)
 #define WATCHDOG_MINIMUM_PSRAM_BYTES 524288
 
+// ================================================================================================
+// Journal / persistence settings
+// ================================================================================================
+
+// Enable the journal
+// The journal keeps the total counts and the radiation history in the internal flash, so they survive restarts and power loss
+// It needs a SPIFFS / LittleFS data partition in the selected partition scheme
+// 0 = Disabled, 1 = Enabled
+// Default: 1
+#define ENABLE_JOURNAL 1
+
+// How often the total counts are written to the journal in seconds
+// Counts recorded after the last checkpoint are lost on a power loss
+// Default: 60
+#define JOURNAL_COUNTS_INTERVAL_SECONDS 60
+
+// How often the radiation history is written to the journal in seconds
+// The history is much larger than the counts, so it is written less often to limit the wear of the flash
+// Default: 3600
+#define JOURNAL_HISTORY_INTERVAL_SECONDS 3600
+
+// The maximum size of the journal file in bytes
+// If the journal file would grow larger than this, it is compacted down to the latest record of each type
+// This must be at least twice the size of the radiation history
+// Default: 65536 (64 KiB)
+#define JOURNAL_MAXIMUM_SIZE_BYTES 65536
+
+// The journal files in the internal flash and the magic number marking the start of a record
+// These values should not be changed!
+#define JOURNAL_FILE           "/journal.bin"
+#define JOURNAL_TEMPORARY_FILE "/journal.tmp"
+#define JOURNAL_RECORD_MAGIC   0x4C4E524A
+
+// ================================================================================================
+// Pulse capture settings
+// ================================================================================================
+
+// Enable the pulse capture
+// Records the tube, start time and length of every pulse the tube ISRs see, including pulses rejected as noise
+// This is meant for inter-arrival time analysis and detector diagnostics, the capture can be downloaded from /data/pulses
+// The capture buffer is allocated in the PSRAM, without PSRAM nothing is captured
+// Only works with the tube ISR counting mode (TUBE_COUNTING_MODE 0)
+// 0 = Disabled, 1 = Enabled
+// Default: 0
+#define ENABLE_PULSE_CAPTURE 0
+
+// Number of pulses the capture buffer can hold
+// Each pulse takes up 8 bytes of PSRAM, the default buffers a few seconds of tens of thousands of pulses per second
+// Pulses that don't fit into the buffer are dropped and counted, the counts are still recorded
+// Must be a power of 2
+// Default: 131072 (1 MB)
+#define PULSE_CAPTURE_BUFFER_SIZE 131072
+
+// Stream the captured pulses over the serial interface
+// The pulses are sent as binary frames in between the log messages, only as much as fits into the serial transmit buffer per loop
+// The serial interface and /data/pulses take the pulses from the same buffer, so only one of them can be used
+// While the serial stream is enabled, requests to /data/pulses are rejected
+// 0 = Disabled, 1 = Enabled
+// Default: 0
+#define PULSE_CAPTURE_SERIAL 0
+
+// Maximum number of pulses in one binary frame
+// Default: 256
+#define PULSE_CAPTURE_FRAME_PULSES 256
+
+// Maximum number of pulses sent per request to /data/pulses
+// This limits how long a request occupies the web server, the rest is sent with the next request
+// The main loop is only paused while a frame is copied out of the buffer, not while it is sent
+// Default: 16384
+#define PULSE_CAPTURE_REQUEST_PULSES 16384
+
+// Magic value marking the start of a binary frame ("GMTP")
+// This value should not be changed!
+#define PULSE_CAPTURE_FRAME_MAGIC 0x50544D47
+
+// ================================================================================================
+// Live stream settings
+// ================================================================================================
+
+// Maximum number of clients subscribed to the live stream at /data/stream at the same time
+// Every subscriber keeps a connection open, further subscribers are turned away
+// Default: 4
+#define LIVE_STREAM_MAXIMUM_SUBSCRIBERS 4
+
+// Interval between two live stream frames in milliseconds
+// Default: 1000
+#define LIVE_STREAM_INTERVAL_MILLISECONDS 1000
+
+// Size of the shared live stream frame buffer in bytes
+// Default: 512
+#define LIVE_STREAM_FRAME_SIZE_BYTES 512
+
+// Number of frames in a row a subscriber can miss before it is disconnected
+// Frames are sent without waiting for the connection, so a stalled connection never blocks the main loop
+// A frame is skipped for a subscriber whose connection takes none of it, or that still has the rest of the previous frame to send
+// The frames carry a sequence number, so a subscriber can tell that it missed some
+// Default: 10
+#define LIVE_STREAM_MAXIMUM_SKIPPED_FRAMES 10
+
+// ================================================================================================
+// Metrics / snapshot settings
+// ================================================================================================
+
+// Size of the buffer the OpenMetrics text at /metrics is rendered into in bytes
+// The buffer is allocated once, if it is too small the endpoint returns an error instead of incomplete metrics
+// Default: 6144
+#define METRICS_BUFFER_SIZE_BYTES 6144
+
+// Interval over which the longest main loop iteration is reported in seconds
+// This should be at least the scrape interval, so no peak is missed between two scrapes
+// Default: 10
+#define METRICS_LOOP_PEAK_INTERVAL_SECONDS 10
+
+// Size of the buffer the snapshots at /data/snapshot are built in, in bytes
+// It is allocated in the PSRAM on the first request and has to fit every requested field, including the radiation history
+// All radiation history resolutions together take up to about 25 kB
+// Default: 32768
+#define SNAPSHOT_BUFFER_SIZE_BYTES 32768
+
+// ================================================================================================
+// Pulse simulator / benchmark settings
+// ================================================================================================
+
+// Enable the pulse simulator
+// The pulse simulator generates a synthetic Poisson distributed pulse train on the tube pin and feeds it through the regular counting path
+// Every log interval it logs the number of generated and counted pulses as well as the expected and measured CPM
+// This is meant for benchmarking the pulse counting and checking the CPM math before flashing a unit and must be disabled for normal operation
+// Disconnect the tube driver board from the simulated pin header while the pulse simulator is enabled!
+// 0 = Disabled, 1 = Enabled
+// Default: 0
+#define ENABLE_PULSE_SIMULATOR 0
+
+// The pin the pulse simulator drives
+// Default: MAIN_TRG_PIN
+#define PULSE_SIMULATOR_PIN MAIN_TRG_PIN
+
+// The average rate of the simulated pulse train in pulses per second
+// Increase this value until pulses start getting lost to find the highest rate the counting path can sustain
+// Default: 100
+#define PULSE_SIMULATOR_RATE_CPS 100
+
+// The length of a simulated pulse in microseconds
+// Default: TUBE_MEDIAN_PULSE_LENGTH_MICROSECONDS
+#define PULSE_SIMULATOR_PULSE_LENGTH_MICROSECONDS TUBE_MEDIAN_PULSE_LENGTH_MICROSECONDS
+
+// The CPU core the pulse generator runs on
+// This should be the core that is not handling the tube interrupts (the Arduino loop runs on core 1)
+// This value should not be changed!
+// Default: 0
+#define PULSE_SIMULATOR_CORE 0
+
 // ================================================================================================
 // Pin assignments
 // ================================================================================================
@@ -43,6 +43,16 @@ void CosmicRayDetector::begin() {
 
 }
 
+// ================================================================================================
+// Update the cosmic ray detector
+// ================================================================================================
+void CosmicRayDetector::update() {
+
+  // Move the pulses recorded by the coincidence tube ISR into the moving average and the total counts
+  _coincidenceTube.update();
+
+}
+
 // ================================================================================================
 // Enable the cosmic ray detector
 // ================================================================================================
@@ -55,7 +65,8 @@ void CosmicRayDetector::enable() {
     for (uint8_t i = 0; i < 60; i++) { _movingAverage[i] = 0; }
 
     // Reset the position of the moving average index
-    _movingAverageIndex = 0;
+    _movingAverageIndex            = 0;
+    _movingAverageTickMicroseconds = micros();
 
     // Set the tube offsets
     _coincidenceTubeOffset = _coincidenceTube.getCounts();
@@ -106,6 +117,9 @@ void CosmicRayDetector::disable() {
     // Disable the coincidence tube
     _coincidenceTube.disable();
 
+    // Collect the pulses that were recorded before the coincidence tube was disabled
+    update();
+
     // Detach the ISR from the hardware timer
     timerDetachInterrupt(_movingAverageTimer);
 
@@ -119,10 +133,11 @@ void CosmicRayDetector::disable() {
     for (uint8_t i = 0; i < 60; i++) { _movingAverage[i] = 0; }
 
     // Reset variables
-    _movingAverageIndex    = 0;
-    _coincidenceTubeOffset = 0;
-    _mainTubeOffset        = 0;
-    _followerTubeOffset    = 0;
+    _movingAverageIndex            = 0;
+    _movingAverageTickMicroseconds = 0;
+    _coincidenceTubeOffset         = 0;
+    _mainTubeOffset                = 0;
+    _followerTubeOffset            = 0;
 
     // Set the enabled flag to false
     _enabled = false;
@@ -242,8 +257,9 @@ CosmicRayDetector::CosmicRayDetector():
   // Initialize members
   _initialized(false),
   _movingAverageIndex(0),
+  _movingAverageTickMicroseconds(0),
   _movingAverageTimer(NULL),
-  _coincidenceTube(COINCIDENCE_TRG_PIN, _movingAverage, _movingAverageIndex),
+  _coincidenceTube(COINCIDENCE_TRG_PIN, _movingAverage, _movingAverageIndex, _movingAverageTickMicroseconds),
   _enabled(false),
   _coincidenceTubeOffset(0),
   _mainTubeOffset(0),
@@ -265,6 +281,9 @@ void IRAM_ATTR CosmicRayDetector::_advanceMovingAverage(void *instancePointer) {
   // Clear the next element in the array
   instance->_movingAverage[wrappedIndex] = 0;
 
+  // Remember when the index was advanced, so pulses recorded before that can still be assigned to the previous element
+  instance->_movingAverageTickMicroseconds = micros();
+
   // Set the moving index to the next element in the array
   instance->_movingAverageIndex = wrappedIndex;
 
@@ -18,6 +18,7 @@ class CosmicRayDetector {
     static CosmicRayDetector& getInstance();
 
     void     begin();                                     // Initialize everything
+    void     update();                                    // Update the cosmic ray detector
     void     enable();                                    // Enable the cosmic ray detector
     void     disable();                                   // Disable the cosmic ray detector
     void     setCosmicRayDetectorState(const bool state); // Set the state of the cosmic ray detector
@@ -38,15 +39,16 @@ class CosmicRayDetector {
     CosmicRayDetector(const CosmicRayDetector&) = delete;
     CosmicRayDetector& operator=(const CosmicRayDetector&) = delete;
 
-    bool              _initialized;           // Flag for checking of the cosmic ray detector is enabled
-    volatile uint16_t _movingAverage[60];     // Array for storing coincidence events per hour
-    volatile uint8_t  _movingAverageIndex;    // Index of the moving average array
-    hw_timer_t        *_movingAverageTimer;   // Hardware timer for advancing the moving average array
-    CoincidenceTube   _coincidenceTube;       // Virtual coincidence tube
-    bool              _enabled;               // Flag for checking if the cosmic ray detector is enabled
-    uint64_t          _coincidenceTubeOffset; // Coincidence tube counts offset
-    uint64_t          _mainTubeOffset;        // Main tube counts offset
-    uint64_t          _followerTubeOffset;    // Follower tube counts offset
+    bool              _initialized;                   // Flag for checking of the cosmic ray detector is enabled
+    volatile uint16_t _movingAverage[60];             // Array for storing coincidence events per hour
+    volatile uint8_t  _movingAverageIndex;            // Index of the moving average array
+    volatile uint32_t _movingAverageTickMicroseconds; // Time the moving average index was last advanced in microseconds
+    hw_timer_t        *_movingAverageTimer;           // Hardware timer for advancing the moving average array
+    CoincidenceTube   _coincidenceTube;               // Virtual coincidence tube
+    bool              _enabled;                       // Flag for checking if the cosmic ray detector is enabled
+    uint64_t          _coincidenceTubeOffset;         // Coincidence tube counts offset
+    uint64_t          _mainTubeOffset;                // Main tube counts offset
+    uint64_t          _followerTubeOffset;            // Follower tube counts offset
 
     // Interrupt service routine for advancing the moving average
     static void IRAM_ATTR _advanceMovingAverage(void *instancePointer);
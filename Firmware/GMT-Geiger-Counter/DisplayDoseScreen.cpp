@@ -27,7 +27,8 @@ DisplayDoseScreen::DisplayDoseScreen(
   _borderColor(borderColor),
   _backgroundColor(backgroundColor),
   _value(value),
-  _unit(unit)
+  _unit(unit),
+  _dirty(true)
 
 {}
 
@@ -76,6 +77,9 @@ void DisplayDoseScreen::draw(GFXcanvas16 &canvas) {
   canvas.setCursor(cursorX, cursorY);
   canvas.print(_unit);
 
+  // The dose screen is up to date now
+  _dirty = false;
+
 }
 
 // ================================================================================================
@@ -83,6 +87,9 @@ void DisplayDoseScreen::draw(GFXcanvas16 &canvas) {
 // ================================================================================================
 void DisplayDoseScreen::setBorderColor(const uint16_t color) {
 
+  // Only draw the dose screen again if the color changed
+  if (_borderColor != color) { _dirty = true; }
+
   _borderColor = color;
 
 }
@@ -92,24 +99,40 @@ void DisplayDoseScreen::setBorderColor(const uint16_t color) {
 // ================================================================================================
 void DisplayDoseScreen::setBackgroundColor(const uint16_t color) {
 
+  // Only draw the dose screen again if the color changed
+  if (_backgroundColor != color) { _dirty = true; }
+
   _backgroundColor = color;
 
 }
 
 // ================================================================================================
-// Set the screen background color
+// Set the screen value
 // ================================================================================================
 void DisplayDoseScreen::setValue(const char *value) {
 
+  // The value string is usually reused for the new text, so the pointer can't tell if it changed
   _value = value;
+  _dirty = true;
 
 }
 
 // ================================================================================================
-// Set the screen background color
+// Set the screen unit
 // ================================================================================================
 void DisplayDoseScreen::setUnit(const char *unit) {
 
-  _unit = unit;
+  // Draw again with the new unit
+  _unit  = unit;
+  _dirty = true;
+
+}
+
+// ================================================================================================
+// Get whether the dose screen changed since it was last drawn
+// ================================================================================================
+bool DisplayDoseScreen::getDirtyState() {
+
+  return _dirty;
 
 }
\ No newline at end of file
@@ -29,6 +29,7 @@ class DisplayDoseScreen {
     void setBackgroundColor(const uint16_t color); // Set the screen background color
     void setValue(const char *value);              // Set the screen value
     void setUnit(const char *unit);                // Set the screen unit
+    bool getDirtyState();                          // Get whether the dose screen changed since it was last drawn
 
   // ----------------------------------------------------------------------------------------------
   // Private
@@ -43,6 +44,7 @@ class DisplayDoseScreen {
     uint16_t       _backgroundColor; // Screen background color
     const char     *_value;          // Value string
     const char     *_unit;           // Unit string
+    bool           _dirty;           // Flag for drawing the dose screen again on the next refresh
 
 };
 
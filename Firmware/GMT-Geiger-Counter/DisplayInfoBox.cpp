@@ -13,7 +13,8 @@ DisplayInfoBox::DisplayInfoBox(const uint16_t x, const uint16_t y, const uint16_
   _y(y),
   _width(width - 26),
   _icon(icon),
-  _value(value)
+  _value(value),
+  _dirty(true)
 
 {}
 
@@ -35,6 +36,9 @@ void DisplayInfoBox::draw(GFXcanvas16 &canvas) {
   canvas.setCursor(_x + 31, _y + 18);
   canvas.print(_value);
 
+  // The info box is up to date now
+  _dirty = false;
+
 }
 
 // ================================================================================================
@@ -42,6 +46,17 @@ void DisplayInfoBox::draw(GFXcanvas16 &canvas) {
 // ================================================================================================
 void DisplayInfoBox::setValue(const char *value) {
 
+  // Always draw again, the owner only sets the value when its text changed
   _value = value;
+  _dirty = true;
+
+}
+
+// ================================================================================================
+// Get whether the info box changed since it was last drawn
+// ================================================================================================
+bool DisplayInfoBox::getDirtyState() {
+
+  return _dirty;
 
 }
\ No newline at end of file
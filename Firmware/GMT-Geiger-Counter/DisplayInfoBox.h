@@ -17,6 +17,7 @@ class DisplayInfoBox {
 
     void draw(GFXcanvas16 &canvas);   // Draw the info box
     void setValue(const char *value); // Set the info box value
+    bool getDirtyState();             // Get whether the info box changed since it was last drawn
 
   // ----------------------------------------------------------------------------------------------
   // Private
@@ -28,6 +29,7 @@ class DisplayInfoBox {
     const uint16_t _width;  // Info box width
     const Image    &_icon;  // Info box icon
     const char     *_value; // Info box text value
+    bool           _dirty; // Flag for drawing the info box again on the next refresh
 
 };
 
@@ -13,7 +13,8 @@ DisplayToastBox::DisplayToastBox(const uint16_t x, const uint16_t y, const uint1
   _y(y),
   _width(width),
   _title(title),
-  _value(value)
+  _value(value),
+  _dirty(true)
 
 {}
 
@@ -41,6 +42,9 @@ void DisplayToastBox::draw(GFXcanvas16 &canvas) {
   canvas.setCursor(_x + 5, _y + 42);
   canvas.print(_value);
 
+  // The toast box is up to date now
+  _dirty = false;
+
 }
 
 // ================================================================================================
@@ -48,6 +52,17 @@ void DisplayToastBox::draw(GFXcanvas16 &canvas) {
 // ================================================================================================
 void DisplayToastBox::setValue(const char *value) {
 
+  // The text may have changed in the same buffer, so there's nothing to compare against
   _value = value;
+  _dirty = true;
+
+}
+
+// ================================================================================================
+// Get whether the toast box changed since it was last drawn
+// ================================================================================================
+bool DisplayToastBox::getDirtyState() {
+
+  return _dirty;
 
 }
\ No newline at end of file
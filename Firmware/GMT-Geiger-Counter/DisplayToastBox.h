@@ -17,6 +17,7 @@ class DisplayToastBox {
 
     void draw(GFXcanvas16 &canvas);   // Draw the toast box
     void setValue(const char *value); // Set the toast box value
+    bool getDirtyState();             // Get whether the toast box changed since it was last drawn
 
   // ----------------------------------------------------------------------------------------------
   // Private
@@ -28,6 +29,7 @@ class DisplayToastBox {
     const uint16_t _width;  // Toast box width
     const char     *_title; // Toast box title
     const char     *_value; // Toast box text value
+    bool           _dirty; // Flag for drawing the toast box again on the next refresh
 
 };
 
@@ -12,6 +12,9 @@
 #include "RGBLED.h"
 #include "Wireless.h"
 #include "Watchdog.h"
+#include "PulseSimulator.h"
+#include "PulseCapture.h"
+#include "LiveStream.h"
 
 // ------------------------------------------------------------------------------------------------
 // Global
@@ -26,6 +29,23 @@ bool     LAST_DETECTIONS_MUTE_STATE    = false;
 bool     LAST_BUZZER_MUTER_STATE       = false;
 bool     LAST_RGB_LED_STATE            = true;
 uint64_t LOG_TIMER                     = 0;
+uint64_t LOOP_ITERATIONS               = 0;
+uint64_t LOOP_MICROSECONDS             = 0;
+uint32_t LOOP_PEAK_MICROSECONDS        = 0;
+uint32_t LAST_LOOP_PEAK_MICROSECONDS   = 0;
+uint64_t LOOP_PEAK_TIMER               = 0;
+
+// Buffer the metrics are rendered into, only the web server task uses it
+char METRICS_BUFFER[METRICS_BUFFER_SIZE_BYTES];
+
+// Buffer the snapshots are built in, allocated in the PSRAM on the first request, only the web server task uses it
+char *SNAPSHOT_BUFFER = NULL;
+
+// Copy of the buckets of one radiation history resolution, latest first, allocated in the PSRAM on the first request, only the web server task uses it
+RadiationHistory::Bucket *RADIATION_HISTORY_SNAPSHOT = NULL;
+
+// Radiation history resolution names in the order of the resolution enumerator
+const char *RADIATION_HISTORY_RESOLUTIONS[4] = {"seconds", "minutes", "hours", "days"};
 
 // Function prototypes
 void setup();
@@ -88,10 +108,31 @@ void toggleSystemSDCardLogging(const bool toggled);
 void toggleSystemDataLogging(const bool toggled);
 void toggleSystemEventLogging(const bool toggled);
 void toggleSystemInfoLogging(const bool toggled);
+void toggleSystemBinaryLogging(const bool toggled);
 void sendGeigerCounterData();
+size_t getGeigerCounterMessage(const uint32_t time, char *buffer, const size_t size);
+void sendRadiationHistoryData();
+size_t getRadiationHistoryHeader(const uint32_t time, const RadiationHistory::Resolution resolution, char *buffer, const size_t size);
+size_t addRadiationHistoryBuckets(uint16_t &age, char *buffer, const size_t size);
+bool allocateRadiationHistorySnapshot();
+void copyRadiationHistory(const RadiationHistory::Resolution resolution);
+void sendPulseCaptureData();
 void sendCosmicRayDetectorData();
+size_t getCosmicRayDetectorMessage(const uint32_t time, char *buffer, const size_t size);
+void sendRandomNumberGeneratorData();
+size_t getRandomNumberGeneratorMessage(const uint32_t time, char *buffer, const size_t size);
 void sendLogFileData();
+void sendLogManifestData();
+void subscribeLiveStream();
+void streamLogFile(File &file, const char *name);
+void streamConvertedLogFile(File &file, const char *name);
+void sendConvertedLogFileContent(const char *data, const size_t size);
 void sendSystemInfoData();
+size_t getSystemInfoMessage(const uint32_t time, char *buffer, const size_t size);
+void sendSnapshotData();
+void sendMetrics();
+void addMetricFamily(size_t &length, const char *name, const char *type, const char *help);
+void addMetricSample(size_t &length, const char *sample, const double value);
 void sendRestartAcknowledgement();
 void restart();
 void reset();
@@ -104,6 +145,24 @@ void setup() {
   // Setup hardware pins
   setupPins();
 
+  // Assign web server endpoints, the web server task starts serving them once the wireless interface is initialized
+  wireless.server.on("/data/geiger-counter",          HTTP_GET, sendGeigerCounterData        );
+  wireless.server.on("/data/radiation-history",       HTTP_GET, sendRadiationHistoryData     );
+  wireless.server.on("/data/cosmic-ray-detector",     HTTP_GET, sendCosmicRayDetectorData    );
+  wireless.server.on("/data/random-number-generator", HTTP_GET, sendRandomNumberGeneratorData);
+  wireless.server.on("/data/log",                     HTTP_GET, sendLogFileData              );
+  wireless.server.on("/data/logs",                    HTTP_GET, sendLogManifestData          );
+  wireless.server.on("/data/stream",                  HTTP_GET, subscribeLiveStream          );
+  wireless.server.on("/data/system",                  HTTP_GET, sendSystemInfoData           );
+  wireless.server.on("/data/snapshot",                HTTP_GET, sendSnapshotData             );
+  wireless.server.on("/metrics",                      HTTP_GET, sendMetrics                  );
+  wireless.server.on("/system/restart",               HTTP_PUT, sendRestartAcknowledgement   );
+
+  // If the pulse capture is enabled in the main configuration file, assign the capture endpoint
+  #if ENABLE_PULSE_CAPTURE == 1
+    wireless.server.on("/data/pulses", HTTP_GET, sendPulseCaptureData);
+  #endif
+
   // Initialize everything
   logger.begin();
   sdCard.begin();
@@ -115,31 +174,51 @@ void setup() {
   touchscreen.begin();
   rgbLED.begin();
   wireless.begin();
+
+  // Keep the request handlers waiting until everything is set up
+  wireless.lock();
+
+  liveStream.begin();
   watchdog.begin();
 
+  // If the pulse simulator is enabled in the main configuration file, take over the tube pin
+  #if ENABLE_PULSE_SIMULATOR == 1
+    pulseSimulator.begin();
+  #endif
+
+  // If the pulse capture is enabled in the main configuration file, allocate the capture buffer
+  #if ENABLE_PULSE_CAPTURE == 1
+    pulseCapture.begin();
+  #endif
+
   // Set touch actions
   setTouchActions();
 
   // Load and set the user settings
   setUserSettings();
 
-  // Assign web server endpoints
-  wireless.server.on("/data/geiger-counter",          HTTP_GET, sendGeigerCounterData        );
-  wireless.server.on("/data/cosmic-ray-detector",     HTTP_GET, sendCosmicRayDetectorData    );
-  wireless.server.on("/data/random-number-generator", HTTP_GET, sendRandomNumberGeneratorData);
-  wireless.server.on("/data/log",                     HTTP_GET, sendLogFileData              );
-  wireless.server.on("/data/system",                  HTTP_GET, sendSystemInfoData           );
-  wireless.server.on("/system/restart",               HTTP_PUT, sendRestartAcknowledgement   );
-
   // Enable geiger counter
   geigerCounter.enable();
 
+  // If the pulse simulator is enabled in the main configuration file, start generating pulses
+  #if ENABLE_PULSE_SIMULATOR == 1
+    pulseSimulator.enable();
+  #endif
+
+  // If the pulse capture is enabled in the main configuration file, start capturing pulses
+  #if ENABLE_PULSE_CAPTURE == 1
+    pulseCapture.enable();
+  #endif
+
   // Enable touchscreen
   touchscreen.enable();
 
   // Play jingle
   buzzer.play(buzzer.jingle);
 
+  // Start handling requests
+  wireless.unlock();
+
 }
 
 // ================================================================================================
@@ -147,6 +226,21 @@ void setup() {
 // ================================================================================================
 void loop() {
 
+  // Keep the request handlers from reading data while it is being updated
+  wireless.lock();
+
+  // Start of the loop iteration
+  uint32_t loopStart = micros();
+
+  // Collect the pulses recorded by the tube ISRs
+  geigerCounter.update();
+  cosmicRayDetector.update();
+
+  // If the pulse capture is enabled in the main configuration file, stream the captured pulses
+  #if ENABLE_PULSE_CAPTURE == 1
+    pulseCapture.update();
+  #endif
+
   // Audio feedback
   audioFeedback();
 
@@ -162,12 +256,38 @@ void loop() {
   // Update user settings
   settings.update();
 
+  // Verify the SD card mount state if it is due
+  sdCard.update();
+
   // Update wireless interface
   wireless.update();
 
+  // Push the measurements to the live stream subscribers
+  liveStream.update();
+
   // Update the watchdog
   watchdog.update();
 
+  // Measure the loop iteration
+  uint32_t loopTime = micros() - loopStart;
+
+  LOOP_ITERATIONS++;
+  LOOP_MICROSECONDS      += loopTime;
+  LOOP_PEAK_MICROSECONDS  = max(LOOP_PEAK_MICROSECONDS, loopTime);
+
+  // At the end of every peak interval, keep the longest loop iteration of the interval and start over
+  if (millis() - LOOP_PEAK_TIMER >= METRICS_LOOP_PEAK_INTERVAL_SECONDS * 1000) {
+
+    LOOP_PEAK_TIMER             = millis();
+    LAST_LOOP_PEAK_MICROSECONDS = LOOP_PEAK_MICROSECONDS;
+    LOOP_PEAK_MICROSECONDS      = 0;
+
+  }
+
+  // Let the request handlers waiting for data have their turn
+  wireless.unlock();
+  wireless.yieldLock();
+
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -308,6 +428,7 @@ void setTouchActions() {
   touchscreen.systemSettings1.dataLogging.action   = toggleSystemDataLogging;
   touchscreen.systemSettings1.eventLogging.action  = toggleSystemEventLogging;
   touchscreen.systemSettings1.systemLogging.action = toggleSystemInfoLogging;
+  touchscreen.systemSettings1.binaryLogging.action = toggleSystemBinaryLogging;
 
   // --------------------------------------------
   // System settings 2 touch actions
@@ -356,6 +477,7 @@ void setUserSettings() {
   // Logger settings
 
   logger.setSerialLoggingState(settings.data.parameters.logger.serial);
+  logger.setLogFormat(settings.data.parameters.logger.format);
   logger.setSDCardLoggingState(settings.data.parameters.logger.sdCard);
   logger.setLogLevelState(Logger::DATA, settings.data.parameters.logger.data);
   logger.setLogLevelState(Logger::EVENT, settings.data.parameters.logger.event);
@@ -435,18 +557,11 @@ void visualFeedback() {
   touchscreen.geigerCounterInfo3.autoIntegrate.setToggleState(geigerCounter.getAutoIntegrateState());
   touchscreen.geigerCounterInfo3.autoRange.setToggleState(geigerCounter.getAutoRangeState());
   
-  // Deselect all units radio buttons
-  geigerCounterDeselectAllUnits();
-
-  // Select the measurement unit radio button depending on the selected measurement unit
-  switch (geigerCounter.getMeasurementUnit()) {
-
-    case GeigerCounter::SIEVERTS: touchscreen.geigerCounterInfo3.sieverts.select(); break;
-    case GeigerCounter::REM:      touchscreen.geigerCounterInfo3.rem.select();      break;
-    case GeigerCounter::RONTGEN:  touchscreen.geigerCounterInfo3.rontgen.select();  break;
-    case GeigerCounter::GRAY:     touchscreen.geigerCounterInfo3.gray.select();     break;
-
-  }
+  // Select only the measurement unit radio button of the selected measurement unit, set each one so the ones that didn't change aren't redrawn
+  touchscreen.geigerCounterInfo3.sieverts.setSelectState(geigerCounter.getMeasurementUnit() == GeigerCounter::SIEVERTS);
+  touchscreen.geigerCounterInfo3.rem.setSelectState(geigerCounter.getMeasurementUnit() == GeigerCounter::REM);
+  touchscreen.geigerCounterInfo3.rontgen.setSelectState(geigerCounter.getMeasurementUnit() == GeigerCounter::RONTGEN);
+  touchscreen.geigerCounterInfo3.gray.setSelectState(geigerCounter.getMeasurementUnit() == GeigerCounter::GRAY);
 
   // --------------------------------------------
   // Audio settings screen
@@ -476,7 +591,7 @@ void visualFeedback() {
   // --------------------------------------------
   // Radiation history screen
 
-  touchscreen.radiationHistory.setRadiationHistory(geigerCounter.getHistory(), geigerCounter.getHistoryIndex());
+  touchscreen.radiationHistory.setRadiationHistory(geigerCounter.getHistory());
 
   // --------------------------------------------
   // True RNG screen
@@ -508,6 +623,7 @@ void visualFeedback() {
   touchscreen.systemSettings1.dataLogging.setToggleState(logger.getLogLevelState(Logger::DATA));
   touchscreen.systemSettings1.eventLogging.setToggleState(logger.getLogLevelState(Logger::EVENT));
   touchscreen.systemSettings1.systemLogging.setToggleState(logger.getLogLevelState(Logger::SYSTEM));
+  touchscreen.systemSettings1.binaryLogging.setToggleState(logger.getLogFormat() == Logger::BINARY);
 
   // --------------------------------------------
   // RGB LED
@@ -528,7 +644,7 @@ void visualFeedback() {
 void audioFeedback() {
 
   uint64_t counts               = geigerCounter.getCounts();
-  double   microsievertsPerHour = geigerCounter.getMicrosievertsPerHour();
+  double   microsievertsPerHour = geigerCounter.getCorrectedMicrosievertsPerHour();
   uint64_t coincidenceEvents    = cosmicRayDetector.getCoincidenceEvents();
 
   // If the dose reaches the alarm level and not already playing alarm and alerts not muted
@@ -679,23 +795,25 @@ void dataFeedback() {
     if (geigerCounter.getGeigerCounterState()) {
 
       // Get data
-      Logger::KeyValuePair geigerCounterData[10] = {
-
-        {"counts",                Logger::UINT64_T, {.uint64_v = geigerCounter.getCounts()}                       },
-        {"mainCounts",            Logger::UINT64_T, {.uint64_v = geigerCounter.getMainTubeCounts()}               },
-        {"followerCounts",        Logger::UINT64_T, {.uint64_v = geigerCounter.getFollowerTubeCounts()}           },
-        {"countsPerMinute",       Logger::DOUBLE_T, {.double_v = geigerCounter.getCountsPerMinute(60)}            },
-        {"totalMicrosieverts",    Logger::DOUBLE_T, {.double_v = geigerCounter.getAbsorbedMicrosieverts()}        },
-        {"mainMicrosieverts" ,    Logger::DOUBLE_T, {.double_v = geigerCounter.getMainAbsorbedMicrosieverts()}    },
-        {"followerMicrosieverts", Logger::DOUBLE_T, {.double_v = geigerCounter.getFollowerAbsorbedMicrosieverts()}},
-        {"microsievertsPerHour",  Logger::DOUBLE_T, {.double_v = geigerCounter.getMicrosievertsPerHour(60)}       },
-        {"tubes",                 Logger::UINT8_T,  {.uint8_v  = TOTAL_NUMBER_OF_TUBES}                           },
-        {"tubeType",              Logger::STRING_T, {.string_v = TUBE_TYPE_NAME}                                  }
+      Logger::KeyValuePair geigerCounterData[12] = {
+
+        {"counts",                        Logger::UINT64_T, {.uint64_v = geigerCounter.getCounts()}                         },
+        {"mainCounts",                    Logger::UINT64_T, {.uint64_v = geigerCounter.getMainTubeCounts()}                 },
+        {"followerCounts",                Logger::UINT64_T, {.uint64_v = geigerCounter.getFollowerTubeCounts()}             },
+        {"countsPerMinute",               Logger::DOUBLE_T, {.double_v = geigerCounter.getCountsPerMinute(60)}              },
+        {"correctedCountsPerMinute",      Logger::DOUBLE_T, {.double_v = geigerCounter.getCorrectedCountsPerMinute(60)}     },
+        {"totalMicrosieverts",            Logger::DOUBLE_T, {.double_v = geigerCounter.getAbsorbedMicrosieverts()}          },
+        {"mainMicrosieverts" ,            Logger::DOUBLE_T, {.double_v = geigerCounter.getMainAbsorbedMicrosieverts()}      },
+        {"followerMicrosieverts",         Logger::DOUBLE_T, {.double_v = geigerCounter.getFollowerAbsorbedMicrosieverts()}  },
+        {"microsievertsPerHour",          Logger::DOUBLE_T, {.double_v = geigerCounter.getMicrosievertsPerHour(60)}         },
+        {"correctedMicrosievertsPerHour", Logger::DOUBLE_T, {.double_v = geigerCounter.getCorrectedMicrosievertsPerHour(60)}},
+        {"tubes",                         Logger::UINT8_T,  {.uint8_v  = TOTAL_NUMBER_OF_TUBES}                             },
+        {"tubeType",                      Logger::STRING_T, {.string_v = TUBE_TYPE_NAME}                                    }
 
       };
 
       // Log data
-      logger.log(Logger::DATA, "geigerCounter", geigerCounterData, 10);
+      logger.log(Logger::DATA, "geigerCounter", geigerCounterData, 12);
 
     }
 
@@ -718,6 +836,11 @@ void dataFeedback() {
 
     }
 
+    // If the pulse simulator is enabled in the main configuration file, log the benchmark results
+    #if ENABLE_PULSE_SIMULATOR == 1
+      pulseSimulator.log();
+    #endif
+
     // Update log timer
     LOG_TIMER = millis();
 
@@ -1775,6 +1898,22 @@ void toggleSystemInfoLogging(const bool toggled) {
 
 }
 
+// ================================================================================================
+// 
+// ================================================================================================
+void toggleSystemBinaryLogging(const bool toggled) {
+
+  // Set the new log file format, this starts a new log file
+  logger.setLogFormat(toggled ? Logger::BINARY : Logger::JSON);
+
+  // Update settings
+  settings.data.parameters.logger.format = logger.getLogFormat();
+
+  // Play a sound
+  buzzer.play(buzzer.tap);
+
+}
+
 // ------------------------------------------------------------------------------------------------
 // Web server actions
 
@@ -1783,32 +1922,282 @@ void toggleSystemInfoLogging(const bool toggled) {
 // ================================================================================================
 void sendGeigerCounterData() {
 
+  // JSON data buffer
+  char json[LOG_MESSAGE_MAXIMUM_SIZE_BYTES];
+
+  // Pause the main loop while collecting the data
+  wireless.lock();
+
+  // Construct the data string
+  size_t length = getGeigerCounterMessage(millis(), json, sizeof(json));
+
+  // Let the main loop continue, the data is in the buffer
+  wireless.unlock();
+
+  // If the data didn't fit into the buffer, there is nothing to send
+  if (length == 0) {
+
+    wireless.server.send(500, "text/plain", "500 - Data Buffer Too Small!");
+
+    return;
+
+  }
+
+  // Send JSON data straight from the buffer
+  wireless.server.send_P(200, "application/json", json, length);
+
+}
+
+// ================================================================================================
+// Construct the Geiger counter data message in a buffer and return its length, 0 if it doesn't fit
+// ================================================================================================
+size_t getGeigerCounterMessage(const uint32_t time, char *buffer, const size_t size) {
+
   // Get data
-  Logger::KeyValuePair data[12] = {
-
-    {"enabled",               Logger::BOOL_T,   {.bool_v   = geigerCounter.getGeigerCounterState()}           },
-    {"counts",                Logger::UINT64_T, {.uint64_v = geigerCounter.getCounts()}                       },
-    {"mainCounts",            Logger::UINT64_T, {.uint64_v = geigerCounter.getMainTubeCounts()}               },
-    {"followerCounts",        Logger::UINT64_T, {.uint64_v = geigerCounter.getFollowerTubeCounts()}           },
-    {"countsPerMinute",       Logger::DOUBLE_T, {.double_v = geigerCounter.getCountsPerMinute(60)}            },
-    {"totalMicrosieverts",    Logger::DOUBLE_T, {.double_v = geigerCounter.getAbsorbedMicrosieverts()}        },
-    {"mainMicrosieverts" ,    Logger::DOUBLE_T, {.double_v = geigerCounter.getMainAbsorbedMicrosieverts()}    },
-    {"followerMicrosieverts", Logger::DOUBLE_T, {.double_v = geigerCounter.getFollowerAbsorbedMicrosieverts()}},
-    {"microsievertsPerHour",  Logger::DOUBLE_T, {.double_v = geigerCounter.getMicrosievertsPerHour(60)}       },
-    {"rating",                Logger::UINT8_T,  {.uint8_v  = geigerCounter.getRadiationRating()}              },
-    {"tubes",                 Logger::UINT8_T,  {.uint8_v  = TOTAL_NUMBER_OF_TUBES}                           },
-    {"tubeType",              Logger::STRING_T, {.string_v = TUBE_TYPE_NAME}                                  }
+  Logger::KeyValuePair data[16] = {
 
-  };
+    {"enabled",                       Logger::BOOL_T,   {.bool_v   = geigerCounter.getGeigerCounterState()}             },
+    {"counts",                        Logger::UINT64_T, {.uint64_v = geigerCounter.getCounts()}                         },
+    {"mainCounts",                    Logger::UINT64_T, {.uint64_v = geigerCounter.getMainTubeCounts()}                 },
+    {"followerCounts",                Logger::UINT64_T, {.uint64_v = geigerCounter.getFollowerTubeCounts()}             },
+    {"countsPerMinute",               Logger::DOUBLE_T, {.double_v = geigerCounter.getCountsPerMinute(60)}              },
+    {"correctedCountsPerMinute",      Logger::DOUBLE_T, {.double_v = geigerCounter.getCorrectedCountsPerMinute(60)}     },
+    {"autoCountsPerMinute",           Logger::DOUBLE_T, {.double_v = geigerCounter.getCountsPerMinute()}                },
+    {"autoConfidence",                Logger::DOUBLE_T, {.double_v = geigerCounter.getCountsPerMinuteConfidence()}      },
+    {"totalMicrosieverts",            Logger::DOUBLE_T, {.double_v = geigerCounter.getAbsorbedMicrosieverts()}          },
+    {"mainMicrosieverts" ,            Logger::DOUBLE_T, {.double_v = geigerCounter.getMainAbsorbedMicrosieverts()}      },
+    {"followerMicrosieverts",         Logger::DOUBLE_T, {.double_v = geigerCounter.getFollowerAbsorbedMicrosieverts()}  },
+    {"microsievertsPerHour",          Logger::DOUBLE_T, {.double_v = geigerCounter.getMicrosievertsPerHour(60)}         },
+    {"correctedMicrosievertsPerHour", Logger::DOUBLE_T, {.double_v = geigerCounter.getCorrectedMicrosievertsPerHour(60)}},
+    {"rating",                        Logger::UINT8_T,  {.uint8_v  = geigerCounter.getRadiationRating()}                },
+    {"tubes",                         Logger::UINT8_T,  {.uint8_v  = TOTAL_NUMBER_OF_TUBES}                             },
+    {"tubeType",                      Logger::STRING_T, {.string_v = TUBE_TYPE_NAME}                                    }
 
-  // JSON data string
-  String json;
+  };
 
   // Construct the data string
-  logger.getLogMessage("geigerCounter", data, 12, json);
+  return logger.getLogMessage(time, "geigerCounter", data, 16, buffer, size);
+
+}
+
+// ================================================================================================
+// 
+// ================================================================================================
+void sendRadiationHistoryData() {
+
+  // Use the minutes resolution if no other resolution is requested
+  RadiationHistory::Resolution resolution = RadiationHistory::MINUTES;
+
+  // Get the requested resolution
+  for (uint8_t i = RadiationHistory::SECONDS; i <= RadiationHistory::DAYS; i++) {
+
+    if (wireless.server.arg("resolution") == RADIATION_HISTORY_RESOLUTIONS[i]) { resolution = (RadiationHistory::Resolution)i; }
+
+  }
+
+  // If there is no radiation history snapshot buffer
+  if (!allocateRadiationHistorySnapshot()) {
+
+    // Return with a 503 - No Snapshot Buffer!
+    wireless.server.send(503, "text/plain", "503 - No Snapshot Buffer!");
 
-  // Send JSON data
-  wireless.server.send(200, "application/json", json);
+    return;
+
+  }
+
+  // Chunk buffer
+  char   buffer[512];
+  size_t size = 0;
+
+  // Pause the main loop once while copying the radiation history, so the whole response shows the same state of it
+  wireless.lock();
+
+  copyRadiationHistory(resolution);
+
+  // Number of buckets left to send, starting with the oldest one
+  uint16_t age = geigerCounter.getHistory().getLength(resolution);
+
+  // Add the message header
+  size += getRadiationHistoryHeader(millis(), resolution, buffer, sizeof(buffer));
+
+  // Let the main loop continue while the response is sent from the copy
+  wireless.unlock();
+
+  // The response is sent in chunks directly from the history buckets, the length is not known in advance
+  wireless.server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  wireless.server.send(200, "application/json", "");
+
+  // Until every bucket is sent
+  while (true) {
+
+    // Add as many buckets as fit into the buffer
+    size += addRadiationHistoryBuckets(age, buffer + size, sizeof(buffer) - size);
+
+    // If every bucket was added, stop
+    if (age == 0) { break; }
+
+    // Otherwise send the full buffer as a chunk
+    wireless.server.sendContent(buffer, size);
+
+    size = 0;
+
+  }
+
+  // If there is no room left for the message footer, send the buffer first
+  if (size + 4 > sizeof(buffer)) {
+
+    wireless.server.sendContent(buffer, size);
+
+    size = 0;
+
+  }
+
+  // Add the message footer and send the last chunk
+  size += snprintf(buffer + size, sizeof(buffer) - size, "]}}");
+
+  wireless.server.sendContent(buffer, size);
+
+  // End the chunked response
+  wireless.server.sendContent("");
+
+}
+
+// ================================================================================================
+// Construct the start of a radiation history message in a buffer and return its length
+// ================================================================================================
+size_t getRadiationHistoryHeader(const uint32_t time, const RadiationHistory::Resolution resolution, char *buffer, const size_t size) {
+
+  return snprintf(buffer, size, "{\"type\":\"radiationHistory\",\"time\":%" PRIu32 ",\"data\":{\"resolution\":\"%s\",\"interval\":%" PRIu32 ",\"buckets\":[", time, RADIATION_HISTORY_RESOLUTIONS[resolution], geigerCounter.getHistory().getIntervalSeconds(resolution));
+
+}
+
+// ================================================================================================
+// Add as many buckets of the radiation history copy as fit into a buffer, starting at an age, and return their length
+// ================================================================================================
+size_t addRadiationHistoryBuckets(uint16_t &age, char *buffer, const size_t size) {
+
+  // Length of the added buckets
+  size_t length = 0;
+
+  // For every bucket left, starting with the oldest one
+  while (age > 0) {
+
+    // Get the bucket
+    const RadiationHistory::Bucket &bucket = RADIATION_HISTORY_SNAPSHOT[age - 1];
+
+    // Length of the bucket
+    size_t bucketLength = 0;
+
+    // Add the bucket as [minimum, maximum, mean] or null if it was not recorded yet
+    if (bucket.mean == UINT32_MAX) {
+
+      bucketLength = snprintf(buffer + length, size - length, "null%s", (age > 1) ? "," : "");
+
+    } else {
+
+      bucketLength = snprintf(buffer + length, size - length, "[%" PRIu32 ",%" PRIu32 ",%" PRIu32 "]%s", bucket.minimum, bucket.maximum, bucket.mean, (age > 1) ? "," : "");
+
+    }
+
+    // If the bucket didn't fit, leave it for the next call
+    if (bucketLength >= size - length) { break; }
+
+    length += bucketLength;
+
+    age--;
+
+  }
+
+  return length;
+
+}
+
+// ================================================================================================
+// Allocate the radiation history copy in the PSRAM on the first request, large enough for every resolution
+// ================================================================================================
+bool allocateRadiationHistorySnapshot() {
+
+  // If it is already allocated, there is nothing to do
+  if (RADIATION_HISTORY_SNAPSHOT != NULL) { return true; }
+
+  // Get the number of buckets of the longest resolution
+  uint16_t length = 0;
+
+  for (uint8_t i = RadiationHistory::SECONDS; i <= RadiationHistory::DAYS; i++) { length = max(length, geigerCounter.getHistory().getLength((RadiationHistory::Resolution)i)); }
+
+  RADIATION_HISTORY_SNAPSHOT = (RadiationHistory::Bucket*)heap_caps_malloc(length * sizeof(RadiationHistory::Bucket), MALLOC_CAP_SPIRAM);
+
+  return RADIATION_HISTORY_SNAPSHOT != NULL;
+
+}
+
+// ================================================================================================
+// Copy the buckets of a radiation history resolution, latest first, the main loop has to be paused
+// ================================================================================================
+void copyRadiationHistory(const RadiationHistory::Resolution resolution) {
+
+  // Get the radiation history
+  RadiationHistory &history = geigerCounter.getHistory();
+
+  for (uint16_t age = 0; age < history.getLength(resolution); age++) { RADIATION_HISTORY_SNAPSHOT[age] = history.getBucket(resolution, age); }
+
+}
+
+// ================================================================================================
+// 
+// ================================================================================================
+void sendPulseCaptureData() {
+
+  // If the serial stream is enabled in the main configuration file, it takes the pulses out of the buffer
+  // A second consumer would get every other frame, so the request is rejected
+  #if PULSE_CAPTURE_SERIAL == 1
+
+    wireless.server.send(409, "text/plain", "409 - Pulses Are Streamed Over Serial!");
+
+    return;
+
+  #endif
+
+  // The captured pulses are sent as binary frames in chunks, the length is not known in advance
+  wireless.server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  wireless.server.send(200, "application/octet-stream", "");
+
+  // Frame buffer
+  uint8_t buffer[sizeof(PulseCapture::FrameHeader) + PULSE_CAPTURE_FRAME_PULSES * sizeof(PulseCapture::Pulse)];
+
+  // Number of pulses sent
+  uint32_t pulses = 0;
+
+  // Send frames until the buffer is empty or the maximum number of pulses per request was sent
+  // Pulses captured in the meantime are left for the next request
+  while (pulses < PULSE_CAPTURE_REQUEST_PULSES) {
+
+    // Copy the oldest pulses out of the capture buffer, pausing the main loop while doing so
+    wireless.lock();
+    size_t size = pulseCapture.getFrame(buffer, sizeof(buffer));
+    wireless.unlock();
+
+    // If there are no more pulses, stop
+    if (size == 0) { break; }
+
+    // Send the frame as a chunk
+    wireless.server.sendContent((const char*)buffer, size);
+
+    // If the client is gone, the frame was not sent and its pulses stay in the buffer for the next request
+    if (!wireless.server.client().connected()) { return; }
+
+    // Take the pulses of the sent frame out of the buffer
+    wireless.lock();
+    pulseCapture.removeFrame(size);
+    wireless.unlock();
+
+    // Increase the number of pulses sent
+    pulses += (size - sizeof(PulseCapture::FrameHeader)) / sizeof(PulseCapture::Pulse);
+
+  }
+
+  // End the chunked response
+  wireless.server.sendContent("");
 
 }
 
@@ -1817,6 +2206,37 @@ void sendGeigerCounterData() {
 // ================================================================================================
 void sendCosmicRayDetectorData() {
 
+  // JSON data buffer
+  char json[LOG_MESSAGE_MAXIMUM_SIZE_BYTES];
+
+  // Pause the main loop while collecting the data
+  wireless.lock();
+
+  // Construct the data string
+  size_t length = getCosmicRayDetectorMessage(millis(), json, sizeof(json));
+
+  // Let the main loop continue, the data is in the buffer
+  wireless.unlock();
+
+  // If the data didn't fit into the buffer, there is nothing to send
+  if (length == 0) {
+
+    wireless.server.send(500, "text/plain", "500 - Data Buffer Too Small!");
+
+    return;
+
+  }
+
+  // Send JSON data straight from the buffer
+  wireless.server.send_P(200, "application/json", json, length);
+
+}
+
+// ================================================================================================
+// Construct the cosmic ray detector data message in a buffer and return its length, 0 if it doesn't fit
+// ================================================================================================
+size_t getCosmicRayDetectorMessage(const uint32_t time, char *buffer, const size_t size) {
+
   // Get data
   Logger::KeyValuePair data[6] = {
 
@@ -1829,14 +2249,8 @@ void sendCosmicRayDetectorData() {
     
   };
 
-  // JSON data string
-  String json;
-
   // Construct the data string
-  logger.getLogMessage("cosmicRayDetector", data, 6, json);
-
-  // Send JSON data
-  wireless.server.send(200, "application/json", json);
+  return logger.getLogMessage(time, "cosmicRayDetector", data, 6, buffer, size);
 
 }
 
@@ -1845,6 +2259,37 @@ void sendCosmicRayDetectorData() {
 // ================================================================================================
 void sendRandomNumberGeneratorData() {
 
+  // JSON data buffer
+  char json[LOG_MESSAGE_MAXIMUM_SIZE_BYTES];
+
+  // Pause the main loop while collecting the data
+  wireless.lock();
+
+  // Construct the data string
+  size_t length = getRandomNumberGeneratorMessage(millis(), json, sizeof(json));
+
+  // Let the main loop continue, the data is in the buffer
+  wireless.unlock();
+
+  // If the data didn't fit into the buffer, there is nothing to send
+  if (length == 0) {
+
+    wireless.server.send(500, "text/plain", "500 - Data Buffer Too Small!");
+
+    return;
+
+  }
+
+  // Send JSON data straight from the buffer
+  wireless.server.send_P(200, "application/json", json, length);
+
+}
+
+// ================================================================================================
+// Construct the random number generator data message in a buffer and return its length, 0 if it doesn't fit
+// ================================================================================================
+size_t getRandomNumberGeneratorMessage(const uint32_t time, char *buffer, const size_t size) {
+
   // Get data
   Logger::KeyValuePair data[3] = {
 
@@ -1854,14 +2299,8 @@ void sendRandomNumberGeneratorData() {
 
   };
 
-  // JSON data string
-  String json;
-
   // Construct the data string
-  logger.getLogMessage("randomNumberGenerator", data, 3, json);
-
-  // Send JSON data
-  wireless.server.send(200, "application/json", json);
+  return logger.getLogMessage(time, "randomNumberGenerator", data, 3, buffer, size);
 
 }
 
@@ -1870,26 +2309,67 @@ void sendRandomNumberGeneratorData() {
 // ================================================================================================
 void sendLogFileData() {
 
+  // Keep the SD card mounted until the log file was sent
+  sdCard.lock();
+
   // If the SD card is mounted
   if (sdCard.getMountState()) {
 
     // Flag for checking if log file was found
     bool found = false;
 
-    // Get the log file path
-    const char *logFilePath = logger.getLogFilePath();
+    // Write the log buffer to the SD card, so the log file is complete
+    logger.flush();
+
+    // Get the log file path, either of the current log file or of a log file listed in the log manifest
+    String logFilePath = logger.getLogFilePath();
+    String fileName    = wireless.server.arg("file");
+
+    // If a log file is requested by name
+    if (!fileName.isEmpty()) {
+
+      // Only log file names are accepted, so nothing outside the log directory can be requested
+      if (!fileName.startsWith("Log_") || fileName.indexOf('/') >= 0) {
 
-    // Check if log file exists
-    if (sdCard.exists(logFilePath)) {
+        // Return with a 400 - Invalid Log File!
+        wireless.server.send(400, "text/plain", "400 - Invalid Log File!");
+
+        sdCard.unlock();
+
+        return;
+
+      }
+
+      logFilePath  = SD_CARD_LOG_DIRECTORY;
+      logFilePath += "/";
+      logFilePath += fileName;
+
+    }
+
+    // Check if there is a log file and it exists
+    if (!logFilePath.isEmpty() && sdCard.exists(logFilePath.c_str())) {
 
       // Open log file
-      File file = sdCard.open(logFilePath);
+      File file = sdCard.open(logFilePath.c_str());
 
       // If log file was successfully accessed
       if (file) {
 
-        // Stream the log file data to the HTTP client
-        wireless.server.streamFile(file, "text/plain");
+        // Get the log file name
+        const char *name = logFilePath.c_str() + strlen(SD_CARD_LOG_DIRECTORY) + 1;
+
+        // If the whole current log file is requested and it is written in the binary format, like the web app does when binary logging is enabled
+        // Send it converted to the JSON log format the web app reads, the binary log file itself can still be requested by name or by range
+        if (fileName.isEmpty() && strstr(name, ".bin") && !wireless.server.hasArg("since") && !wireless.server.hasHeader("Range")) {
+
+          streamConvertedLogFile(file, name);
+
+        // Otherwise, stream the requested part of the log file to the HTTP client
+        } else {
+
+          streamLogFile(file, name);
+
+        }
 
         // Set the found flag to true
         found = true;
@@ -1916,6 +2396,243 @@ void sendLogFileData() {
 
   }
 
+  sdCard.unlock();
+
+}
+
+// ================================================================================================
+// Stream a log file, or the part of it requested with a range header or "?since=<offset>"
+// ================================================================================================
+void streamLogFile(File &file, const char *name) {
+
+  // Get the log file size
+  uint32_t size = file.size();
+
+  // Requested bytes, by default the whole log file
+  uint32_t start   = 0;
+  uint32_t end     = size;
+  bool     limited = false;
+  int      status  = 200;
+
+  // If everything after an offset is requested, e.g. to only fetch new log messages
+  if (wireless.server.hasArg("since")) {
+
+    // Start at the offset, an offset past the end returns nothing, which tells the client that the log file changed
+    start   = min((uint32_t)strtoul(wireless.server.arg("since").c_str(), NULL, 10), size);
+    limited = true;
+
+  // If a byte range is requested
+  } else if (wireless.server.hasHeader("Range")) {
+
+    // Get the range header, only a single range like "bytes=<first>-<last>", "bytes=<first>-" or "bytes=-<length>" is supported
+    String range = wireless.server.header("Range");
+    int    dash  = range.indexOf('-');
+
+    // Anything else is ignored and the whole log file is sent
+    if (range.startsWith("bytes=") && dash > 0 && range.indexOf(',') < 0) {
+
+      // Get the first and the last byte of the range
+      String first = range.substring(6, dash);
+      String last  = range.substring(dash + 1);
+
+      // If only a length is given, the range is at the end of the log file
+      if (first.isEmpty()) {
+
+        start = size - min((uint32_t)strtoul(last.c_str(), NULL, 10), size);
+
+      } else {
+
+        start = strtoul(first.c_str(), NULL, 10);
+
+        if (!last.isEmpty()) { end = min((uint32_t)strtoul(last.c_str(), NULL, 10) + 1, size); }
+
+      }
+
+      // If the range is outside of the log file
+      if (start >= end) {
+
+        // Return with a 416 - Range Not Satisfiable!
+        wireless.server.sendHeader("Content-Range", String("bytes */") + size);
+        wireless.server.send(416, "text/plain", "416 - Range Not Satisfiable!");
+
+        return;
+
+      }
+
+      limited = true;
+      status  = 206;
+
+    }
+
+  }
+
+  // Limit range and incremental requests, the client can ask for the rest with the next request
+  if (limited) { end = min(end, start + LOG_REQUEST_MAXIMUM_BYTES); }
+
+  // Tell the client which bytes of which log file it gets
+  if (status == 206) { wireless.server.sendHeader("Content-Range", String("bytes ") + start + "-" + (end - 1) + "/" + size); }
+
+  wireless.server.sendHeader("Accept-Ranges", "bytes");
+  wireless.server.sendHeader("X-Log-File",    name);
+  wireless.server.sendHeader("X-Log-Size",    String(size));
+
+  // Send the response header, the length is known in advance
+  wireless.server.setContentLength(end - start);
+  wireless.server.send(status, strstr(name, ".bin") ? "application/octet-stream" : "text/plain", "");
+
+  // Chunk buffer
+  char buffer[LOG_REQUEST_CHUNK_BYTES];
+
+  // Go to the first requested byte
+  file.seek(start);
+
+  // Until all requested bytes are sent
+  while (start < end) {
+
+    // Read the next piece of the log file
+    size_t length = file.read((uint8_t*)buffer, min((uint32_t)sizeof(buffer), end - start));
+
+    // If reading failed, stop
+    if (length == 0) { break; }
+
+    // Send the piece
+    wireless.server.sendContent(buffer, length);
+
+    start += length;
+
+    // Let other tasks, like the logging task, run in between
+    yield();
+
+  }
+
+}
+
+// ================================================================================================
+// Stream a binary log file converted to the JSON log format
+// ================================================================================================
+void streamConvertedLogFile(File &file, const char *name) {
+
+  // Send the response header, the length of the converted log file is not known in advance
+  wireless.server.sendHeader("X-Log-File", name);
+  wireless.server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  wireless.server.send(200, "text/plain", "");
+
+  // Convert the log file piece by piece, a damaged log file is sent up to the last complete log message
+  logger.convertLogFile(file, sendConvertedLogFileContent);
+
+  // End the chunked response
+  wireless.server.sendContent("");
+
+}
+
+// ================================================================================================
+// Send a piece of a converted log file
+// ================================================================================================
+void sendConvertedLogFileContent(const char *data, const size_t size) {
+
+  // Send the piece
+  wireless.server.sendContent(data, size);
+
+  // Let other tasks, like the logging task, run in between
+  yield();
+
+}
+
+// ================================================================================================
+// 
+// ================================================================================================
+void sendLogManifestData() {
+
+  // Keep the SD card mounted until the log manifest was sent
+  sdCard.lock();
+
+  // If the SD card is not mounted
+  if (!sdCard.getMountState()) {
+
+    // Return with a 500 - No SD Card Mounted!
+    wireless.server.send(500, "text/plain", "500 - No SD Card Mounted!");
+
+    sdCard.unlock();
+
+    return;
+
+  }
+
+  // Write the log buffer to the SD card, so the size of the current log file is up to date
+  logger.flush();
+
+  // Get the number of log file parts
+  uint32_t entries = logger.getManifestSize();
+
+  // The response is sent in chunks directly from the log manifest, the length is not known in advance
+  wireless.server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  wireless.server.send(200, "application/json", "");
+
+  // Chunk buffer
+  char   buffer[512];
+  size_t size = 0;
+
+  // Get the name of the current log file, empty if there is none
+  // The path is a copy, so it stays valid while the logging task moves on to the next log file part
+  String      logFilePath = logger.getLogFilePath();
+  const char *current     = strrchr(logFilePath.c_str(), '/');
+
+  // Add the message header
+  size += snprintf(buffer + size, sizeof(buffer) - size, "{\"type\":\"logManifest\",\"time\":%lu,\"data\":{\"current\":\"%s\",\"files\":[", millis(), current ? current + 1 : "");
+
+  // For every log file part, in the order they were started
+  for (uint32_t index = 0; index < entries; index++) {
+
+    // Get the log manifest entry
+    Logger::ManifestEntry entry;
+
+    if (!logger.getManifestEntry(index, entry)) { break; }
+
+    // Add the log file part
+    size += snprintf(buffer + size, sizeof(buffer) - size, "%s{\"file\":\"%s\",\"id\":%u,\"part\":%u,\"format\":\"%s\",\"size\":%" PRIu32 ",\"firstTime\":%" PRIu32 ",\"lastTime\":%" PRIu32 "}", (index > 0) ? "," : "", logger.getLogFileName(entry).c_str(), entry.id, entry.part, (entry.format == Logger::BINARY) ? "binary" : "json", entry.size, entry.firstTime, entry.lastTime);
+
+    // If the buffer is almost full, send it as a chunk
+    if (size >= sizeof(buffer) - 160) {
+
+      wireless.server.sendContent(buffer, size);
+
+      size = 0;
+
+    }
+
+  }
+
+  // Add the message footer and send the last chunk
+  size += snprintf(buffer + size, sizeof(buffer) - size, "]}}");
+
+  wireless.server.sendContent(buffer, size);
+
+  // End the chunked response
+  wireless.server.sendContent("");
+
+  sdCard.unlock();
+
+}
+
+// ================================================================================================
+// 
+// ================================================================================================
+void subscribeLiveStream() {
+
+  // Hand the connection over to the live stream, the response is sent from there
+  // The main loop is paused, so the subscribers don't change while a frame is sent to them
+  wireless.lock();
+  bool subscribed = liveStream.subscribe(wireless.server.client());
+  wireless.unlock();
+
+  // If there is no free subscriber slot
+  if (!subscribed) {
+
+    // Return with a 503 - Too Many Subscribers!
+    wireless.server.send(503, "text/plain", "503 - Too Many Subscribers!");
+
+  }
+
 }
 
 // ================================================================================================
@@ -1923,8 +2640,39 @@ void sendLogFileData() {
 // ================================================================================================
 void sendSystemInfoData() {
 
+  // JSON data buffer
+  char json[LOG_MESSAGE_MAXIMUM_SIZE_BYTES];
+
+  // Pause the main loop while collecting the data
+  wireless.lock();
+
+  // Construct the data string
+  size_t length = getSystemInfoMessage(millis(), json, sizeof(json));
+
+  // Let the main loop continue, the data is in the buffer
+  wireless.unlock();
+
+  // If the data didn't fit into the buffer, there is nothing to send
+  if (length == 0) {
+
+    wireless.server.send(500, "text/plain", "500 - Data Buffer Too Small!");
+
+    return;
+
+  }
+
+  // Send JSON data straight from the buffer
+  wireless.server.send_P(200, "application/json", json, length);
+
+}
+
+// ================================================================================================
+// Construct the system info data message in a buffer and return its length, 0 if it doesn't fit
+// ================================================================================================
+size_t getSystemInfoMessage(const uint32_t time, char *buffer, const size_t size) {
+
   // Get data
-  Logger::KeyValuePair data[16] = {
+  Logger::KeyValuePair data[20] = {
 
     {"uptime",                Logger::UINT64_T, {.uint64_v = millis()}                                     },
     {"heapSize",              Logger::UINT32_T, {.uint32_v = ESP.getHeapSize()}                            },
@@ -1941,18 +2689,280 @@ void sendSystemInfoData() {
     {"hotspot",               Logger::BOOL_T,   {.bool_v   = wireless.getHotspotState()}                   },
     {"wifi",                  Logger::BOOL_T,   {.bool_v   = wireless.getWiFiState()}                      },
     {"server",                Logger::BOOL_T,   {.bool_v   = wireless.getServerState()}                    },
-    {"firmware",              Logger::STRING_T, {.string_v = FIRMWARE_VERSION}                             }
+    {"firmware",              Logger::STRING_T, {.string_v = FIRMWARE_VERSION}                             },
+    {"droppedLogMessages",    Logger::UINT32_T, {.uint32_v = logger.getDroppedMessages()}                  },
+    {"sdCardOperations",      Logger::UINT32_T, {.uint32_v = sdCard.getOperationsPerSecond()}              },
+    {"streamSubscribers",     Logger::UINT8_T,  {.uint8_v  = liveStream.getSubscribers()}                  },
+    {"streamFrameMicros",     Logger::UINT32_T, {.uint32_v = liveStream.getFrameMicroseconds()}            }
 
   };
 
-  // JSON data string
-  String json;
-
   // Construct the data string
-  logger.getLogMessage("system", data, 16, json);
+  return logger.getLogMessage(time, "system", data, 20, buffer, size);
+
+}
+
+// ================================================================================================
+// 
+// ================================================================================================
+void sendSnapshotData() {
+
+  // Allocate the snapshot buffer in the PSRAM on the first request
+  if (SNAPSHOT_BUFFER == NULL) { SNAPSHOT_BUFFER = (char*)heap_caps_malloc(SNAPSHOT_BUFFER_SIZE_BYTES, MALLOC_CAP_SPIRAM); }
+
+  // If there is no snapshot buffer or no radiation history snapshot buffer
+  if (SNAPSHOT_BUFFER == NULL || !allocateRadiationHistorySnapshot()) {
+
+    // Return with a 503 - No Snapshot Buffer!
+    wireless.server.send(503, "text/plain", "503 - No Snapshot Buffer!");
+
+    return;
+
+  }
+
+  // Get the requested fields as ",<field>,<field>,", by default everything except the radiation history
+  String fields  = ",";
+         fields += wireless.server.hasArg("fields") ? wireless.server.arg("fields") : "geigerCounter,cosmicRayDetector,randomNumberGenerator,system";
+         fields += ",";
+
+  // Fields and the functions constructing their data messages
+  const char *names[4]                                           = {"geigerCounter",         "cosmicRayDetector",         "randomNumberGenerator",         "system"            };
+  size_t     (*messages[4])(const uint32_t, char*, const size_t) = {getGeigerCounterMessage, getCosmicRayDetectorMessage, getRandomNumberGeneratorMessage, getSystemInfoMessage};
+
+  // Length of the snapshot and the flag for checking if everything fit into the buffer
+  size_t length   = 0;
+  bool   complete = true;
+
+  // Pause the main loop for the whole snapshot, so all values are from the same point in time
+  // The pulses recorded by the tube ISRs are only collected in the main loop, so they can't change in between either
+  wireless.lock();
+
+  // Time of the snapshot, shared by all data messages
+  uint32_t time = millis();
+
+  // Add the message header
+  length += snprintf(SNAPSHOT_BUFFER, SNAPSHOT_BUFFER_SIZE_BYTES, "{\"type\":\"snapshot\",\"time\":%" PRIu32 ",\"data\":[", time);
+
+  // Flag for separating the data messages
+  bool first = true;
+
+  // For every requested field
+  for (uint8_t i = 0; i < 4 && complete; i++) {
+
+    if (fields.indexOf(String(",") + names[i] + ",") < 0) { continue; }
+
+    // Add a separator, if there is room left
+    if (!first && length + 1 < SNAPSHOT_BUFFER_SIZE_BYTES) { SNAPSHOT_BUFFER[length++] = ','; }
 
-  // Send JSON data
-  wireless.server.send(200, "application/json", json);
+    // Add the data message, exactly as its own endpoint would send it, 0 if it doesn't fit
+    size_t messageLength = messages[i](time, SNAPSHOT_BUFFER + length, SNAPSHOT_BUFFER_SIZE_BYTES - length);
+
+    complete  = (messageLength > 0);
+    length   += messageLength;
+    first     = false;
+
+  }
+
+  // For every requested radiation history resolution, like "radiationHistory.minutes"
+  for (uint8_t i = RadiationHistory::SECONDS; i <= RadiationHistory::DAYS && complete; i++) {
+
+    if (fields.indexOf(String(",radiationHistory.") + RADIATION_HISTORY_RESOLUTIONS[i] + ",") < 0) { continue; }
+
+    RadiationHistory::Resolution resolution = (RadiationHistory::Resolution)i;
+
+    // Copy the buckets, the main loop is paused for the whole snapshot anyway
+    copyRadiationHistory(resolution);
+
+    // Number of buckets to add
+    uint16_t age = geigerCounter.getHistory().getLength(resolution);
+
+    // Add a separator and the message header, if there is room left
+    length += snprintf(SNAPSHOT_BUFFER + length, SNAPSHOT_BUFFER_SIZE_BYTES - length, "%s", first ? "" : ",");
+
+    if (length < SNAPSHOT_BUFFER_SIZE_BYTES) { length += getRadiationHistoryHeader(time, resolution, SNAPSHOT_BUFFER + length, SNAPSHOT_BUFFER_SIZE_BYTES - length); }
+
+    // Add the buckets and the message footer, if there is room left
+    if (length < SNAPSHOT_BUFFER_SIZE_BYTES) { length += addRadiationHistoryBuckets(age, SNAPSHOT_BUFFER + length, SNAPSHOT_BUFFER_SIZE_BYTES - length); }
+
+    if (length < SNAPSHOT_BUFFER_SIZE_BYTES) { length += snprintf(SNAPSHOT_BUFFER + length, SNAPSHOT_BUFFER_SIZE_BYTES - length, "]}}"); }
+
+    complete = (age == 0 && length < SNAPSHOT_BUFFER_SIZE_BYTES);
+    first    = false;
+
+  }
+
+  // Let the main loop continue, the snapshot is in the buffer
+  wireless.unlock();
+
+  // Add the message footer
+  if (complete) { length += snprintf(SNAPSHOT_BUFFER + length, SNAPSHOT_BUFFER_SIZE_BYTES - length, "]}"); }
+
+  // If the snapshot didn't fit into the buffer
+  if (!complete || length >= SNAPSHOT_BUFFER_SIZE_BYTES) {
+
+    // Return with a 500 - Snapshot Buffer Too Small!
+    wireless.server.send(500, "text/plain", "500 - Snapshot Buffer Too Small!");
+
+    return;
+
+  }
+
+  // Send the snapshot straight from the buffer
+  wireless.server.send_P(200, "application/json", SNAPSHOT_BUFFER, length);
+
+}
+
+// ================================================================================================
+// 
+// ================================================================================================
+void sendMetrics() {
+
+  // Length of the rendered metrics
+  size_t length = 0;
+
+  // Pause the main loop while collecting the data
+  wireless.lock();
+
+  // Geiger counter
+  addMetricFamily(length, "gmt_geiger_counter_enabled", "gauge", "Whether the Geiger counter is enabled.");
+  addMetricSample(length, "gmt_geiger_counter_enabled", geigerCounter.getGeigerCounterState());
+
+  addMetricFamily(length, "gmt_counts", "counter", "Total number of counts.");
+  addMetricSample(length, "gmt_counts_total", geigerCounter.getCounts());
+
+  addMetricFamily(length, "gmt_tube_counts", "counter", "Number of counts per tube.");
+  addMetricSample(length, "gmt_tube_counts_total{tube=\"main\"}",     geigerCounter.getMainTubeCounts());
+  addMetricSample(length, "gmt_tube_counts_total{tube=\"follower\"}", geigerCounter.getFollowerTubeCounts());
+
+  addMetricFamily(length, "gmt_counts_per_minute", "gauge", "Counts per minute over the last 60 seconds.");
+  addMetricSample(length, "gmt_counts_per_minute", geigerCounter.getCountsPerMinute(60));
+
+  addMetricFamily(length, "gmt_corrected_counts_per_minute", "gauge", "Dead time corrected counts per minute over the last 60 seconds.");
+  addMetricSample(length, "gmt_corrected_counts_per_minute", geigerCounter.getCorrectedCountsPerMinute(60));
+
+  addMetricFamily(length, "gmt_microsieverts_per_hour", "gauge", "Dead time corrected equivalent dose rate over the last 60 seconds in microsieverts per hour.");
+  addMetricSample(length, "gmt_microsieverts_per_hour", geigerCounter.getCorrectedMicrosievertsPerHour(60));
+
+  addMetricFamily(length, "gmt_absorbed_microsieverts", "counter", "Total absorbed dose in microsieverts.");
+  addMetricSample(length, "gmt_absorbed_microsieverts_total", geigerCounter.getAbsorbedMicrosieverts());
+
+  addMetricFamily(length, "gmt_radiation_rating", "gauge", "Radiation rating, 0 is normal.");
+  addMetricSample(length, "gmt_radiation_rating", geigerCounter.getRadiationRating());
+
+  // Cosmic ray detector
+  addMetricFamily(length, "gmt_cosmic_ray_detector_enabled", "gauge", "Whether the cosmic ray detector is enabled.");
+  addMetricSample(length, "gmt_cosmic_ray_detector_enabled", cosmicRayDetector.getCosmicRayDetectorState());
+
+  addMetricFamily(length, "gmt_coincidence_events", "counter", "Total number of coincidence events.");
+  addMetricSample(length, "gmt_coincidence_events_total", cosmicRayDetector.getCoincidenceEventsTotal());
+
+  addMetricFamily(length, "gmt_coincidence_events_per_hour", "gauge", "Coincidence events per hour.");
+  addMetricSample(length, "gmt_coincidence_events_per_hour", cosmicRayDetector.getCoincidenceEventsPerHour());
+
+  // Random number generator
+  addMetricFamily(length, "gmt_random_number_generator_enabled", "gauge", "Whether the random number generator is enabled.");
+  addMetricSample(length, "gmt_random_number_generator_enabled", randomNumberGenerator.getState());
+
+  addMetricFamily(length, "gmt_random_number_generator_stale", "gauge", "Whether the random bit is stale.");
+  addMetricSample(length, "gmt_random_number_generator_stale", randomNumberGenerator.getStaleState());
+
+  // Main loop
+  addMetricFamily(length, "gmt_loop_duration_seconds", "summary", "Duration of the main loop iterations.");
+  addMetricSample(length, "gmt_loop_duration_seconds_sum",   LOOP_MICROSECONDS / 1000000.0);
+  addMetricSample(length, "gmt_loop_duration_seconds_count", LOOP_ITERATIONS);
+
+  addMetricFamily(length, "gmt_loop_peak_duration_seconds", "gauge", "Longest main loop iteration during the last peak interval.");
+  addMetricSample(length, "gmt_loop_peak_duration_seconds", LAST_LOOP_PEAK_MICROSECONDS / 1000000.0);
+
+  // Display
+  addMetricFamily(length, "gmt_display_frame_duration_seconds", "summary", "Time spent drawing frames and writing them to the display.");
+  addMetricSample(length, "gmt_display_frame_duration_seconds_sum",   touchscreen.getFrameMicroseconds() / 1000000.0);
+  addMetricSample(length, "gmt_display_frame_duration_seconds_count", touchscreen.getFrames());
+
+  addMetricFamily(length, "gmt_display_transferred_bytes", "counter", "Pixel data written to the display.");
+  addMetricSample(length, "gmt_display_transferred_bytes_total", touchscreen.getTransferredBytes());
+
+  // Storage and logging
+  addMetricFamily(length, "gmt_sd_card_mounted", "gauge", "Whether the SD card is mounted.");
+  addMetricSample(length, "gmt_sd_card_mounted", sdCard.getMountState());
+
+  addMetricFamily(length, "gmt_sd_card_mounts", "counter", "Number of times the SD card was mounted.");
+  addMetricSample(length, "gmt_sd_card_mounts_total", sdCard.getMounts());
+
+  addMetricFamily(length, "gmt_sd_card_operations_per_second", "gauge", "SD card operations during the last second.");
+  addMetricSample(length, "gmt_sd_card_operations_per_second", sdCard.getOperationsPerSecond());
+
+  addMetricFamily(length, "gmt_log_messages_dropped", "counter", "Log messages dropped because the log queue was full.");
+  addMetricSample(length, "gmt_log_messages_dropped_total", logger.getDroppedMessages());
+
+  addMetricFamily(length, "gmt_stream_subscribers", "gauge", "Number of live stream subscribers.");
+  addMetricSample(length, "gmt_stream_subscribers", liveStream.getSubscribers());
+
+  // Let the main loop continue, the rest doesn't depend on it
+  wireless.unlock();
+
+  // System
+  addMetricFamily(length, "gmt_uptime_seconds", "gauge", "Time since the system was started.");
+  addMetricSample(length, "gmt_uptime_seconds", esp_timer_get_time() / 1000000.0);
+
+  addMetricFamily(length, "gmt_heap_size_bytes", "gauge", "Size of the internal heap.");
+  addMetricSample(length, "gmt_heap_size_bytes", ESP.getHeapSize());
+
+  addMetricFamily(length, "gmt_heap_free_bytes", "gauge", "Free internal heap.");
+  addMetricSample(length, "gmt_heap_free_bytes", ESP.getFreeHeap());
+
+  addMetricFamily(length, "gmt_heap_minimum_free_bytes", "gauge", "Lowest free internal heap since the system was started.");
+  addMetricSample(length, "gmt_heap_minimum_free_bytes", ESP.getMinFreeHeap());
+
+  addMetricFamily(length, "gmt_heap_largest_block_bytes", "gauge", "Largest block that can be allocated from the internal heap.");
+  addMetricSample(length, "gmt_heap_largest_block_bytes", ESP.getMaxAllocHeap());
+
+  addMetricFamily(length, "gmt_psram_free_bytes", "gauge", "Free PSRAM.");
+  addMetricSample(length, "gmt_psram_free_bytes", ESP.getFreePsram());
+
+  // Firmware version as an info metric, the end of the metrics is marked with "# EOF"
+  addMetricFamily(length, "gmt_firmware", "info", "Firmware version.");
+  addMetricSample(length, "gmt_firmware_info{version=\"" FIRMWARE_VERSION "\"}", 1);
+
+  length += snprintf(METRICS_BUFFER + min(length, sizeof(METRICS_BUFFER)), sizeof(METRICS_BUFFER) - min(length, sizeof(METRICS_BUFFER)), "# EOF\n");
+
+  // If the metrics didn't fit into the buffer
+  if (length >= sizeof(METRICS_BUFFER)) {
+
+    // Return with a 500 - Metrics Buffer Too Small!
+    wireless.server.send(500, "text/plain", "500 - Metrics Buffer Too Small!");
+
+    return;
+
+  }
+
+  // Send the metrics straight from the buffer
+  wireless.server.send_P(200, "application/openmetrics-text; version=1.0.0; charset=utf-8", METRICS_BUFFER, length);
+
+}
+
+// ================================================================================================
+// Add the type and help line of a metric to the metrics buffer
+// ================================================================================================
+void addMetricFamily(size_t &length, const char *name, const char *type, const char *help) {
+
+  // Once the buffer is full, only the length keeps growing, so the overflow can be detected
+  size_t offset = min(length, sizeof(METRICS_BUFFER));
+
+  length += snprintf(METRICS_BUFFER + offset, sizeof(METRICS_BUFFER) - offset, "# TYPE %s %s\n# HELP %s %s\n", name, type, name, help);
+
+}
+
+// ================================================================================================
+// Add a sample of a metric to the metrics buffer
+// ================================================================================================
+void addMetricSample(size_t &length, const char *sample, const double value) {
+
+  // Once the buffer is full, only the length keeps growing, so the overflow can be detected
+  size_t offset = min(length, sizeof(METRICS_BUFFER));
+
+  // Integers up to 15 digits, like the counts, are written exactly
+  length += snprintf(METRICS_BUFFER + offset, sizeof(METRICS_BUFFER) - offset, "%s %.15g\n", sample, value);
 
 }
 
@@ -1964,10 +2974,8 @@ void sendRestartAcknowledgement() {
   // Reply with a success message
   wireless.server.send(200, "application/json", "{\"success\":true}");
 
-  // Update the wireless interface
-  wireless.update();
-
-  // Restart the system
+  // Restart the system, pausing the main loop, so nothing else is written in the meantime
+  wireless.lock();
   restart();
 
 }
@@ -1991,6 +2999,12 @@ void restart() {
   // Log event message
   logger.log(Logger::EVENT, "event", event, 2);
 
+  // Save the total counts and the radiation history before restarting
+  geigerCounter.save();
+
+  // Write the log buffer to the SD card
+  logger.close();
+
   // Delay restart for 100 ms
   delay(100);
 
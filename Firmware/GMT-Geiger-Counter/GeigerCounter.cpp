@@ -37,8 +37,111 @@ void GeigerCounter::begin() {
     _mainTube.begin();
     _followerTube.begin();
 
+    // If the journal is enabled in the main configuration file, restore the state from before the last restart
+    #if ENABLE_JOURNAL == 1
+      journal.begin();
+      _restore();
+    #endif
+
+  }
+
+}
+
+// ================================================================================================
+// Update the Geiger counter
+// ================================================================================================
+void GeigerCounter::update() {
+
+  // Get a consistent set of the number of advances, the current second's index and the time it started
+  // If the timer ISR advanced the index in between, read them again
+  uint32_t ticks;
+  uint8_t  index;
+  uint32_t tickMicroseconds;
+
+  do {
+
+    ticks            = _movingAverageTicks;
+    index            = _movingAverageIndex;
+    tickMicroseconds = _movingAverageTickMicroseconds;
+
+  } while (ticks != _movingAverageTicks);
+
+  // Number of seconds that passed since the last update
+  uint32_t elapsedSeconds = ticks - _runningSumTicks;
+
+  // Number of seconds that were completed since the last update
+  // The running sum array only holds 60 seconds, so at most the latest 59 completed seconds can be kept next to the current one
+  uint8_t completedSeconds = min(elapsedSeconds, (uint32_t)59);
+
+  // Remember the number of advances the running sum array has caught up with
+  _runningSumTicks = ticks;
+
+  // If the main loop was stalled for 60 seconds or more, the index went around the array at least once
+  if (elapsedSeconds > completedSeconds) {
+
+    // Every second in the array starts over at the current running sum
+    // The pulses recorded meanwhile are still assigned to their seconds by their timestamps, the ones older than the array only go into the total counts
+    for (uint8_t i = 0; i < 60; i++) { _runningSumStart[i] = _runningSum; }
+
+    // Continue at the current second
+    _runningSumIndex = index;
+
+  } else {
+
+    // For every second the timer ISR has started since the last update
+    for (uint8_t second = 0; second < completedSeconds; second++) {
+
+      // Set the index to the next second
+      _runningSumIndex = (_runningSumIndex + 1) % 60;
+
+      // The next second starts at the current running sum
+      _runningSumStart[_runningSumIndex] = _runningSum;
+
+    }
+
+  }
+
+  // Remember the time the current second started
+  _runningSumTickMicroseconds = tickMicroseconds;
+
+  // Move the pulses recorded by the tube ISRs into the running sum and the total counts
+  _mainTube.update();
+  _followerTube.update();
+
+  // For every completed second, starting with the oldest
+  // This happens after the tube pulses were collected, so pulses that belong to the completed seconds are included
+  for (uint8_t second = completedSeconds; second > 0; second--) {
+
+    // Get the index of the completed second and the second after it
+    uint8_t completedIndex = (_runningSumIndex + 60 - second) % 60;
+    uint8_t nextIndex      = (completedIndex + 1) % 60;
+
+    // Get the counts of the completed second
+    uint32_t counts = _runningSumStart[nextIndex] - _runningSumStart[completedIndex];
+
+    // Add the counts to the rate estimator
+    _estimator.add(counts);
+
+    // Add the counts as a counts per minute value to the radiation history
+    _history.add(counts * 60);
+
   }
 
+  // If the journal is enabled in the main configuration file
+  #if ENABLE_JOURNAL == 1
+
+    // Increase the journal timers by the seconds that passed
+    _journalCountsTimerSeconds  += elapsedSeconds;
+    _journalHistoryTimerSeconds += elapsedSeconds;
+
+    // If it is time for a checkpoint of the total counts, write them to the journal
+    if (_journalCountsTimerSeconds >= JOURNAL_COUNTS_INTERVAL_SECONDS) { _saveCounts(); }
+
+    // If it is time for a checkpoint of the radiation history, write it to the journal
+    if (_journalHistoryTimerSeconds >= JOURNAL_HISTORY_INTERVAL_SECONDS) { _saveHistory(); }
+
+  #endif
+
 }
 
 // ================================================================================================
@@ -49,18 +152,26 @@ void GeigerCounter::enable() {
   // If not enabled
   if (!_enabled) {
 
-    // Clear the moving average array
-    for (uint8_t i = 0; i < 60; i++) { _movingAverage[i] = 0; }
-
-    // Set all elements in the radiation history array to an impossibly high value marking them as cleared
-    for (uint8_t sample = 0; sample < RADIATION_HISTORY_LENGTH_MINUTES; sample++) { _history[sample] = UINT32_MAX; }
+    // Clear the running sum array
+    for (uint8_t i = 0; i < 60; i++) { _runningSumStart[i] = 0; }
 
     // Reset variables
-    _movingAverageIndex   = 0;
-    _autoIntegrationTimer = 0;
-    _metricPrefix         = METRIC_MICRO;
-    _historyIndex         = 0;
-    _historyTimerSeconds  = 0;
+    _movingAverageIndex            = 0;
+    _movingAverageTickMicroseconds = micros();
+    _movingAverageTicks            = 0;
+    _runningSum                    = 0;
+    _runningSumIndex               = 0;
+    _runningSumTicks               = 0;
+    _runningSumTickMicroseconds    = _movingAverageTickMicroseconds;
+    _autoIntegrationTimer          = 0;
+    _metricPrefix                  = METRIC_MICRO;
+
+    // Forget the count rate estimated before
+    _estimator.clear();
+
+    // If the Geiger counter was disabled before, nothing was recorded in the meantime
+    // Add that time to the radiation history as a gap, so the buckets after it stay at the right time
+    if (_disableTimeMilliseconds != 0) { _history.addGap((millis() - _disableTimeMilliseconds + 500) / 1000); }
 
     // If main tube is enabled in the main configuration file, enable pulse counting
     #if ENABLE_MAIN_TUBE == 1
@@ -75,8 +186,8 @@ void GeigerCounter::enable() {
     // Set hardware timer frequency to 1Mhz
     _movingAverageTimer = timerBegin(1000000);
 
-    // Attach the update ISR to the hardware timer and pass the class instance pointer to it
-    timerAttachInterruptArg(_movingAverageTimer, _update, this);
+    // Attach the moving average ISR to the hardware timer and pass the class instance pointer to it
+    timerAttachInterruptArg(_movingAverageTimer, _advanceMovingAverage, this);
 
     // Set alarm to call the ISR function, every second, repeat, forever
     timerAlarm(_movingAverageTimer, 1000000, true, 0);
@@ -117,6 +228,9 @@ void GeigerCounter::disable() {
       _followerTube.disable();
     #endif
 
+    // Collect the pulses that were recorded before the tubes were disabled
+    update();
+
     // Detach the ISR from the hardware timer
     timerDetachInterrupt(_movingAverageTimer);
 
@@ -126,18 +240,25 @@ void GeigerCounter::disable() {
     // Clear the hardware timer
     _movingAverageTimer = NULL;
 
-    // Clear the moving average array
-    for (uint8_t i = 0; i < 60; i++) { _movingAverage[i] = 0; }
-
-    // Set all elements in the radiation history array to an impossibly high value marking them as cleared
-    for (uint8_t sample = 0; sample < RADIATION_HISTORY_LENGTH_MINUTES; sample++) { _history[sample] = UINT32_MAX; }
+    // Clear the running sum array
+    for (uint8_t i = 0; i < 60; i++) { _runningSumStart[i] = 0; }
 
     // Reset variables
-    _movingAverageIndex   = 0;
-    _autoIntegrationTimer = 0;
-    _metricPrefix         = METRIC_MICRO;
-    _historyIndex         = 0;
-    _historyTimerSeconds  = 0;
+    _movingAverageIndex            = 0;
+    _movingAverageTickMicroseconds = 0;
+    _movingAverageTicks            = 0;
+    _runningSum                    = 0;
+    _runningSumIndex               = 0;
+    _runningSumTicks               = 0;
+    _runningSumTickMicroseconds    = 0;
+    _autoIntegrationTimer          = 0;
+    _metricPrefix                  = METRIC_MICRO;
+
+    // Forget the count rate estimated before
+    _estimator.clear();
+
+    // Remember when the Geiger counter was disabled, the time until it is enabled again is a gap in the radiation history
+    _disableTimeMilliseconds = max(millis(), (unsigned long)1);
 
     // Set the enabled flag to false
     _enabled = false;
@@ -157,6 +278,25 @@ void GeigerCounter::disable() {
 
 }
 
+// ================================================================================================
+// Save the total counts and the radiation history to the journal
+// ================================================================================================
+void GeigerCounter::save() {
+
+  // If the journal is enabled in the main configuration file
+  #if ENABLE_JOURNAL == 1
+
+    // Collect the latest pulses first
+    update();
+
+    // Write everything to the journal
+    _saveCounts();
+    _saveHistory();
+
+  #endif
+
+}
+
 // ================================================================================================
 // Set the Geiger counter state
 // ================================================================================================
@@ -308,26 +448,15 @@ uint64_t GeigerCounter::getFollowerTubeCounts() {
 // ================================================================================================
 double GeigerCounter::getCountsPerMinute(const uint8_t timeSeconds) {
 
-  // CPM variable
-  double cpm = 0.0;
+  // Get the index of the oldest second in the integration time, if it underflows wrap to the end of the array
+  uint8_t oldestIndex = (_runningSumIndex + 60 - (timeSeconds - 1)) % 60;
 
-  // For the number of seconds in the integration time
-  // This will select the number of elements from the moving average array to sum up an average over
-  for (uint8_t i = 0; i < timeSeconds; i++) {
+  // The counts in the integration time are the running sum minus the running sum at the start of the oldest second
+  // The running sum is allowed to wrap around, the difference is still correct
+  uint32_t counts = _runningSum - _runningSumStart[oldestIndex];
 
-    // Calculate a wrapped index by using i + 60 - 1, if it underflows wrapped to the end of the array
-    uint8_t wrappedIndex = (_movingAverageIndex + 60 - i) % 60;
-
-    // Add the count value of that element to the CPM variable
-    cpm += _movingAverage[wrappedIndex];
-
-  }
-
-  // Divide the CPM value by the integration time and multiply by 60 to get the actual value for 60 seconds
-  cpm = (cpm / timeSeconds) * 60.0;
-
-  // Return the counts per minute
-  return cpm;
+  // Divide the counts by the integration time and multiply by 60 to get the actual value for 60 seconds
+  return ((double)counts / timeSeconds) * 60.0;
 
 }
 
@@ -339,39 +468,53 @@ double GeigerCounter::getCountsPerMinute() {
   // If automatically adjusting the integration time is enabled
   if (_autoIntegrate) {
 
-    // If at least one second has passed since the last adjustment
-    if (millis() - _autoIntegrationTimer >= 1000) {
+    // If the Kalman estimator is selected in the main configuration file
+    #if INTEGRATION_TIME_ESTIMATOR == 1
 
-      // Get the ratio between a shortterm and longterm counts per minute readings
-      float ratio = getCountsPerMinute(10) / getCountsPerMinute(60);
+      // Show the integration time the estimate is currently equivalent to
+      _integrationTimeSeconds = _estimator.getIntegrationTime();
 
-      // Set the default integration time as a target
-      uint8_t target = INTEGRATION_TIME_AUTO_AVERAGE_SECONDS;
+      // Return the estimated count rate as a counts per minute value
+      return _estimator.getCountsPerSecond() * 60.0;
 
-      // Depending on the ration between the short and longterm counts per minute value
-      // Set the target integration time to its minimum or its maximum
-      if      (ratio > INTEGRATION_TIME_AUTO_UPPER_BOUND) { target = INTEGRATION_TIME_AUTO_MINIMUM_SECONDS; }
-      else if (ratio < INTEGRATION_TIME_AUTO_LOWER_BOUND) { target = INTEGRATION_TIME_AUTO_MAXIMUM_SECONDS; }
-      else                                                { target = INTEGRATION_TIME_AUTO_AVERAGE_SECONDS; }
+    // Otherwise adjust the integration time step-wise
+    #else
 
-      // Get the current integration time
-      uint8_t integrationTime = getIntegrationTime();
+      // If at least one second has passed since the last adjustment
+      if (millis() - _autoIntegrationTimer >= 1000) {
 
-      // Increase or decrease the current integration time by the step size to reach the target
-      if      (integrationTime < target) { integrationTime += INTEGRATION_TIME_STEP_SIZE_SECONDS; }
-      else if (integrationTime > target) { integrationTime -= INTEGRATION_TIME_STEP_SIZE_SECONDS; }
+        // Get the ratio between a shortterm and longterm counts per minute readings
+        float ratio = getCountsPerMinute(10) / getCountsPerMinute(60);
 
-      // Clip the integration time to the minimum or maximum if necessary
-      if      (integrationTime < INTEGRATION_TIME_AUTO_MINIMUM_SECONDS) { integrationTime = INTEGRATION_TIME_AUTO_MINIMUM_SECONDS; }
-      else if (integrationTime > INTEGRATION_TIME_AUTO_MAXIMUM_SECONDS) { integrationTime = INTEGRATION_TIME_AUTO_MAXIMUM_SECONDS; }
+        // Set the default integration time as a target
+        uint8_t target = INTEGRATION_TIME_AUTO_AVERAGE_SECONDS;
 
-      // Set the new integration time
-      setIntegrationTime(integrationTime);
+        // Depending on the ration between the short and longterm counts per minute value
+        // Set the target integration time to its minimum or its maximum
+        if      (ratio > INTEGRATION_TIME_AUTO_UPPER_BOUND) { target = INTEGRATION_TIME_AUTO_MINIMUM_SECONDS; }
+        else if (ratio < INTEGRATION_TIME_AUTO_LOWER_BOUND) { target = INTEGRATION_TIME_AUTO_MAXIMUM_SECONDS; }
+        else                                                { target = INTEGRATION_TIME_AUTO_AVERAGE_SECONDS; }
 
-      // Update the timer
-      _autoIntegrationTimer = millis();
+        // Get the current integration time
+        uint8_t integrationTime = getIntegrationTime();
 
-    }
+        // Increase or decrease the current integration time by the step size to reach the target
+        if      (integrationTime < target) { integrationTime += INTEGRATION_TIME_STEP_SIZE_SECONDS; }
+        else if (integrationTime > target) { integrationTime -= INTEGRATION_TIME_STEP_SIZE_SECONDS; }
+
+        // Clip the integration time to the minimum or maximum if necessary
+        if      (integrationTime < INTEGRATION_TIME_AUTO_MINIMUM_SECONDS) { integrationTime = INTEGRATION_TIME_AUTO_MINIMUM_SECONDS; }
+        else if (integrationTime > INTEGRATION_TIME_AUTO_MAXIMUM_SECONDS) { integrationTime = INTEGRATION_TIME_AUTO_MAXIMUM_SECONDS; }
+
+        // Set the new integration time
+        setIntegrationTime(integrationTime);
+
+        // Update the timer
+        _autoIntegrationTimer = millis();
+
+      }
+
+    #endif
 
   }
 
@@ -380,6 +523,34 @@ double GeigerCounter::getCountsPerMinute() {
 
 }
 
+// ================================================================================================
+// Get the half width of the 95% confidence interval of the counts per minute for a fixed integration time
+// ================================================================================================
+double GeigerCounter::getCountsPerMinuteConfidence(const uint8_t timeSeconds) {
+
+  // Get the number of counts in the integration time
+  double counts = getCountsPerMinute(timeSeconds) * timeSeconds / 60.0;
+
+  // The counts are Poisson distributed, so their standard deviation is the square root of their number
+  return 1.96 * sqrt(counts) / timeSeconds * 60.0;
+
+}
+
+// ================================================================================================
+// Get the half width of the 95% confidence interval of the counts per minute
+// ================================================================================================
+double GeigerCounter::getCountsPerMinuteConfidence() {
+
+  // If the Kalman estimator is selected in the main configuration file and automatically adjusting the integration time is enabled
+  #if INTEGRATION_TIME_ESTIMATOR == 1
+    if (_autoIntegrate) { return _estimator.getConfidenceCountsPerSecond() * 60.0; }
+  #endif
+
+  // Get the confidence interval for the currently set integration time
+  return getCountsPerMinuteConfidence(getIntegrationTime());
+
+}
+
 // ================================================================================================
 // Get microsieverts per hour for a fixed integration time
 // ================================================================================================
@@ -400,6 +571,44 @@ double GeigerCounter::getMicrosievertsPerHour() {
 
 }
 
+// ================================================================================================
+// Get the dead time corrected counts per minute for a fixed integration time
+// ================================================================================================
+double GeigerCounter::getCorrectedCountsPerMinute(const uint8_t timeSeconds) {
+
+  return _correctDeadTime(getCountsPerMinute(timeSeconds));
+
+}
+
+// ================================================================================================
+// Get the dead time corrected counts per minute
+// ================================================================================================
+double GeigerCounter::getCorrectedCountsPerMinute() {
+
+  return _correctDeadTime(getCountsPerMinute());
+
+}
+
+// ================================================================================================
+// Get the dead time corrected microsieverts per hour for a fixed integration time
+// ================================================================================================
+double GeigerCounter::getCorrectedMicrosievertsPerHour(const uint8_t timeSeconds) {
+
+  // Multiply the corrected CPM by the conversion factor and divide by the number of tubes
+  return (getCorrectedCountsPerMinute(timeSeconds) * TUBE_CONVERSION_FACTOR_CPM_TO_USVH) / TOTAL_NUMBER_OF_TUBES;
+
+}
+
+// ================================================================================================
+// Get the dead time corrected microsieverts per hour
+// ================================================================================================
+double GeigerCounter::getCorrectedMicrosievertsPerHour() {
+
+  // Multiply the corrected CPM by the conversion factor and divide by the number of tubes
+  return (getCorrectedCountsPerMinute() * TUBE_CONVERSION_FACTOR_CPM_TO_USVH) / TOTAL_NUMBER_OF_TUBES;
+
+}
+
 // ================================================================================================
 // Get the equivalent dose in the selected measurement unit
 // ================================================================================================
@@ -413,10 +622,10 @@ double GeigerCounter::getEquivalentDose() {
   // Store the resulting value in the equivalent dose variable
   switch (_measurementUnit) {
 
-    case SIEVERTS: equivalentDose = getMicrosievertsPerHour();         break;
-    case REM:      equivalentDose = getMicrosievertsPerHour() * 100.0; break;
-    case RONTGEN:  equivalentDose = getMicrosievertsPerHour() * 100.0; break;
-    case GRAY:     equivalentDose = getMicrosievertsPerHour();         break;
+    case SIEVERTS: equivalentDose = getCorrectedMicrosievertsPerHour();         break;
+    case REM:      equivalentDose = getCorrectedMicrosievertsPerHour() * 100.0; break;
+    case RONTGEN:  equivalentDose = getCorrectedMicrosievertsPerHour() * 100.0; break;
+    case GRAY:     equivalentDose = getCorrectedMicrosievertsPerHour();         break;
 
   }
 
@@ -549,8 +758,8 @@ GeigerCounter::EquivalentDoseUnit GeigerCounter::getEquivalentDoseUnit() {
 // ================================================================================================
 GeigerCounter::RadiationRating GeigerCounter::getRadiationRating() {
 
-  // Get microsieverts per hour measurement
-  double microsievertsPerHours = getMicrosievertsPerHour();
+  // Get the dead time corrected microsieverts per hour measurement
+  double microsievertsPerHours = getCorrectedMicrosievertsPerHour();
 
   RadiationRating rating = RATING_NORMAL;
 
@@ -586,23 +795,14 @@ GeigerCounter::RadiationRating GeigerCounter::getRadiationRating() {
 }
 
 // ================================================================================================
-// Get a pointer to the radiation history array
+// Get the radiation history
 // ================================================================================================
-uint32_t* GeigerCounter::getHistory() {
+RadiationHistory& GeigerCounter::getHistory() {
 
   return _history;
 
 }
 
-// ================================================================================================
-// Get the index of the radiation history array
-// ================================================================================================
-uint8_t GeigerCounter::getHistoryIndex() {
-
-  return _historyIndex;
-
-}
-
 // ------------------------------------------------------------------------------------------------
 // Private
 
@@ -614,53 +814,195 @@ GeigerCounter::GeigerCounter():
   // Initialize members
   _initialized(false),
   _movingAverageIndex(0),
+  _movingAverageTickMicroseconds(0),
+  _movingAverageTicks(0),
+  _runningSum(0),
+  _runningSumIndex(0),
+  _runningSumTicks(0),
+  _runningSumTickMicroseconds(0),
   _movingAverageTimer(NULL),
-  _mainTube(MAIN_TRG_PIN, _movingAverage, _movingAverageIndex),
-  _followerTube(FOLLOWER_TRG_PIN, _movingAverage, _movingAverageIndex),
+  _mainTube(MAIN_TRG_PIN, PulseCapture::MAIN_TUBE, _runningSum, _runningSumStart, _runningSumIndex, _runningSumTickMicroseconds),
+  _followerTube(FOLLOWER_TRG_PIN, PulseCapture::FOLLOWER_TUBE, _runningSum, _runningSumStart, _runningSumIndex, _runningSumTickMicroseconds),
   _enabled(false),
+  _disableTimeMilliseconds(0),
   _integrationTimeSeconds(INTEGRATION_TIME_AUTO_AVERAGE_SECONDS),
   _autoIntegrate(true),
   _autoIntegrationTimer(0),
   _autoRange(true),
   _measurementUnit(SIEVERTS),
   _metricPrefix(METRIC_MICRO),
-  _historyIndex(0),
-  _historyTimerSeconds(0)
+  _journalCountsTimerSeconds(0),
+  _journalHistoryTimerSeconds(0)
 
 {}
 
 // ================================================================================================
-// Interrupt service routine for updating the Geiger counter
+// Correct a counts per minute value for the dead time of the tubes
 // ================================================================================================
-void IRAM_ATTR GeigerCounter::_update(void *instancePointer) {
+double GeigerCounter::_correctDeadTime(const double countsPerMinute) {
 
-  // Cast the generic instance pointer back to a instance pointer of type GeigerCounter 
-  GeigerCounter *instance = (GeigerCounter*)instancePointer;
+  // If no dead time correction is selected, the recorded value is the true value
+  #if TUBE_DEAD_TIME_MODEL == 0
 
-  // Calculate a wrapped index by using the current index + 1, if it overflows wrapped to the start of the array
-  uint8_t wrappedIndex = (instance->_movingAverageIndex + 1) % 60;
+    return countsPerMinute;
 
-  // Clear the next element in the array
-  instance->_movingAverage[wrappedIndex] = 0;
+  #else
 
-  // Set the moving index to the next element in the array
-  instance->_movingAverageIndex = wrappedIndex;
+    // Dead time of a single tube in seconds
+    const double deadTime = TUBE_DEAD_TIME_MICROSECONDS / 1000000.0;
 
-  // Increase the history timer by 1 second
-  instance->_historyTimerSeconds++;
+    // The tubes are split evenly across the pin headers, so each tube only sees its share of the recorded counts
+    // Get the recorded count rate of a single tube in counts per second
+    double recordedRate = countsPerMinute / 60.0 / TOTAL_NUMBER_OF_TUBES;
 
-  // If one minute on the history timer has passed
-  if (instance->_historyTimerSeconds >= 60) {
+    // True count rate variable
+    double trueRate = recordedRate;
 
-    // Set the element to the current counts per minute value
-    instance->_history[instance->_historyIndex] = instance->getCountsPerMinute(60);
+    // Non-paralyzable model: m = n / (1 + n * t) solved for n
+    #if TUBE_DEAD_TIME_MODEL == 1
+
+      // If the recorded rate reaches the limit of 1 / dead time, the tube is saturated and the true rate can't be determined
+      // Clip the correction to 1000x so a saturated tube still reports a very high value instead of infinity
+      double busyFraction = recordedRate * deadTime;
+
+      if (busyFraction >= 0.999) { busyFraction = 0.999; }
+
+      trueRate = recordedRate / (1.0 - busyFraction);
+
+    // Paralyzable model: m = n * e^(-n * t), solved for n with Newton's method
+    #elif TUBE_DEAD_TIME_MODEL == 2
+
+      // The recorded rate can't exceed 1 / (e * dead time), at that point the true rate is 1 / dead time
+      if (recordedRate >= 1.0 / (M_E * deadTime)) {
+
+        trueRate = 1.0 / deadTime;
+
+      } else {
+
+        // Starting below the solution, Newton's method converges to the lower (physical) solution
+        for (uint8_t i = 0; i < 20; i++) {
+
+          // Function value and derivative at the current estimate
+          double decay      = exp(-trueRate * deadTime);
+          double value      = trueRate * decay - recordedRate;
+          double derivative = decay * (1.0 - trueRate * deadTime);
+
+          // Take a Newton step
+          double step = value / derivative;
+          trueRate   -= step;
+
+          // Stop once the estimate has converged to a fraction of a count per second
+          if (fabs(step) < 0.001) { break; }
+
+        }
+
+      }
+
+    #endif
+
+    // Convert the true rate back to counts per minute of all tubes
+    return trueRate * 60.0 * TOTAL_NUMBER_OF_TUBES;
+
+  #endif
+
+}
+
+// ================================================================================================
+// Write the total counts to the journal
+// ================================================================================================
+void GeigerCounter::_saveCounts() {
 
-    // Set the history index to the next element in the array
-    instance->_historyIndex = (instance->_historyIndex + 1) % RADIATION_HISTORY_LENGTH_MINUTES;
+  // Get the total counts of both tubes
+  CountsRecord record = {_mainTube.getCounts(), _followerTube.getCounts()};
 
-    // Reset the history timer
-    instance->_historyTimerSeconds = 0;
+  // Append them to the journal
+  journal.write(Journal::COUNTS, &record, sizeof(CountsRecord));
+
+  // Reset the timer
+  _journalCountsTimerSeconds = 0;
+
+}
+
+// ================================================================================================
+// Write the radiation history to the journal
+// ================================================================================================
+void GeigerCounter::_saveHistory() {
+
+  // Append the complete history archive to the journal
+  journal.write(Journal::HISTORY, &_history.getArchive(), sizeof(RadiationHistory::Archive));
+
+  // Reset the timer
+  _journalHistoryTimerSeconds = 0;
+
+}
+
+// ================================================================================================
+// Restore the total counts and the radiation history from the journal
+// ================================================================================================
+void GeigerCounter::_restore() {
+
+  // Total counts record
+  CountsRecord record;
+
+  // Flags for checking what was restored
+  bool counts  = false;
+  bool history = false;
+
+  // If the total counts were found in the journal, restore them
+  if (journal.read(Journal::COUNTS, &record, sizeof(CountsRecord))) {
+
+    _mainTube.setCounts(record.mainTubeCounts);
+    _followerTube.setCounts(record.followerTubeCounts);
+
+    counts = true;
 
   }
 
+  // If the radiation history was found in the journal and is consistent, keep it
+  // It is read directly into the archive to avoid another copy of the history, so an invalid archive has to be cleared again
+  if (journal.read(Journal::HISTORY, &_history.getArchive(), sizeof(RadiationHistory::Archive)) && _history.isValid()) {
+
+    history = true;
+
+  } else {
+
+    _history.clear();
+
+  }
+
+  // Create event data
+  Logger::KeyValuePair event[4] = {
+
+    {"source",  Logger::STRING_T, {.string_v = "journal"} },
+    {"action",  Logger::STRING_T, {.string_v = "restored"}},
+    {"counts",  Logger::BOOL_T,   {.bool_v   = counts}    },
+    {"history", Logger::BOOL_T,   {.bool_v   = history}   }
+
+  };
+
+  // Log event message
+  logger.log(Logger::EVENT, "event", event, 4);
+
+}
+
+// ================================================================================================
+// Interrupt service routine for advancing the moving average
+// ================================================================================================
+void IRAM_ATTR GeigerCounter::_advanceMovingAverage(void *instancePointer) {
+
+  // Cast the generic instance pointer back to a instance pointer of type GeigerCounter 
+  GeigerCounter *instance = (GeigerCounter*)instancePointer;
+
+  // Calculate a wrapped index by using the current index + 1, if it overflows wrapped to the start of the array
+  uint8_t wrappedIndex = (instance->_movingAverageIndex + 1) % 60;
+
+  // Remember when the index was advanced, so pulses recorded before that can still be assigned to the previous second
+  instance->_movingAverageTickMicroseconds = micros();
+
+  // Set the moving index to the next element in the array
+  instance->_movingAverageIndex = wrappedIndex;
+
+  // Count the advance last, the main loop reads it to detect an advance while reading the index and the time
+  instance->_movingAverageTicks = instance->_movingAverageTicks + 1;
+
 }
\ No newline at end of file
@@ -5,6 +5,9 @@
 #include "Configuration.h"
 #include "Logger.h"
 #include "Tube.h"
+#include "RadiationHistory.h"
+#include "RateEstimator.h"
+#include "Journal.h"
 
 class GeigerCounter {
 
@@ -55,34 +58,41 @@ class GeigerCounter {
     // Get the single instance of the class
     static GeigerCounter& getInstance();
 
-    void               begin();                                            // Initialize everything
-    void               enable();                                           // Enable the Geiger counter
-    void               disable();                                          // Disable the Geiger counter
-    void               setGeigerCounterState(const bool state);            // Set the Geiger counter state
-    void               setIntegrationTime(const uint8_t timeSeconds);      // Set the integration time
-    void               setAutoIntegrateState(const bool state);            // Set the state of the automatic integration time adjustment
-    void               setAutoRangeState(const bool state);                // Set if the equivalent dose should auto range
-    void               setMeasurementUnit(const MeasurementUnit unit);     // Set the measurement unit of the equivalent dose
-    bool               getGeigerCounterState();                            // Get the Geiger counter state
-    uint8_t            getIntegrationTime();                               // Get the set integration time
-    bool               getAutoIntegrateState();                            // Get the state of the automatic integration time adjustment
-    bool               getAutoRangeState();                                // Get the auto ranging state
-    MeasurementUnit    getMeasurementUnit();                               // Get the measurement unit
-    uint64_t           getCounts();                                        // Get the total number of counts
-    uint64_t           getMainTubeCounts();                                // Get the number of counts the main tube has recorded
-    uint64_t           getFollowerTubeCounts();                            // Get the number of counts the follower tube has recorded
-    double             getCountsPerMinute(const uint8_t timeSeconds);      // Get the counts per minute for a fixed integration time
-    double             getCountsPerMinute();                               // Get the counts per minute
-    double             getMicrosievertsPerHour(const uint8_t timeSeconds); // Get microsieverts per hour for a fixed integration time
-    double             getMicrosievertsPerHour();                          // Get microsieverts per hour
-    double             getEquivalentDose();                                // Get the equivalent dose in the selected measurement unit
-    double             getAbsorbedMicrosieverts();                         // Get the total absorbed dose in microsieverts
-    double             getMainAbsorbedMicrosieverts();                     // Get the total absorbed dose for the main tube in microsieverts
-    double             getFollowerAbsorbedMicrosieverts();                 // Get the total absorbed dose for the follower tube in microsieverts
-    EquivalentDoseUnit getEquivalentDoseUnit();                            // Get the equivalent dose unit
-    RadiationRating    getRadiationRating();                               // Get the radiation rating
-    uint32_t*          getHistory();                                       // Get a pointer to the radiation history array
-    uint8_t            getHistoryIndex();                                  // Get the index of the radiation history array
+    void               begin();                                                     // Initialize everything
+    void               update();                                                    // Update the Geiger counter
+    void               enable();                                                    // Enable the Geiger counter
+    void               disable();                                                   // Disable the Geiger counter
+    void               save();                                                      // Save the total counts and the radiation history to the journal
+    void               setGeigerCounterState(const bool state);                     // Set the Geiger counter state
+    void               setIntegrationTime(const uint8_t timeSeconds);               // Set the integration time
+    void               setAutoIntegrateState(const bool state);                     // Set the state of the automatic integration time adjustment
+    void               setAutoRangeState(const bool state);                         // Set if the equivalent dose should auto range
+    void               setMeasurementUnit(const MeasurementUnit unit);              // Set the measurement unit of the equivalent dose
+    bool               getGeigerCounterState();                                     // Get the Geiger counter state
+    uint8_t            getIntegrationTime();                                        // Get the set integration time
+    bool               getAutoIntegrateState();                                     // Get the state of the automatic integration time adjustment
+    bool               getAutoRangeState();                                         // Get the auto ranging state
+    MeasurementUnit    getMeasurementUnit();                                        // Get the measurement unit
+    uint64_t           getCounts();                                                 // Get the total number of counts
+    uint64_t           getMainTubeCounts();                                         // Get the number of counts the main tube has recorded
+    uint64_t           getFollowerTubeCounts();                                     // Get the number of counts the follower tube has recorded
+    double             getCountsPerMinute(const uint8_t timeSeconds);               // Get the counts per minute for a fixed integration time
+    double             getCountsPerMinute();                                        // Get the counts per minute
+    double             getCountsPerMinuteConfidence(const uint8_t timeSeconds);     // Get the half width of the 95% confidence interval of the counts per minute for a fixed integration time
+    double             getCountsPerMinuteConfidence();                              // Get the half width of the 95% confidence interval of the counts per minute
+    double             getMicrosievertsPerHour(const uint8_t timeSeconds);          // Get microsieverts per hour for a fixed integration time
+    double             getMicrosievertsPerHour();                                   // Get microsieverts per hour
+    double             getCorrectedCountsPerMinute(const uint8_t timeSeconds);      // Get the dead time corrected counts per minute for a fixed integration time
+    double             getCorrectedCountsPerMinute();                               // Get the dead time corrected counts per minute
+    double             getCorrectedMicrosievertsPerHour(const uint8_t timeSeconds); // Get the dead time corrected microsieverts per hour for a fixed integration time
+    double             getCorrectedMicrosievertsPerHour();                          // Get the dead time corrected microsieverts per hour
+    double             getEquivalentDose();                                         // Get the equivalent dose in the selected measurement unit
+    double             getAbsorbedMicrosieverts();                                  // Get the total absorbed dose in microsieverts
+    double             getMainAbsorbedMicrosieverts();                              // Get the total absorbed dose for the main tube in microsieverts
+    double             getFollowerAbsorbedMicrosieverts();                          // Get the total absorbed dose for the follower tube in microsieverts
+    EquivalentDoseUnit getEquivalentDoseUnit();                                     // Get the equivalent dose unit
+    RadiationRating    getRadiationRating();                                        // Get the radiation rating
+    RadiationHistory&  getHistory();                                                // Get the radiation history
 
   // ----------------------------------------------------------------------------------------------
   // Private
@@ -103,25 +113,46 @@ class GeigerCounter {
 
     };
 
-    bool              _initialized;                               // Flag for checking if the Geiger counter is initialized
-    volatile uint16_t _movingAverage[60];                         // An array for storing counts per second for a duration of 60 seconds
-    volatile uint8_t  _movingAverageIndex;                        // Index of the moving average array
-    hw_timer_t        *_movingAverageTimer;                       // Hardware timer for advancing the moving average array
-    Tube              _mainTube;                                  // Main Tube
-    Tube              _followerTube;                              // Follower tube
-    bool              _enabled;                                   // Flag for checking if Geiger counter is enabled
-    uint8_t           _integrationTimeSeconds;                    // Number of seconds to use from the moving average array to average over 
-    bool              _autoIntegrate;                             // Flag for enabling automatic adjustment of the integration time
-    uint64_t          _autoIntegrationTimer;                      // Timer for adjusting the auto integration
-    bool              _autoRange;                                 // Flag for enabling equivalent dose auto ranging
-    MeasurementUnit   _measurementUnit;                           // Selected measurement unit
-    MetricPrefix      _metricPrefix;                              // Current metric prefix
-    uint32_t          _history[RADIATION_HISTORY_LENGTH_MINUTES]; // Radiation history array
-    uint8_t           _historyIndex;                              // Index of the radiation history array
-    uint8_t           _historyTimerSeconds;                       // Radiation history update timer
-
-    // Interrupt service routine for updating the Geiger counter
-    static void IRAM_ATTR _update(void *instancePointer);
+    bool              _initialized;                   // Flag for checking if the Geiger counter is initialized
+    volatile uint8_t  _movingAverageIndex;            // Index of the current second, advanced by the timer ISR
+    volatile uint32_t _movingAverageTickMicroseconds; // Time the timer ISR last advanced the index
+    volatile uint32_t _movingAverageTicks;            // Number of times the timer ISR advanced the index
+    uint32_t          _runningSum;                    // Running sum of all counts
+    uint32_t          _runningSumStart[60];           // The running sum at the start of each second for a duration of 60 seconds
+    uint8_t           _runningSumIndex;               // Index of the current second in the running sum array
+    uint32_t          _runningSumTicks;               // Number of timer ISR advances the running sum array has caught up with
+    uint32_t          _runningSumTickMicroseconds;    // Time the current second in the running sum array started
+    hw_timer_t        *_movingAverageTimer;           // Hardware timer for advancing the moving average array
+    Tube              _mainTube;                      // Main Tube
+    Tube              _followerTube;                  // Follower tube
+    bool              _enabled;                       // Flag for checking if Geiger counter is enabled
+    uint32_t          _disableTimeMilliseconds;       // Time the Geiger counter was last disabled, 0 if it never was
+    uint8_t           _integrationTimeSeconds;        // Number of seconds to use from the moving average array to average over
+    bool              _autoIntegrate;                 // Flag for enabling automatic adjustment of the integration time
+    uint64_t          _autoIntegrationTimer;          // Timer for adjusting the auto integration
+    bool              _autoRange;                     // Flag for enabling equivalent dose auto ranging
+    MeasurementUnit   _measurementUnit;               // Selected measurement unit
+    MetricPrefix      _metricPrefix;                  // Current metric prefix
+    RadiationHistory  _history;                       // Radiation history
+    RateEstimator     _estimator;                     // Count rate estimator for the automatic integration time
+    uint32_t          _journalCountsTimerSeconds;     // Seconds since the total counts were last written to the journal
+    uint32_t          _journalHistoryTimerSeconds;    // Seconds since the radiation history was last written to the journal
+
+    // Total counts record structure for the journal
+    struct CountsRecord {
+
+      uint64_t mainTubeCounts;     // Total number of counts of the main tube
+      uint64_t followerTubeCounts; // Total number of counts of the follower tube
+
+    };
+
+    double _correctDeadTime(const double countsPerMinute); // Correct a counts per minute value for the dead time of the tubes
+    void   _saveCounts();                                  // Write the total counts to the journal
+    void   _saveHistory();                                 // Write the radiation history to the journal
+    void   _restore();                                     // Restore the total counts and the radiation history from the journal
+
+    // Interrupt service routine for advancing the moving average
+    static void IRAM_ATTR _advanceMovingAverage(void *instancePointer);
 
 };
 
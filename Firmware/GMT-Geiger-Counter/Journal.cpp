@@ -0,0 +1,376 @@
+#include "Journal.h"
+#include "Logger.h"
+
+// ------------------------------------------------------------------------------------------------
+// Public
+
+// Initialize global reference
+Journal& journal = Journal::getInstance();
+
+// ================================================================================================
+// Get the single instance of the class
+// ================================================================================================
+Journal& Journal::getInstance() {
+
+  // Get the single instance
+  static Journal instance;
+
+  // Return the instance
+  return instance;
+
+}
+
+// ================================================================================================
+// Initialize everything
+// ================================================================================================
+void Journal::begin() {
+
+  // If not initialized
+  if (!_initialized) {
+
+    // Set initialization flag to true
+    _initialized = true;
+
+    // Initialize logger
+    logger.begin();
+
+    // Mount the internal flash filesystem, format it if it can't be mounted
+    _mounted = LittleFS.begin(true);
+
+    // If the filesystem is mounted
+    if (_mounted) {
+
+      // A leftover temporary file is an unfinished compaction
+      // The journal file is only replaced by renaming the temporary file, so the journal file is still intact
+      if (LittleFS.exists(JOURNAL_TEMPORARY_FILE)) { LittleFS.remove(JOURNAL_TEMPORARY_FILE); }
+
+      // Find the latest valid record of each type
+      _scan();
+
+      // Open the journal file to check its size
+      File file = LittleFS.open(JOURNAL_FILE);
+
+      // If the file is larger than its valid part, the last record was not completely written
+      // Remove the damaged part by compacting the journal, otherwise new records would be appended after it and never found
+      if (file && file.size() > _size) {
+
+        file.close();
+
+        _compact();
+
+      }
+
+      // Close the journal file
+      file.close();
+
+    }
+
+  }
+
+}
+
+// ================================================================================================
+// Append a record to the journal
+// ================================================================================================
+bool Journal::write(const RecordType type, const void *data, const uint32_t size) {
+
+  // If the filesystem is not mounted, there is nowhere to write to
+  if (!_mounted) { return false; }
+
+  // If the record would grow the journal past its maximum size, compact it first, if that fails there is no room for the record
+  if (_size + sizeof(Header) + size > JOURNAL_MAXIMUM_SIZE_BYTES && !_compact()) { return false; }
+
+  // Create the record header
+  Header header = {JOURNAL_RECORD_MAGIC, (uint32_t)type, size, 0xFFFFFFFF};
+
+  // Calculate the CRC of the record type, size and data
+  header.crc = _getCRC((const uint8_t *)&header.type, sizeof(header.type) + sizeof(header.size), header.crc);
+  header.crc = ~_getCRC((const uint8_t *)data, size, header.crc);
+
+  // Open the journal file in append mode
+  File file = LittleFS.open(JOURNAL_FILE, FILE_APPEND, true);
+
+  // If opening the journal file failed
+  if (!file) { return false; }
+
+  // If the journal file is larger than its valid part, a record was not completely written and removing it failed before
+  // A record appended after the damaged part could never be found, so the damaged part has to be removed first
+  if (file.size() != _size) {
+
+    file.close();
+
+    if (!_compact()) { return false; }
+
+    file = LittleFS.open(JOURNAL_FILE, FILE_APPEND, true);
+
+    if (!file) { return false; }
+
+  }
+
+  // Write the record header and data
+  size_t written = file.write((const uint8_t *)&header, sizeof(Header));
+  written       += file.write((const uint8_t *)data, size);
+
+  // Close the journal file
+  file.close();
+
+  // If the record was not completely written, e.g. because the filesystem is full
+  if (written != sizeof(Header) + size) {
+
+    // Remove the damaged record, if that fails it is removed before the next record is written
+    _compact();
+
+    return false;
+
+  }
+
+  // The new record is the latest record of its type
+  _offsets[type] = _size;
+  _sizes[type]   = size;
+  _size         += sizeof(Header) + size;
+
+  return true;
+
+}
+
+// ================================================================================================
+// Read the latest valid record of a type
+// ================================================================================================
+bool Journal::read(const RecordType type, void *data, const uint32_t size) {
+
+  // If the filesystem is not mounted or there is no record of this type with the expected size
+  if (!_mounted || _sizes[type] != size) { return false; }
+
+  // Open the journal file
+  File file = LittleFS.open(JOURNAL_FILE);
+
+  // Flag for checking if reading was successful
+  bool success = false;
+
+  // If successfully accessed the journal file
+  if (file) {
+
+    // Read the record data
+    success = file.seek(_offsets[type] + sizeof(Header)) && file.read((uint8_t *)data, size) == size;
+
+  }
+
+  // Close the journal file
+  file.close();
+
+  return success;
+
+}
+
+// ================================================================================================
+// Get the mount state of the journal filesystem
+// ================================================================================================
+bool Journal::getMountState() {
+
+  return _mounted;
+
+}
+
+// ================================================================================================
+// Get the size of the journal file in bytes
+// ================================================================================================
+uint32_t Journal::getSize() {
+
+  return _size;
+
+}
+
+// ------------------------------------------------------------------------------------------------
+// Private
+
+// ================================================================================================
+// Constructor
+// ================================================================================================
+Journal::Journal():
+
+  // Initialize members
+  _initialized(false),
+  _mounted(false),
+  _size(0),
+  _offsets{},
+  _sizes{}
+
+{}
+
+// ================================================================================================
+// Find the latest valid record of each type
+// ================================================================================================
+void Journal::_scan() {
+
+  // Forget all records
+  for (uint8_t type = 0; type < RECORD_TYPES; type++) { _offsets[type] = 0; _sizes[type] = 0; }
+
+  // Start at the beginning of the journal
+  _size = 0;
+
+  // Open the journal file
+  File file = LittleFS.open(JOURNAL_FILE);
+
+  // If there is no journal file, there are no records
+  if (!file) { return; }
+
+  // Get the size of the journal file
+  uint32_t fileSize = file.size();
+
+  // Header and chunk buffer
+  Header  header;
+  uint8_t buffer[256];
+
+  // For every complete record header
+  while (file.read((uint8_t *)&header, sizeof(Header)) == sizeof(Header)) {
+
+    // Stop at anything that does not look like a complete record
+    if (header.magic != JOURNAL_RECORD_MAGIC || header.size > fileSize - _size - sizeof(Header)) { break; }
+
+    // Calculate the CRC of the record type and size
+    uint32_t crc = _getCRC((const uint8_t *)&header.type, sizeof(header.type) + sizeof(header.size), 0xFFFFFFFF);
+
+    // Calculate the CRC of the record data chunk by chunk
+    uint32_t remaining = header.size;
+
+    while (remaining > 0) {
+
+      size_t length = file.read(buffer, min(remaining, (uint32_t)sizeof(buffer)));
+
+      if (length == 0) { break; }
+
+      crc        = _getCRC(buffer, length, crc);
+      remaining -= length;
+
+    }
+
+    // Stop at the first record that was not completely or correctly written
+    if (remaining > 0 || ~crc != header.crc) { break; }
+
+    // If the record type is known, it is now the latest record of its type
+    if (header.type < RECORD_TYPES) {
+
+      _offsets[header.type] = _size;
+      _sizes[header.type]   = header.size;
+
+    }
+
+    // Move on to the next record
+    _size += sizeof(Header) + header.size;
+
+  }
+
+  // Close the journal file
+  file.close();
+
+}
+
+// ================================================================================================
+// Rewrite the journal with only the latest record of each type
+// ================================================================================================
+bool Journal::_compact() {
+
+  // Flag for checking if compacting was successful
+  bool success = true;
+
+  // Open the journal file and a new temporary file
+  File source      = LittleFS.open(JOURNAL_FILE);
+  File destination = LittleFS.open(JOURNAL_TEMPORARY_FILE, FILE_WRITE, true);
+
+  // If successfully accessed both files
+  if (source && destination) {
+
+    // Copy the latest record of each type
+    for (uint8_t type = 0; type < RECORD_TYPES; type++) { success = success && _copyRecord(source, destination, (RecordType)type); }
+
+  } else {
+
+    success = false;
+
+  }
+
+  // Close both files
+  source.close();
+  destination.close();
+
+  // Replace the journal file with the compacted file in one step
+  // If the power is lost before this, the old journal file is still intact and the temporary file will be removed
+  if (success) { success = LittleFS.rename(JOURNAL_TEMPORARY_FILE, JOURNAL_FILE); }
+
+  // If compacting failed, only remove the incomplete temporary file
+  // The journal file was not touched, its valid records are kept and the next write tries to compact it again
+  if (!success) { LittleFS.remove(JOURNAL_TEMPORARY_FILE); }
+
+  // Find the records in the journal file
+  _scan();
+
+  // Create event data
+  Logger::KeyValuePair event[2] = {
+
+    {"source", Logger::STRING_T, {.string_v = "journal"}                                 },
+    {"action", Logger::STRING_T, {.string_v = success ? "compacted" : "compactionFailed"}}
+
+  };
+
+  // Log event message
+  logger.log(Logger::EVENT, "event", event, 2);
+
+  return success;
+
+}
+
+// ================================================================================================
+// Copy the latest record of a type to another file
+// ================================================================================================
+bool Journal::_copyRecord(File &source, File &destination, const RecordType type) {
+
+  // If there is no record of this type, there is nothing to copy
+  if (_sizes[type] == 0) { return true; }
+
+  // Go to the start of the record
+  if (!source.seek(_offsets[type])) { return false; }
+
+  // Chunk buffer
+  uint8_t buffer[256];
+
+  // Copy the record header and data chunk by chunk
+  uint32_t remaining = sizeof(Header) + _sizes[type];
+
+  while (remaining > 0) {
+
+    size_t length = source.read(buffer, min(remaining, (uint32_t)sizeof(buffer)));
+
+    if (length == 0 || destination.write(buffer, length) != length) { return false; }
+
+    remaining -= length;
+
+  }
+
+  return true;
+
+}
+
+// ================================================================================================
+// Calculate CRC
+// ================================================================================================
+uint32_t Journal::_getCRC(const uint8_t *bytes, const size_t length, uint32_t crc) {
+
+  // Generic CRC algorithm, continuing from a previous CRC value so that data can be processed in chunks
+  // Start with 0xFFFFFFFF and invert the final value
+
+  for (size_t i = 0; i < length; i++) {
+
+    crc ^= bytes[i];
+
+    for (uint8_t j = 0; j < 8; j++) {
+
+      if (crc & 1) { crc = (crc >> 1) ^ 0xEDB88320; }
+      else         { crc >>= 1;                     }
+
+    }
+
+  }
+
+  return crc;
+
+}
@@ -0,0 +1,74 @@
+#ifndef _JOURNAL_H
+#define _JOURNAL_H
+
+#include "Arduino.h"
+#include "Configuration.h"
+#include "FS.h"
+#include "LittleFS.h"
+
+// Append-only, CRC protected journal in the internal flash
+// Every record is appended to the journal file, the latest valid record of each type wins
+// A record that was only partially written, e.g. because of a power loss, fails its CRC check and is dropped together with everything after it
+// Once the journal file grows too large, it is compacted by writing only the latest record of each type to a new file and replacing the old one
+class Journal {
+
+  // ----------------------------------------------------------------------------------------------
+  // Public
+
+  public:
+
+    // Record type enumerator
+    enum RecordType {
+
+      COUNTS,  // Total counts of the tubes
+      HISTORY, // Radiation history archive
+      RECORD_TYPES
+
+    };
+
+    // Get the single instance of the class
+    static Journal& getInstance();
+
+    void     begin();                                                             // Initialize everything
+    bool     write(const RecordType type, const void *data, const uint32_t size); // Append a record to the journal
+    bool     read(const RecordType type, void *data, const uint32_t size);        // Read the latest valid record of a type
+    bool     getMountState();                                                     // Get the mount state of the journal filesystem
+    uint32_t getSize();                                                           // Get the size of the journal file in bytes
+
+  // ----------------------------------------------------------------------------------------------
+  // Private
+
+  private:
+
+    // Prevent direct instantiation
+    Journal();
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    // Record header structure
+    struct Header {
+
+      uint32_t magic; // Marks the start of a record
+      uint32_t type;  // Record type
+      uint32_t size;  // Size of the record data in bytes
+      uint32_t crc;   // CRC of the record type, size and data
+
+    };
+
+    bool     _initialized;           // Flag for checking if the journal is initialized
+    bool     _mounted;               // Flag for checking if the journal filesystem is mounted
+    uint32_t _size;                  // Size of the valid part of the journal file in bytes
+    uint32_t _offsets[RECORD_TYPES]; // File offset of the latest valid record of each type
+    uint32_t _sizes[RECORD_TYPES];   // Data size of the latest valid record of each type, 0 if there is none
+
+    void     _scan();                                                             // Find the latest valid record of each type
+    bool     _compact();                                                          // Rewrite the journal with only the latest record of each type
+    bool     _copyRecord(File &source, File &destination, const RecordType type); // Copy the latest record of a type to another file
+    uint32_t _getCRC(const uint8_t *bytes, const size_t length, uint32_t crc);    // Calculate CRC
+
+};
+
+// Global reference to the journal instance for easy access
+extern Journal& journal;
+
+#endif
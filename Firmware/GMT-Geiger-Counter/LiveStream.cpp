@@ -0,0 +1,285 @@
+#include "LiveStream.h"
+#include "lwip/sockets.h"
+#include <errno.h>
+
+// ------------------------------------------------------------------------------------------------
+// Public
+
+// Initialize global reference
+LiveStream& liveStream = LiveStream::getInstance();
+
+// ================================================================================================
+// Get the single instance of the class
+// ================================================================================================
+LiveStream& LiveStream::getInstance() {
+
+  // Get the single instance
+  static LiveStream instance;
+
+  // Return the instance
+  return instance;
+
+}
+
+// ================================================================================================
+// Initialize everything
+// ================================================================================================
+void LiveStream::begin() {
+
+  // If not initialized
+  if (!_initialized) {
+
+    // Set initialization flag to true
+    _initialized = true;
+
+    // Initialize logger
+    logger.begin();
+
+    // Start the first interval
+    _timer          = millis();
+    _counts         = geigerCounter.getCounts();
+    _mainCounts     = geigerCounter.getMainTubeCounts();
+    _followerCounts = geigerCounter.getFollowerTubeCounts();
+
+  }
+
+}
+
+// ================================================================================================
+// Send a frame to all subscribers once per interval
+// ================================================================================================
+void LiveStream::update() {
+
+  // Send what is left of the previous frames, on every loop so a frame is completed as soon as the connection takes it
+  _sendRemainders();
+
+  // If the interval has not passed yet, there is nothing to do
+  if (millis() - _timer < LIVE_STREAM_INTERVAL_MILLISECONDS) { return; }
+
+  // Get the actual length of the interval and start the next one
+  uint32_t interval = millis() - _timer;
+
+  _timer = millis();
+
+  // Get the counts and the change since the previous frame
+  // This is done even without subscribers, so the first frame a new subscriber gets only covers one interval
+  uint64_t counts         = geigerCounter.getCounts();
+  uint64_t mainCounts     = geigerCounter.getMainTubeCounts();
+  uint64_t followerCounts = geigerCounter.getFollowerTubeCounts();
+
+  uint32_t newCounts         = counts - _counts;
+  uint32_t newMainCounts     = mainCounts - _mainCounts;
+  uint32_t newFollowerCounts = followerCounts - _followerCounts;
+
+  _counts         = counts;
+  _mainCounts     = mainCounts;
+  _followerCounts = followerCounts;
+
+  // If there are no subscribers, there is no frame
+  if (getSubscribers() == 0) { return; }
+
+  // Time the frame
+  uint32_t start = micros();
+
+  // Get data
+  Logger::KeyValuePair data[8] = {
+
+    {"interval",             Logger::UINT32_T, {.uint32_v = interval}                                 },
+    {"counts",               Logger::UINT32_T, {.uint32_v = newCounts}                                },
+    {"mainCounts",           Logger::UINT32_T, {.uint32_v = newMainCounts}                            },
+    {"followerCounts",       Logger::UINT32_T, {.uint32_v = newFollowerCounts}                        },
+    {"totalCounts",          Logger::UINT64_T, {.uint64_v = counts}                                   },
+    {"countsPerMinute",      Logger::DOUBLE_T, {.double_v = geigerCounter.getCountsPerMinute()}       },
+    {"microsievertsPerHour", Logger::DOUBLE_T, {.double_v = geigerCounter.getMicrosievertsPerHour()}  },
+    {"totalMicrosieverts",   Logger::DOUBLE_T, {.double_v = geigerCounter.getAbsorbedMicrosieverts()} }
+
+  };
+
+  // Add the event ID and the start of the event data
+  size_t length = snprintf(_frame, sizeof(_frame), "id: %" PRIu32 "\ndata: ", _sequence++);
+
+  // Add the data as a JSON message, leaving room for the blank line that ends the event
+  size_t json = logger.getLogMessage("geigerCounter", data, 8, _frame + length, sizeof(_frame) - length - 2);
+
+  // If the data doesn't fit into the frame buffer, there is no frame
+  if (json == 0) { return; }
+
+  length += json;
+
+  // End the event
+  _frame[length++] = '\n';
+  _frame[length++] = '\n';
+
+  // For every subscriber
+  for (uint8_t subscriber = 0; subscriber < LIVE_STREAM_MAXIMUM_SUBSCRIBERS; subscriber++) {
+
+    // If the subscriber is not connected, skip it
+    if (!_clients[subscriber].connected()) { continue; }
+
+    // If the subscriber still has the rest of the previous frame to send, the new frame can't be put in between
+    // Otherwise send as much of the frame as the connection takes without blocking the main loop
+    int sent = _remainderSizes[subscriber] > 0 ? 0 : _send(subscriber, _frame, length);
+
+    // If the connection failed, drop the subscriber
+    if (sent < 0) { _disconnect(subscriber); continue; }
+
+    // If nothing was sent, skip the frame for this subscriber, a subscriber that doesn't keep up for several frames is dropped
+    if (sent == 0) {
+
+      if (++_skipped[subscriber] >= LIVE_STREAM_MAXIMUM_SKIPPED_FRAMES) { _disconnect(subscriber); }
+
+      continue;
+
+    }
+
+    _skipped[subscriber] = 0;
+
+    // Keep the rest of the frame, it is sent with the next loops
+    _remainderSizes[subscriber] = length - sent;
+
+    memcpy(_remainders[subscriber], _frame + sent, _remainderSizes[subscriber]);
+
+  }
+
+  // Get the time the frame took
+  _frameMicroseconds = micros() - start;
+
+}
+
+// ================================================================================================
+// Keep the client of the current request as a subscriber, false if there is no room
+// ================================================================================================
+bool LiveStream::subscribe(WiFiClient client) {
+
+  // For every subscriber slot
+  for (uint8_t subscriber = 0; subscriber < LIVE_STREAM_MAXIMUM_SUBSCRIBERS; subscriber++) {
+
+    // If the slot is free
+    if (!_clients[subscriber].connected()) {
+
+      // Send every frame right away and keep the connection open after the request handler returns
+      client.setNoDelay(true);
+      client.setSSE(true);
+
+      // Send the response header, the response has no end
+      client.print("HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\nCache-Control: no-cache\r\nConnection: keep-alive\r\n\r\n");
+
+      // Take the slot
+      _clients[subscriber]        = client;
+      _skipped[subscriber]        = 0;
+      _remainderSizes[subscriber] = 0;
+
+      return true;
+
+    }
+
+  }
+
+  // There is no free slot
+  return false;
+
+}
+
+// ================================================================================================
+// Get the number of connected subscribers
+// ================================================================================================
+uint8_t LiveStream::getSubscribers() {
+
+  // Number of connected subscribers
+  uint8_t subscribers = 0;
+
+  // Count the connected subscribers
+  for (uint8_t subscriber = 0; subscriber < LIVE_STREAM_MAXIMUM_SUBSCRIBERS; subscriber++) {
+
+    if (_clients[subscriber].connected()) { subscribers++; }
+
+  }
+
+  return subscribers;
+
+}
+
+// ================================================================================================
+// Get the time it took to serialize and send the last frame in microseconds
+// ================================================================================================
+uint32_t LiveStream::getFrameMicroseconds() {
+
+  return _frameMicroseconds;
+
+}
+
+// ------------------------------------------------------------------------------------------------
+// Private
+
+// ================================================================================================
+// Send as much data to a subscriber as its connection takes without blocking
+// Returns the number of bytes sent, or -1 if the connection failed
+// ================================================================================================
+int LiveStream::_send(const uint8_t subscriber, const char *data, const size_t size) {
+
+  // Write straight to the socket without waiting, the WiFi client would block until everything is sent
+  int sent = send(_clients[subscriber].fd(), data, size, MSG_DONTWAIT);
+
+  // If the send buffer of the connection is full, nothing was sent but the connection is fine
+  if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) { return 0; }
+
+  return sent;
+
+}
+
+// ================================================================================================
+// Send what is left of the previous frames to the subscribers
+// ================================================================================================
+void LiveStream::_sendRemainders() {
+
+  // For every subscriber with the rest of a frame to send
+  for (uint8_t subscriber = 0; subscriber < LIVE_STREAM_MAXIMUM_SUBSCRIBERS; subscriber++) {
+
+    if (_remainderSizes[subscriber] == 0) { continue; }
+
+    // If the subscriber is gone, forget the rest of the frame
+    if (!_clients[subscriber].connected()) { _remainderSizes[subscriber] = 0; continue; }
+
+    // Send as much of the rest as the connection takes
+    int sent = _send(subscriber, _remainders[subscriber], _remainderSizes[subscriber]);
+
+    // If the connection failed, drop the subscriber
+    if (sent < 0) { _disconnect(subscriber); continue; }
+
+    // Move what is still left to the start of the buffer
+    _remainderSizes[subscriber] -= sent;
+
+    memmove(_remainders[subscriber], _remainders[subscriber] + sent, _remainderSizes[subscriber]);
+
+  }
+
+}
+
+// ================================================================================================
+// Drop a subscriber
+// ================================================================================================
+void LiveStream::_disconnect(const uint8_t subscriber) {
+
+  _clients[subscriber].stop();
+
+  _remainderSizes[subscriber] = 0;
+
+}
+
+// ================================================================================================
+// Constructor
+// ================================================================================================
+LiveStream::LiveStream():
+
+  // Initialize members
+  _initialized(false),
+  _skipped{},
+  _remainderSizes{},
+  _sequence(0),
+  _timer(0),
+  _counts(0),
+  _mainCounts(0),
+  _followerCounts(0),
+  _frameMicroseconds(0)
+
+{}
@@ -0,0 +1,60 @@
+#ifndef _LIVE_STREAM_H
+#define _LIVE_STREAM_H
+
+#include "Arduino.h"
+#include "Configuration.h"
+#include "Logger.h"
+#include "GeigerCounter.h"
+#include "WiFi.h"
+
+// Pushes the Geiger counter measurements to any number of HTTP clients as server-sent events
+// Every frame is serialized once and the same bytes are written to all subscribers
+class LiveStream {
+
+  // ----------------------------------------------------------------------------------------------
+  // Public
+
+  public:
+
+    // Get the single instance of the class
+    static LiveStream& getInstance();
+
+    void     begin();                          // Initialize everything
+    void     update();                         // Send a frame to all subscribers once per interval
+    bool     subscribe(WiFiClient client);     // Keep the client of the current request as a subscriber, false if there is no room
+    uint8_t  getSubscribers();                 // Get the number of connected subscribers
+    uint32_t getFrameMicroseconds();           // Get the time it took to serialize and send the last frame in microseconds
+
+  // ----------------------------------------------------------------------------------------------
+  // Private
+
+  private:
+
+    // Prevent direct instantiation
+    LiveStream();
+    LiveStream(const LiveStream&) = delete;
+    LiveStream& operator=(const LiveStream&) = delete;
+
+    bool       _initialized;                                                               // Flag for checking if the live stream is initialized
+    WiFiClient _clients[LIVE_STREAM_MAXIMUM_SUBSCRIBERS];                                  // Subscriber connections, unused ones are not connected
+    uint8_t    _skipped[LIVE_STREAM_MAXIMUM_SUBSCRIBERS];                                  // Frames in a row each subscriber missed because its connection didn't take them
+    char       _remainders[LIVE_STREAM_MAXIMUM_SUBSCRIBERS][LIVE_STREAM_FRAME_SIZE_BYTES]; // Rest of a frame each subscriber's connection didn't take yet
+    size_t     _remainderSizes[LIVE_STREAM_MAXIMUM_SUBSCRIBERS];                           // Size of the rest of the frame of each subscriber
+    char       _frame[LIVE_STREAM_FRAME_SIZE_BYTES];                                       // Shared frame buffer
+    uint32_t   _sequence;                                                                  // Frame sequence number, sent as the event ID so clients can tell if they missed a frame
+    uint64_t   _timer;                                                                     // Timer for sending frames
+    uint64_t   _counts;                                                                    // Total counts at the previous frame
+    uint64_t   _mainCounts;                                                                // Main tube counts at the previous frame
+    uint64_t   _followerCounts;                                                            // Follower tube counts at the previous frame
+    uint32_t   _frameMicroseconds;                                                         // Time it took to serialize and send the last frame
+
+    int  _send(const uint8_t subscriber, const char *data, const size_t size);  // Send as much data to a subscriber as its connection takes without blocking
+    void _sendRemainders();                                                      // Send what is left of the previous frames to the subscribers
+    void _disconnect(const uint8_t subscriber);                                  // Drop a subscriber
+
+};
+
+// Global reference to the live stream instance for easy access
+extern LiveStream& liveStream;
+
+#endif
@@ -38,6 +38,28 @@ void Logger::begin() {
     // Initialize serial communication
     Serial.begin(SERIAL_BAUD_RATE);
 
+    // Allocate the log buffer, preferably in the PSRAM
+    // Without a log buffer, log messages are written to the log file directly
+    _buffer = (char*)heap_caps_malloc(LOG_BUFFER_SIZE_BYTES, MALLOC_CAP_SPIRAM);
+
+    if (_buffer == NULL) { _buffer = (char*)malloc(LOG_BUFFER_SIZE_BYTES); }
+
+    // Create the mutex for the log file and the log buffer, which are used by the logging task and by flush() and close()
+    _mutex = xSemaphoreCreateRecursiveMutex();
+
+    // Create the log queue
+    _queue = xRingbufferCreate(LOG_QUEUE_SIZE_BYTES, RINGBUF_TYPE_NOSPLIT);
+
+    // Start the logging task
+    // Without a log queue or a logging task, log messages are written directly
+    if (_queue != NULL && xTaskCreatePinnedToCore(_logTask, "logger", LOG_TASK_STACK_SIZE_BYTES, this, 1, &_task, LOG_TASK_CORE) != pdPASS) {
+
+      vRingbufferDelete(_queue);
+
+      _queue = NULL;
+
+    }
+
     // Initialize SD card
     sdCard.begin();
 
@@ -45,6 +67,151 @@ void Logger::begin() {
 
 }
 
+// ================================================================================================
+// Write the queued log messages and the log buffer to the SD card
+// ================================================================================================
+void Logger::flush() {
+
+  // Keep the logging task away from the log file
+  _lock();
+
+  // Output the log messages that are still in the log queue
+  _drainQueue();
+
+  // Write the log buffer to the SD card
+  _flush();
+
+  _unlock();
+
+}
+
+// ================================================================================================
+// Write the log buffer to the SD card and close the log file, e.g. before the SD card is unmounted
+// ================================================================================================
+void Logger::close() {
+
+  // Keep the logging task away from the log file
+  _lock();
+
+  // Write the queued log messages and the log buffer to the SD card
+  flush();
+
+  // Update the log manifest entry with the final log file size
+  _writeManifestEntry();
+
+  // Close the log file and the log manifest
+  _logFile.close();
+  _manifestFile.close();
+
+  _unlock();
+
+}
+
+// ================================================================================================
+// Keep the logging task away from the log file, e.g. while the SD card is unmounted
+// ================================================================================================
+void Logger::lock() {
+
+  _lock();
+
+}
+
+// ================================================================================================
+// Let the logging task write to the log file again
+// ================================================================================================
+void Logger::unlock() {
+
+  _unlock();
+
+}
+
+// ================================================================================================
+// Convert a binary log file to the JSON log format, handing the converted log file to the output function in pieces
+// The output is what the log file would have been in the JSON log format, every log message followed by a ","
+// Returns false if the log file is damaged or there is not enough memory, the output then ends with the last complete log message
+// ================================================================================================
+bool Logger::convertLogFile(File &file, void (*output)(const char *data, const size_t size)) {
+
+  // Allocate the decoder, preferably in the PSRAM
+  Decoder *decoder = (Decoder*)heap_caps_malloc(sizeof(Decoder), MALLOC_CAP_SPIRAM);
+
+  if (decoder == NULL) { decoder = (Decoder*)malloc(sizeof(Decoder)); }
+
+  // If there is not enough memory, nothing can be converted
+  if (decoder == NULL) { return false; }
+
+  // No schema is defined before the first header
+  memset(decoder->defined, 0, sizeof(decoder->defined));
+
+  decoder->time       = 0;
+  decoder->outputSize = 0;
+
+  // Only the bytes that are in the log file right now are converted, records appended meanwhile are left for the next request
+  uint32_t remaining = file.size();
+  size_t   inputSize = 0;
+  bool     invalid   = false;
+
+  file.seek(0);
+
+  // Until the log file is decoded or turns out to be damaged
+  while (!invalid) {
+
+    // Fill up the input buffer
+    size_t length = file.read(decoder->input + inputSize, min((uint32_t)(sizeof(decoder->input) - inputSize), remaining));
+
+    inputSize += length;
+    remaining -= length;
+
+    // Position in the input buffer
+    size_t position = 0;
+
+    // Decode every complete item in the input buffer
+    while (!invalid && position < inputSize) {
+
+      size_t itemSize = _decodeBinaryItem(*decoder, decoder->input + position, inputSize - position, invalid);
+
+      // If the item is incomplete, it is decoded once the rest of it is read
+      if (itemSize == 0) { break; }
+
+      position += itemSize;
+
+      // If the output buffer might not have room for the next log message, hand it to the output function
+      if (decoder->outputSize >= LOG_MESSAGE_MAXIMUM_SIZE_BYTES) {
+
+        output(decoder->output, decoder->outputSize);
+
+        decoder->outputSize = 0;
+
+      }
+
+    }
+
+    // Move the incomplete item to the start of the input buffer
+    inputSize -= position;
+
+    memmove(decoder->input, decoder->input + position, inputSize);
+
+    // If nothing was read or decoded, the end of the log file is reached
+    // If there is anything left, reading failed or the log file ends with an incomplete item
+    if (length == 0 && position == 0) {
+
+      invalid = invalid || inputSize > 0 || remaining > 0;
+
+      break;
+
+    }
+
+  }
+
+  // Hand the rest of the output to the output function
+  if (decoder->outputSize > 0) { output(decoder->output, decoder->outputSize); }
+
+  free(decoder);
+
+  return !invalid;
+
+}
+
 // ================================================================================================
 // Set serial logging state
 // ================================================================================================
@@ -61,6 +228,9 @@ void Logger::setSDCardLoggingState(const bool state) {
 
   _sdCardLogging = state;
 
+  // If SD card logging is disabled, write what is left in the log buffer and release the log file
+  if (!_sdCardLogging) { close(); }
+
 }
 
 // ================================================================================================
@@ -72,6 +242,34 @@ void Logger::setLogLevelState(const LogLevel level, const bool state) {
 
 }
 
+// ================================================================================================
+// Set the log file format, a new log file is started if it changes
+// ================================================================================================
+void Logger::setLogFormat(const LogFormat format) {
+
+  // Keep the logging task away from the log file
+  _lock();
+
+  // If the log file format changes
+  if (format != _logFormat) {
+
+    // Finish the current log file
+    close();
+
+    // Set the new log file format
+    _logFormat = format;
+
+    // Start a new log file with the next free log file ID
+    _logFilePath = "";
+    _logFileID   = 0;
+    _logFilePart = 0;
+
+  }
+
+  _unlock();
+
+}
+
 // ================================================================================================
 // Get state of serial logging
 // ================================================================================================
@@ -100,167 +298,139 @@ bool Logger::getLogLevelState(const LogLevel level) {
 }
 
 // ================================================================================================
-// Get path to log file
+// Get the log file format
 // ================================================================================================
-const char* Logger::getLogFilePath() {
+Logger::LogFormat Logger::getLogFormat() {
 
-  // Check if the SD card is mounted
-  if (sdCard.getMountState()) {
+  return _logFormat;
 
-    // Check if the log file path is unset
-    if (_logFilePath.isEmpty()) {
-
-      // Open log directory
-      File directory = sdCard.open(SD_CARD_LOG_DIRECTORY);
+}
 
-      // If accessing the log directory was successful
-      if (directory && directory.isDirectory()) {
+// ================================================================================================
+// Get path to log file, empty if no log file was opened yet
+// ================================================================================================
+String Logger::getLogFilePath() {
 
-        // Element variable
-        File element;
+  // Keep the logging task away from the log file path while it is copied
+  _lock();
 
-        // Loop through all elements in the log directory
-        while ((element = directory.openNextFile())) {
+  String path = _logFilePath;
 
-          // If the element is not a directory
-          if (element && !element.isDirectory()) {
-            
-            // Get the element name
-            String name = element.name();
+  _unlock();
 
-            // Check if it is a JSON file
-            if (name.endsWith(".json")) {
+  return path;
 
-              // Increase the log file ID
-              _logFileID++;
+}
 
-            }
+// ================================================================================================
+// Get the running total of log messages dropped because the log queue was full
+// ================================================================================================
+uint32_t Logger::getDroppedMessages() {
 
-          }
-          
-          // Close each element after use
-          element.close();
+  // This counter wraps around, only the difference between two readings is meaningful
+  return _droppedMessages.load(std::memory_order_relaxed);
 
-        }
+}
 
-        // Increase the log file ID to the next log file
-        _logFileID++;
+// ================================================================================================
+// Get the number of log manifest entries
+// ================================================================================================
+uint32_t Logger::getManifestSize() {
 
-        // Construct the full log file path with the new log file ID
-        _logFilePath  = SD_CARD_LOG_DIRECTORY;
-        _logFilePath += "/Log_";
-        _logFilePath += _logFileID;
-        _logFilePath += ".json";
-      
-      }
+  // Number of log manifest entries
+  uint32_t size = 0;
 
-      // Close the log directory
-      directory.close();
-    
-    // If a log file is already selected
-    } else {
+  // Keep the logging task away from the log manifest
+  _lock();
 
-      // Open the selected log file
-      File file = sdCard.open(_logFilePath.c_str());
+  // If the SD card is mounted and the log manifest can be opened, the entries follow the header
+  if (sdCard.getMountState() && _openManifest()) {
 
-      // If log file size is larger than the maximum allowed size
-      if (file && file.size() >= LOG_FILE_MAXIMUM_SIZE_BYTES) {
+    size = (_manifestFile.size() - sizeof(ManifestHeader)) / sizeof(ManifestEntry);
 
-        // Increase log file part
-        _logFilePart++;
+  }
 
-        // Construct new file path to the next log file part
-        _logFilePath  = SD_CARD_LOG_DIRECTORY;
-        _logFilePath += "/Log_";
-        _logFilePath += _logFileID;
-        _logFilePath += ".json.part";
-        _logFilePath += _logFilePart;
+  _unlock();
 
-      }
+  return size;
 
-      // Close log file
-      file.close();
+}
 
-    }
+// ================================================================================================
+// Get a log manifest entry
+// ================================================================================================
+bool Logger::getManifestEntry(const uint32_t index, ManifestEntry &entry) {
 
-  }
+  // Flag for checking if the entry was read
+  bool success = false;
 
-  // Return the log file path
-  return _logFilePath.c_str();
+  // Keep the logging task away from the log manifest
+  _lock();
 
-}
+  // If the SD card is mounted and the log manifest can be opened
+  if (sdCard.getMountState() && _openManifest()) {
 
-// ================================================================================================
-// Construct and return a log message
-// ================================================================================================
-void Logger::getLogMessage(const char *type, const KeyValuePair *data, const uint8_t size, String &message) {
+    // Read the entry at its fixed position
+    if (_manifestFile.seek(sizeof(ManifestHeader) + index * sizeof(ManifestEntry))) {
 
-  // Clear the log message
-  message = "";
+      success = _manifestFile.read((uint8_t*)&entry, sizeof(ManifestEntry)) == sizeof(ManifestEntry);
 
-  // Add log message type
-  message += "{\"type\":\"";
-  message += type;
+    }
 
-  // Add log message time
-  message += "\",\"time\":";
-  message += millis();
+    // The entry of the current log file part is only written on open, rotate and close, its up to date version is in memory
+    // The size is what was written to the SD card so far, without the log buffer
+    if (success && index == _manifestIndex) {
 
-  // Add log message data
-  message += ",\"data\":{";
+      entry      = _manifestEntry;
+      entry.size = _logFileSize - _bufferSize;
 
-  // For each key value pair
-  for (uint8_t pair = 0; pair < size; pair++) {
+    }
 
-    // Add the key
-    message += "\"";
-    message += data[pair].key;
-    message += "\":";
+  }
 
-    // Add the value depending on the type
-    switch (data[pair].type) {
+  _unlock();
 
-      // If value is an unsigned integer simply add it to the message
-      case UINT8_T:  message += data[pair].value.uint8_v;  break;
-      case UINT32_T: message += data[pair].value.uint32_v; break;
-      case UINT64_T: message += data[pair].value.uint64_v; break;
+  return success;
 
-      // If value is a floating point number format it to have 5 decimal places
-      case DOUBLE_T: message += String(data[pair].value.double_v, 5); break;
+}
 
-      // If value is a sting
-      case STRING_T:
+// ================================================================================================
+// Get the name of the log file part a log manifest entry belongs to
+// ================================================================================================
+String Logger::getLogFileName(const ManifestEntry &entry) {
 
-        // Escape the value with '"'
-        message += "\"";
-        message += data[pair].value.string_v;
-        message += "\"";
+  // Log file name with the log file ID and the extension of the log file format
+  String name  = "Log_";
+         name += entry.id;
+         name += (entry.format == BINARY) ? ".bin" : ".json";
 
-      break;
+  // If this is not the first part, add the log file part
+  if (entry.part > 0) {
 
-      // If the value is a boolean
-      case BOOL_T:
+    name += ".part";
+    name += entry.part;
 
-        // Add a "true" or "false" depending on the boolean value
-        if (data[pair].value.bool_v) { message += "true";  }
-        else                         { message += "false"; }
+  }
 
-      break;
+  return name;
 
-    }
+}
 
-    // If not the last the key value pair
-    if (pair < size - 1) {
+// ================================================================================================
+// Construct a log message in a buffer and return its length, 0 if it doesn't fit
+// ================================================================================================
+size_t Logger::getLogMessage(const char *type, const KeyValuePair *data, const uint8_t size, char *buffer, const size_t bufferSize) {
 
-      // Add a trailing ","
-      message += ",";
+  return _getLogMessage(millis(), type, data, size, buffer, bufferSize);
 
-    }
+}
 
-  }
+// ================================================================================================
+// Construct a log message with a given time, e.g. to give several log messages the same time
+// ================================================================================================
+size_t Logger::getLogMessage(const uint32_t time, const char *type, const KeyValuePair *data, const uint8_t size, char *buffer, const size_t bufferSize) {
 
-  // Add the trailing "}}" to the message
-  message += "}}";
+  return _getLogMessage(time, type, data, size, buffer, bufferSize);
 
 }
 
@@ -272,47 +442,35 @@ void Logger::log(const LogLevel level, const char *type, const KeyValuePair *dat
   // If selected log level is enabled
   if (_logLevels[level]) {
 
-    // Log message string
-    String message = "";
-
-    // Construct the log message
-    getLogMessage(type, data, size, message);
-
-    // If serial logging is enabled
-    if (_serialLogging) {
-
-      // Print log message to serial console
-      Serial.println(message);
-
-    }
-
-    // If SD card logging is enabled and data is intended for SD card
-    if (_sdCardLogging && sdCardData) {
+    // Get where the log message goes
+    uint8_t targets = (_serialLogging ? TO_SERIAL : 0) | (_sdCardLogging && sdCardData ? TO_SD_CARD : 0);
 
-      // Add a "," to the end of the log message
-      message += ",";
+    // If the log message doesn't go anywhere, there is nothing to do
+    if (targets == 0) { return; }
 
-      // If SD card is mounted
-      if (sdCard.getMountState()) {
+    // Queued log message buffer
+    uint8_t message[LOG_MESSAGE_MAXIMUM_SIZE_BYTES];
 
-        // Open the log file in append mode
-        File file = sdCard.open(getLogFilePath(), FILE_APPEND);
+    // Copy the log message, it is formatted and written by the logging task
+    size_t length = _getQueuedMessage(targets, type, data, size, message, sizeof(message));
 
-        // If opening the log file was successful
-        if (file) {
+    // If the log message doesn't fit into the buffer, drop it
+    if (length == 0) { return; }
 
-          // Write log message to log file
-          file.print(message);
+    // If the logging task is running, hand it the log message
+    if (_queue != NULL) {
 
-        }
+      _queueMessage(message, length);
 
-        // Close the log file
-        file.close();
+    // Otherwise, e.g. before the logger is initialized, write the log message directly
+    } else {
 
-      }
+      _lock();
+      _output(message, length);
+      _unlock();
 
     }
-  
+
   }
 
 }
@@ -331,6 +489,1141 @@ Logger::Logger():
   _sdCardLogging(false),
   _logFilePath(""),
   _logFileID(0),
-  _logFilePart(0)
+  _logFilePart(0),
+  _logFileSize(0),
+  _buffer(NULL),
+  _bufferSize(0),
+  _flushTimer(0),
+  _logFormat(JSON),
+  _nextSchema(0),
+  _recordTime(0),
+  _queue(NULL),
+  _mutex(NULL),
+  _task(NULL),
+  _droppedMessages(0),
+  _manifestIndex(UINT32_MAX)
+
+{}
+
+// ================================================================================================
+// Append data to the log file through the log buffer
+// ================================================================================================
+void Logger::_write(const char *data, const size_t size) {
+
+  // If the log file can't be opened, the data is lost
+  if (!_openLogFile()) { return; }
+
+  // If there is no log buffer, write the data to the log file directly
+  if (_buffer == NULL) {
+
+    _logFileSize += _logFile.write((const uint8_t*)data, size);
+
+    return;
+
+  }
+
+  // Number of bytes copied into the log buffer
+  size_t position = 0;
+
+  // Until all data is in the log buffer
+  while (position < size) {
+
+    // If the log buffer is empty, start the timer for writing it to the SD card
+    if (_bufferSize == 0) { _flushTimer = millis(); }
+
+    // The log buffer is full when it reaches a sector boundary of the log file
+    // After a timed write the log file usually ends in the middle of a sector, the next full log buffer is shorter and ends on a sector boundary again
+    size_t capacity = LOG_BUFFER_SIZE_BYTES - ((_logFileSize - _bufferSize) % 512);
+
+    // Copy as much data as fits into the log buffer
+    size_t length = min(size - position, capacity - _bufferSize);
+
+    memcpy(_buffer + _bufferSize, data + position, length);
+
+    _bufferSize  += length;
+    _logFileSize += length;
+    position     += length;
+
+    // If the log buffer is full, write it to the SD card
+    if (_bufferSize == capacity) { _flush(); }
+
+  }
+
+}
+
+// ================================================================================================
+// Write the log buffer to the SD card
+// ================================================================================================
+void Logger::_flush() {
+
+  // If there is anything in the log buffer
+  if (_bufferSize > 0) {
+
+    // If the log file is open
+    if (_logFile) {
+
+      // Write the log buffer to the log file
+      size_t written = _logFile.write((const uint8_t*)_buffer, _bufferSize);
+
+      // Commit the new file size to the file allocation table, so the written data survives a power loss
+      _logFile.flush();
+
+      // If not everything was written, e.g. because the SD card was removed, close the log file and have the mount state verified
+      // It is opened again with the next log message, which also gets its actual size again
+      if (written != _bufferSize) {
+
+        _logFile.close();
+
+        sdCard.reportError();
+
+      }
+
+    }
+
+    // Clear the log buffer
+    _bufferSize = 0;
+
+  }
+
+}
+
+// ================================================================================================
+// Open the log file for appending, or the next log file part if it is full
+// ================================================================================================
+bool Logger::_openLogFile() {
+
+  // If the log file is already open and not larger than the maximum allowed size
+  if (_logFile && _logFileSize < LOG_FILE_MAXIMUM_SIZE_BYTES) { return true; }
+
+  // If the log file is open, it is larger than the maximum allowed size
+  if (_logFile) {
+
+    // Finish the current log file and its log manifest entry
+    _flush();
+    _writeManifestEntry();
+    _logFile.close();
+
+    // Increase log file part
+    _logFilePart++;
+
+    // Construct new file path to the next log file part
+    _setLogFilePath();
+
+  }
+
+  // If no log file was started yet, e.g. after a restart or a new log file format, take a new log file ID
+  if (_logFilePath.isEmpty() && !_reserveLogFileID()) { return false; }
+
+  // Open the log file in append mode
+  _logFile = sdCard.open(_logFilePath.c_str(), FILE_APPEND);
+
+  // If opening the log file failed
+  if (!_logFile) { return false; }
+
+  // Get the log file size once, from here on it is tracked in memory
+  _logFileSize = _logFile.size();
+
+  // If the log manifest has no entry for this log file part yet, add one
+  if (_manifestIndex == UINT32_MAX || _manifestEntry.id != _logFileID || _manifestEntry.part != _logFilePart || _manifestEntry.format != _logFormat) {
+
+    _addManifestEntry();
+
+  // If it is opened again, e.g. after a failed write, its entry gets the actual log file size
+  } else {
+
+    _writeManifestEntry();
+
+  }
+
+  // If the log file is written in the binary format
+  if (_logFormat == BINARY) {
+
+    // Forget all schemas, they have to be defined again after the header
+    for (uint8_t schema = 0; schema < LOG_BINARY_SCHEMAS; schema++) { _schemas[schema].hash = 0; }
+
+    _nextSchema = 0;
+    _recordTime = 0;
+
+    // Every time the log file is opened, e.g. after a restart or a failed write, it continues with a header
+    // This way a decoder never applies differences to values from before a gap
+    const char header[6] = {0x00, 'G', 'M', 'T', 'L', BINARY_VERSION};
+
+    _write(header, sizeof(header));
+
+  }
+
+  return true;
+
+}
+
+// ================================================================================================
+// Take the next free log file ID from the log manifest and set the log file path
+// ================================================================================================
+bool Logger::_reserveLogFileID() {
+
+  // If the SD card is not mounted or the log manifest can't be opened, there is no free log file ID
+  if (!sdCard.getMountState() || !_openManifest()) { return false; }
+
+  // Read the log manifest header, it holds the next free log file ID so the log directory doesn't have to be searched
+  ManifestHeader header;
+
+  _manifestFile.seek(0);
+
+  // If reading the header failed
+  if (_manifestFile.read((uint8_t*)&header, sizeof(ManifestHeader)) != sizeof(ManifestHeader)) { return false; }
+
+  // Take the next free log file ID
+  _logFileID   = header.nextID;
+  _logFilePart = 0;
+
+  // Reserve it in the log manifest
+  header.nextID++;
+
+  _manifestFile.seek(0);
+  _manifestFile.write((const uint8_t*)&header, sizeof(ManifestHeader));
+  _manifestFile.flush();
+
+  // Construct the full log file path with the new log file ID
+  _setLogFilePath();
+
+  return true;
+
+}
+
+// ================================================================================================
+// Set the path of the current log file part
+// ================================================================================================
+void Logger::_setLogFilePath() {
+
+  // Log manifest entry of the current log file part, only the name matters here
+  ManifestEntry entry = {_logFileID, _logFilePart, _logFormat, 0, 0, 0};
+
+  // Log file path with the log file name
+  _logFilePath  = SD_CARD_LOG_DIRECTORY;
+  _logFilePath += "/";
+  _logFilePath += getLogFileName(entry);
+
+}
+
+// ================================================================================================
+// Open the log manifest, rebuilding it from the log directory if it is missing or damaged
+// ================================================================================================
+bool Logger::_openManifest() {
+
+  // If the log manifest is already open, there is nothing to do
+  if (_manifestFile) { return true; }
+
+  // If the log manifest is missing or damaged, e.g. on the first start with a new SD card, create it from the log directory
+  if (!sdCard.exists(SD_CARD_LOG_MANIFEST_FILE) || !_checkManifest()) { _rebuildManifest(); }
+
+  // Open the log manifest for reading and writing at any position
+  _manifestFile = sdCard.open(SD_CARD_LOG_MANIFEST_FILE, "r+");
+
+  return (bool)_manifestFile;
+
+}
+
+// ================================================================================================
+// Check if the log manifest file has a valid header and whole entries
+// ================================================================================================
+bool Logger::_checkManifest() {
+
+  // Flag for checking if the log manifest is valid
+  bool valid = false;
+
+  // Open the log manifest
+  File file = sdCard.open(SD_CARD_LOG_MANIFEST_FILE);
+
+  // If the log manifest has room for the header and whole entries
+  if (file && file.size() >= sizeof(ManifestHeader) && (file.size() - sizeof(ManifestHeader)) % sizeof(ManifestEntry) == 0) {
+
+    // Read the header
+    ManifestHeader header;
+
+    if (file.read((uint8_t*)&header, sizeof(ManifestHeader)) == sizeof(ManifestHeader)) {
+
+      // Check the magic and the version
+      valid = memcmp(header.magic, "GMTM", 4) == 0 && header.version == MANIFEST_VERSION;
+
+    }
+
+  }
+
+  // Close the log manifest
+  file.close();
+
+  return valid;
+
+}
+
+// ================================================================================================
+// Create the log manifest from the log files in the log directory
+// ================================================================================================
+void Logger::_rebuildManifest() {
+
+  // Create an empty log manifest
+  File manifest = sdCard.open(SD_CARD_LOG_MANIFEST_FILE, FILE_WRITE);
+
+  // If that failed, there is no log manifest
+  if (!manifest) { return; }
+
+  // Log manifest header, log file IDs start with 1
+  ManifestHeader header = {{'G', 'M', 'T', 'M'}, MANIFEST_VERSION, 1};
+
+  manifest.write((const uint8_t*)&header, sizeof(ManifestHeader));
+
+  // Open log directory
+  File directory = sdCard.open(SD_CARD_LOG_DIRECTORY);
+
+  // If accessing the log directory was successful
+  if (directory && directory.isDirectory()) {
+
+    // Element variable
+    File element;
+
+    // Loop through all elements in the log directory, this only happens once per SD card
+    while ((element = directory.openNextFile())) {
+
+      // Log manifest entry
+      ManifestEntry entry;
+
+      // If the element is a log file part
+      if (!element.isDirectory() && _parseLogFileName(element.name(), entry)) {
+
+        // Add its entry, the times are unknown
+        entry.size = element.size();
+
+        manifest.write((const uint8_t*)&entry, sizeof(ManifestEntry));
+
+        // The next log file ID comes after the highest one in use, gaps from deleted log files are not reused
+        if (entry.id >= header.nextID) { header.nextID = entry.id + 1; }
+
+      }
+
+      // Close each element after use
+      element.close();
+
+    }
+
+  }
+
+  // Close the log directory
+  directory.close();
+
+  // Write the header again with the next log file ID
+  manifest.seek(0);
+  manifest.write((const uint8_t*)&header, sizeof(ManifestHeader));
+
+  // Close the log manifest
+  manifest.close();
+
+}
+
+// ================================================================================================
+// Get the log file ID, part and format from a log file name
+// ================================================================================================
+bool Logger::_parseLogFileName(const String &name, ManifestEntry &entry) {
+
+  // Log file names look like "Log_<ID>.<json|bin>" with an optional ".part<part>"
+  int extension = name.indexOf('.');
+
+  // If the name doesn't start with "Log_" followed by an ID, it is not a log file
+  if (!name.startsWith("Log_") || extension <= 4) { return false; }
+
+  // Get the log file ID
+  entry.id        = name.substring(4, extension).toInt();
+  entry.part      = 0;
+  entry.size      = 0;
+  entry.firstTime = 0;
+  entry.lastTime  = 0;
+
+  // Everything after the ID
+  String suffix = name.substring(extension);
+
+  // Get the log file format
+  if      (suffix.startsWith(".json")) { entry.format = JSON;   suffix = suffix.substring(5); }
+  else if (suffix.startsWith(".bin") ) { entry.format = BINARY; suffix = suffix.substring(4); }
+  else                                 { return false;                                        }
+
+  // Get the log file part, if there is one
+  if      (suffix.isEmpty()           ) { return true;                                        }
+  else if (suffix.startsWith(".part")) { entry.part = suffix.substring(5).toInt(); return true; }
+  else                                 { return false;                                        }
+
+}
+
+// ================================================================================================
+// Append a log manifest entry for the current log file part
+// ================================================================================================
+void Logger::_addManifestEntry() {
+
+  // Start the entry of the current log file part
+  _manifestEntry = {_logFileID, _logFilePart, _logFormat, _logFileSize, 0, 0};
+  _manifestIndex = UINT32_MAX;
+
+  // If the log manifest can't be opened, the log file part is missing from it until it is rebuilt
+  if (!_openManifest()) { return; }
+
+  // The new entry goes after the last one
+  _manifestIndex = (_manifestFile.size() - sizeof(ManifestHeader)) / sizeof(ManifestEntry);
+
+  // Append the entry
+  _manifestFile.seek(sizeof(ManifestHeader) + _manifestIndex * sizeof(ManifestEntry));
+  _manifestFile.write((const uint8_t*)&_manifestEntry, sizeof(ManifestEntry));
+  _manifestFile.flush();
+
+}
+
+// ================================================================================================
+// Write the current log manifest entry if the log file has grown
+// ================================================================================================
+void Logger::_writeManifestEntry() {
+
+  // If there is no current entry or the log file size didn't change, there is nothing to do
+  if (_manifestIndex == UINT32_MAX || _manifestEntry.size == _logFileSize) { return; }
+
+  // If the log manifest can't be opened, the entry is written with the next update
+  if (!_openManifest()) { return; }
+
+  // Set the new log file size
+  _manifestEntry.size = _logFileSize;
+
+  // Overwrite the entry in place, the log manifest doesn't grow so the file allocation table is left alone
+  _manifestFile.seek(sizeof(ManifestHeader) + _manifestIndex * sizeof(ManifestEntry));
+  _manifestFile.write((const uint8_t*)&_manifestEntry, sizeof(ManifestEntry));
+  _manifestFile.flush();
+
+}
+
+// ================================================================================================
+// Take the mutex, if it exists
+// ================================================================================================
+void Logger::_lock() {
+
+  if (_mutex != NULL) { xSemaphoreTakeRecursive(_mutex, portMAX_DELAY); }
+
+}
+
+// ================================================================================================
+// Give the mutex back, if it exists
+// ================================================================================================
+void Logger::_unlock() {
+
+  if (_mutex != NULL) { xSemaphoreGiveRecursive(_mutex); }
+
+}
+
+// ================================================================================================
+// Add a queued log message to the log queue, according to the overflow policy
+// ================================================================================================
+void Logger::_queueMessage(const uint8_t *message, const size_t size) {
+
+  // Until the log message is in the log queue
+  while (xRingbufferSend(_queue, message, size, 0) != pdTRUE) {
+
+    // Count the dropped log message
+    _droppedMessages.fetch_add(1, std::memory_order_relaxed);
+
+    // If the oldest log messages are dropped to make room for new ones
+    #if LOG_QUEUE_OVERFLOW_POLICY == LOG_DROP_OLDEST
+
+      // Take the oldest log message out of the log queue
+      size_t  oldestSize = 0;
+      uint8_t *oldest    = (uint8_t*)xRingbufferReceive(_queue, &oldestSize, 0);
+
+      // If there is none left to drop, e.g. because the logging task is still writing the only other one, drop the new log message instead
+      if (oldest == NULL) { return; }
+
+      // Drop the oldest log message
+      vRingbufferReturnItem(_queue, oldest);
+
+    // If the new log message is dropped
+    #else
+
+      return;
+
+    #endif
+
+  }
+
+  // Wake up the logging task, it takes the log message out of the log queue
+  xTaskNotifyGive(_task);
+
+}
+
+// ================================================================================================
+// Output all log messages in the log queue
+// ================================================================================================
+void Logger::_drainQueue() {
+
+  // If there is no log queue, there is nothing to do
+  if (_queue == NULL) { return; }
+
+  // Queued log message
+  size_t  size    = 0;
+  uint8_t *message = NULL;
+
+  // Output and remove every log message that is in the log queue right now
+  while ((message = (uint8_t*)xRingbufferReceive(_queue, &size, 0)) != NULL) {
+
+    _output(message, size);
+
+    vRingbufferReturnItem(_queue, message);
+
+  }
+
+}
+
+// ================================================================================================
+// Write a queued log message to the serial console and the SD card
+// ================================================================================================
+void Logger::_output(const uint8_t *message, const size_t size) {
+
+  // Get the header of the queued log message
+  QueuedMessage header;
+
+  memcpy(&header, message, sizeof(QueuedMessage));
+
+  // Position in the queued log message
+  size_t position = sizeof(QueuedMessage);
+
+  // Get the message type
+  const char *type = (const char*)message + position;
+
+  position += strlen(type) + 1;
+
+  // Restore the key value pairs, keys and strings point into the queued log message
+  KeyValuePair data[LOG_MESSAGE_MAXIMUM_VALUES];
+
+  for (uint8_t pair = 0; pair < header.size; pair++) {
+
+    // Get the value type and the key
+    data[pair].type = (ValueType)message[position];
+    data[pair].key  = (const char*)message + position + 1;
+
+    position += strlen(data[pair].key) + 2;
+
+    // Strings are stored with their terminating null character, everything else with its size
+    if (data[pair].type == STRING_T) {
+
+      data[pair].value.string_v = (const char*)message + position;
+
+      position += strlen(data[pair].value.string_v) + 1;
+
+    } else {
+
+      data[pair].value.uint64_v = 0;
+
+      memcpy(&data[pair].value, message + position, _getValueSize(data[pair].type));
+
+      position += _getValueSize(data[pair].type);
+
+    }
+
+  }
+
+  // Log message buffer, with room for a trailing line break
+  char buffer[LOG_MESSAGE_MAXIMUM_SIZE_BYTES + 2];
+
+  // Construct the log message
+  size_t length = _getLogMessage(header.time, type, data, header.size, buffer, LOG_MESSAGE_MAXIMUM_SIZE_BYTES);
+
+  // If the log message doesn't fit into the buffer, drop it
+  if (length == 0) { return; }
+
+  // If the log message goes to the serial console
+  if (header.targets & TO_SERIAL) {
+
+    // Print log message to serial console, with the line break in the same write so it can't be split up by other output
+    buffer[length]     = '\r';
+    buffer[length + 1] = '\n';
+
+    Serial.write((const uint8_t*)buffer, length + 2);
+
+  }
+
+  // If the log message goes to the SD card and the SD card is mounted
+  if ((header.targets & TO_SD_CARD) && sdCard.getMountState()) {
+
+    // If the log file is written in the binary format
+    if (_logFormat == BINARY) {
+
+      // Open the log file before constructing the record, opening a log file resets the schemas the record is encoded with
+      if (_openLogFile()) {
+
+        // Construct the binary log record in the log message buffer, the JSON log message is no longer needed
+        length = _getBinaryLogMessage(header.time, type, data, header.size, (uint8_t*)buffer, sizeof(buffer));
+
+        // Append the binary log record to the log file through the log buffer
+        if (length > 0) { _write(buffer, length); }
+
+      }
+
+    } else {
+
+      // Append the log message followed by a "," to the log file through the log buffer
+      _write(buffer, length);
+      _write(",", 1);
+
+    }
+
+    // Keep track of the time range of the log file part for the log manifest
+    if (_manifestEntry.firstTime == 0) { _manifestEntry.firstTime = header.time; }
+
+    _manifestEntry.lastTime = header.time;
+
+  }
+
+}
+
+// ================================================================================================
+// Copy a log message into a self-contained queued log message
+// ================================================================================================
+size_t Logger::_getQueuedMessage(const uint8_t targets, const char *type, const KeyValuePair *data, const uint8_t size, uint8_t *buffer, const size_t bufferSize) {
+
+  // Messages with more values than can be restored from the log queue are dropped
+  if (size > LOG_MESSAGE_MAXIMUM_VALUES) { return 0; }
+
+  // Get the length of the header and the message type
+  size_t length = sizeof(QueuedMessage) + strlen(type) + 1;
+
+  // If that doesn't fit, there is no queued log message
+  if (length > bufferSize) { return 0; }
+
+  // Add the header, the time is taken now so that it doesn't depend on when the logging task gets to the message
+  QueuedMessage header = {(uint32_t)millis(), targets, size};
+
+  memcpy(buffer, &header, sizeof(QueuedMessage));
+
+  // Add the message type
+  memcpy(buffer + sizeof(QueuedMessage), type, strlen(type) + 1);
+
+  // For every key value pair
+  for (uint8_t pair = 0; pair < size; pair++) {
+
+    // Get the key length and the value, strings are copied with their terminating null character
+    size_t     keySize   = strlen(data[pair].key) + 1;
+    const void *value    = (data[pair].type == STRING_T) ? (const void*)data[pair].value.string_v : (const void*)&data[pair].value;
+    size_t     valueSize = (data[pair].type == STRING_T) ? strlen(data[pair].value.string_v) + 1 : _getValueSize(data[pair].type);
+
+    // If the key value pair doesn't fit, there is no queued log message
+    if (length + 1 + keySize + valueSize > bufferSize) { return 0; }
+
+    // Add the value type, the key and the value
+    buffer[length] = data[pair].type;
+
+    memcpy(buffer + length + 1,           data[pair].key, keySize);
+    memcpy(buffer + length + 1 + keySize, value,          valueSize);
+
+    length += 1 + keySize + valueSize;
+
+  }
+
+  return length;
+
+}
+
+// ================================================================================================
+// Get the number of bytes a value takes up in a queued log message, except for strings
+// ================================================================================================
+uint8_t Logger::_getValueSize(const ValueType type) {
+
+  // All union members start at the beginning of the union, so the first bytes are the value
+  switch (type) {
+
+    case UINT8_T:  return sizeof(uint8_t);
+    case UINT32_T: return sizeof(uint32_t);
+    case UINT64_T: return sizeof(uint64_t);
+    case DOUBLE_T: return sizeof(double);
+    case BOOL_T:   return sizeof(bool);
+    default:       return 0;
+
+  }
+
+}
+
+// ================================================================================================
+// Construct a log message with a given time in a buffer
+// ================================================================================================
+size_t Logger::_getLogMessage(const uint32_t time, const char *type, const KeyValuePair *data, const uint8_t size, char *buffer, const size_t bufferSize) {
+
+  // If there is no room at all, there is no log message
+  if (bufferSize == 0) { return 0; }
+
+  // Add log message type, time and the start of the data
+  // The message is written straight into the buffer, so nothing is allocated on the heap
+  size_t length = snprintf(buffer, bufferSize, "{\"type\":\"%s\",\"time\":%" PRIu32 ",\"data\":{", type, time);
+
+  // For each key value pair, as long as there is room left
+  for (uint8_t pair = 0; pair < size && length < bufferSize; pair++) {
+
+    // Position and remaining room in the buffer
+    char   *position = buffer + length;
+    size_t remaining = bufferSize - length;
+
+    // Add a trailing "," if not the last key value pair
+    const char *separator = (pair < size - 1) ? "," : "";
+
+    // Add the key and the value depending on the type
+    switch (data[pair].type) {
+
+      // If value is an unsigned integer simply add it to the message
+      case UINT8_T:  length += snprintf(position, remaining, "\"%s\":%u%s",          data[pair].key, data[pair].value.uint8_v,  separator); break;
+      case UINT32_T: length += snprintf(position, remaining, "\"%s\":%" PRIu32 "%s", data[pair].key, data[pair].value.uint32_v, separator); break;
+      case UINT64_T: length += snprintf(position, remaining, "\"%s\":%" PRIu64 "%s", data[pair].key, data[pair].value.uint64_v, separator); break;
+
+      // If value is a floating point number format it to have 5 decimal places
+      case DOUBLE_T: length += snprintf(position, remaining, "\"%s\":%.5f%s",        data[pair].key, data[pair].value.double_v, separator); break;
+
+      // If value is a sting escape the value with '"'
+      case STRING_T: length += snprintf(position, remaining, "\"%s\":\"%s\"%s",      data[pair].key, data[pair].value.string_v, separator); break;
+
+      // If the value is a boolean add a "true" or "false" depending on the boolean value
+      case BOOL_T:   length += snprintf(position, remaining, "\"%s\":%s%s",          data[pair].key, data[pair].value.bool_v ? "true" : "false", separator); break;
+
+    }
+
+  }
+
+  // Add the trailing "}}" to the message
+  if (length < bufferSize) { length += snprintf(buffer + length, bufferSize - length, "}}"); }
+
+  // If the log message was cut off, it is not valid JSON
+  if (length >= bufferSize) {
+
+    buffer[0] = '\0';
+
+    return 0;
+
+  }
+
+  return length;
+
+}
+
+// ================================================================================================
+// Construct a binary log record, preceded by its schema if it is new
+// ================================================================================================
+size_t Logger::_getBinaryLogMessage(const uint32_t time, const char *type, const KeyValuePair *data, const uint8_t size, uint8_t *buffer, const size_t bufferSize) {
+
+  // Messages with more values than a schema can hold are not written
+  if (size > LOG_MESSAGE_MAXIMUM_VALUES) { return 0; }
+
+  // FNV-1a hash of the message type, the keys and the value types identifies the schema
+  uint32_t hash = 2166136261;
+
+  for (const char *character = type; *character; character++) { hash = (hash ^ (uint8_t)*character) * 16777619; }
+
+  for (uint8_t pair = 0; pair < size; pair++) {
+
+    hash = (hash ^ data[pair].type) * 16777619;
+
+    for (const char *character = data[pair].key; *character; character++) { hash = (hash ^ (uint8_t)*character) * 16777619; }
+
+  }
+
+  // 0 marks unused schemas
+  if (hash == 0) { hash = 1; }
+
+  // Number of bytes in the buffer
+  size_t length = 0;
+
+  // Find the schema of the message
+  uint8_t id = 0;
+
+  while (id < LOG_BINARY_SCHEMAS && _schemas[id].hash != hash) { id++; }
+
+  // If the schema is not defined in the current log file
+  if (id == LOG_BINARY_SCHEMAS) {
+
+    // Use an unused schema, or replace the one that is next in turn
+    for (id = 0; id < LOG_BINARY_SCHEMAS && _schemas[id].hash != 0; id++) {}
+
+    if (id == LOG_BINARY_SCHEMAS) { id = _nextSchema; _nextSchema = (_nextSchema + 1) % LOG_BINARY_SCHEMAS; }
+
+    // Define the schema, the first record is encoded against zero values
+    _schemas[id].hash = hash;
+
+    memset(_schemas[id].values, 0, sizeof(_schemas[id].values));
+
+    // Add the schema
+    _putByte(buffer, bufferSize, length, 0x01);
+    _putByte(buffer, bufferSize, length, id);
+    _putString(buffer, bufferSize, length, type, false);
+    _putByte(buffer, bufferSize, length, size);
+
+    for (uint8_t pair = 0; pair < size; pair++) {
+
+      _putByte(buffer, bufferSize, length, data[pair].type);
+      _putString(buffer, bufferSize, length, data[pair].key, false);
+
+    }
+
+  }
+
+  // Add the record tag and the time since the previous record
+  _putByte(buffer, bufferSize, length, 0x80 | id);
+  _putVarint(buffer, bufferSize, length, time - _recordTime);
+
+  // Add the values
+  for (uint8_t pair = 0; pair < size; pair++) {
+
+    // Integer value the difference to the previous value is encoded for
+    uint64_t value = 0;
+
+    switch (data[pair].type) {
+
+      // Single byte values are added as they are
+      case UINT8_T:  _putByte(buffer, bufferSize, length, data[pair].value.uint8_v);         continue;
+      case BOOL_T:   _putByte(buffer, bufferSize, length, data[pair].value.bool_v);          continue;
+
+      // Strings are added with their length
+      case STRING_T: _putString(buffer, bufferSize, length, data[pair].value.string_v, true); continue;
+
+      // Counters only ever change a little between two records, so their differences are short varints
+      case UINT32_T: value = data[pair].value.uint32_v; break;
+      case UINT64_T: value = data[pair].value.uint64_v; break;
+
+      // Floating point numbers are rounded to the same 5 decimal places as in a JSON log message, values out of range are clipped
+      case DOUBLE_T: {
+
+        double fixed = data[pair].value.double_v * 100000.0;
+
+        value = isnan(fixed) ? 0 : (uint64_t)llround(constrain(fixed, -9.0e18, 9.0e18));
+
+        break;
+
+      }
+
+    }
+
+    // Add the difference to the previous value as a zigzag varint, so that small negative differences are short too
+    int64_t difference = (int64_t)(value - _schemas[id].values[pair]);
+
+    _putVarint(buffer, bufferSize, length, ((uint64_t)difference << 1) ^ (uint64_t)(difference >> 63));
+
+    // Remember the value for the next record
+    _schemas[id].values[pair] = value;
+
+  }
+
+  // If the record doesn't fit into the buffer, the schema and the previous values no longer match the log file
+  // Forget the schema, so it is defined again with the next message
+  if (length > bufferSize) {
+
+    _schemas[id].hash = 0;
+
+    return 0;
+
+  }
+
+  // Remember the time of the record
+  _recordTime = time;
+
+  return length;
+
+}
+
+// ================================================================================================
+// Append a byte to a binary log record, as long as there is room
+// ================================================================================================
+void Logger::_putByte(uint8_t *buffer, const size_t bufferSize, size_t &length, const uint8_t value) {
+
+  // The length keeps counting beyond the end of the buffer, so that a record that doesn't fit can be detected
+  if (length < bufferSize) { buffer[length] = value; }
+
+  length++;
+
+}
+
+// ================================================================================================
+// Append a varint to a binary log record
+// ================================================================================================
+void Logger::_putVarint(uint8_t *buffer, const size_t bufferSize, size_t &length, uint64_t value) {
+
+  // 7 bits per byte, starting with the lowest ones, the highest bit is set on all but the last byte
+  while (value >= 0x80) {
+
+    _putByte(buffer, bufferSize, length, (value & 0x7F) | 0x80);
+
+    value >>= 7;
+
+  }
+
+  _putByte(buffer, bufferSize, length, value);
+
+}
+
+// ================================================================================================
+// Append a string to a binary log record
+// ================================================================================================
+void Logger::_putString(uint8_t *buffer, const size_t bufferSize, size_t &length, const char *value, const bool varint) {
+
+  // Get the string length, names in a schema are limited to 255 characters
+  size_t characters = varint ? strlen(value) : min(strlen(value), (size_t)255);
+
+  // Add the string length
+  if (varint) { _putVarint(buffer, bufferSize, length, characters); }
+  else        { _putByte(buffer, bufferSize, length, characters);   }
+
+  // Add the characters
+  for (size_t character = 0; character < characters; character++) { _putByte(buffer, bufferSize, length, value[character]); }
+
+}
+
+// ================================================================================================
+// Decode a header, schema or record of a binary log file, a record is added to the output as a JSON log message
+// Returns the size of the item, 0 if it is incomplete or invalid
+// ================================================================================================
+size_t Logger::_decodeBinaryItem(Decoder &decoder, const uint8_t *data, const size_t size, bool &invalid) {
+
+  // Position in the item, after the tag byte
+  size_t position = 1;
+
+  // If the item is a header
+  if (data[0] == 0x00) {
+
+    // If the header is incomplete
+    if (size < 6) { return 0; }
+
+    // If the header doesn't match the format version, the rest of the log file can't be decoded
+    if (memcmp(data + 1, "GMTL", 4) != 0 || data[5] != BINARY_VERSION) { invalid = true; return 0; }
+
+    // Forget all schemas and the time of the previous record, like the logger does when it opens the log file
+    memset(decoder.defined, 0, sizeof(decoder.defined));
+
+    decoder.time = 0;
+
+    return 6;
+
+  }
+
+  // If the item is a schema
+  if (data[0] == 0x01) {
+
+    // If the schema ID and the message type length are incomplete
+    if (size < 3) { return 0; }
+
+    // Get the schema ID
+    uint8_t id = data[position++];
+
+    if (id >= LOG_BINARY_SCHEMAS) { invalid = true; return 0; }
+
+    // The schema is replaced, its previous definition no longer applies
+    decoder.defined[id] = false;
+
+    // Message type and keys of the schema
+    char   *names    = decoder.names[id];
+    size_t namesSize = 0;
+
+    // For the message type and the key of every value
+    for (int16_t pair = -1; pair < (int16_t)decoder.sizes[id]; pair++) {
+
+      // If it is a value
+      if (pair >= 0) {
+
+        // If the value type is incomplete
+        if (position >= size) { return 0; }
+
+        // Get the value type
+        decoder.types[id][pair] = data[position++];
+
+        if (decoder.types[id][pair] > BOOL_T) { invalid = true; return 0; }
+
+      }
+
+      // If the name is incomplete
+      if (position >= size || position + 1 + data[position] > size) { return 0; }
+
+      // Get the name length
+      uint8_t characters = data[position++];
+
+      if (namesSize + characters + 1 > sizeof(decoder.names[id])) { invalid = true; return 0; }
+
+      // Copy the name
+      memcpy(names + namesSize, data + position, characters);
+
+      names[namesSize + characters] = '\0';
+
+      namesSize += characters + 1;
+      position  += characters;
+
+      // If it is the message type, get the number of values
+      if (pair < 0) {
+
+        if (position >= size) { return 0; }
+
+        decoder.sizes[id] = data[position++];
+
+        if (decoder.sizes[id] > LOG_MESSAGE_MAXIMUM_VALUES) { invalid = true; return 0; }
+
+      }
+
+    }
+
+    // The first record is decoded against zero values
+    memset(decoder.values[id], 0, sizeof(decoder.values[id]));
+
+    decoder.defined[id] = true;
+
+    return position;
+
+  }
+
+  // If the item is not a record either, the rest of the log file can't be decoded
+  if (!(data[0] & 0x80)) { invalid = true; return 0; }
+
+  // Get the schema ID, a record of a schema that is not defined can't be decoded
+  uint8_t id = data[0] & 0x7F;
+
+  if (id >= LOG_BINARY_SCHEMAS || !decoder.defined[id]) { invalid = true; return 0; }
+
+  // Get the time since the previous record
+  uint64_t difference = 0;
+
+  if (!_getVarint(data, size, position, difference)) { return 0; }
+
+  // Values of the record, the previous values of the schema are only updated once the record is complete
+  KeyValuePair pairs[LOG_MESSAGE_MAXIMUM_VALUES];
+  uint64_t     values[LOG_MESSAGE_MAXIMUM_VALUES];
+  size_t       stringsSize = 0;
+
+  // The keys follow the message type
+  const char *key = decoder.names[id] + strlen(decoder.names[id]) + 1;
+
+  // For every value of the schema
+  for (uint8_t pair = 0; pair < decoder.sizes[id]; pair++) {
+
+    pairs[pair].key  = key;
+    pairs[pair].type = (ValueType)decoder.types[id][pair];
+
+    key += strlen(key) + 1;
+
+    values[pair] = decoder.values[id][pair];
+
+    switch (pairs[pair].type) {
+
+      // Single byte values are stored as they are
+      case UINT8_T: if (position >= size) { return 0; } pairs[pair].value.uint8_v = data[position++];      continue;
+      case BOOL_T:  if (position >= size) { return 0; } pairs[pair].value.bool_v  = data[position++] != 0; continue;
+
+      // Strings are stored with their length
+      case STRING_T: {
+
+        uint64_t characters = 0;
+
+        if (!_getVarint(data, size, position, characters) || position + characters > size) { return 0; }
+
+        if (stringsSize + characters + 1 > sizeof(decoder.strings)) { invalid = true; return 0; }
+
+        // Copy the string
+        memcpy(decoder.strings + stringsSize, data + position, characters);
+
+        decoder.strings[stringsSize + characters] = '\0';
+
+        pairs[pair].value.string_v = decoder.strings + stringsSize;
+
+        stringsSize += characters + 1;
+        position    += characters;
+
+        continue;
+
+      }
+
+      // Counters and floating point numbers are stored as zigzag varints of the difference to the previous value
+      default: {
+
+        uint64_t zigzag = 0;
+
+        if (!_getVarint(data, size, position, zigzag)) { return 0; }
+
+        values[pair] += (zigzag >> 1) ^ (0 - (zigzag & 1));
+
+        break;
+
+      }
+
+    }
+
+    // Get the value of its type, floating point numbers are stored as fixed point numbers with 5 decimal places
+    if      (pairs[pair].type == UINT32_T) { pairs[pair].value.uint32_v = (uint32_t)values[pair];                 }
+    else if (pairs[pair].type == UINT64_T) { pairs[pair].value.uint64_v = values[pair];                           }
+    else                                   { pairs[pair].value.double_v = (double)(int64_t)values[pair] / 100000.0; }
+
+  }
+
+  // The record is complete, remember its values and its time
+  memcpy(decoder.values[id], values, decoder.sizes[id] * sizeof(uint64_t));
+
+  decoder.time += (uint32_t)difference;
+
+  // Add the JSON log message followed by a "," to the output, a log message that doesn't fit is dropped like when it was logged
+  size_t length = _getLogMessage(decoder.time, decoder.names[id], pairs, decoder.sizes[id], decoder.output + decoder.outputSize, LOG_MESSAGE_MAXIMUM_SIZE_BYTES);
+
+  if (length > 0) {
+
+    decoder.output[decoder.outputSize + length] = ',';
+
+    decoder.outputSize += length + 1;
+
+  }
+
+  return position;
+
+}
+
+// ================================================================================================
+// Read a varint of a binary log file, false if it is incomplete
+// ================================================================================================
+bool Logger::_getVarint(const uint8_t *data, const size_t size, size_t &position, uint64_t &value) {
+
+  value = 0;
+
+  // 7 bits per byte, starting with the lowest ones, the highest bit is set on all but the last byte
+  for (uint8_t shift = 0; position < size && shift < 64; shift += 7) {
+
+    uint8_t byte = data[position++];
+
+    value |= (uint64_t)(byte & 0x7F) << shift;
+
+    if (!(byte & 0x80)) { return true; }
+
+  }
+
+  return false;
+
+}
+
+// ================================================================================================
+// Task for writing the queued log messages
+// ================================================================================================
+void Logger::_logTask(void *instancePointer) {
+
+  // Cast the generic instance pointer back to a instance pointer of type Logger
+  Logger *instance = (Logger*)instancePointer;
+
+  // Run forever
+  while (true) {
+
+    // Wait until a log message is queued, at most for a second so that the log buffer is still written in time
+    // The log messages are only taken out of the log queue under the lock, otherwise flush() could write newer ones before them
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+
+    // Keep flush() and close() away from the log file
+    instance->_lock();
+
+    // Write the log messages and remove them from the log queue
+    instance->_drainQueue();
+
+    // If there is anything in the log buffer and the flush interval has passed, write the log buffer to the SD card
+    if (instance->_bufferSize > 0 && millis() - instance->_flushTimer >= LOG_FLUSH_INTERVAL_SECONDS * 1000) {
+
+      instance->_flush();
+
+    }
+
+    instance->_unlock();
+
+  }
 
-{}
\ No newline at end of file
+}
\ No newline at end of file
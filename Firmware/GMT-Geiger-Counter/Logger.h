@@ -4,6 +4,12 @@
 #include "Arduino.h"
 #include "Configuration.h"
 #include "SDCard.h"
+#include "freertos/ringbuf.h"
+#include <atomic>
+
+// Log queue overflow policies
+#define LOG_DROP_NEWEST 0
+#define LOG_DROP_OLDEST 1
 
 class Logger {
 
@@ -21,6 +27,14 @@ class Logger {
 
     };
 
+    // Log file format enumerator
+    enum LogFormat : uint8_t {
+
+      JSON,  // Comma separated JSON log messages
+      BINARY // Compact binary records, see below
+
+    };
+
     // Value type enumerator
     enum ValueType {
 
@@ -53,19 +67,55 @@ class Logger {
 
     };
 
+    // Binary log format
+    // A binary log file is a sequence of records, each starting with a tag byte
+    // Header (tag 0x00): "GMTL" and the format version, written whenever the log file is opened, resets all schemas and previous values
+    // Schema (tag 0x01): schema ID, type length and type, number of values, then for every value its type, key length and key
+    // Record (tag 0x80 | schema ID): time since the previous record in milliseconds as a varint, then every value of the schema
+    // Values: UINT8_T and BOOL_T as one byte, STRING_T as a varint length and the characters
+    // UINT32_T, UINT64_T and DOUBLE_T (as a fixed point number with 5 decimal places) as zigzag varints of the difference to the previous value of the schema
+    static constexpr uint8_t BINARY_VERSION = 1;
+
+    // Log manifest entry structure, one for every log file part
+    // The log manifest file starts with "GMTM", the manifest version and the next log file ID, followed by the entries in the order the log file parts were started
+    struct __attribute__((packed)) ManifestEntry {
+
+      uint16_t id;        // Log file ID
+      uint16_t part;      // Log file part
+      uint8_t  format;    // Log file format
+      uint32_t size;      // Log file size in bytes, as of the last time the log file part was opened, finished or closed
+      uint32_t firstTime; // Time of the first log message, 0 if unknown
+      uint32_t lastTime;  // Time of the last log message, 0 if unknown
+
+    };
+
+    static constexpr uint8_t MANIFEST_VERSION = 1;
+
     // Get the single instance of the class
     static Logger& getInstance();
 
     void        begin();                                                                                                                 // Initialize everything
+    void        flush();                                                                                                                 // Write the queued log messages and the log buffer to the SD card
+    void        close();                                                                                                                 // Write the queued log messages and the log buffer to the SD card and close the log file, e.g. before the SD card is unmounted
     void        setSerialLoggingState(const bool state);                                                                                 // Set serial logging state
     void        setSDCardLoggingState(const bool state);                                                                                 // Set SD card logging state
     void        setLogLevelState(const LogLevel level, const bool state);                                                                // Set a log level state
+    void        setLogFormat(const LogFormat format);                                                                                    // Set the log file format, a new log file is started if it changes
     bool        getSerialLoggingState();                                                                                                 // Get state of serial logging
     bool        getSDCardLoggingState();                                                                                                 // Get state of SD card logging
     bool        getLogLevelState(const LogLevel level);                                                                                  // Get the state of a log level
-    const char* getLogFilePath();                                                                                                        // Get path to log file
-    void        getLogMessage(const char *type, const KeyValuePair *data, const uint8_t size, String &message);                          // Construct and return a log message
+    LogFormat   getLogFormat();                                                                                                          // Get the log file format
+    String      getLogFilePath();                                                                                                        // Get path to log file, empty if no log file was opened yet
+    uint32_t    getDroppedMessages();                                                                                                    // Get the running total of log messages dropped because the log queue was full
+    uint32_t    getManifestSize();                                                                                                       // Get the number of log manifest entries
+    bool        getManifestEntry(const uint32_t index, ManifestEntry &entry);                                                            // Get a log manifest entry
+    String      getLogFileName(const ManifestEntry &entry);                                                                              // Get the name of the log file part a log manifest entry belongs to
+    size_t      getLogMessage(const char *type, const KeyValuePair *data, const uint8_t size, char *buffer, const size_t bufferSize);    // Construct a log message in a buffer and return its length, 0 if it doesn't fit
+    size_t      getLogMessage(const uint32_t time, const char *type, const KeyValuePair *data, const uint8_t size, char *buffer, const size_t bufferSize); // Construct a log message with a given time, e.g. to give several log messages the same time
     void        log(const LogLevel level, const char *type, const KeyValuePair *data, const uint8_t size, const bool sdCardData = true); // Log data
+    void        lock();                                                                                                                  // Keep the logging task away from the log file, e.g. while the SD card is unmounted
+    void        unlock();                                                                                                                // Let the logging task write to the log file again
+    bool        convertLogFile(File &file, void (*output)(const char *data, const size_t size));                                         // Convert a binary log file to the JSON log format, handing the converted log file to the output function in pieces
 
   // ----------------------------------------------------------------------------------------------
   // Private
@@ -77,13 +127,115 @@ class Logger {
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
 
-    bool     _initialized;   // Flag for checking if SD card was initialized
-    bool     _serialLogging; // Flag for checking if serial logging is enabled
-    bool     _sdCardLogging; // Flag for checking if SD card logging is enabled
-    bool     _logLevels[3];  // Log level flags
-    String   _logFilePath;   // Log file path
-    uint16_t _logFileID;     // Log file ID
-    uint16_t _logFilePart;   // Log file part
+    // The log buffer is written in whole SD card sectors
+    static_assert(LOG_BUFFER_SIZE_BYTES % 512 == 0, "LOG_BUFFER_SIZE_BYTES must be a multiple of 512!");
+
+    // Queued log message targets
+    enum Target : uint8_t {
+
+      TO_SERIAL  = 0x01, // Print the log message to the serial console
+      TO_SD_CARD = 0x02  // Write the log message to the log file
+
+    };
+
+    // Queued log message header structure, followed by the message type and the key value pairs
+    // Every key value pair is stored as its value type, its key, and its value (strings with a terminating null character)
+    struct __attribute__((packed)) QueuedMessage {
+
+      uint32_t time;    // Time the message was logged
+      uint8_t  targets; // Where the message goes
+      uint8_t  size;    // Number of key value pairs
+
+    };
+
+    // Log manifest header structure
+    struct __attribute__((packed)) ManifestHeader {
+
+      char     magic[4]; // "GMTM"
+      uint8_t  version;  // Log manifest version
+      uint16_t nextID;   // Next free log file ID
+
+    };
+
+    // Schema IDs have to fit next to the record tag bit
+    static_assert(LOG_BINARY_SCHEMAS > 0 && LOG_BINARY_SCHEMAS <= 128, "LOG_BINARY_SCHEMAS must be between 1 and 128!");
+
+    // Binary log schema structure
+    struct Schema {
+
+      uint32_t hash;                              // Hash of the message type, keys and value types, 0 if the schema is unused
+      uint64_t values[LOG_MESSAGE_MAXIMUM_VALUES]; // Previous values the next record is encoded against
+
+    };
+
+    // Binary log decoder structure, the state of a log file conversion
+    struct Decoder {
+
+      char     names[LOG_BINARY_SCHEMAS][LOG_MESSAGE_MAXIMUM_SIZE_BYTES]; // Message type and keys of every schema, each followed by a '\0'
+      uint8_t  types[LOG_BINARY_SCHEMAS][LOG_MESSAGE_MAXIMUM_VALUES];     // Value types of every schema
+      uint64_t values[LOG_BINARY_SCHEMAS][LOG_MESSAGE_MAXIMUM_VALUES];    // Previous values of every schema the next record is decoded against
+      uint8_t  sizes[LOG_BINARY_SCHEMAS];                                 // Number of values of every schema
+      bool     defined[LOG_BINARY_SCHEMAS];                               // Flags for checking if a schema is defined
+      uint32_t time;                                                      // Time of the previous record
+      uint8_t  input[2 * LOG_MESSAGE_MAXIMUM_SIZE_BYTES];                 // Part of the binary log file that is read but not decoded yet
+      char     strings[LOG_MESSAGE_MAXIMUM_SIZE_BYTES];                   // String values of the current record, each followed by a '\0'
+      char     output[2 * LOG_MESSAGE_MAXIMUM_SIZE_BYTES];                // JSON log messages that are not handed to the output function yet
+      size_t   outputSize;                                                // Number of bytes in the output buffer
+
+    };
+
+    bool                  _initialized;                 // Flag for checking if SD card was initialized
+    bool                  _serialLogging;               // Flag for checking if serial logging is enabled
+    bool                  _sdCardLogging;               // Flag for checking if SD card logging is enabled
+    bool                  _logLevels[3];                // Log level flags
+    String                _logFilePath;                 // Log file path
+    uint16_t              _logFileID;                   // Log file ID
+    uint16_t              _logFilePart;                 // Log file part
+    File                  _logFile;                     // Log file that is kept open for appending
+    uint32_t              _logFileSize;                 // Size of the log file including the log buffer, tracked in memory
+    char                  *_buffer;                     // Log buffer
+    uint16_t              _bufferSize;                  // Number of bytes in the log buffer
+    uint64_t              _flushTimer;                  // Timer for writing the log buffer to the SD card
+    LogFormat             _logFormat;                   // Log file format
+    Schema                _schemas[LOG_BINARY_SCHEMAS]; // Binary log schemas of the current log file
+    uint8_t               _nextSchema;                  // Binary log schema that is replaced next if there is no unused one
+    uint32_t              _recordTime;                  // Time of the previous binary log record
+    RingbufHandle_t       _queue;                       // Log queue between the callers and the logging task
+    SemaphoreHandle_t     _mutex;                       // Recursive mutex for the log file and the log buffer
+    TaskHandle_t          _task;                        // Handle of the logging task
+    std::atomic<uint32_t> _droppedMessages;             // Log messages dropped because the log queue was full
+    File                  _manifestFile;                // Log manifest file that is kept open for updating
+    ManifestEntry         _manifestEntry;               // Log manifest entry of the current log file part
+    uint32_t              _manifestIndex;               // Index of the current log manifest entry, UINT32_MAX if there is none
+
+    void    _write(const char *data, const size_t size);                                                                                                         // Append data to the log file through the log buffer
+    void    _flush();                                                                                                                                            // Write the log buffer to the SD card
+    bool    _openLogFile();                                                                                                                                      // Open the log file for appending, or the next log file part if it is full
+    bool    _reserveLogFileID();                                                                                                                                 // Take the next free log file ID from the log manifest and set the log file path
+    void    _setLogFilePath();                                                                                                                                   // Set the path of the current log file part
+    bool    _openManifest();                                                                                                                                     // Open the log manifest, rebuilding it from the log directory if it is missing or damaged
+    bool    _checkManifest();                                                                                                                                    // Check if the log manifest file has a valid header and whole entries
+    void    _rebuildManifest();                                                                                                                                  // Create the log manifest from the log files in the log directory
+    bool    _parseLogFileName(const String &name, ManifestEntry &entry);                                                                                         // Get the log file ID, part and format from a log file name
+    void    _addManifestEntry();                                                                                                                                 // Append a log manifest entry for the current log file part
+    void    _writeManifestEntry();                                                                                                                               // Write the current log manifest entry if the log file has grown, on open, rotate and close
+    void    _lock();                                                                                                                                             // Take the mutex, if it exists
+    void    _unlock();                                                                                                                                           // Give the mutex back, if it exists
+    void    _queueMessage(const uint8_t *message, const size_t size);                                                                                            // Add a queued log message to the log queue, according to the overflow policy
+    void    _drainQueue();                                                                                                                                       // Output all log messages in the log queue
+    void    _output(const uint8_t *message, const size_t size);                                                                                                  // Write a queued log message to the serial console and the SD card
+    size_t  _getQueuedMessage(const uint8_t targets, const char *type, const KeyValuePair *data, const uint8_t size, uint8_t *buffer, const size_t bufferSize);  // Copy a log message into a self-contained queued log message
+    uint8_t _getValueSize(const ValueType type);                                                                                                                 // Get the number of bytes a value takes up in a queued log message, except for strings
+    size_t  _getLogMessage(const uint32_t time, const char *type, const KeyValuePair *data, const uint8_t size, char *buffer, const size_t bufferSize);          // Construct a log message with a given time in a buffer
+    size_t  _getBinaryLogMessage(const uint32_t time, const char *type, const KeyValuePair *data, const uint8_t size, uint8_t *buffer, const size_t bufferSize); // Construct a binary log record, preceded by its schema if it is new
+    void    _putByte(uint8_t *buffer, const size_t bufferSize, size_t &length, const uint8_t value);                                                             // Append a byte to a binary log record, as long as there is room
+    void    _putVarint(uint8_t *buffer, const size_t bufferSize, size_t &length, uint64_t value);                                                                // Append a varint to a binary log record
+    void    _putString(uint8_t *buffer, const size_t bufferSize, size_t &length, const char *value, const bool varint);                                          // Append a string to a binary log record, with a varint or a single byte length
+    size_t  _decodeBinaryItem(Decoder &decoder, const uint8_t *data, const size_t size, bool &invalid);                                                          // Decode a header, schema or record of a binary log file, a record is added to the output as a JSON log message
+    bool    _getVarint(const uint8_t *data, const size_t size, size_t &position, uint64_t &value);                                                               // Read a varint of a binary log file, false if it is incomplete
+
+    // Task for writing the queued log messages
+    static void _logTask(void *instancePointer);
 
 };
 
@@ -0,0 +1,77 @@
+#include "PulseBuffer.h"
+
+// ------------------------------------------------------------------------------------------------
+// Public
+
+// ================================================================================================
+// Constructor
+// ================================================================================================
+PulseBuffer::PulseBuffer():
+
+  // Initialize members
+  _head(0),
+  _tail(0),
+  _overflowCounts(0)
+
+{}
+
+// ================================================================================================
+// Add a pulse to the buffer (producer only)
+// ================================================================================================
+bool IRAM_ATTR PulseBuffer::push(const uint32_t timeMicroseconds, const uint32_t counts) {
+
+  // Get the write index and the read index published by the consumer
+  uint32_t head = _head.load(std::memory_order_relaxed);
+  uint32_t tail = _tail.load(std::memory_order_acquire);
+
+  // If the buffer is full
+  if (head - tail >= TUBE_PULSE_BUFFER_SIZE) {
+
+    // Don't lose the counts, only the timestamp, by adding them to the overflow counter
+    _overflowCounts.store(_overflowCounts.load(std::memory_order_relaxed) + counts, std::memory_order_release);
+
+    return false;
+
+  }
+
+  // Write the pulse into the free slot
+  _pulses[head & (TUBE_PULSE_BUFFER_SIZE - 1)] = {timeMicroseconds, counts};
+
+  // Publish the pulse to the consumer
+  _head.store(head + 1, std::memory_order_release);
+
+  return true;
+
+}
+
+// ================================================================================================
+// Remove the oldest pulse from the buffer (consumer only)
+// ================================================================================================
+bool PulseBuffer::pop(Pulse &pulse) {
+
+  // Get the read index and the write index published by the producer
+  uint32_t tail = _tail.load(std::memory_order_relaxed);
+  uint32_t head = _head.load(std::memory_order_acquire);
+
+  // If the buffer is empty
+  if (tail == head) { return false; }
+
+  // Read the oldest pulse
+  pulse = _pulses[tail & (TUBE_PULSE_BUFFER_SIZE - 1)];
+
+  // Hand the slot back to the producer
+  _tail.store(tail + 1, std::memory_order_release);
+
+  return true;
+
+}
+
+// ================================================================================================
+// Get the running total of counts that did not fit into the buffer
+// ================================================================================================
+uint32_t PulseBuffer::getOverflowCounts() {
+
+  // This counter wraps around, only the difference between two readings is meaningful
+  return _overflowCounts.load(std::memory_order_acquire);
+
+}
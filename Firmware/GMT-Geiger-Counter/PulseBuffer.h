@@ -0,0 +1,47 @@
+#ifndef _PULSE_BUFFER_H
+#define _PULSE_BUFFER_H
+
+#include "Arduino.h"
+#include "Configuration.h"
+#include <atomic>
+
+// Single producer / single consumer lock-free ring buffer of timestamped pulses
+// The producer is a tube ISR, the consumer is the main loop
+class PulseBuffer {
+
+  // ----------------------------------------------------------------------------------------------
+  // Public
+
+  public:
+
+    // Pulse structure
+    struct Pulse {
+
+      uint32_t timeMicroseconds; // Time of the rising edge of the pulse in microseconds
+      uint32_t counts;           // Number of counts the pulse represents
+
+    };
+
+    // Constructor
+    PulseBuffer();
+
+    bool IRAM_ATTR push(const uint32_t timeMicroseconds, const uint32_t counts); // Add a pulse to the buffer (producer only)
+    bool           pop(Pulse &pulse);                                            // Remove the oldest pulse from the buffer (consumer only)
+    uint32_t       getOverflowCounts();                                          // Get the running total of counts that did not fit into the buffer
+
+  // ----------------------------------------------------------------------------------------------
+  // Private
+
+  private:
+
+    // The buffer size must be a power of 2 so that the indices can be wrapped with a mask
+    static_assert((TUBE_PULSE_BUFFER_SIZE & (TUBE_PULSE_BUFFER_SIZE - 1)) == 0, "TUBE_PULSE_BUFFER_SIZE must be a power of 2!");
+
+    Pulse                 _pulses[TUBE_PULSE_BUFFER_SIZE]; // Pulse storage
+    std::atomic<uint32_t> _head;                           // Write index, only modified by the producer
+    std::atomic<uint32_t> _tail;                           // Read index, only modified by the consumer
+    std::atomic<uint32_t> _overflowCounts;                 // Counts that did not fit into the buffer, only modified by the producer
+
+};
+
+#endif
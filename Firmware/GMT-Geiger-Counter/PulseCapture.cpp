@@ -0,0 +1,312 @@
+#include "PulseCapture.h"
+
+// ------------------------------------------------------------------------------------------------
+// Public
+
+// Initialize global reference
+PulseCapture& pulseCapture = PulseCapture::getInstance();
+
+// ================================================================================================
+// Get the single instance of the class
+// ================================================================================================
+PulseCapture& PulseCapture::getInstance() {
+
+  // Get the single instance
+  static PulseCapture instance;
+
+  // Return the instance
+  return instance;
+
+}
+
+// ================================================================================================
+// Initialize everything
+// ================================================================================================
+void PulseCapture::begin() {
+
+  // If not initialized
+  if (!_initialized) {
+
+    // Set initialization flag to true
+    _initialized = true;
+
+    // Initialize logger
+    logger.begin();
+
+    // Allocate the pulse storage in the PSRAM
+    // The tube ISRs are not registered as IRAM interrupts, so they never run while the flash cache, and with it the PSRAM, is disabled
+    _pulses = (Pulse*)heap_caps_malloc(PULSE_CAPTURE_BUFFER_SIZE * sizeof(Pulse), MALLOC_CAP_SPIRAM);
+
+    // If there is not enough PSRAM
+    if (_pulses == NULL) {
+
+      // Create event data
+      Logger::KeyValuePair event[2] = {
+
+        {"source", Logger::STRING_T, {.string_v = "pulseCapture"}},
+        {"action", Logger::STRING_T, {.string_v = "unavailable"} }
+
+      };
+
+      // Log event message
+      logger.log(Logger::EVENT, "event", event, 2);
+
+    }
+
+  }
+
+}
+
+// ================================================================================================
+// Stream the captured pulses over the serial interface and report dropped pulses
+// ================================================================================================
+void PulseCapture::update() {
+
+  // If the serial stream is enabled in the main configuration file
+  #if PULSE_CAPTURE_SERIAL == 1
+
+    // Frame buffer
+    uint8_t buffer[sizeof(FrameHeader) + PULSE_CAPTURE_FRAME_PULSES * sizeof(Pulse)];
+
+    // Send frames as long as they fit into the serial transmit buffer without blocking
+    // At least a frame header and 16 pulses have to fit, otherwise the frames would only ever hold a few pulses
+    for (int available = Serial.availableForWrite(); available >= (int)(sizeof(FrameHeader) + 16 * sizeof(Pulse)); available = Serial.availableForWrite()) {
+
+      // Get a frame that fits into the free space of the transmit buffer
+      size_t size = getFrame(buffer, min((size_t)available, sizeof(buffer)));
+
+      // If there are no more pulses, stop
+      if (size == 0) { break; }
+
+      // Send the frame and take its pulses out of the buffer
+      Serial.write(buffer, size);
+      removeFrame(size);
+
+    }
+
+  #endif
+
+  // Get the number of dropped pulses
+  uint32_t dropped = _dropped.load(std::memory_order_acquire);
+
+  // If pulses were dropped since the last report, the buffer is not emptied fast enough
+  // This is reported at most once per second, while pulses are dropped it would otherwise be reported on every loop
+  if (dropped != _reportedDropped && millis() - _reportTimer >= 1000) {
+
+    // Create event data
+    Logger::KeyValuePair event[3] = {
+
+      {"source",  Logger::STRING_T, {.string_v = "pulseCapture"}},
+      {"action",  Logger::STRING_T, {.string_v = "dropped"}     },
+      {"dropped", Logger::UINT32_T, {.uint32_v = dropped}       }
+
+    };
+
+    // Log event message
+    logger.log(Logger::EVENT, "event", event, 3);
+
+    // Remember the reported number of dropped pulses
+    _reportedDropped = dropped;
+
+    // Update the timer
+    _reportTimer = millis();
+
+  }
+
+}
+
+// ================================================================================================
+// Enable the pulse capture
+// ================================================================================================
+void PulseCapture::enable() {
+
+  // If not enabled and the pulse storage exists
+  if (!_enabled && _pulses != NULL) {
+
+    // Set the enabled flag to true
+    _enabled = true;
+
+    // Create event data
+    Logger::KeyValuePair event[2] = {
+
+      {"source", Logger::STRING_T, {.string_v = "pulseCapture"}},
+      {"action", Logger::STRING_T, {.string_v = "enabled"}     }
+
+    };
+
+    // Log event message
+    logger.log(Logger::EVENT, "event", event, 2);
+
+  }
+
+}
+
+// ================================================================================================
+// Disable the pulse capture
+// ================================================================================================
+void PulseCapture::disable() {
+
+  // If enabled
+  if (_enabled) {
+
+    // Set the enabled flag to false
+    // Pulses that are already in the buffer can still be taken out
+    _enabled = false;
+
+    // Create event data
+    Logger::KeyValuePair event[2] = {
+
+      {"source", Logger::STRING_T, {.string_v = "pulseCapture"}},
+      {"action", Logger::STRING_T, {.string_v = "disabled"}    }
+
+    };
+
+    // Log event message
+    logger.log(Logger::EVENT, "event", event, 2);
+
+  }
+
+}
+
+// ================================================================================================
+// Add a pulse to the buffer (ISR only)
+// ================================================================================================
+void IRAM_ATTR PulseCapture::capture(const Source source, const uint32_t startMicroseconds, const uint32_t widthMicroseconds, const uint32_t counts) {
+
+  // If not capturing, do nothing
+  if (!_enabled) { return; }
+
+  // Get the write index and the read index published by the main loop
+  uint32_t head = _head.load(std::memory_order_relaxed);
+  uint32_t tail = _tail.load(std::memory_order_acquire);
+
+  // If the buffer is full, drop the pulse and count it
+  if (head - tail >= PULSE_CAPTURE_BUFFER_SIZE) {
+
+    _dropped.store(_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+
+    return;
+
+  }
+
+  // Write the pulse into the free slot, clipping the values to their field sizes
+  _pulses[head & (PULSE_CAPTURE_BUFFER_SIZE - 1)] = {
+
+    startMicroseconds,
+    (uint16_t)(widthMicroseconds < UINT16_MAX ? widthMicroseconds : UINT16_MAX),
+    source,
+    (uint8_t)(counts < UINT8_MAX ? counts : UINT8_MAX)
+
+  };
+
+  // Publish the pulse to the main loop
+  _head.store(head + 1, std::memory_order_release);
+
+}
+
+// ================================================================================================
+// Copy the oldest pulses of the buffer into a binary frame
+// The pulses stay in the buffer until the frame was sent and removed, so a failed send can be repeated
+// ================================================================================================
+size_t PulseCapture::getFrame(uint8_t *buffer, const size_t size) {
+
+  // If there is no pulse storage or not even room for one pulse, there is no frame
+  if (_pulses == NULL || size < sizeof(FrameHeader) + sizeof(Pulse)) { return 0; }
+
+  // Get the read index and the write index published by the ISRs
+  uint32_t tail = _tail.load(std::memory_order_relaxed);
+  uint32_t head = _head.load(std::memory_order_acquire);
+
+  // Get the number of pulses that fit into the frame
+  uint32_t pulses = min(head - tail, (uint32_t)min((size - sizeof(FrameHeader)) / sizeof(Pulse), (size_t)PULSE_CAPTURE_FRAME_PULSES));
+
+  // If the buffer is empty, there is no frame
+  if (pulses == 0) { return 0; }
+
+  // Create the frame header
+  FrameHeader header = {PULSE_CAPTURE_FRAME_MAGIC, 1, (uint16_t)pulses, tail + pulses, _dropped.load(std::memory_order_acquire)};
+
+  // Copy the header into the frame
+  memcpy(buffer, &header, sizeof(FrameHeader));
+
+  // Copy the pulses into the frame, in up to two parts if they wrap around the end of the buffer
+  uint32_t start = tail & (PULSE_CAPTURE_BUFFER_SIZE - 1);
+  uint32_t first = min(pulses, (uint32_t)PULSE_CAPTURE_BUFFER_SIZE - start);
+
+  memcpy(buffer + sizeof(FrameHeader), &_pulses[start], first * sizeof(Pulse));
+  memcpy(buffer + sizeof(FrameHeader) + first * sizeof(Pulse), &_pulses[0], (pulses - first) * sizeof(Pulse));
+
+  return sizeof(FrameHeader) + pulses * sizeof(Pulse);
+
+}
+
+// ================================================================================================
+// Take the pulses of a sent frame out of the buffer
+// ================================================================================================
+void PulseCapture::removeFrame(const size_t size) {
+
+  // If it is not a frame, do nothing
+  if (size < sizeof(FrameHeader)) { return; }
+
+  // Hand the slots of the frame back to the ISRs
+  _tail.store(_tail.load(std::memory_order_relaxed) + (size - sizeof(FrameHeader)) / sizeof(Pulse), std::memory_order_release);
+
+}
+
+// ================================================================================================
+// Get the pulse capture state
+// ================================================================================================
+bool PulseCapture::getState() {
+
+  return _enabled;
+
+}
+
+// ================================================================================================
+// Get the running total of captured pulses
+// ================================================================================================
+uint32_t PulseCapture::getCaptured() {
+
+  // This counter wraps around, only the difference between two readings is meaningful
+  return _head.load(std::memory_order_acquire);
+
+}
+
+// ================================================================================================
+// Get the running total of dropped pulses
+// ================================================================================================
+uint32_t PulseCapture::getDropped() {
+
+  // This counter wraps around, only the difference between two readings is meaningful
+  return _dropped.load(std::memory_order_acquire);
+
+}
+
+// ================================================================================================
+// Get the number of pulses waiting in the buffer
+// ================================================================================================
+uint32_t PulseCapture::getBuffered() {
+
+  return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_relaxed);
+
+}
+
+// ------------------------------------------------------------------------------------------------
+// Private
+
+// ================================================================================================
+// Constructor
+// ================================================================================================
+PulseCapture::PulseCapture():
+
+  // Initialize members
+  _initialized(false),
+  _enabled(false),
+  _pulses(NULL),
+  _head(0),
+  _tail(0),
+  _dropped(0),
+  _reportedDropped(0),
+  _reportTimer(0)
+
+{}
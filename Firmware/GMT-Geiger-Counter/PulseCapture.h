@@ -0,0 +1,92 @@
+#ifndef _PULSE_CAPTURE_H
+#define _PULSE_CAPTURE_H
+
+#include "Arduino.h"
+#include "Configuration.h"
+#include "Logger.h"
+#include <atomic>
+
+// Records every pulse the tube ISRs see into a ring buffer in the PSRAM and hands them out as compact binary frames
+// All tube ISRs are dispatched by the same GPIO interrupt handler, so there is only ever one producer at a time
+// There must only ever be one consumer as well, either the serial stream or /data/pulses
+class PulseCapture {
+
+  // ----------------------------------------------------------------------------------------------
+  // Public
+
+  public:
+
+    // Pulse source enumerator
+    enum Source : uint8_t {
+
+      MAIN_TUBE,
+      FOLLOWER_TUBE,
+      COINCIDENCE_TUBE
+
+    };
+
+    // Captured pulse structure (8 bytes, little-endian)
+    struct __attribute__((packed)) Pulse {
+
+      uint32_t startMicroseconds; // Time of the rising edge in microseconds
+      uint16_t widthMicroseconds; // Length of the pulse in microseconds, clipped to 65535
+      uint8_t  source;            // Tube the pulse was recorded on
+      uint8_t  counts;            // Number of counts the pulse was counted as, 0 if it was rejected as noise
+
+    };
+
+    // Binary frame header structure (16 bytes, little-endian), followed by the pulses of the frame
+    struct __attribute__((packed)) FrameHeader {
+
+      uint32_t magic;    // Frame magic value
+      uint16_t version;  // Frame format version
+      uint16_t pulses;   // Number of pulses in the frame
+      uint32_t captured; // Running total of captured pulses, including the ones in this frame
+      uint32_t dropped;  // Running total of pulses that did not fit into the buffer
+
+    };
+
+    // Get the single instance of the class
+    static PulseCapture& getInstance();
+
+    void           begin();                                                                                                      // Initialize everything
+    void           update();                                                                                                     // Stream the captured pulses over the serial interface and report dropped pulses
+    void           enable();                                                                                                     // Enable the pulse capture
+    void           disable();                                                                                                    // Disable the pulse capture
+    void IRAM_ATTR capture(const Source source, const uint32_t startMicroseconds, const uint32_t widthMicroseconds, const uint32_t counts); // Add a pulse to the buffer (ISR only)
+    size_t         getFrame(uint8_t *buffer, const size_t size);                                                                 // Copy the oldest pulses of the buffer into a binary frame
+    void           removeFrame(const size_t size);                                                                               // Take the pulses of a sent frame out of the buffer
+    bool           getState();                                                                                                   // Get the pulse capture state
+    uint32_t       getCaptured();                                                                                                // Get the running total of captured pulses
+    uint32_t       getDropped();                                                                                                 // Get the running total of dropped pulses
+    uint32_t       getBuffered();                                                                                                // Get the number of pulses waiting in the buffer
+
+  // ----------------------------------------------------------------------------------------------
+  // Private
+
+  private:
+
+    // Prevent direct instantiation
+    PulseCapture();
+    PulseCapture(const PulseCapture&) = delete;
+    PulseCapture& operator=(const PulseCapture&) = delete;
+
+    // The buffer size must be a power of 2 so that the indices can be wrapped with a mask
+    static_assert((PULSE_CAPTURE_BUFFER_SIZE & (PULSE_CAPTURE_BUFFER_SIZE - 1)) == 0, "PULSE_CAPTURE_BUFFER_SIZE must be a power of 2!");
+    static_assert(sizeof(Pulse) == 8 && sizeof(FrameHeader) == 16, "Unexpected pulse capture frame layout!");
+
+    bool                  _initialized;     // Flag for checking if the pulse capture is initialized
+    volatile bool         _enabled;         // Flag for checking if the pulse capture is enabled
+    Pulse                 *_pulses;         // Pulse storage in the PSRAM
+    std::atomic<uint32_t> _head;            // Write index, only modified by the ISRs, this is also the running total of captured pulses
+    std::atomic<uint32_t> _tail;            // Read index, only modified by the consumer
+    std::atomic<uint32_t> _dropped;         // Pulses that did not fit into the buffer, only modified by the ISRs
+    uint32_t              _reportedDropped; // Dropped pulses at the last report
+    uint64_t              _reportTimer;     // Timer for reporting dropped pulses
+
+};
+
+// Global reference to the pulse capture instance for easy access
+extern PulseCapture& pulseCapture;
+
+#endif
@@ -0,0 +1,299 @@
+#include "PulseSimulator.h"
+
+// ------------------------------------------------------------------------------------------------
+// Public
+
+// Initialize global reference
+PulseSimulator& pulseSimulator = PulseSimulator::getInstance();
+
+// ================================================================================================
+// Get the single instance of the class
+// ================================================================================================
+PulseSimulator& PulseSimulator::getInstance() {
+
+  // Get the single instance
+  static PulseSimulator instance;
+
+  // Return the instance
+  return instance;
+
+}
+
+// ================================================================================================
+// Initialize everything
+// ================================================================================================
+void PulseSimulator::begin() {
+
+  // If not initialized
+  if (!_initialized) {
+
+    // Set initialization flag to true
+    _initialized = true;
+
+    // Initialize logger
+    logger.begin();
+
+    // Initialize the Geiger counter so that the tube pin is set up before it is taken over
+    geigerCounter.begin();
+
+    // Drive the tube pin as an output
+    // On the ESP32 an output pin keeps its input path enabled, so the tube ISR still sees every edge
+    pinMode(PULSE_SIMULATOR_PIN, OUTPUT);
+    digitalWrite(PULSE_SIMULATOR_PIN, LOW);
+
+  }
+
+}
+
+// ================================================================================================
+// Enable the pulse simulator
+// ================================================================================================
+void PulseSimulator::enable() {
+
+  // If not enabled
+  if (!_enabled) {
+
+    // Reset the benchmark counters
+    _lastGeneratedPulses = _generatedPulses;
+    _lastCountedPulses   = geigerCounter.getCounts();
+    _lastLogMicroseconds = esp_timer_get_time();
+
+    // Start the pulse generator task on the core that is not running the tube ISRs
+    xTaskCreatePinnedToCore(_generatePulses, "pulseSimulator", 2048, this, 1, &_task, PULSE_SIMULATOR_CORE);
+
+    // Set the enabled flag to true
+    _enabled = true;
+
+    // Create event data
+    Logger::KeyValuePair event[2] = {
+
+      {"source", Logger::STRING_T, {.string_v = "pulseSimulator"}},
+      {"action", Logger::STRING_T, {.string_v = "enabled"}       }
+
+    };
+
+    // Log event message
+    logger.log(Logger::EVENT, "event", event, 2);
+
+  }
+
+}
+
+// ================================================================================================
+// Disable the pulse simulator
+// ================================================================================================
+void PulseSimulator::disable() {
+
+  // If enabled
+  if (_enabled) {
+
+    // Stop the pulse generator task
+    vTaskDelete(_task);
+
+    // Clear the task handle
+    _task = NULL;
+
+    // The task might have been stopped in the middle of a pulse, pull the pin low again
+    digitalWrite(PULSE_SIMULATOR_PIN, LOW);
+
+    // Set the enabled flag to false
+    _enabled = false;
+
+    // Create event data
+    Logger::KeyValuePair event[2] = {
+
+      {"source", Logger::STRING_T, {.string_v = "pulseSimulator"}},
+      {"action", Logger::STRING_T, {.string_v = "disabled"}      }
+
+    };
+
+    // Log event message
+    logger.log(Logger::EVENT, "event", event, 2);
+
+  }
+
+}
+
+// ================================================================================================
+// Log the benchmark results since the last call
+// ================================================================================================
+void PulseSimulator::log() {
+
+  // If enabled
+  if (_enabled) {
+
+    // Get the current time and the totals of generated and counted pulses
+    uint64_t nowMicroseconds = esp_timer_get_time();
+    uint32_t generated       = _generatedPulses;
+    uint64_t counted         = geigerCounter.getCounts();
+
+    // Calculate the elapsed time in seconds since the last log
+    double elapsedSeconds = (nowMicroseconds - _lastLogMicroseconds) / 1000000.0;
+
+    // Calculate the number of generated and counted pulses since the last log
+    // The 32 bit generated pulse counter is allowed to wrap around between logs
+    uint64_t generatedDelta = (uint32_t)(generated - _lastGeneratedPulses);
+    uint64_t countedDelta   = counted   - _lastCountedPulses;
+
+    // Calculate the generated and counted rates in pulses per second
+    double generatedPerSecond = (elapsedSeconds > 0.0) ? generatedDelta / elapsedSeconds : 0.0;
+    double countedPerSecond   = (elapsedSeconds > 0.0) ? countedDelta   / elapsedSeconds : 0.0;
+
+    // Calculate the number of pulses the counting path has missed
+    uint64_t lost = (generatedDelta > countedDelta) ? generatedDelta - countedDelta : 0;
+
+    // Measure the average time it takes to get the counts per minute for every integration time from 1 to 60 seconds
+    // Accumulate the results so the compiler can't skip the calls
+    volatile double countsPerMinuteSum      = 0.0;
+    uint64_t        windowStartMicroseconds = esp_timer_get_time();
+
+    for (uint8_t timeSeconds = 1; timeSeconds <= 60; timeSeconds++) { countsPerMinuteSum = countsPerMinuteSum + geigerCounter.getCountsPerMinute(timeSeconds); }
+
+    double windowMicroseconds = (esp_timer_get_time() - windowStartMicroseconds) / 60.0;
+
+    // Get data
+    Logger::KeyValuePair data[8] = {
+
+      {"rate",                    Logger::UINT32_T, {.uint32_v = getRate()}                                },
+      {"generated",               Logger::UINT64_T, {.uint64_v = generatedDelta}                           },
+      {"counted",                 Logger::UINT64_T, {.uint64_v = countedDelta}                             },
+      {"lost",                    Logger::UINT64_T, {.uint64_v = lost}                                     },
+      {"countedPerSecond",        Logger::DOUBLE_T, {.double_v = countedPerSecond}                         },
+      {"expectedCountsPerMinute", Logger::DOUBLE_T, {.double_v = generatedPerSecond * 60.0}                },
+      {"countsPerMinute",         Logger::DOUBLE_T, {.double_v = geigerCounter.getCountsPerMinute(60)}     },
+      {"windowMicroseconds",      Logger::DOUBLE_T, {.double_v = windowMicroseconds}                       }
+
+    };
+
+    // Log data
+    logger.log(Logger::DATA, "pulseSimulator", data, 8);
+
+    // Update the benchmark counters
+    _lastGeneratedPulses = generated;
+    _lastCountedPulses   = counted;
+    _lastLogMicroseconds = nowMicroseconds;
+
+  }
+
+}
+
+// ================================================================================================
+// Get the pulse simulator state
+// ================================================================================================
+bool PulseSimulator::getState() {
+
+  return _enabled;
+
+}
+
+// ================================================================================================
+// Get the configured average rate in pulses per second
+// ================================================================================================
+uint32_t PulseSimulator::getRate() {
+
+  return PULSE_SIMULATOR_RATE_CPS;
+
+}
+
+// ================================================================================================
+// Get the total number of generated pulses
+// ================================================================================================
+uint32_t PulseSimulator::getGeneratedPulses() {
+
+  return _generatedPulses;
+
+}
+
+// ------------------------------------------------------------------------------------------------
+// Private
+
+// ================================================================================================
+// Constructor
+// ================================================================================================
+PulseSimulator::PulseSimulator():
+
+  // Initialize members
+  _initialized(false),
+  _enabled(false),
+  _task(NULL),
+  _generatedPulses(0),
+  _lastGeneratedPulses(0),
+  _lastCountedPulses(0),
+  _lastLogMicroseconds(0)
+
+{}
+
+// ================================================================================================
+// Get a Poisson distributed interval until the next pulse
+// ================================================================================================
+uint32_t PulseSimulator::_getInterval() {
+
+  // Get a uniformly distributed random number in the range (0, 1]
+  double uniform = ((double)esp_random() + 1.0) / 4294967296.0;
+
+  // The intervals of a Poisson process are exponentially distributed with the mean 1 / rate
+  return (uint32_t)(-::log(uniform) * (1000000.0 / PULSE_SIMULATOR_RATE_CPS));
+
+}
+
+// ================================================================================================
+// Task for generating the pulse train
+// ================================================================================================
+void PulseSimulator::_generatePulses(void *instancePointer) {
+
+  // Cast the generic instance pointer back to a instance pointer of type PulseSimulator
+  PulseSimulator *instance = (PulseSimulator*)instancePointer;
+
+  // Time of the next pulse and the last time the task gave up the core
+  int64_t nextPulseMicroseconds = esp_timer_get_time();
+  int64_t lastYieldMicroseconds = nextPulseMicroseconds;
+
+  // Generate pulses forever until the task is deleted
+  for (;;) {
+
+    // Schedule the next pulse
+    nextPulseMicroseconds += instance->_getInterval();
+
+    // Wait until the next pulse is due
+    while (esp_timer_get_time() < nextPulseMicroseconds) {
+
+      // If the wait is long enough, sleep instead of spinning
+      if (nextPulseMicroseconds - esp_timer_get_time() > 2000) {
+
+        vTaskDelay(1);
+
+        lastYieldMicroseconds = esp_timer_get_time();
+
+      }
+
+    }
+
+    // At high rates the task never sleeps, so give the idle task a chance regularly to keep the task watchdog happy
+    if (esp_timer_get_time() - lastYieldMicroseconds >= 100000) {
+
+      vTaskDelay(1);
+
+      lastYieldMicroseconds = esp_timer_get_time();
+
+    }
+
+    // Generate a single pulse just like the tube driver board would
+    // Pulses closer together than the pulse length are delayed, the same way the driver board's one-shot behaves
+    digitalWrite(PULSE_SIMULATOR_PIN, HIGH);
+    delayMicroseconds(PULSE_SIMULATOR_PULSE_LENGTH_MICROSECONDS);
+    digitalWrite(PULSE_SIMULATOR_PIN, LOW);
+
+    // Count the generated pulse
+    instance->_generatedPulses++;
+
+    // The next pulse is scheduled from when this pulse was due, not from when it ended, otherwise every interval would be stretched by the pulse length
+    // Only if the pulse train fell far behind schedule, e.g. because the task didn't get the core for a while, continue from now instead of catching up with a burst of pulses
+    if (esp_timer_get_time() - nextPulseMicroseconds > 100000) {
+
+      nextPulseMicroseconds = esp_timer_get_time();
+
+    }
+
+  }
+
+}
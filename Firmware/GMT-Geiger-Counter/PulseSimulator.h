@@ -0,0 +1,55 @@
+#ifndef _PULSE_SIMULATOR_H
+#define _PULSE_SIMULATOR_H
+
+#include "Arduino.h"
+#include "Configuration.h"
+#include "Logger.h"
+#include "GeigerCounter.h"
+
+class PulseSimulator {
+
+  // ----------------------------------------------------------------------------------------------
+  // Public
+
+  public:
+
+    // Get the single instance of the class
+    static PulseSimulator& getInstance();
+
+    void     begin();                // Initialize everything
+    void     enable();               // Enable the pulse simulator
+    void     disable();              // Disable the pulse simulator
+    void     log();                  // Log the benchmark results since the last call
+    bool     getState();             // Get the pulse simulator state
+    uint32_t getRate();              // Get the configured average rate in pulses per second
+    uint32_t getGeneratedPulses();   // Get the total number of generated pulses
+
+  // ----------------------------------------------------------------------------------------------
+  // Private
+
+  private:
+
+    // Prevent direct instantiation
+    PulseSimulator();
+    PulseSimulator(const PulseSimulator&) = delete;
+    PulseSimulator& operator=(const PulseSimulator&) = delete;
+
+    bool              _initialized;               // Flag for checking if the pulse simulator is initialized
+    bool              _enabled;                   // Flag for checking if the pulse simulator is enabled
+    TaskHandle_t      _task;                      // Handle of the pulse generator task
+    volatile uint32_t _generatedPulses;           // Total number of generated pulses (32 bit so it can be read atomically from the other core)
+    uint32_t          _lastGeneratedPulses;       // Number of generated pulses at the last log
+    uint64_t          _lastCountedPulses;         // Number of counted pulses at the last log
+    uint64_t          _lastLogMicroseconds;       // Time of the last log in microseconds
+
+    uint32_t _getInterval(); // Get a Poisson distributed interval until the next pulse
+
+    // Task for generating the pulse train
+    static void _generatePulses(void *instancePointer);
+
+};
+
+// Global reference to the pulse simulator instance for easy access
+extern PulseSimulator& pulseSimulator;
+
+#endif
@@ -0,0 +1,243 @@
+#include "RadiationHistory.h"
+
+// ------------------------------------------------------------------------------------------------
+// Public
+
+// ================================================================================================
+// Constructor
+// ================================================================================================
+RadiationHistory::RadiationHistory():
+
+  // Initialize members
+  _buckets{_archive.seconds, _archive.minutes, _archive.hours, _archive.days},
+  _lengths{RADIATION_HISTORY_SECONDS, RADIATION_HISTORY_MINUTES, RADIATION_HISTORY_HOURS, RADIATION_HISTORY_DAYS},
+  _samples{1, 60, 60, 24}
+
+{
+
+  // Start with an empty history
+  clear();
+
+}
+
+// ================================================================================================
+// Clear all buckets
+// ================================================================================================
+void RadiationHistory::clear() {
+
+  // For every resolution
+  for (uint8_t resolution = SECONDS; resolution <= DAYS; resolution++) {
+
+    // Set every bucket to an impossibly high value marking it as cleared
+    for (uint16_t bucket = 0; bucket < _lengths[resolution]; bucket++) { _buckets[resolution][bucket] = {UINT32_MAX, UINT32_MAX, UINT32_MAX}; }
+
+    // Reset the index and the bucket that is being recorded
+    _archive.indices[resolution]        = 0;
+    _archive.consolidations[resolution] = {UINT32_MAX, 0, 0, 0, 0};
+
+  }
+
+}
+
+// ================================================================================================
+// Add a one second counts per minute sample
+// ================================================================================================
+void RadiationHistory::add(const uint32_t countsPerMinute) {
+
+  // A one second bucket only holds a single sample
+  _addBucket(SECONDS, {countsPerMinute, countsPerMinute, countsPerMinute});
+
+}
+
+// ================================================================================================
+// Add a number of seconds without samples
+// ================================================================================================
+void RadiationHistory::addGap(const uint32_t seconds) {
+
+  _addGap(SECONDS, seconds);
+
+}
+
+// ================================================================================================
+// Get a pointer to the bucket array of a resolution
+// ================================================================================================
+const RadiationHistory::Bucket* RadiationHistory::getBuckets(const Resolution resolution) {
+
+  return _buckets[resolution];
+
+}
+
+// ================================================================================================
+// Get a bucket by its age, 0 being the latest bucket
+// ================================================================================================
+const RadiationHistory::Bucket& RadiationHistory::getBucket(const Resolution resolution, const uint16_t age) {
+
+  // Calculate a wrapped index going back from the latest bucket, if it underflows wrap to the end of the array
+  uint16_t wrappedIndex = (_archive.indices[resolution] + _lengths[resolution] - 1 - (age % _lengths[resolution])) % _lengths[resolution];
+
+  return _buckets[resolution][wrappedIndex];
+
+}
+
+// ================================================================================================
+// Get the number of buckets of a resolution
+// ================================================================================================
+uint16_t RadiationHistory::getLength(const Resolution resolution) {
+
+  return _lengths[resolution];
+
+}
+
+// ================================================================================================
+// Get the index of the next bucket of a resolution, which is also the oldest bucket
+// ================================================================================================
+uint16_t RadiationHistory::getIndex(const Resolution resolution) {
+
+  return _archive.indices[resolution];
+
+}
+
+// ================================================================================================
+// Get the number of seconds a bucket of a resolution spans
+// ================================================================================================
+uint32_t RadiationHistory::getIntervalSeconds(const Resolution resolution) {
+
+  // Multiply the number of consolidated samples of every resolution up to this one
+  uint32_t intervalSeconds = 1;
+
+  for (uint8_t i = SECONDS; i <= resolution; i++) { intervalSeconds *= _samples[i]; }
+
+  return intervalSeconds;
+
+}
+
+// ================================================================================================
+// Get the archive holding the complete state of the history
+// ================================================================================================
+RadiationHistory::Archive& RadiationHistory::getArchive() {
+
+  return _archive;
+
+}
+
+// ================================================================================================
+// Check if the archive is consistent, e.g. after restoring it
+// ================================================================================================
+bool RadiationHistory::isValid() {
+
+  // For every resolution
+  for (uint8_t resolution = SECONDS; resolution <= DAYS; resolution++) {
+
+    // Get the bucket that is being recorded
+    const Consolidation &consolidation = _archive.consolidations[resolution];
+
+    // The index must be inside the bucket array, the bucket that is being recorded can't be complete and can't have more recorded samples than samples
+    if (_archive.indices[resolution] >= _lengths[resolution] || consolidation.samples >= _samples[resolution] || consolidation.recorded > consolidation.samples) { return false; }
+
+  }
+
+  return true;
+
+}
+
+// ------------------------------------------------------------------------------------------------
+// Private
+
+// ================================================================================================
+// Add a bucket to a resolution and consolidate it into the next resolution
+// ================================================================================================
+void RadiationHistory::_addBucket(const Resolution resolution, const Bucket &bucket) {
+
+  // Write the bucket to the array and set the index to the next bucket
+  _buckets[resolution][_archive.indices[resolution]] = bucket;
+  _archive.indices[resolution]                       = (_archive.indices[resolution] + 1) % _lengths[resolution];
+
+  // If there is no coarser resolution, there is nothing to consolidate
+  if (resolution == DAYS) { return; }
+
+  // Get the bucket of the next resolution that is being recorded
+  Resolution    next           = (Resolution)(resolution + 1);
+  Consolidation &consolidation = _archive.consolidations[next];
+
+  // If the bucket was recorded, consolidate it into it
+  if (bucket.mean != UINT32_MAX) {
+
+    if (bucket.minimum < consolidation.minimum) { consolidation.minimum = bucket.minimum; }
+    if (bucket.maximum > consolidation.maximum) { consolidation.maximum = bucket.maximum; }
+
+    consolidation.sum += bucket.mean;
+    consolidation.recorded++;
+
+  }
+
+  // Count the bucket either way, the bucket of the next resolution spans a fixed time
+  consolidation.samples++;
+
+  // If the bucket of the next resolution is complete
+  if (consolidation.samples >= _samples[next]) {
+
+    // If nothing in it was recorded, it is part of a gap
+    Bucket consolidated = {UINT32_MAX, UINT32_MAX, UINT32_MAX};
+
+    // Otherwise every consolidated bucket spans the same time, so the mean of the recorded means is the mean of the recorded part of the bucket
+    if (consolidation.recorded > 0) { consolidated = {consolidation.minimum, consolidation.maximum, (uint32_t)((consolidation.sum + consolidation.recorded / 2) / consolidation.recorded)}; }
+
+    // The extremes of a one minute bucket are its mean, the one second samples it is made of are too noisy to be extremes
+    if (next == MINUTES) { consolidated.minimum = consolidated.mean; consolidated.maximum = consolidated.mean; }
+
+    // Start recording the next bucket
+    consolidation = {UINT32_MAX, 0, 0, 0, 0};
+
+    // Add the completed bucket to the next resolution
+    _addBucket(next, consolidated);
+
+  }
+
+}
+
+// ================================================================================================
+// Add a number of buckets that were not recorded to a resolution
+// ================================================================================================
+void RadiationHistory::_addGap(const Resolution resolution, const uint32_t buckets) {
+
+  // Not recorded bucket
+  const Bucket gap = {UINT32_MAX, UINT32_MAX, UINT32_MAX};
+
+  // The coarsest resolution has nothing to consolidate into, more gap buckets than it holds would only overwrite each other
+  if (resolution == DAYS) {
+
+    for (uint32_t i = 0; i < min(buckets, (uint32_t)_lengths[DAYS]); i++) { _addBucket(DAYS, gap); }
+
+    return;
+
+  }
+
+  // Get the bucket of the next resolution that is being recorded
+  Resolution    next           = (Resolution)(resolution + 1);
+  Consolidation &consolidation = _archive.consolidations[next];
+
+  // Gap buckets left to add
+  uint32_t left = buckets;
+
+  // Add gap buckets one by one until the bucket of the next resolution that is being recorded is complete
+  while (left > 0 && consolidation.samples > 0) { _addBucket(resolution, gap); left--; }
+
+  // The rest of the gap covers whole buckets of the next resolution and a remainder
+  uint32_t whole     = left / _samples[next];
+  uint32_t remainder = left % _samples[next];
+
+  // Mark the whole buckets as gap buckets in this resolution, no more than it holds, without consolidating them one by one
+  for (uint32_t i = 0; i < min(whole * _samples[next], (uint32_t)_lengths[resolution]); i++) {
+
+    _buckets[resolution][_archive.indices[resolution]] = gap;
+    _archive.indices[resolution]                       = (_archive.indices[resolution] + 1) % _lengths[resolution];
+
+  }
+
+  // Add the whole buckets to the next resolution in one go
+  _addGap(next, whole);
+
+  // Add the remainder one by one, it starts the next bucket of the next resolution
+  for (uint32_t i = 0; i < remainder; i++) { _addBucket(resolution, gap); }
+
+}
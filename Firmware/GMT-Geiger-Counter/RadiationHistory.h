@@ -0,0 +1,94 @@
+#ifndef _RADIATION_HISTORY_H
+#define _RADIATION_HISTORY_H
+
+#include "Arduino.h"
+#include "Configuration.h"
+
+// Round-robin archive of counts per minute values in multiple resolutions
+// Every one second sample is consolidated incrementally into minutes, hours and days, keeping the minimum, maximum and mean of each bucket
+// A one second sample is far too noisy to be an extreme, so the minimum and maximum of the coarser buckets are the extremes of the one minute means in them
+// Time without samples, e.g. while the Geiger counter is disabled, is added as a gap of buckets that were not recorded
+class RadiationHistory {
+
+  // ----------------------------------------------------------------------------------------------
+  // Public
+
+  public:
+
+    // History resolution enumerator
+    enum Resolution {
+
+      SECONDS,
+      MINUTES,
+      HOURS,
+      DAYS
+
+    };
+
+    // History bucket structure
+    // A bucket with a mean of UINT32_MAX has not been recorded, either not yet or because of a gap
+    struct Bucket {
+
+      uint32_t minimum; // Minimum counts per minute value in the bucket
+      uint32_t maximum; // Maximum counts per minute value in the bucket
+      uint32_t mean;    // Mean counts per minute value of the bucket
+
+    };
+
+    // Consolidation structure for the bucket that is currently being recorded
+    struct Consolidation {
+
+      uint32_t minimum;  // Minimum counts per minute value so far
+      uint32_t maximum;  // Maximum counts per minute value so far
+      uint64_t sum;      // Sum of the mean values so far
+      uint16_t samples;  // Number of samples so far, including the ones that were not recorded
+      uint16_t recorded; // Number of recorded samples so far
+
+    };
+
+    // Archive structure holding the complete state of the history
+    // This is a plain block of memory, so it can be saved and restored as a whole
+    struct Archive {
+
+      Bucket        seconds[RADIATION_HISTORY_SECONDS]; // One second buckets
+      Bucket        minutes[RADIATION_HISTORY_MINUTES]; // One minute buckets
+      Bucket        hours[RADIATION_HISTORY_HOURS];     // One hour buckets
+      Bucket        days[RADIATION_HISTORY_DAYS];       // One day buckets
+      uint16_t      indices[4];                         // Index of the next bucket of every resolution
+      Consolidation consolidations[4];                  // Bucket that is currently being recorded for every resolution
+
+    };
+
+    // Constructor
+    RadiationHistory();
+
+    void          clear();                                                    // Clear all buckets
+    void          add(const uint32_t countsPerMinute);                        // Add a one second counts per minute sample
+    void          addGap(const uint32_t seconds);                             // Add a number of seconds without samples
+    const Bucket* getBuckets(const Resolution resolution);                    // Get a pointer to the bucket array of a resolution
+    const Bucket& getBucket(const Resolution resolution, const uint16_t age); // Get a bucket by its age, 0 being the latest bucket
+    uint16_t      getLength(const Resolution resolution);                     // Get the number of buckets of a resolution
+    uint16_t      getIndex(const Resolution resolution);                      // Get the index of the next bucket of a resolution, which is also the oldest bucket
+    uint32_t      getIntervalSeconds(const Resolution resolution);            // Get the number of seconds a bucket of a resolution spans
+    Archive&      getArchive();                                               // Get the archive holding the complete state of the history
+    bool          isValid();                                                  // Check if the archive is consistent, e.g. after restoring it
+
+  // ----------------------------------------------------------------------------------------------
+  // Private
+
+  private:
+
+    // The radiation history screen shows the latest minutes, so there must be at least as many
+    static_assert(RADIATION_HISTORY_LENGTH_MINUTES <= RADIATION_HISTORY_MINUTES, "RADIATION_HISTORY_LENGTH_MINUTES can't be larger than RADIATION_HISTORY_MINUTES!");
+
+    Archive  _archive;     // Complete state of the history
+    Bucket   *_buckets[4]; // Bucket arrays of every resolution
+    uint16_t _lengths[4];  // Number of buckets of every resolution
+    uint16_t _samples[4];  // Number of buckets of the previous resolution consolidated into one bucket
+
+    void _addBucket(const Resolution resolution, const Bucket &bucket); // Add a bucket to a resolution and consolidate it into the next resolution
+    void _addGap(const Resolution resolution, const uint32_t buckets);  // Add a number of buckets that were not recorded to a resolution
+
+};
+
+#endif
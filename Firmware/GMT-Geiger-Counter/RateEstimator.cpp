@@ -0,0 +1,150 @@
+#include "RateEstimator.h"
+
+// ------------------------------------------------------------------------------------------------
+// Public
+
+// ================================================================================================
+// Constructor
+// ================================================================================================
+RateEstimator::RateEstimator():
+
+  // Initialize members
+  _changes(0)
+
+{
+
+  // Start without any samples
+  clear();
+
+}
+
+// ================================================================================================
+// Forget all samples
+// ================================================================================================
+void RateEstimator::clear() {
+
+  // Reset the filter
+  _rate     = 0;
+  _variance = 0;
+  _samples  = 0;
+
+  // Reset the change point detector
+  _increaseSum    = 0;
+  _decreaseSum    = 0;
+  _increaseCounts = 0;
+  _decreaseCounts = 0;
+  _increaseLength = 0;
+  _decreaseLength = 0;
+
+}
+
+// ================================================================================================
+// Add the counts of one second
+// ================================================================================================
+void RateEstimator::add(const uint32_t counts) {
+
+  // Current rate estimate, kept above the minimum so the Poisson statistics below stay defined
+  double rate = max(_rate, (double)ESTIMATOR_MINIMUM_RATE_CPS);
+
+  // Add the log-likelihood ratio of the counts for the rate having increased or decreased by the change ratio
+  // Each statistic is reset to zero when it becomes negative, so it only grows while the counts keep pointing to a change
+  _increaseSum += counts * log(ESTIMATOR_CHANGE_RATIO) - rate * (ESTIMATOR_CHANGE_RATIO - 1.0);
+  _decreaseSum += rate * (1.0 - 1.0 / ESTIMATOR_CHANGE_RATIO) - counts * log(ESTIMATOR_CHANGE_RATIO);
+
+  // Keep track of the counts since each statistic was last zero, this is where the change most likely happened
+  if (_increaseSum > 0) { _increaseCounts += counts; _increaseLength++; } else { _increaseSum = 0; _increaseCounts = 0; _increaseLength = 0; }
+  if (_decreaseSum > 0) { _decreaseCounts += counts; _decreaseLength++; } else { _decreaseSum = 0; _decreaseCounts = 0; _decreaseLength = 0; }
+
+  // If the count rate changed, restart the filter from the counts since the change
+  if (_increaseSum > ESTIMATOR_CHANGE_THRESHOLD) { _restart(_increaseCounts, _increaseLength); return; }
+  if (_decreaseSum > ESTIMATOR_CHANGE_THRESHOLD) { _restart(_decreaseCounts, _decreaseLength); return; }
+
+  // Increase the number of samples since the filter was restarted
+  if (_samples < UINT16_MAX) { _samples++; }
+
+  // Predict, the true count rate may have drifted by the process noise
+  double variance = _variance + ESTIMATOR_PROCESS_NOISE * rate;
+
+  // Kalman gain, the variance of Poisson distributed counts equals their rate
+  double gain = variance / (variance + rate);
+
+  // Never trust the estimate more than the plain average of the samples since the restart
+  // Right after a restart the filter is just the average of all samples, until it reaches its steady state
+  if (gain < 1.0 / _samples) {
+
+    gain      = 1.0 / _samples;
+    _rate    += gain * (counts - _rate);
+    _variance = max(_rate, (double)ESTIMATOR_MINIMUM_RATE_CPS) / _samples;
+
+  } else {
+
+    _rate    += gain * (counts - _rate);
+    _variance = (1.0 - gain) * variance;
+
+  }
+
+}
+
+// ================================================================================================
+// Get the estimated count rate in counts per second
+// ================================================================================================
+double RateEstimator::getCountsPerSecond() {
+
+  return _rate;
+
+}
+
+// ================================================================================================
+// Get the half width of the 95% confidence interval in counts per second
+// ================================================================================================
+double RateEstimator::getConfidenceCountsPerSecond() {
+
+  return 1.96 * sqrt(_variance);
+
+}
+
+// ================================================================================================
+// Get the fixed integration time in seconds the estimate is currently equivalent to
+// ================================================================================================
+uint8_t RateEstimator::getIntegrationTime() {
+
+  // If there are no samples yet
+  if (_variance <= 0) { return 1; }
+
+  // An average over n seconds of Poisson distributed counts has a variance of rate / n
+  double seconds = max(_rate, (double)ESTIMATOR_MINIMUM_RATE_CPS) / _variance;
+
+  // Round and clip to the length of the moving average
+  return (uint8_t)constrain(seconds + 0.5, 1.0, 60.0);
+
+}
+
+// ================================================================================================
+// Get the number of changes that restarted the filter
+// ================================================================================================
+uint32_t RateEstimator::getChanges() {
+
+  return _changes;
+
+}
+
+// ------------------------------------------------------------------------------------------------
+// Private
+
+// ================================================================================================
+// Restart the filter from the counts recorded since a change
+// ================================================================================================
+void RateEstimator::_restart(const uint32_t counts, const uint16_t length) {
+
+  // Forget everything before the change
+  clear();
+
+  // The average of the samples since the change is the new estimate
+  _samples  = length;
+  _rate     = (double)counts / length;
+  _variance = max(_rate, (double)ESTIMATOR_MINIMUM_RATE_CPS) / length;
+
+  // Increase the number of changes
+  _changes++;
+
+}
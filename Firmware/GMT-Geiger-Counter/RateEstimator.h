@@ -0,0 +1,46 @@
+#ifndef _RATE_ESTIMATOR_H
+#define _RATE_ESTIMATOR_H
+
+#include "Arduino.h"
+#include "Configuration.h"
+
+// Poisson-aware Kalman filter estimating the count rate from the counts of every second
+// A two-sided CUSUM detector on the Poisson log-likelihood ratio restarts the filter when the count rate changes
+class RateEstimator {
+
+  // ----------------------------------------------------------------------------------------------
+  // Public
+
+  public:
+
+    // Constructor
+    RateEstimator();
+
+    void     clear();                        // Forget all samples
+    void     add(const uint32_t counts);     // Add the counts of one second
+    double   getCountsPerSecond();           // Get the estimated count rate in counts per second
+    double   getConfidenceCountsPerSecond(); // Get the half width of the 95% confidence interval in counts per second
+    uint8_t  getIntegrationTime();           // Get the fixed integration time in seconds the estimate is currently equivalent to
+    uint32_t getChanges();                   // Get the number of changes that restarted the filter
+
+  // ----------------------------------------------------------------------------------------------
+  // Private
+
+  private:
+
+    double   _rate;           // Estimated count rate in counts per second
+    double   _variance;       // Variance of the estimated count rate
+    uint16_t _samples;        // Number of samples since the filter was restarted
+    double   _increaseSum;    // CUSUM statistic for an increase of the count rate
+    double   _decreaseSum;    // CUSUM statistic for a decrease of the count rate
+    uint32_t _increaseCounts; // Counts since the increase statistic was last zero
+    uint32_t _decreaseCounts; // Counts since the decrease statistic was last zero
+    uint16_t _increaseLength; // Seconds since the increase statistic was last zero
+    uint16_t _decreaseLength; // Seconds since the decrease statistic was last zero
+    uint32_t _changes;        // Number of changes that restarted the filter
+
+    void _restart(const uint32_t counts, const uint16_t length); // Restart the filter from the counts recorded since a change
+
+};
+
+#endif
@@ -1,5 +1,6 @@
 from pathlib import Path
 from bs4 import BeautifulSoup
+import gzip
 import rcssmin
 import rjsmin
 import htmlmin
@@ -65,12 +66,24 @@ def buildApp(path):
     # Return the minified HTML content
     return htmlmin.minify(str(html), remove_empty_space=True).replace("\n", "")
 
+# =================================================================================================
+# Write a web app and its precompressed ".gz" sibling
+# =================================================================================================
+def writeApp(path, content):
+
+    # Write the web app
+    with open(path, "w") as file: file.write(content)
+
+    # Write the compressed web app, which is sent to all browsers that accept it
+    # The modification time is left out, so rebuilding an unchanged web app gives the same file
+    with open(f"{path}.gz", "wb") as file: file.write(gzip.compress(content.encode("utf-8"), compresslevel=9, mtime=0))
+
 # =================================================================================================
 # Build all web apps
 # =================================================================================================
 
-with open("./index.html",               "w") as file: file.write(buildApp("./Root"))
-with open("./geiger-counter.html",      "w") as file: file.write(buildApp("./Geiger Counter"))
-with open("./cosmic-ray-detector.html", "w") as file: file.write(buildApp("./Cosmic Ray Detector"))
-with open("./wifi-settings.html",       "w") as file: file.write(buildApp("./WiFi Settings"))
-with open("./system-info.html",         "w") as file: file.write(buildApp("./System Info"))
\ No newline at end of file
+writeApp("./index.html",               buildApp("./Root"))
+writeApp("./geiger-counter.html",      buildApp("./Geiger Counter"))
+writeApp("./cosmic-ray-detector.html", buildApp("./Cosmic Ray Detector"))
+writeApp("./wifi-settings.html",       buildApp("./WiFi Settings"))
+writeApp("./system-info.html",         buildApp("./System Info"))
\ No newline at end of file
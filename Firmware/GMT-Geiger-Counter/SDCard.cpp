@@ -30,6 +30,9 @@ void SDCard::begin() {
     // Set the initialization flag to true
     _initialized = true;
 
+    // Create the lock that keeps the SD card from being unmounted while files are in use
+    _mutex = xSemaphoreCreateRecursiveMutex();
+
     // Setup SD card chip select pin
     pinMode(SD_CS_PIN, OUTPUT);
     digitalWrite(SD_CS_PIN, HIGH);
@@ -44,6 +47,32 @@ void SDCard::begin() {
 
 }
 
+// ================================================================================================
+// Verify the mount state if it is due and update the operation counter
+// ================================================================================================
+void SDCard::update() {
+
+  // If a file operation failed or the health check interval has passed, verify the mount state
+  if (_error || millis() - _healthCheckTimer >= SD_CARD_HEALTH_CHECK_INTERVAL_SECONDS * 1000) {
+
+    // Reset the timer and the error flag
+    _healthCheckTimer = millis();
+    _error            = false;
+
+    _verifyMountState();
+
+  }
+
+  // Once a second, move the operation count over to the operations per second
+  if (millis() - _operationsTimer >= 1000) {
+
+    _operationsTimer     = millis();
+    _operationsPerSecond = _operations.exchange(0);
+
+  }
+
+}
+
 // ================================================================================================
 // Mount the SD card
 // ================================================================================================
@@ -52,6 +81,9 @@ void SDCard::mount() {
   // If SD card is not mounted
   if (!_mounted) {
 
+    // Count the SD card operation
+    _operations++;
+
     // Try mounting SD card
     if (SD.begin(SD_CS_PIN)) {
 
@@ -60,8 +92,12 @@ void SDCard::mount() {
       SD.mkdir(SD_CARD_LOG_DIRECTORY);
       SD.mkdir(SD_CARD_WEB_APP_DIRECTORY);
 
-      // Set mounted flag to true
-      _mounted = true;
+      // Set mounted flag to true and start the health check interval over
+      _mounted          = true;
+      _healthCheckTimer = millis();
+
+      // Count the mount, anything cached from the SD card before is outdated now
+      _mounts++;
 
       // Create event data
       Logger::KeyValuePair event[2] = {
@@ -94,15 +130,26 @@ void SDCard::mount() {
 // ================================================================================================
 void SDCard::unmount() {
 
+  // Wait until no other task is using files on the SD card
+  lock();
+
   // If the SD card is mounted
   if (_mounted) {
 
-    // Unmount SD card
-    SD.end();
+    // Keep the logging task away from the log file until the SD card is unmounted
+    // Otherwise it could open a new log file in between closing the log file and clearing the mounted flag
+    logger.lock();
+
+    // Write the log buffer and close the log file while the SD card is still mounted
+    logger.close();
 
-    // Set mounted flag to false
+    // Set mounted flag to false, then unmount SD card
     _mounted = false;
 
+    SD.end();
+
+    logger.unlock();
+
     // Create event data
     Logger::KeyValuePair event[2] = {
 
@@ -116,6 +163,8 @@ void SDCard::unmount() {
 
   }
 
+  unlock();
+
 }
 
 // ================================================================================================
@@ -137,26 +186,40 @@ void SDCard::setMountState(const bool state) {
 }
 
 // ================================================================================================
-// Return the mount state of the SD card
+// Return the last known mount state of the SD card
 // ================================================================================================
 bool SDCard::getMountState() {
 
-  // If SD card is flagged as mounted
-  if (_mounted) {
+  // The mount state is verified in update(), so this doesn't access the SD card
+  return _mounted;
 
-    // Check if root directory can be accessed
-    if (!SD.exists(SD_CARD_ROOT_DIRECTORY)) {
+}
 
-      // If accessing the root directory failed unmount SD card
-      // Setting the mounted sate to false
-      unmount();
+// ================================================================================================
+// Report a failed file operation, the mount state is verified on the next update
+// ================================================================================================
+void SDCard::reportError() {
 
-    }
-  
-  }
+  // Only set a flag, this may be called from other tasks while the main loop is using the SD card
+  _error = true;
 
-  // Return the mount state
-  return _mounted;
+}
+
+// ================================================================================================
+// Get the number of SD card operations during the last second
+// ================================================================================================
+uint32_t SDCard::getOperationsPerSecond() {
+
+  return _operationsPerSecond;
+
+}
+
+// ================================================================================================
+// Get the number of times the SD card was mounted, this changes whenever the SD card might have been swapped
+// ================================================================================================
+uint32_t SDCard::getMounts() {
+
+  return _mounts;
 
 }
 
@@ -165,7 +228,17 @@ bool SDCard::getMountState() {
 // ================================================================================================
 File SDCard::open(const char *path, const char *mode, const bool create) {
 
-  return SD.open(path, mode, create);
+  // Count the SD card operation
+  _operations++;
+
+  // Try opening the file
+  File file = SD.open(path, mode, create);
+
+  // If opening a file for writing failed, the SD card might have been removed
+  // A file that can't be opened for reading usually just doesn't exist, a removed SD card is still found by the next health check
+  if (!file && (create || strcmp(mode, FILE_READ) != 0)) { reportError(); }
+
+  return file;
 
 }
 
@@ -174,13 +247,58 @@ File SDCard::open(const char *path, const char *mode, const bool create) {
 // ================================================================================================
 bool SDCard::exists(const char *path) {
 
+  // Count the SD card operation
+  _operations++;
+
   return SD.exists(path);
 
 }
 
+// ================================================================================================
+// Keep the SD card from being unmounted, e.g. while a file is sent to an HTTP client
+// ================================================================================================
+void SDCard::lock() {
+
+  if (_mutex != NULL) { xSemaphoreTakeRecursive(_mutex, portMAX_DELAY); }
+
+}
+
+// ================================================================================================
+// Allow the SD card to be unmounted again
+// ================================================================================================
+void SDCard::unlock() {
+
+  if (_mutex != NULL) { xSemaphoreGiveRecursive(_mutex); }
+
+}
+
 // ------------------------------------------------------------------------------------------------
 // Private
 
+// ================================================================================================
+// Check if the root directory can be accessed and unmount the SD card if it can't
+// ================================================================================================
+void SDCard::_verifyMountState() {
+
+  // If SD card is flagged as mounted
+  if (_mounted) {
+
+    // Count the SD card operation
+    _operations++;
+
+    // Check if root directory can be accessed
+    if (!SD.exists(SD_CARD_ROOT_DIRECTORY)) {
+
+      // If accessing the root directory failed unmount SD card
+      // Setting the mounted sate to false
+      unmount();
+
+    }
+
+  }
+
+}
+
 // ================================================================================================
 // Constructor
 // ================================================================================================
@@ -188,6 +306,13 @@ SDCard::SDCard():
 
   // Initialize members
   _initialized(false),
-  _mounted(false)
+  _mounted(false),
+  _error(false),
+  _healthCheckTimer(0),
+  _operationsTimer(0),
+  _operations(0),
+  _operationsPerSecond(0),
+  _mounts(0),
+  _mutex(NULL)
 
 {}
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "Configuration.h"
 #include "SD.h"
 #include "Logger.h"
+#include <atomic>
 
 class SDCard {
 
@@ -16,13 +17,19 @@ class SDCard {
     // Get the single instance of the class
     static SDCard& getInstance();
 
-    void begin();                                                                         // Initialize the SD card
-    void mount();                                                                         // Mount the SD card
-    void unmount();                                                                       // Unmount the SD card
-    void setMountState(const bool state);                                                 // Set the SD card mount state
-    bool getMountState();                                                                 // Return the mount state of the SD card
-    File open(const char *path, const char *mode = FILE_READ, const bool create = false); // SD card wrapper function for opening files
-    bool exists(const char *path);                                                        // SD card wrapper function for checking if an element exists
+    void     begin();                                                                         // Initialize the SD card
+    void     update();                                                                        // Verify the mount state if it is due and update the operation counter
+    void     mount();                                                                         // Mount the SD card
+    void     unmount();                                                                       // Unmount the SD card
+    void     setMountState(const bool state);                                                 // Set the SD card mount state
+    bool     getMountState();                                                                 // Return the last known mount state of the SD card
+    void     reportError();                                                                   // Report a failed file operation, the mount state is verified on the next update
+    uint32_t getOperationsPerSecond();                                                        // Get the number of SD card operations during the last second
+    uint32_t getMounts();                                                                     // Get the number of times the SD card was mounted, this changes whenever the SD card might have been swapped
+    File     open(const char *path, const char *mode = FILE_READ, const bool create = false); // SD card wrapper function for opening files
+    bool     exists(const char *path);                                                        // SD card wrapper function for checking if an element exists
+    void     lock();                                                                          // Keep the SD card from being unmounted, e.g. while a file is sent to an HTTP client
+    void     unlock();                                                                        // Allow the SD card to be unmounted again
 
   // ----------------------------------------------------------------------------------------------
   // Private
@@ -34,8 +41,17 @@ class SDCard {
     SDCard(const SDCard&) = delete;
     SDCard& operator=(const SDCard&) = delete;
 
-    bool _initialized; // Flag for checking if SD card was initialized
-    bool _mounted;     // Flag for checking if SD card is mounted
+    bool                  _initialized;         // Flag for checking if SD card was initialized
+    volatile bool         _mounted;             // Flag for checking if SD card is mounted
+    volatile bool         _error;               // Flag for verifying the mount state on the next update
+    uint64_t              _healthCheckTimer;    // Timer for verifying the mount state
+    uint64_t              _operationsTimer;     // Timer for the operation counter
+    std::atomic<uint32_t> _operations;          // SD card operations since the operation counter was last updated
+    uint32_t              _operationsPerSecond; // SD card operations during the last second
+    volatile uint32_t     _mounts;              // Number of times the SD card was mounted
+    SemaphoreHandle_t     _mutex;               // Recursive mutex held while files are in use by other tasks and while unmounting
+
+    void _verifyMountState(); // Check if the root directory can be accessed and unmount the SD card if it can't
 
 };
 
@@ -16,9 +16,17 @@ class Screen {
     // Virtual update function
     virtual void update(const XPT2046::Point &position) = 0;
 
-    // Virtual draw function
+    // Virtual draw function, draws the whole screen including the static parts
     virtual void draw(GFXcanvas16 &canvas) = 0;
 
+    // Redraw function, draws only the screen elements that changed onto the last drawn frame
+    // Screens that don't keep track of their elements are drawn whole every time
+    virtual void redraw(GFXcanvas16 &canvas) { draw(canvas); }
+
+    // Dirty state function, returns whether anything on the screen changed since it was last drawn
+    // Screens that don't keep track of their elements always need to be drawn
+    virtual bool getDirtyState() { return true; }
+
     // Virtual destructor
     virtual ~Screen() = default;
 
@@ -50,4 +50,27 @@ void ScreenAudioSettings::draw(GFXcanvas16 &canvas) {
   interface.draw(canvas);
   muteEverything.draw(canvas);
 
+}
+
+// ================================================================================================
+// Redraw
+// ================================================================================================
+void ScreenAudioSettings::redraw(GFXcanvas16 &canvas) {
+
+  // The title bar never changes, only draw the toggles that changed
+  if (detections.getDirtyState())     { detections.draw(canvas);     }
+  if (notifications.getDirtyState())  { notifications.draw(canvas);  }
+  if (alerts.getDirtyState())         { alerts.draw(canvas);         }
+  if (interface.getDirtyState())      { interface.draw(canvas);      }
+  if (muteEverything.getDirtyState()) { muteEverything.draw(canvas); }
+
+}
+
+// ================================================================================================
+// Get whether anything on the screen changed since it was last drawn
+// ================================================================================================
+bool ScreenAudioSettings::getDirtyState() {
+
+  return detections.getDirtyState() || notifications.getDirtyState() || alerts.getDirtyState() || interface.getDirtyState() || muteEverything.getDirtyState();
+
 }
\ No newline at end of file
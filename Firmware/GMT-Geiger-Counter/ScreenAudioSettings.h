@@ -28,6 +28,8 @@ class ScreenAudioSettings: public ScreenBasicLandscape {
     // Update and draw calls
     void update(const XPT2046::Point &position) override;
     void draw(GFXcanvas16 &canvas) override;
+    void redraw(GFXcanvas16 &canvas) override;
+    bool getDirtyState() override;
 
 };
 
@@ -13,7 +13,7 @@ ScreenCosmicRayDetector::ScreenCosmicRayDetector():
   mute( 187, 163, 51, 25, IMAGE_MUTE       ),
   sleep(187, 189, 51, 25, IMAGE_SLEEP_SMALL),
   _coincidenceEventsString("0"),
-  _coincidenceEventsPerHourString("0.00 CPH"),
+  _coincidenceEventsPerHourString("0 CPH"),
   _coincidenceEventsTotalString("0"),
   _mainTubeCountsString("0"),
   _followerTubeCountsString("0"),
@@ -21,7 +21,12 @@ ScreenCosmicRayDetector::ScreenCosmicRayDetector():
   _coincidenceEventsPerHour(2, 163, 184, IMAGE_MUON_SMALL, _coincidenceEventsPerHourString.c_str()),
   _coincidenceEventsTotal(2, 189, 184, IMAGE_SUM, _coincidenceEventsTotalString.c_str()),
   _mainTubeCounts(120, 215, 118, STRING_COUNTS, _mainTubeCountsString.c_str()),
-  _followerTubeCounts(120, 267, 118, STRING_COUNTS, _followerTubeCountsString.c_str())
+  _followerTubeCounts(120, 267, 118, STRING_COUNTS, _followerTubeCountsString.c_str()),
+  _coincidenceEventsValue(0),
+  _coincidenceEventsPerHourValue(0),
+  _coincidenceEventsTotalValue(0),
+  _mainTubeCountsValue(0),
+  _followerTubeCountsValue(0)
 
 {}
 
@@ -63,13 +68,43 @@ void ScreenCosmicRayDetector::draw(GFXcanvas16 &canvas) {
 
 }
 
+// ================================================================================================
+// Redraw
+// ================================================================================================
+void ScreenCosmicRayDetector::redraw(GFXcanvas16 &canvas) {
+
+  // The title bar, the diagram and the buttons never change, only draw the values that changed
+  if (_coincidenceEventsScreen.getDirtyState())  { _coincidenceEventsScreen.draw(canvas);  }
+  if (_coincidenceEventsPerHour.getDirtyState()) { _coincidenceEventsPerHour.draw(canvas); }
+  if (_coincidenceEventsTotal.getDirtyState())   { _coincidenceEventsTotal.draw(canvas);   }
+  if (_mainTubeCounts.getDirtyState())           { _mainTubeCounts.draw(canvas);           }
+  if (_followerTubeCounts.getDirtyState())       { _followerTubeCounts.draw(canvas);       }
+
+}
+
+// ================================================================================================
+// Get whether anything on the screen changed since it was last drawn
+// ================================================================================================
+bool ScreenCosmicRayDetector::getDirtyState() {
+
+  return _coincidenceEventsScreen.getDirtyState() || _coincidenceEventsPerHour.getDirtyState() || _coincidenceEventsTotal.getDirtyState() || _mainTubeCounts.getDirtyState() || _followerTubeCounts.getDirtyState();
+
+}
+
 // ================================================================================================
 // Set coincidence events
 // ================================================================================================
 void ScreenCosmicRayDetector::setCoincidenceEvents(const uint64_t &coincidenceEvents) {
 
+  // Nothing to do if the value didn't change
+  if (coincidenceEvents == _coincidenceEventsValue) { return; }
+
+  _coincidenceEventsValue  = coincidenceEvents;
   _coincidenceEventsString = coincidenceEvents;
 
+  // Draw the new value on the next refresh
+  _coincidenceEventsScreen.setValue(_coincidenceEventsString.c_str());
+
 }
 
 // ================================================================================================
@@ -77,10 +112,18 @@ void ScreenCosmicRayDetector::setCoincidenceEvents(const uint64_t &coincidenceEv
 // ================================================================================================
 void ScreenCosmicRayDetector::setCoincidenceEventsPerHour(const uint32_t &coincidenceEventsPerHour) {
 
+  // Nothing to do if the value didn't change
+  if (coincidenceEventsPerHour == _coincidenceEventsPerHourValue) { return; }
+
+  _coincidenceEventsPerHourValue = coincidenceEventsPerHour;
+
   _coincidenceEventsPerHourString  = coincidenceEventsPerHour;
   _coincidenceEventsPerHourString += " ";
   _coincidenceEventsPerHourString += STRING_COUNTS_PER_HOUR_ABBREVIATION;
 
+  // Draw the new value on the next refresh
+  _coincidenceEventsPerHour.setValue(_coincidenceEventsPerHourString.c_str());
+
 }
 
 // ================================================================================================
@@ -88,8 +131,15 @@ void ScreenCosmicRayDetector::setCoincidenceEventsPerHour(const uint32_t &coinci
 // ================================================================================================
 void ScreenCosmicRayDetector::setCoincidenceEventsTotal(const uint64_t &coincidenceEventsTotal) {
 
+  // Nothing to do if the value didn't change
+  if (coincidenceEventsTotal == _coincidenceEventsTotalValue) { return; }
+
+  _coincidenceEventsTotalValue  = coincidenceEventsTotal;
   _coincidenceEventsTotalString = coincidenceEventsTotal;
 
+  // Draw the new value on the next refresh
+  _coincidenceEventsTotal.setValue(_coincidenceEventsTotalString.c_str());
+
 }
 
 // ================================================================================================
@@ -97,8 +147,15 @@ void ScreenCosmicRayDetector::setCoincidenceEventsTotal(const uint64_t &coincide
 // ================================================================================================
 void ScreenCosmicRayDetector::setMainTubeCounts(const uint64_t &mainTubeCounts) {
 
+  // Nothing to do if the value didn't change
+  if (mainTubeCounts == _mainTubeCountsValue) { return; }
+
+  _mainTubeCountsValue  = mainTubeCounts;
   _mainTubeCountsString = mainTubeCounts;
 
+  // Draw the new value on the next refresh
+  _mainTubeCounts.setValue(_mainTubeCountsString.c_str());
+
 }
 
 // ================================================================================================
@@ -106,6 +163,13 @@ void ScreenCosmicRayDetector::setMainTubeCounts(const uint64_t &mainTubeCounts)
 // ================================================================================================
 void ScreenCosmicRayDetector::setFollowerTubeCounts(const uint64_t &followerTubeCounts) {
 
+  // Nothing to do if the value didn't change
+  if (followerTubeCounts == _followerTubeCountsValue) { return; }
+
+  _followerTubeCountsValue  = followerTubeCounts;
   _followerTubeCountsString = followerTubeCounts;
 
+  // Draw the new value on the next refresh
+  _followerTubeCounts.setValue(_followerTubeCountsString.c_str());
+
 }
\ No newline at end of file
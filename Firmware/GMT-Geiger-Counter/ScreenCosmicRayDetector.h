@@ -28,6 +28,8 @@ class ScreenCosmicRayDetector: public ScreenBasicPortrait {
     // Update and draw calls
     void update(const XPT2046::Point &position) override;
     void draw(GFXcanvas16 &canvas) override;
+    void redraw(GFXcanvas16 &canvas) override;
+    bool getDirtyState() override;
 
     // Set screen variables
     void setCoincidenceEvents(const uint64_t &coincidenceEvents);               // Set coincidence events
@@ -52,6 +54,13 @@ class ScreenCosmicRayDetector: public ScreenBasicPortrait {
     DisplayToastBox   _mainTubeCounts;                 // Main tube counts
     DisplayToastBox   _followerTubeCounts;             // Follower tube counts
 
+    // Values currently shown, so that the strings are only formatted again when a value changes
+    uint64_t          _coincidenceEventsValue;         // Coincidence events
+    uint32_t          _coincidenceEventsPerHourValue;  // Coincidence events per hour
+    uint64_t          _coincidenceEventsTotalValue;    // Total coincidence events
+    uint64_t          _mainTubeCountsValue;            // Main tube counts
+    uint64_t          _followerTubeCountsValue;        // Follower tube counts
+
 };
 
 #endif
\ No newline at end of file
@@ -26,6 +26,7 @@ class ScreenDisableCosmicRayDetector: public ScreenBasicPortrait {
     // Update and draw calls
     void update(const XPT2046::Point &position) override;
     void draw(GFXcanvas16 &canvas) override;
+    bool getDirtyState() override;
 
 };
 
@@ -81,4 +81,14 @@ void ScreenDisableGeigerCounter::draw(GFXcanvas16 &canvas) {
   confirm.draw(canvas);
   dismiss.draw(canvas);
 
+}
+
+// ================================================================================================
+// Get whether anything on the screen changed since it was last drawn
+// ================================================================================================
+bool ScreenDisableGeigerCounter::getDirtyState() {
+
+  // Nothing on the screen changes once it has been drawn
+  return false;
+
 }
\ No newline at end of file
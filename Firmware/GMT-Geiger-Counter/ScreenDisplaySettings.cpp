@@ -44,4 +44,25 @@ void ScreenDisplaySettings::draw(GFXcanvas16 &canvas) {
   timeout.draw(canvas);
   rgbLED.draw(canvas);
 
+}
+
+// ================================================================================================
+// Redraw
+// ================================================================================================
+void ScreenDisplaySettings::redraw(GFXcanvas16 &canvas) {
+
+  // The title bar never changes, only draw the toggles that changed
+  if (display.getDirtyState()) { display.draw(canvas); }
+  if (timeout.getDirtyState()) { timeout.draw(canvas); }
+  if (rgbLED.getDirtyState())  { rgbLED.draw(canvas);  }
+
+}
+
+// ================================================================================================
+// Get whether anything on the screen changed since it was last drawn
+// ================================================================================================
+bool ScreenDisplaySettings::getDirtyState() {
+
+  return display.getDirtyState() || timeout.getDirtyState() || rgbLED.getDirtyState();
+
 }
\ No newline at end of file
@@ -26,6 +26,8 @@ class ScreenDisplaySettings: public ScreenBasicLandscape {
     // Update and draw calls
     void update(const XPT2046::Point &position) override;
     void draw(GFXcanvas16 &canvas) override;
+    void redraw(GFXcanvas16 &canvas) override;
+    bool getDirtyState() override;
 
 };
 
@@ -32,7 +32,13 @@ ScreenGeigerCounter::ScreenGeigerCounter():
   _equivalentDoseScreen(2, 31, 160, 129, COLOR_GREEN_MEDIUM, COLOR_GREEN_DARK, _equivalentDoseString.c_str(), STRING_MICRO_SIEVERTS_PER_HOUR_ABBREVIATION),
   _radiationRating(2, 161, 160, IMAGE_RADIATION, STRING_NORMAL                 ),
   _countsPerMinute(2, 187, 160, IMAGE_PARTICLE,  _countsPerMinuteString.c_str()),
-  _integrationTime(2, 213, 160, IMAGE_CLOCK,     _integrationTimeString.c_str())
+  _integrationTime(2, 213, 160, IMAGE_CLOCK,     _integrationTimeString.c_str()),
+
+  _equivalentDoseValue(0),
+  _equivalentDoseUnitValue(GeigerCounter::MICRO_SIEVERTS_PER_HOUR),
+  _radiationRatingValue(GeigerCounter::RATING_NORMAL),
+  _countsPerMinuteValue(0),
+  _integrationTimeValue(30)
 
 {}
 
@@ -99,11 +105,40 @@ void ScreenGeigerCounter::draw(GFXcanvas16 &canvas) {
 
 }
 
+// ================================================================================================
+// Redraw
+// ================================================================================================
+void ScreenGeigerCounter::redraw(GFXcanvas16 &canvas) {
+
+  // The title bar and the icons never change, only draw the elements with new values
+  if (_equivalentDoseScreen.getDirtyState()) { _equivalentDoseScreen.draw(canvas); }
+  if (_radiationRating.getDirtyState())      { _radiationRating.draw(canvas);      }
+  if (_countsPerMinute.getDirtyState())      { _countsPerMinute.draw(canvas);      }
+  if (_integrationTime.getDirtyState())      { _integrationTime.draw(canvas);      }
+
+}
+
+// ================================================================================================
+// Get whether anything on the screen changed since it was last drawn
+// ================================================================================================
+bool ScreenGeigerCounter::getDirtyState() {
+
+  return _equivalentDoseScreen.getDirtyState() || _radiationRating.getDirtyState() || _countsPerMinute.getDirtyState() || _integrationTime.getDirtyState();
+
+}
+
 // ================================================================================================
 // Set the equivalent dose
 // ================================================================================================
 void ScreenGeigerCounter::setEquivalentDose(const double &equivalentDose) {
 
+  // The equivalent dose is shown with two decimal places, a smaller change doesn't need a new string
+  int64_t equivalentDoseValue = (int64_t)(round(equivalentDose * 100));
+
+  if (equivalentDoseValue == _equivalentDoseValue) { return; }
+
+  _equivalentDoseValue = equivalentDoseValue;
+
   // If equivalent dose value is less than 1000
   if (equivalentDose < 1000) {
 
@@ -118,6 +153,9 @@ void ScreenGeigerCounter::setEquivalentDose(const double &equivalentDose) {
 
   }
 
+  // Draw the new value on the next refresh
+  _equivalentDoseScreen.setValue(_equivalentDoseString.c_str());
+
 }
 
 // ================================================================================================
@@ -125,6 +163,11 @@ void ScreenGeigerCounter::setEquivalentDose(const double &equivalentDose) {
 // ================================================================================================
 void ScreenGeigerCounter::setEquivalentDoseUnit(GeigerCounter::EquivalentDoseUnit equivalentDoseUnit) {
 
+  // Nothing to do if the unit didn't change
+  if (equivalentDoseUnit == _equivalentDoseUnitValue) { return; }
+
+  _equivalentDoseUnitValue = equivalentDoseUnit;
+
   // Depending on the equivalent dose unit selected
   // Set the equivalent dose unit string
 
@@ -155,6 +198,11 @@ void ScreenGeigerCounter::setEquivalentDoseUnit(GeigerCounter::EquivalentDoseUni
 // ================================================================================================
 void ScreenGeigerCounter::setRadiationRating(const GeigerCounter::RadiationRating radiationRating) {
 
+  // Nothing to do if the rating didn't change
+  if (radiationRating == _radiationRatingValue) { return; }
+
+  _radiationRatingValue = radiationRating;
+
   // Depending on the radiation rating
   // Update the dose screen border and background color
   // Update the radiation rating info box value
@@ -201,21 +249,39 @@ void ScreenGeigerCounter::setRadiationRating(const GeigerCounter::RadiationRatin
 // ================================================================================================
 void ScreenGeigerCounter::setCountsPerMinute(const double &countsPerMinute) {
 
+  // The counts per minute are shown rounded, only a change of the rounded value needs a new string
+  uint64_t countsPerMinuteValue = (uint64_t)(round(countsPerMinute));
+
+  if (countsPerMinuteValue == _countsPerMinuteValue) { return; }
+
+  _countsPerMinuteValue = countsPerMinuteValue;
+
   // Convert counts per minute to a string with unit appended to it
-  _countsPerMinuteString  = (uint64_t)(round(countsPerMinute));
+  _countsPerMinuteString  = countsPerMinuteValue;
   _countsPerMinuteString += " ";
   _countsPerMinuteString += STRING_COUNTS_PER_MINUTE_ABBREVIATION;
 
+  // Draw the new value on the next refresh
+  _countsPerMinute.setValue(_countsPerMinuteString.c_str());
+
 }
 
 // ================================================================================================
 // Set the integration time
 // ================================================================================================
 void ScreenGeigerCounter::setIntegrationTime(const uint8_t integrationTime) {
+
+  // Nothing to do if the integration time didn't change
+  if (integrationTime == _integrationTimeValue) { return; }
+
+  _integrationTimeValue = integrationTime;
   
   // Convert integration time to a string with unit appended to it
   _integrationTimeString  = integrationTime;
   _integrationTimeString += " ";
   _integrationTimeString += STRING_SECONDS_ABBREVIATION;
 
+  // Draw the new value on the next refresh
+  _integrationTime.setValue(_integrationTimeString.c_str());
+
 }
\ No newline at end of file
@@ -42,6 +42,8 @@ class ScreenGeigerCounter: public Screen {
     // Update and draw calls
     void update(const XPT2046::Point &position) override;
     void draw(GFXcanvas16 &canvas) override;
+    void redraw(GFXcanvas16 &canvas) override;
+    bool getDirtyState() override;
 
     // Set screen variables
     void setEquivalentDose(const double &equivalentDose);                                   // Set the equivalent dose
@@ -63,6 +65,13 @@ class ScreenGeigerCounter: public Screen {
     DisplayInfoBox    _countsPerMinute;       // Counts per minute info box
     DisplayInfoBox    _integrationTime;       // Integration time info box
 
+    // Values currently shown, so that the strings are only formatted again when a value changes
+    int64_t                           _equivalentDoseValue;     // Equivalent dose in hundredths
+    GeigerCounter::EquivalentDoseUnit _equivalentDoseUnitValue; // Equivalent dose unit
+    GeigerCounter::RadiationRating    _radiationRatingValue;    // Radiation rating
+    uint64_t                          _countsPerMinuteValue;    // Rounded counts per minute
+    uint8_t                           _integrationTimeValue;    // Integration time
+
 };
 
 #endif
\ No newline at end of file
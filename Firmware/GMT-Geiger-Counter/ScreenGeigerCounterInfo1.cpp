@@ -17,7 +17,10 @@ ScreenGeigerCounterInfo1::ScreenGeigerCounterInfo1():
   _followerTubeCountsString("0"),
   _countsScreen(2, 31, 316, 77, COLOR_BLUE_MEDIUM, COLOR_BLUE_DARK, _countsString.c_str(), STRING_COUNTS),
   _mainTubeCounts(    160, 109, 158, STRING_COUNTS, _mainTubeCountsString.c_str()),
-  _followerTubeCounts(160, 161, 158, STRING_COUNTS, _followerTubeCountsString.c_str())
+  _followerTubeCounts(160, 161, 158, STRING_COUNTS, _followerTubeCountsString.c_str()),
+  _countsValue(0),
+  _mainTubeCountsValue(0),
+  _followerTubeCountsValue(0)
 
 {}
 
@@ -57,13 +60,41 @@ void ScreenGeigerCounterInfo1::draw(GFXcanvas16 &canvas) {
 
 }
 
+// ================================================================================================
+// Redraw
+// ================================================================================================
+void ScreenGeigerCounterInfo1::redraw(GFXcanvas16 &canvas) {
+
+  // The title bar, the diagram and the buttons never change, only draw the counts that changed
+  if (_countsScreen.getDirtyState())       { _countsScreen.draw(canvas);       }
+  if (_mainTubeCounts.getDirtyState())     { _mainTubeCounts.draw(canvas);     }
+  if (_followerTubeCounts.getDirtyState()) { _followerTubeCounts.draw(canvas); }
+
+}
+
+// ================================================================================================
+// Get whether anything on the screen changed since it was last drawn
+// ================================================================================================
+bool ScreenGeigerCounterInfo1::getDirtyState() {
+
+  return _countsScreen.getDirtyState() || _mainTubeCounts.getDirtyState() || _followerTubeCounts.getDirtyState();
+
+}
+
 // ================================================================================================
 // Set the total counts
 // ================================================================================================
 void ScreenGeigerCounterInfo1::setCounts(const uint64_t &counts) {
 
+  // Nothing to do if the value didn't change
+  if (counts == _countsValue) { return; }
+
+  _countsValue  = counts;
   _countsString = counts;
 
+  // Draw the new value on the next refresh
+  _countsScreen.setValue(_countsString.c_str());
+
 }
 
 // ================================================================================================
@@ -71,8 +102,15 @@ void ScreenGeigerCounterInfo1::setCounts(const uint64_t &counts) {
 // ================================================================================================
 void ScreenGeigerCounterInfo1::setMainTubeCounts(const uint64_t &counts) {
 
+  // Nothing to do if the value didn't change
+  if (counts == _mainTubeCountsValue) { return; }
+
+  _mainTubeCountsValue  = counts;
   _mainTubeCountsString = counts;
 
+  // Draw the new value on the next refresh
+  _mainTubeCounts.setValue(_mainTubeCountsString.c_str());
+
 }
 
 // ================================================================================================
@@ -80,6 +118,13 @@ void ScreenGeigerCounterInfo1::setMainTubeCounts(const uint64_t &counts) {
 // ================================================================================================
 void ScreenGeigerCounterInfo1::setFollowerTubeCounts(const uint64_t &counts) {
 
+  // Nothing to do if the value didn't change
+  if (counts == _followerTubeCountsValue) { return; }
+
+  _followerTubeCountsValue  = counts;
   _followerTubeCountsString = counts;
 
+  // Draw the new value on the next refresh
+  _followerTubeCounts.setValue(_followerTubeCountsString.c_str());
+
 }
\ No newline at end of file
@@ -28,6 +28,8 @@ class ScreenGeigerCounterInfo1: public ScreenBasicLandscape {
     // Update and draw calls
     void update(const XPT2046::Point &position) override;
     void draw(GFXcanvas16 &canvas) override;
+    void redraw(GFXcanvas16 &canvas) override;
+    bool getDirtyState() override;
 
     void setCounts(const uint64_t &counts);             // Set the total counts
     void setMainTubeCounts(const uint64_t &counts);     // Set the main tube counts
@@ -45,6 +47,11 @@ class ScreenGeigerCounterInfo1: public ScreenBasicLandscape {
     DisplayToastBox   _mainTubeCounts;           // Main tube counts screen element
     DisplayToastBox   _followerTubeCounts;       // Follower tube counts screen element
 
+    // Values currently shown, so that the strings are only formatted again when a value changes
+    uint64_t          _countsValue;              // Total counts
+    uint64_t          _mainTubeCountsValue;      // Main tube counts
+    uint64_t          _followerTubeCountsValue;  // Follower tube counts
+
 };
 
 #endif
\ No newline at end of file
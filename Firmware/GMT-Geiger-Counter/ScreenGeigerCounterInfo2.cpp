@@ -17,7 +17,10 @@ ScreenGeigerCounterInfo2::ScreenGeigerCounterInfo2():
   _followerAbsorbedDoseString("0.00"),
   _absorbedDoseScreen(2, 31, 316, 77, COLOR_BLUE_MEDIUM, COLOR_BLUE_DARK, _absorbedDoseString.c_str(), STRING_ABSORBED_DOSE_MICRO_SIEVERTS),
   _mainAbsorbedDose(    160, 109, 158, STRING_MICRO_SIEVERTS_ABBREVIATION, _mainAbsorbedDoseString.c_str()),
-  _followerAbsorbedDose(160, 161, 158, STRING_MICRO_SIEVERTS_ABBREVIATION, _followerAbsorbedDoseString.c_str())
+  _followerAbsorbedDose(160, 161, 158, STRING_MICRO_SIEVERTS_ABBREVIATION, _followerAbsorbedDoseString.c_str()),
+  _absorbedDoseValue(0),
+  _mainAbsorbedDoseValue(0),
+  _followerAbsorbedDoseValue(0)
 
 {}
 
@@ -57,13 +60,43 @@ void ScreenGeigerCounterInfo2::draw(GFXcanvas16 &canvas) {
 
 }
 
+// ================================================================================================
+// Redraw
+// ================================================================================================
+void ScreenGeigerCounterInfo2::redraw(GFXcanvas16 &canvas) {
+
+  // The title bar, the diagram and the buttons never change, only draw the doses that changed
+  if (_absorbedDoseScreen.getDirtyState())   { _absorbedDoseScreen.draw(canvas);   }
+  if (_mainAbsorbedDose.getDirtyState())     { _mainAbsorbedDose.draw(canvas);     }
+  if (_followerAbsorbedDose.getDirtyState()) { _followerAbsorbedDose.draw(canvas); }
+
+}
+
+// ================================================================================================
+// Get whether anything on the screen changed since it was last drawn
+// ================================================================================================
+bool ScreenGeigerCounterInfo2::getDirtyState() {
+
+  return _absorbedDoseScreen.getDirtyState() || _mainAbsorbedDose.getDirtyState() || _followerAbsorbedDose.getDirtyState();
+
+}
+
 // ================================================================================================
 // Set the total absorbed dose
 // ================================================================================================
 void ScreenGeigerCounterInfo2::setTotalAbsorbedDose(const double &dose) {
 
+  // The dose is shown with two decimal places, a smaller change doesn't need a new string
+  int64_t value = (int64_t)(round(dose * 100));
+
+  if (value == _absorbedDoseValue) { return; }
+
+  _absorbedDoseValue  = value;
   _absorbedDoseString = dose;
 
+  // Draw the new value on the next refresh
+  _absorbedDoseScreen.setValue(_absorbedDoseString.c_str());
+
 }
 
 // ================================================================================================
@@ -71,8 +104,17 @@ void ScreenGeigerCounterInfo2::setTotalAbsorbedDose(const double &dose) {
 // ================================================================================================
 void ScreenGeigerCounterInfo2::setMainAbsorbedDose(const double &dose) {
 
+  // The dose is shown with two decimal places, a smaller change doesn't need a new string
+  int64_t value = (int64_t)(round(dose * 100));
+
+  if (value == _mainAbsorbedDoseValue) { return; }
+
+  _mainAbsorbedDoseValue  = value;
   _mainAbsorbedDoseString = dose;
 
+  // Draw the new value on the next refresh
+  _mainAbsorbedDose.setValue(_mainAbsorbedDoseString.c_str());
+
 }
 
 // ================================================================================================
@@ -80,6 +122,15 @@ void ScreenGeigerCounterInfo2::setMainAbsorbedDose(const double &dose) {
 // ================================================================================================
 void ScreenGeigerCounterInfo2::setFollowerAbsorbedDose(const double &dose) {
 
+  // The dose is shown with two decimal places, a smaller change doesn't need a new string
+  int64_t value = (int64_t)(round(dose * 100));
+
+  if (value == _followerAbsorbedDoseValue) { return; }
+
+  _followerAbsorbedDoseValue  = value;
   _followerAbsorbedDoseString = dose;
 
+  // Draw the new value on the next refresh
+  _followerAbsorbedDose.setValue(_followerAbsorbedDoseString.c_str());
+
 }
\ No newline at end of file
@@ -28,6 +28,8 @@ class ScreenGeigerCounterInfo2: public ScreenBasicLandscape {
     // Update and draw calls
     void update(const XPT2046::Point &position) override;
     void draw(GFXcanvas16 &canvas) override;
+    void redraw(GFXcanvas16 &canvas) override;
+    bool getDirtyState() override;
 
     void setTotalAbsorbedDose(const double &dose);    // Set the total absorbed dose
     void setMainAbsorbedDose(const double &dose);     // Set the main tube absorbed dose
@@ -45,6 +47,11 @@ class ScreenGeigerCounterInfo2: public ScreenBasicLandscape {
     DisplayToastBox   _mainAbsorbedDose;           // Main tube absorbed dose screen element
     DisplayToastBox   _followerAbsorbedDose;       // Follower tube absorbed dose screen element
 
+    // Values currently shown, so that the strings are only formatted again when a value changes
+    int64_t           _absorbedDoseValue;          // Total absorbed dose in hundredths
+    int64_t           _mainAbsorbedDoseValue;      // Main tube absorbed dose in hundredths
+    int64_t           _followerAbsorbedDoseValue;  // Follower tube absorbed dose in hundredths
+
 };
 
 #endif
\ No newline at end of file
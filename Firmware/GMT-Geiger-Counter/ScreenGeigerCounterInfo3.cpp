@@ -59,4 +59,28 @@ void ScreenGeigerCounterInfo3::draw(GFXcanvas16 &canvas) {
   next.draw(canvas);
   previous.draw(canvas);
 
+}
+
+// ================================================================================================
+// Redraw
+// ================================================================================================
+void ScreenGeigerCounterInfo3::redraw(GFXcanvas16 &canvas) {
+
+  // The title bar and the buttons never change, only draw the toggles and radios that changed
+  if (autoIntegrate.getDirtyState()) { autoIntegrate.draw(canvas); }
+  if (autoRange.getDirtyState())     { autoRange.draw(canvas);     }
+  if (sieverts.getDirtyState())      { sieverts.draw(canvas);      }
+  if (rem.getDirtyState())           { rem.draw(canvas);           }
+  if (rontgen.getDirtyState())       { rontgen.draw(canvas);       }
+  if (gray.getDirtyState())          { gray.draw(canvas);          }
+
+}
+
+// ================================================================================================
+// Get whether anything on the screen changed since it was last drawn
+// ================================================================================================
+bool ScreenGeigerCounterInfo3::getDirtyState() {
+
+  return autoIntegrate.getDirtyState() || autoRange.getDirtyState() || sieverts.getDirtyState() || rem.getDirtyState() || rontgen.getDirtyState() || gray.getDirtyState();
+
 }
\ No newline at end of file
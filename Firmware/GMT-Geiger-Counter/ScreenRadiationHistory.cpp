@@ -10,6 +10,7 @@ ScreenRadiationHistory::ScreenRadiationHistory():
 
   // Initialize members
   ScreenBasicLandscape(STRING_RADIATION_HISTORY_CPM),
+  _history(NULL),
   _historyIndex(0),
   _timeSteps(round(RADIATION_HISTORY_LENGTH_MINUTES / 4.0)),
   _countSteps(round(RADIATION_HISTORY_MINIMUM_SCALE_CPM / 4.0)),
@@ -81,34 +82,39 @@ void ScreenRadiationHistory::draw(GFXcanvas16 &canvas) {
   float width  = 294.0 / (RADIATION_HISTORY_LENGTH_MINUTES - 1);
   float height = 159.0 / (_countSteps * 4); 
 
-  // Get starting position of the first line element
-  uint16_t x = 306;
-  uint16_t y = 200 - round(height * _history[(_historyIndex + RADIATION_HISTORY_LENGTH_MINUTES - 1) % RADIATION_HISTORY_LENGTH_MINUTES]); 
+  // If the radiation history is set
+  if (_history != NULL) {
 
-  // For all samples in the history array
-  for (uint8_t sample = 0; sample < RADIATION_HISTORY_LENGTH_MINUTES; sample++) {
+    // Get starting position of the first line element
+    uint16_t x = 306;
+    uint16_t y = 200 - round(height * _history->getBucket(RadiationHistory::MINUTES, 0).mean);
 
-    // Calculate wrapped index from the current history index offset by the sample + 1
-    uint8_t wrappedIndex = (_historyIndex + RADIATION_HISTORY_LENGTH_MINUTES - (sample + 1)) % RADIATION_HISTORY_LENGTH_MINUTES;
+    // For all minutes shown in the history graph, starting with the latest one
+    for (uint16_t sample = 0; sample < RADIATION_HISTORY_LENGTH_MINUTES; sample++) {
 
-    // If the sample is not invalid
-    if (_history[wrappedIndex] != UINT32_MAX) {
+      // Get the mean counts per minute value of that minute
+      uint32_t countsPerMinute = _history->getBucket(RadiationHistory::MINUTES, sample).mean;
 
-      // Calculate end position of line element
-      uint16_t dx = 306 - round(width  * sample);
-      uint16_t dy = 200 - round(height * _history[wrappedIndex]);
+      // If the sample is not invalid
+      if (countsPerMinute != UINT32_MAX) {
 
-      // Draw the line 3 times with a y offset of -1 to make the line 3px thick
-      for (uint8_t yOffset = 0; yOffset < 3; yOffset++) {
+        // Calculate end position of line element
+        uint16_t dx = 306 - round(width  * sample);
+        uint16_t dy = 200 - round(height * countsPerMinute);
 
-        // Draw line between the two positions
-        canvas.drawLine(x, y - yOffset, dx, dy - yOffset, COLOR_NEON);
+        // Draw the line 3 times with a y offset of -1 to make the line 3px thick
+        for (uint8_t yOffset = 0; yOffset < 3; yOffset++) {
 
-      }
+          // Draw line between the two positions
+          canvas.drawLine(x, y - yOffset, dx, dy - yOffset, COLOR_NEON);
+
+        }
 
-      // Set the next starting position to the current end position
-      x = dx;
-      y = dy;
+        // Set the next starting position to the current end position
+        x = dx;
+        y = dy;
+
+      }
 
     }
 
@@ -130,37 +136,40 @@ void ScreenRadiationHistory::draw(GFXcanvas16 &canvas) {
 // ================================================================================================
 // Update the radiation history
 // ================================================================================================
-void ScreenRadiationHistory::setRadiationHistory(uint32_t *history, const uint8_t index) {
+void ScreenRadiationHistory::setRadiationHistory(RadiationHistory &history) {
 
   // Set the radiation history
-  _history = history;
+  _history = &history;
 
-  // If the radiation history index has updated
-  if (_historyIndex != index){
+  // If a new minute was added to the radiation history
+  if (_historyIndex != history.getIndex(RadiationHistory::MINUTES)) {
 
     // Update the history index
-    _historyIndex = index;
+    _historyIndex = history.getIndex(RadiationHistory::MINUTES);
 
     // Reset count variables
     double   averageCountsPerMinute = 0.0;
     uint32_t maximumCountsPerMinute = 0;
     uint32_t minimumCountsPerMinute = UINT32_MAX;
-    uint8_t  validSamples           = 0;
+    uint16_t validSamples           = 0;
+
+    // For all minutes shown in the history graph
+    for (uint16_t sample = 0; sample < RADIATION_HISTORY_LENGTH_MINUTES; sample++) {
 
-    // For all samples in the history array
-    for (uint8_t sample = 0; sample < RADIATION_HISTORY_LENGTH_MINUTES; sample++) {
+      // Get the mean counts per minute value of that minute
+      uint32_t countsPerMinute = history.getBucket(RadiationHistory::MINUTES, sample).mean;
 
       // Only update count variables if not an invalid count value
-      if (_history[sample] != UINT32_MAX) {
+      if (countsPerMinute != UINT32_MAX) {
 
         // Add sample to the sum of a counts per minute values
-        averageCountsPerMinute += _history[sample];
+        averageCountsPerMinute += countsPerMinute;
 
         // If this sample is larger than the previous maximum set the maximum to it
-        if (_history[sample] > maximumCountsPerMinute) { maximumCountsPerMinute = _history[sample]; }
+        if (countsPerMinute > maximumCountsPerMinute) { maximumCountsPerMinute = countsPerMinute; }
         
         // If this sample is smaller than the previous minimum set the minimum to it
-        if (_history[sample] < minimumCountsPerMinute) { minimumCountsPerMinute = _history[sample]; }
+        if (countsPerMinute < minimumCountsPerMinute) { minimumCountsPerMinute = countsPerMinute; }
 
         // Increase the number of valid samples
         validSamples++;
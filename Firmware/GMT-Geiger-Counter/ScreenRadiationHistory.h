@@ -9,6 +9,7 @@
 #include "Graphics.h"
 #include "ScreenBasicLandscape.h"
 #include "DisplayInfoBox.h"
+#include "RadiationHistory.h"
 
 class ScreenRadiationHistory: public ScreenBasicLandscape {
 
@@ -24,23 +25,23 @@ class ScreenRadiationHistory: public ScreenBasicLandscape {
     void update(const XPT2046::Point &position) override;
     void draw(GFXcanvas16 &canvas) override;
 
-    void setRadiationHistory(uint32_t *history, const uint8_t index); // Update the radiation history
+    void setRadiationHistory(RadiationHistory &history); // Update the radiation history
 
   //-----------------------------------------------------------------------------------------------
   // Private
   
   public:
 
-    uint32_t       *_history;                     // History array
-    uint8_t        _historyIndex;                 // Index of the history array
-    uint8_t        _timeSteps;                    // History graph time steps
-    uint32_t       _countSteps;                   // History graph count steps
-    String         _averageCountsPerMinuteString; // Average counts per minute string
-    String         _maximumCountsPerMinuteString; // Maximum counts per minute string
-    String         _minimumCountsPerMinuteString; // Minimum counts per minute string
-    DisplayInfoBox _averageCountsPerMinute;       // Average counts per minute screen element
-    DisplayInfoBox _maximumCountsPerMinute;       // Maximum counts per minute screen element
-    DisplayInfoBox _minimumCountsPerMinute;       // Minimum counts per minute screen element
+    RadiationHistory *_history;                     // Radiation history
+    uint16_t         _historyIndex;                 // Index of the next minute in the radiation history
+    uint8_t          _timeSteps;                    // History graph time steps
+    uint32_t         _countSteps;                   // History graph count steps
+    String           _averageCountsPerMinuteString; // Average counts per minute string
+    String           _maximumCountsPerMinuteString; // Maximum counts per minute string
+    String           _minimumCountsPerMinuteString; // Minimum counts per minute string
+    DisplayInfoBox   _averageCountsPerMinute;       // Average counts per minute screen element
+    DisplayInfoBox   _maximumCountsPerMinute;       // Maximum counts per minute screen element
+    DisplayInfoBox   _minimumCountsPerMinute;       // Minimum counts per minute screen element
 
 };
 
@@ -75,4 +75,14 @@ void ScreenRotationConfirmation::draw(GFXcanvas16 &canvas) {
   canvas.drawFastHLine(12, 301, 215, COLOR_GRAY_LIGHT);
   canvas.drawFastHLine(12, 307, 215, COLOR_GRAY_LIGHT);
 
+}
+
+// ================================================================================================
+// Get whether anything on the screen changed since it was last drawn
+// ================================================================================================
+bool ScreenRotationConfirmation::getDirtyState() {
+
+  // Nothing on the screen changes once it has been drawn
+  return false;
+
 }
\ No newline at end of file
@@ -36,4 +36,14 @@ void ScreenSleep::draw(GFXcanvas16 &canvas) {
 
   // Dont draw anything on the sleep screen
 
+}
+
+// ================================================================================================
+// Get whether anything on the screen changed since it was last drawn
+// ================================================================================================
+bool ScreenSleep::getDirtyState() {
+
+  // Nothing is drawn on the sleep screen
+  return false;
+
 }
\ No newline at end of file
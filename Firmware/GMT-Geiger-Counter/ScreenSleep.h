@@ -21,6 +21,7 @@ class ScreenSleep: public Screen {
     // Update and draw calls
     void update(const XPT2046::Point &position) override;
     void draw(GFXcanvas16 &canvas) override;
+    bool getDirtyState() override;
 
 };
 
@@ -17,7 +17,8 @@ ScreenSystemSettings1::ScreenSystemSettings1():
   sdCardLogging(2, STRING_LOG_TO_SD_CARD,        true ),
   dataLogging(  3, STRING_LOG_DATA,              true ),
   eventLogging( 4, STRING_LOG_EVENT_MESSAGES,    true ),
-  systemLogging(5, STRING_LOG_SYSTEM_INFO,       false)
+  systemLogging(5, STRING_LOG_SYSTEM_INFO,       false),
+  binaryLogging(6, STRING_BINARY_LOG_FILES,      false)
 
 {}
 
@@ -38,6 +39,7 @@ void ScreenSystemSettings1::update(const XPT2046::Point &position) {
   dataLogging.update(position);
   eventLogging.update(position);
   systemLogging.update(position);
+  binaryLogging.update(position);
 
 }
 
@@ -58,5 +60,31 @@ void ScreenSystemSettings1::draw(GFXcanvas16 &canvas) {
   dataLogging.draw(canvas);
   eventLogging.draw(canvas);
   systemLogging.draw(canvas);
+  binaryLogging.draw(canvas);
+
+}
+
+// ================================================================================================
+// Redraw
+// ================================================================================================
+void ScreenSystemSettings1::redraw(GFXcanvas16 &canvas) {
+
+  // The title bar and the buttons never change, only draw the toggles that changed
+  if (sdCardMounted.getDirtyState()) { sdCardMounted.draw(canvas); }
+  if (serialLogging.getDirtyState()) { serialLogging.draw(canvas); }
+  if (sdCardLogging.getDirtyState()) { sdCardLogging.draw(canvas); }
+  if (dataLogging.getDirtyState())   { dataLogging.draw(canvas);   }
+  if (eventLogging.getDirtyState())  { eventLogging.draw(canvas);  }
+  if (systemLogging.getDirtyState()) { systemLogging.draw(canvas); }
+  if (binaryLogging.getDirtyState()) { binaryLogging.draw(canvas); }
+
+}
+
+// ================================================================================================
+// Get whether anything on the screen changed since it was last drawn
+// ================================================================================================
+bool ScreenSystemSettings1::getDirtyState() {
+
+  return sdCardMounted.getDirtyState() || serialLogging.getDirtyState() || sdCardLogging.getDirtyState() || dataLogging.getDirtyState() || eventLogging.getDirtyState() || systemLogging.getDirtyState() || binaryLogging.getDirtyState();
 
 }
\ No newline at end of file
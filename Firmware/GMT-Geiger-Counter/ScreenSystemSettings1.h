@@ -26,6 +26,7 @@ class ScreenSystemSettings1: public ScreenBasicLandscape {
     TouchToggle dataLogging;
     TouchToggle eventLogging;
     TouchToggle systemLogging;
+    TouchToggle binaryLogging;
 
     // Constructor
     ScreenSystemSettings1();
@@ -33,6 +34,8 @@ class ScreenSystemSettings1: public ScreenBasicLandscape {
     // Update and draw calls
     void update(const XPT2046::Point &position) override;
     void draw(GFXcanvas16 &canvas) override;
+    void redraw(GFXcanvas16 &canvas) override;
+    bool getDirtyState() override;
 
 };
 
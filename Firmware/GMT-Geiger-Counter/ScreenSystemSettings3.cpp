@@ -80,4 +80,14 @@ void ScreenSystemSettings3::draw(GFXcanvas16 &canvas) {
   restart.draw(canvas);
   reset.draw(canvas);
 
+}
+
+// ================================================================================================
+// Get whether anything on the screen changed since it was last drawn
+// ================================================================================================
+bool ScreenSystemSettings3::getDirtyState() {
+
+  // Nothing on the screen changes once it has been drawn
+  return false;
+
 }
\ No newline at end of file
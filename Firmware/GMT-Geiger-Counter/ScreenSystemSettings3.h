@@ -28,6 +28,7 @@ class ScreenSystemSettings3: public ScreenBasicLandscape {
     // Update and draw calls
     void update(const XPT2046::Point &position) override;
     void draw(GFXcanvas16 &canvas) override;
+    bool getDirtyState() override;
 
 };
 
@@ -174,6 +174,7 @@ void Settings::reset() {
   data.parameters.logger.data   = true;
   data.parameters.logger.event  = true;
   data.parameters.logger.system = true;
+  data.parameters.logger.format = Logger::JSON;
 
   // --------------------------------------------
   // Geiger counter parameter
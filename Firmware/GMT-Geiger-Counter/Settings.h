@@ -32,6 +32,7 @@ class Settings {
           bool data;
           bool event;
           bool system;
+          Logger::LogFormat format;
 
         } logger;
 
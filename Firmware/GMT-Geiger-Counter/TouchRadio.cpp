@@ -11,7 +11,8 @@ TouchRadio::TouchRadio(const uint8_t row, const char *text, const bool selected)
   // Initialize members
   _y((26 * row) + 31),
   _text(text),
-  _selected(selected)
+  _selected(selected),
+  _dirty(true)
 
 {}
 
@@ -62,6 +63,9 @@ void TouchRadio::draw(GFXcanvas16 &canvas) {
   canvas.setCursor(5, _y + 18);
   canvas.print(_text);
 
+  // The radio is up to date now
+  _dirty = false;
+
 }
 
 // ================================================================================================
@@ -69,7 +73,7 @@ void TouchRadio::draw(GFXcanvas16 &canvas) {
 // ================================================================================================
 void TouchRadio::select() {
 
-  _selected = true;
+  setSelectState(true);
 
 }
 
@@ -78,7 +82,7 @@ void TouchRadio::select() {
 // ================================================================================================
 void TouchRadio::deselect() {
 
-  _selected = false;
+  setSelectState(false);
 
 }
 
@@ -87,6 +91,9 @@ void TouchRadio::deselect() {
 // ================================================================================================
 void TouchRadio::setSelectState(const bool selected) {
 
+  // Only draw the radio again if it was selected or deselected
+  if (_selected != selected) { _dirty = true; }
+
   _selected = selected;
 
 }
@@ -98,4 +105,13 @@ bool TouchRadio::getSelectState() {
 
   return _selected;
 
+}
+
+// ================================================================================================
+// Get whether the radio changed since it was last drawn
+// ================================================================================================
+bool TouchRadio::getDirtyState() {
+
+  return _dirty;
+
 }
\ No newline at end of file
@@ -23,6 +23,7 @@ class TouchRadio {
     void deselect();                             // Deselect radio
     void setSelectState(const bool selected);    // Set a specific select state
     bool getSelectState();                       // Return the radio state
+    bool getDirtyState();                        // Get whether the radio changed since it was last drawn
 
   //-----------------------------------------------------------------------------------------------
   // Private
@@ -32,6 +33,7 @@ class TouchRadio {
     const uint16_t _y;        // Y position
     const char     *_text;    // Radio text
     bool           _selected; // Radio state
+    bool           _dirty;    // Flag for drawing the radio again on the next refresh
 
 };
 
@@ -11,7 +11,8 @@ TouchToggle::TouchToggle(const uint8_t row, const char *text, const bool toggled
   // Initialize members
   _y((26 * row) + 31),
   _text(text),
-  _toggled(toggled)
+  _toggled(toggled),
+  _dirty(true)
 
 {}
 
@@ -63,6 +64,9 @@ void TouchToggle::draw(GFXcanvas16 &canvas) {
   canvas.setCursor(5, _y + 18);
   canvas.print(_text);
 
+  // The toggle is up to date now
+  _dirty = false;
+
 }
 
 // ================================================================================================
@@ -70,7 +74,7 @@ void TouchToggle::draw(GFXcanvas16 &canvas) {
 // ================================================================================================
 void TouchToggle::toggleOn() {
 
-  _toggled = true;
+  setToggleState(true);
 
 }
 
@@ -79,7 +83,7 @@ void TouchToggle::toggleOn() {
 // ================================================================================================
 void TouchToggle::toggleOff() {
 
-  _toggled = false;
+  setToggleState(false);
 
 }
 
@@ -89,7 +93,7 @@ void TouchToggle::toggleOff() {
 void TouchToggle::toggle() {
 
   // Invert state i.e. toggle
-  _toggled = !_toggled;
+  setToggleState(!_toggled);
 
 }
 
@@ -98,6 +102,9 @@ void TouchToggle::toggle() {
 // ================================================================================================
 void TouchToggle::setToggleState(const bool toggled) {
 
+  // Only draw the toggle again if the state changed, this is set on every loop iteration
+  if (_toggled != toggled) { _dirty = true; }
+
   _toggled = toggled;
 
 }
@@ -109,4 +116,13 @@ bool TouchToggle::getToggleState() {
 
   return _toggled;
 
+}
+
+// ================================================================================================
+// Get whether the toggle changed since it was last drawn
+// ================================================================================================
+bool TouchToggle::getDirtyState() {
+
+  return _dirty;
+
 }
\ No newline at end of file
@@ -24,6 +24,7 @@ class TouchToggle {
     void toggle();                               // Toggle state
     void setToggleState(const bool toggled);     // Toggle a specific state
     bool getToggleState();                       // Return the toggle state
+    bool getDirtyState();                        // Get whether the toggle changed since it was last drawn
 
   //-----------------------------------------------------------------------------------------------
   // Private
@@ -33,6 +34,7 @@ class TouchToggle {
     const uint16_t _y;       // Y position
     const char     *_text;   // Toggle text
     bool           _toggled; // Toggle state
+    bool           _dirty;   // Flag for drawing the toggle again on the next refresh
 
 };
 
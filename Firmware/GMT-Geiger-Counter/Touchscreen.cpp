@@ -42,8 +42,19 @@ void Touchscreen::begin() {
     _display.begin();
     _display.fillScreen(ILI9341_BLACK);
 
-    // Set the frame buffer rotation
-    _canvas.setRotation(_rotation);
+    // The checksums don't know what's on the display yet, so write the whole first frame
+    _invalidated = true;
+
+    // Without a second frame buffer, drawing has to wait until the frame buffer has been written to the display
+    _doubleBuffered = _canvases[1].getBuffer() != NULL;
+
+    // Start the display task, that writes the frames to the display while the next one is drawn
+    // Without a display task, frames are written directly
+    if (xTaskCreatePinnedToCore(_displayTask, "display", DISPLAY_TASK_STACK_SIZE_BYTES, this, 1, &_task, DISPLAY_TASK_CORE) != pdPASS) {
+
+      _task = NULL;
+
+    }
 
     // Setup touch controller
     _touch.begin();
@@ -125,6 +136,9 @@ void Touchscreen::update() {
 
   bool refreshImmediately = false;
 
+  // If a frame is waiting for the previous one to be written, try to hand it over again
+  if (_frameReady) { _submitFrame(); }
+
   // Check if touch event is occurring and if the last event has been released
   if (_touch.touched() && _touch.released()) {
 
@@ -166,8 +180,8 @@ void Touchscreen::update() {
 
     }
     
-    // If refresh interval has been reached or refresh flag has been set
-    if (millis() - _lastRefreshMilliseconds > DISPLAY_REFRESH_INTERVAL_MILLISECONDS || refreshImmediately) {
+    // If refresh interval has been reached, refresh flag has been set or a refresh had to wait for the frame buffer
+    if (millis() - _lastRefreshMilliseconds > DISPLAY_REFRESH_INTERVAL_MILLISECONDS || refreshImmediately || _refreshPending) {
 
       // Refresh the display
       refresh();
@@ -186,17 +200,63 @@ void Touchscreen::refresh() {
   // Only write to the display if it is enabled
   if (_enabled) {
 
+    // Never draw into the frame buffer that is being written, that would tear the frame on the display
+    // With a single frame buffer, refresh again once the frame has been written
+    if (_frameInFlight && !_doubleBuffered) {
+
+      _refreshPending = true;
+
+      return;
+
+    }
+
+    _refreshPending = false;
+
+    // The frame buffers have to be drawn from scratch after a screen switch, a rotation or a display reset
+    bool fullDraw = _invalidated || _screen != _drawnScreen || _rotation != _drawnRotation;
+
+    // Otherwise nothing has to be drawn or written if nothing on the screen changed
+    if (!fullDraw && !_screen->getDirtyState()) {
+
+      _lastRefreshMilliseconds = millis();
+
+      return;
+
+    }
+
+    // Start timing the frame
+    uint64_t frameStart = esp_timer_get_time();
+
+    // Get the frame buffer that isn't being written
+    GFXcanvas16 &canvas = _canvases[_drawCanvas];
+
     // Apply display rotation before drawing
-    _canvas.setRotation(_rotation);
+    canvas.setRotation(_rotation);
+
+    // Draw the whole screen to the frame buffer, or only the parts that changed on top of the last frame
+    if (fullDraw) {
+
+      _screen->draw(canvas);
 
-    // Draw the selected screen to the frame buffer
-    _screen->draw(_canvas);
+      _drawnScreen   = _screen;
+      _drawnRotation = _rotation;
+
+    } else {
+
+      _screen->redraw(canvas);
+
+    }
 
     // Unrotate frame buffer before drawing to the screen
-    _canvas.setRotation(0);
+    canvas.setRotation(0);
+
+    // Count the time it took to draw the frame, the display task adds the time it takes to write it
+    _frameMicroseconds += esp_timer_get_time() - frameStart;
+
+    // Hand the frame to the display task, if the previous frame is still being written this is retried on the next update
+    _frameReady = true;
 
-    // Draw the frame buffer to the display
-    _display.drawRGBBitmap(0, 0, _canvas.getBuffer(), _canvas.width(), _canvas.height());
+    _submitFrame();
 
     // Update the refresh interval
     _lastRefreshMilliseconds = millis();
@@ -323,9 +383,284 @@ bool Touchscreen::getTimeoutState() {
 
 }
 
+// ================================================================================================
+// Get the number of frames drawn
+// ================================================================================================
+uint64_t Touchscreen::getFrames() {
+
+  return _frames;
+
+}
+
+// ================================================================================================
+// Get the total time spent drawing and writing frames
+// ================================================================================================
+uint64_t Touchscreen::getFrameMicroseconds() {
+
+  return _frameMicroseconds;
+
+}
+
+// ================================================================================================
+// Get the number of pixel data bytes written to the display
+// ================================================================================================
+uint64_t Touchscreen::getTransferredBytes() {
+
+  return _transferredBytes;
+
+}
+
+// ================================================================================================
+// Get whether a frame is currently being written to the display
+// ================================================================================================
+bool Touchscreen::getFrameInFlightState() {
+
+  return _frameInFlight;
+
+}
+
 // ------------------------------------------------------------------------------------------------
 // Private
 
+// ================================================================================================
+// Hand the drawn frame to the display task, once the previous frame has been written
+// ================================================================================================
+void Touchscreen::_submitFrame() {
+
+  // Wait for the next update if the previous frame is still being written
+  if (_frameInFlight) { return; }
+
+  _frameReady = false;
+
+  // Count the frame
+  _frames++;
+
+  // Collect the tiles that changed since the last frame, if there are none there is nothing to write
+  if (!_findDamagedTiles()) { return; }
+
+  // The drawn frame buffer is written now, the next frame is drawn into the other one if there is one
+  _writeCanvas = _drawCanvas;
+
+  if (_doubleBuffered) {
+
+    // Screens only redraw what changed on top of the last frame, so bring the other frame buffer up to date first
+    _copyRectangles(_canvases[_writeCanvas].getBuffer(), _canvases[!_writeCanvas].getBuffer());
+
+    _drawCanvas = !_writeCanvas;
+
+  }
+
+  // Mark the frame as in flight before the display task gets to see it
+  _frameInFlight = true;
+
+  // Let the display task write the frame
+  if (_task != NULL) {
+
+    xTaskNotifyGive(_task);
+
+  // Without a display task, write the frame directly
+  } else {
+
+    _writeFrame();
+
+  }
+
+}
+
+// ================================================================================================
+// Collect the tiles that changed since the last frame as rectangles, returns true if there are any
+// ================================================================================================
+bool Touchscreen::_findDamagedTiles() {
+
+  // Get the frame buffer that was just drawn
+  const uint16_t *buffer = _canvases[_drawCanvas].getBuffer();
+
+  _rectangleCount = 0;
+
+  // Go through the tiles row by row
+  for (uint16_t row = 0; row < _TILE_ROWS; row++) {
+
+    // First column of the current run of changed tiles, or -1 if there is no run
+    int16_t runStart = -1;
+
+    // Go through every column and one more to close a run that reaches the right edge
+    for (uint16_t column = 0; column <= _TILE_COLUMNS; column++) {
+
+      bool changed = false;
+
+      // If this is an actual tile
+      if (column < _TILE_COLUMNS) {
+
+        // Compare the tile to the one on the display
+        uint32_t checksum = _getTileChecksum(buffer, column, row);
+        uint16_t index    = row * _TILE_COLUMNS + column;
+
+        changed = _invalidated || checksum != _tileChecksums[index];
+
+        _tileChecksums[index] = checksum;
+
+      }
+
+      // If a run of changed tiles starts here
+      if (changed && runStart < 0) {
+
+        runStart = column;
+
+      // If a run of changed tiles ended before this tile
+      } else if (!changed && runStart >= 0) {
+
+        // Neighbouring tiles become one rectangle, so the address window is set only once
+        _rectangles[_rectangleCount++] = {
+
+          (uint16_t)(runStart * DISPLAY_DAMAGE_TILE_SIZE_PIXELS),
+          (uint16_t)(row * DISPLAY_DAMAGE_TILE_SIZE_PIXELS),
+          (uint16_t)((column - runStart) * DISPLAY_DAMAGE_TILE_SIZE_PIXELS),
+          DISPLAY_DAMAGE_TILE_SIZE_PIXELS
+
+        };
+
+        runStart = -1;
+
+      }
+
+    }
+
+  }
+
+  // The checksums now describe the frame that is going to be on the display
+  _invalidated = false;
+
+  return _rectangleCount > 0;
+
+}
+
+// ================================================================================================
+// Write the rectangles of the frame in flight to the display
+// ================================================================================================
+void Touchscreen::_writeFrame() {
+
+  // Start timing the write
+  uint64_t writeStart = esp_timer_get_time();
+
+  // Get the frame buffer that is being written
+  const uint16_t *buffer = _canvases[_writeCanvas].getBuffer();
+
+  // Write the rectangles one at a time
+  // Every rectangle is its own SPI transaction, so touch and SD card access on the shared SPI bus only wait for one rectangle
+  for (uint16_t rectangle = 0; rectangle < _rectangleCount; rectangle++) {
+
+    _writeRectangle(buffer, _rectangles[rectangle]);
+
+  }
+
+  // Count the time it took to write the frame
+  _frameMicroseconds += esp_timer_get_time() - writeStart;
+
+  // The frame buffer can be drawn into again
+  _frameInFlight = false;
+
+}
+
+// ================================================================================================
+// Write a region of a frame buffer to the display
+// ================================================================================================
+void Touchscreen::_writeRectangle(const uint16_t *buffer, const Rectangle &rectangle) {
+
+  // Pointer to the top left pixel of the region in the unrotated frame buffer
+  uint16_t *pixels = (uint16_t*)buffer + rectangle.y * DISPLAY_WIDTH + rectangle.x;
+
+  // Select the display and set the region the pixels are written to
+  _display.startWrite();
+  _display.setAddrWindow(rectangle.x, rectangle.y, rectangle.width, rectangle.height);
+
+  // The region isn't continuous in the frame buffer, so write it line by line
+  for (uint16_t line = 0; line < rectangle.height; line++) {
+
+    _display.writePixels(pixels + line * DISPLAY_WIDTH, rectangle.width);
+
+  }
+
+  // Deselect the display
+  _display.endWrite();
+
+  // Count the transferred pixel data
+  _transferredBytes += rectangle.width * rectangle.height * sizeof(uint16_t);
+
+}
+
+// ================================================================================================
+// Copy the changed regions of the frame in flight from one frame buffer to another
+// ================================================================================================
+void Touchscreen::_copyRectangles(const uint16_t *source, uint16_t *destination) {
+
+  // Go through the changed regions
+  for (uint16_t rectangle = 0; rectangle < _rectangleCount; rectangle++) {
+
+    // Offset of the top left pixel of the region in the unrotated frame buffers
+    uint32_t offset = _rectangles[rectangle].y * DISPLAY_WIDTH + _rectangles[rectangle].x;
+
+    // The region isn't continuous in the frame buffers, so copy it line by line
+    for (uint16_t line = 0; line < _rectangles[rectangle].height; line++) {
+
+      memcpy(destination + offset + line * DISPLAY_WIDTH, source + offset + line * DISPLAY_WIDTH, _rectangles[rectangle].width * sizeof(uint16_t));
+
+    }
+
+  }
+
+}
+
+// ================================================================================================
+// Get the checksum of a tile of a frame buffer
+// ================================================================================================
+uint32_t Touchscreen::_getTileChecksum(const uint16_t *buffer, const uint16_t column, const uint16_t row) {
+
+  // Pointer to the top left pixel of the tile in the unrotated frame buffer
+  const uint16_t *pixels = buffer + row * DISPLAY_DAMAGE_TILE_SIZE_PIXELS * DISPLAY_WIDTH + column * DISPLAY_DAMAGE_TILE_SIZE_PIXELS;
+
+  // FNV-1a offset basis
+  uint32_t checksum = 2166136261;
+
+  // Go through the lines of the tile
+  for (uint16_t line = 0; line < DISPLAY_DAMAGE_TILE_SIZE_PIXELS; line++) {
+
+    // Read two pixels at a time, the tile size is even and the frame buffer is word aligned
+    const uint32_t *words = (const uint32_t*)(pixels + line * DISPLAY_WIDTH);
+
+    for (uint16_t word = 0; word < DISPLAY_DAMAGE_TILE_SIZE_PIXELS / 2; word++) {
+
+      // FNV-1a step with the FNV prime
+      checksum = (checksum ^ words[word]) * 16777619;
+
+    }
+
+  }
+
+  return checksum;
+
+}
+
+// ================================================================================================
+// Task for writing the frames to the display
+// ================================================================================================
+void Touchscreen::_displayTask(void *instancePointer) {
+
+  // Cast the generic instance pointer back to a instance pointer of type Touchscreen
+  Touchscreen *instance = (Touchscreen*)instancePointer;
+
+  // Run forever
+  while (true) {
+
+    // Wait until a frame has been handed over
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    // Write it to the display
+    instance->_writeFrame();
+
+  }
+
+}
+
 // ================================================================================================
 // Constructor
 // ================================================================================================
@@ -334,14 +669,30 @@ Touchscreen::Touchscreen():
   // Initialize members
   _initialized(false),
   _display(DISPLAY_CS_PIN, DISPLAY_DC_PIN, DISPLAY_RST_PIN),
-  _canvas(DISPLAY_WIDTH, DISPLAY_HEIGHT),
+  _canvases{GFXcanvas16(DISPLAY_WIDTH, DISPLAY_HEIGHT), GFXcanvas16(DISPLAY_WIDTH, DISPLAY_HEIGHT)},
   _touch(TOUCH_CS_PIN, TOUCH_IRQ_PIN),
   _screen(&geigerCounter),
   _previousScreen(&geigerCounter),
+  _drawnScreen(NULL),
+  _drawnRotation(DISPLAY_SCREEN_ROTATION_LANDSCAPE),
   _enabled(false),
   _rotation(DISPLAY_SCREEN_ROTATION_LANDSCAPE),
   _timeout(true),
   _lastTouchMilliseconds(0),
-  _lastRefreshMilliseconds(0)
+  _lastRefreshMilliseconds(0),
+  _tileChecksums(),
+  _invalidated(true),
+  _frames(0),
+  _frameMicroseconds(0),
+  _transferredBytes(0),
+  _drawCanvas(0),
+  _writeCanvas(0),
+  _doubleBuffered(false),
+  _rectangles(),
+  _rectangleCount(0),
+  _frameReady(false),
+  _refreshPending(false),
+  _frameInFlight(false),
+  _task(NULL)
 
 {}
\ No newline at end of file
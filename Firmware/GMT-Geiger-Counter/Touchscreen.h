@@ -2,6 +2,7 @@
 #define _TOUCHSCREEN_H
 
 #include "Arduino.h"
+#include <atomic>
 #include "Configuration.h"
 #include "Adafruit_ILI9341.h"
 #include "Adafruit_GFX.h"
@@ -71,6 +72,10 @@ class Touchscreen {
     void setRotationPortrait();                 // Rotate the touchscreen into portrait orientation
     bool getTouchscreenState();                 // Get the touchscreen state
     bool getTimeoutState();                     // Get the auto timeout state
+    uint64_t getFrames();                       // Get the number of frames drawn
+    uint64_t getFrameMicroseconds();            // Get the total time spent drawing and writing frames
+    uint64_t getTransferredBytes();             // Get the number of pixel data bytes written to the display
+    bool getFrameInFlightState();               // Get whether a frame is currently being written to the display
 
   // ----------------------------------------------------------------------------------------------
   // Private
@@ -82,17 +87,60 @@ class Touchscreen {
     Touchscreen(const Touchscreen&) = delete;
     Touchscreen& operator=(const Touchscreen&) = delete;
 
+    // Region of the display that is written in one go
+    struct Rectangle {
+
+      uint16_t x;
+      uint16_t y;
+      uint16_t width;
+      uint16_t height;
+
+    };
+
+    // Number of damage tiles the unrotated frame buffer is split into
+    static const uint16_t _TILE_COLUMNS = DISPLAY_WIDTH  / DISPLAY_DAMAGE_TILE_SIZE_PIXELS;
+    static const uint16_t _TILE_ROWS    = DISPLAY_HEIGHT / DISPLAY_DAMAGE_TILE_SIZE_PIXELS;
+
+    // Most rectangles a frame can have, when every other tile changed
+    static const uint16_t _MAXIMUM_RECTANGLES = _TILE_ROWS * ((_TILE_COLUMNS + 1) / 2);
+
+    void     _submitFrame();                                                                    // Hand the drawn frame to the display task, once the previous frame has been written
+    bool     _findDamagedTiles();                                                               // Collect the tiles that changed since the last frame as rectangles, returns true if there are any
+    void     _writeFrame();                                                                     // Write the rectangles of the frame in flight to the display
+    void     _writeRectangle(const uint16_t *buffer, const Rectangle &rectangle);               // Write a region of a frame buffer to the display
+    void     _copyRectangles(const uint16_t *source, uint16_t *destination);                    // Copy the changed regions of the frame in flight to another frame buffer
+    uint32_t _getTileChecksum(const uint16_t *buffer, const uint16_t column, const uint16_t row); // Get the checksum of a tile of a frame buffer
+
+    // Task for writing the frames to the display
+    static void _displayTask(void *instancePointer);
+
     bool             _initialized;             // Flag for checking if touchscreen was initialized
     Adafruit_ILI9341 _display;                 // Display object
-    GFXcanvas16      _canvas;                  // Frame buffer object
+    GFXcanvas16      _canvases[2];             // Frame buffer objects, one is drawn into while the other one is written to the display
     XPT2046          _touch;                   // Touch object
     Screen           *_screen;                 // Current screen
     Screen           *_previousScreen;         // Previous screen
+    Screen           *_drawnScreen;            // Screen that is in the frame buffers
+    uint8_t          _drawnRotation;           // Rotation orientation the frame buffers were drawn in
     bool             _enabled;                 // Flag for checking if the touchscreen is enabled
     uint8_t          _rotation;                // Touchscreen rotation orientation
     bool             _timeout;                 // Flag for checking if auto timeout is enabled
     uint64_t         _lastTouchMilliseconds;   // Variable for keeping track of when the last touch event occurred
     uint64_t         _lastRefreshMilliseconds; // Timer for refreshing the display
+    uint32_t         _tileChecksums[_TILE_COLUMNS * _TILE_ROWS]; // Checksums of the tiles currently on the display
+    bool             _invalidated;             // Flag for writing the whole frame on the next refresh
+    uint64_t         _frames;                  // Number of frames drawn
+    std::atomic<uint64_t> _frameMicroseconds;  // Total time spent drawing and writing frames
+    std::atomic<uint64_t> _transferredBytes;   // Number of pixel data bytes written to the display
+    uint8_t          _drawCanvas;              // Index of the frame buffer that is drawn into
+    uint8_t          _writeCanvas;             // Index of the frame buffer that is written to the display
+    bool             _doubleBuffered;          // Flag for checking if there is a second frame buffer to draw into
+    Rectangle        _rectangles[_MAXIMUM_RECTANGLES]; // Changed regions of the frame in flight
+    uint16_t         _rectangleCount;          // Number of changed regions of the frame in flight
+    bool             _frameReady;              // Flag for a drawn frame that waits for the previous one to be written
+    bool             _refreshPending;          // Flag for a refresh that had to wait for the only frame buffer to be written
+    std::atomic<bool> _frameInFlight;          // Flag for checking if a frame is being written to the display
+    TaskHandle_t     _task;                    // Handle of the display task
 
 };
 
@@ -6,16 +6,28 @@
 // ================================================================================================
 // Constructor
 // ================================================================================================
-Tube::Tube(const uint8_t pin, volatile uint16_t *movingAverage, volatile uint8_t &movingAverageIndex):
+Tube::Tube(const uint8_t pin, const PulseCapture::Source source, uint32_t &runningSum, uint32_t *runningSumStart, uint8_t &runningSumIndex, uint32_t &runningSumTickMicroseconds):
 
   // Initialize members
   _pin(pin),
-  _movingAverage(movingAverage),
-  _movingAverageIndex(movingAverageIndex),
+  _source(source),
+  _runningSum(runningSum),
+  _runningSumStart(runningSumStart),
+  _runningSumIndex(runningSumIndex),
+  _runningSumTickMicroseconds(runningSumTickMicroseconds),
   _enabled(false),
   _pulseStartTimeMicroseconds(0),
+  _overflowCounts(0),
   _counts(0)
 
+  #if TUBE_COUNTING_MODE == 1
+
+  ,
+  _pulseCounter(NULL),
+  _pulseCount(0)
+
+  #endif
+
 {}
 
 // ================================================================================================
@@ -26,6 +38,134 @@ void Tube::begin() {
   // Set the pin mode to INPUT
   pinMode(_pin, INPUT);
 
+  // If the hardware pulse counter is used
+  #if TUBE_COUNTING_MODE == 1
+
+    // If the pulse counter unit is not yet created
+    if (_pulseCounter == NULL) {
+
+      // Pulse counter unit configuration
+      // The unit only counts up to its limit and then starts over, accumulating the overflows allows the count to go past that limit
+      pcnt_unit_config_t unitConfig = {};
+      unitConfig.low_limit          = -1;
+      unitConfig.high_limit         = INT16_MAX;
+      unitConfig.flags.accum_count  = 1;
+
+      // Create the pulse counter unit
+      if (pcnt_new_unit(&unitConfig, &_pulseCounter) != ESP_OK) {
+
+        // No unit available, the tube will not count
+        _pulseCounter = NULL;
+
+        return;
+
+      }
+
+      // Filter out noise pulses shorter than the glitch filter time
+      pcnt_glitch_filter_config_t filterConfig = {};
+      filterConfig.max_glitch_ns               = TUBE_PULSE_COUNTER_GLITCH_FILTER_NANOSECONDS;
+      pcnt_unit_set_glitch_filter(_pulseCounter, &filterConfig);
+
+      // Pulse counter channel configuration, only the tube pin is used, no control signal
+      pcnt_chan_config_t channelConfig = {};
+      channelConfig.edge_gpio_num      = _pin;
+      channelConfig.level_gpio_num     = -1;
+
+      // Create the pulse counter channel
+      pcnt_channel_handle_t channel = NULL;
+      pcnt_new_channel(_pulseCounter, &channelConfig, &channel);
+
+      // Count once on the rising edge of a pulse and ignore the falling edge
+      pcnt_channel_set_edge_action(channel, PCNT_CHANNEL_EDGE_ACTION_INCREASE, PCNT_CHANNEL_EDGE_ACTION_HOLD);
+
+      // Watch the high limit so that the overflows are accumulated
+      pcnt_unit_add_watch_point(_pulseCounter, INT16_MAX);
+
+    }
+
+  #endif
+
+}
+
+// ================================================================================================
+// Move the pulses recorded by the ISR into the running sum and the total counts
+// ================================================================================================
+void Tube::update() {
+
+  // If the hardware pulse counter is used
+  #if TUBE_COUNTING_MODE == 1
+
+    // If the pulse counter unit exists
+    if (_pulseCounter != NULL) {
+
+      // Read the hardware pulse counter
+      int pulseCount = 0;
+      pcnt_unit_get_count(_pulseCounter, &pulseCount);
+
+      // Get the number of counts since the last update
+      uint32_t newCounts = (uint32_t)(pulseCount - _pulseCount);
+
+      // If there are any, add them to the running sum
+      // The counter has no timestamps, so the counts belong to the second they were read in
+      // If the main loop was late, the counts of the seconds it missed all go into the current second
+      if (newCounts) {
+
+        _runningSum += newCounts;
+        _counts     += newCounts;
+        _pulseCount  = pulseCount;
+
+      }
+
+    }
+
+  // If the tube ISR is used
+  #else
+
+    // Pulse variable
+    PulseBuffer::Pulse pulse;
+
+    // For every pulse the ISR has recorded since the last update
+    while (_pulseBuffer.pop(pulse)) {
+
+      // Time from the pulse to the start of the current second
+      int32_t ageMicroseconds = (int32_t)(_runningSumTickMicroseconds - pulse.timeMicroseconds);
+
+      // If the pulse happened before the current second started, it belongs to an earlier second
+      // The seconds are started by the timer ISR exactly one second apart, so the timestamp tells how many seconds back that was
+      // This also holds when the main loop was late by more than one second and several seconds were started since the last update
+      if (ageMicroseconds > 0) {
+
+        // Number of seconds the pulse has to be moved back, at most past the oldest second of the array
+        uint8_t secondsBack = min((uint32_t)(ageMicroseconds - 1) / 1000000 + 1, (uint32_t)60);
+
+        // Moving the start of every second after the pulse up by the counts moves them into the second the pulse happened in
+        for (uint8_t second = 0; second < secondsBack; second++) { _runningSumStart[(_runningSumIndex + 60 - second) % 60] += pulse.counts; }
+
+      }
+
+      // Add the counts to the running sum
+      _runningSum += pulse.counts;
+
+      // Add the counts to the total number of counts
+      _counts += pulse.counts;
+
+    }
+
+    // Get the counts that did not fit into the pulse buffer since the last update
+    uint32_t overflowCounts = _pulseBuffer.getOverflowCounts();
+    uint32_t newCounts      = overflowCounts - _overflowCounts;
+
+    // If there are any, add them to the current second, only their timestamps are lost
+    if (newCounts) {
+
+      _runningSum     += newCounts;
+      _counts         += newCounts;
+      _overflowCounts  = overflowCounts;
+
+    }
+
+  #endif
+
 }
 
 // ================================================================================================
@@ -36,8 +176,29 @@ void Tube::enable() {
   // If not already enabled
   if (!_enabled) {
 
-    // Attach a hardware interrupt to the tube pin calling the _countPulse ISR on state change and passing the class instance pointer to it
-    attachInterruptArg(digitalPinToInterrupt(_pin), _countPulse, this, CHANGE);
+    // If the hardware pulse counter is used
+    #if TUBE_COUNTING_MODE == 1
+
+      // If the pulse counter unit exists
+      if (_pulseCounter != NULL) {
+
+        // Start counting from zero
+        pcnt_unit_enable(_pulseCounter);
+        pcnt_unit_clear_count(_pulseCounter);
+        pcnt_unit_start(_pulseCounter);
+
+        // Reset the last read value
+        _pulseCount = 0;
+
+      }
+
+    // If the tube ISR is used
+    #else
+
+      // Attach a hardware interrupt to the tube pin calling the _countPulse ISR on state change and passing the class instance pointer to it
+      attachInterruptArg(digitalPinToInterrupt(_pin), _countPulse, this, CHANGE);
+
+    #endif
 
     // Set the enabled flag to true
     _enabled = true;
@@ -54,8 +215,28 @@ void Tube::disable() {
   // If not already disabled
   if (_enabled) {
 
-    // Detach the hardware interrupt
-    detachInterrupt(digitalPinToInterrupt(_pin));
+    // If the hardware pulse counter is used
+    #if TUBE_COUNTING_MODE == 1
+
+      // If the pulse counter unit exists
+      if (_pulseCounter != NULL) {
+
+        // Collect the counts that were recorded since the last update
+        update();
+
+        // Stop counting
+        pcnt_unit_stop(_pulseCounter);
+        pcnt_unit_disable(_pulseCounter);
+
+      }
+
+    // If the tube ISR is used
+    #else
+
+      // Detach the hardware interrupt
+      detachInterrupt(digitalPinToInterrupt(_pin));
+
+    #endif
 
     // Set the enabled flag to false
     _enabled = false;
@@ -101,6 +282,15 @@ uint64_t Tube::getCounts() {
 
 }
 
+// ================================================================================================
+// Set the total number of counts, e.g. when restoring them
+// ================================================================================================
+void Tube::setCounts(const uint64_t counts) {
+
+  _counts = counts;
+
+}
+
 // ------------------------------------------------------------------------------------------------
 // Private
 
@@ -122,7 +312,10 @@ void IRAM_ATTR Tube::_countPulse(void *instancePointer) {
   }else {
 
     // Calculate the pulse length by subtracting the time from the rising edge to now in microseconds
-    uint64_t pulseLengthMicroseconds = micros() - instance->_pulseStartTimeMicroseconds;
+    uint32_t pulseLengthMicroseconds = micros() - instance->_pulseStartTimeMicroseconds;
+
+    // Number of counts the pulse is counted as
+    uint32_t counts = 0;
 
     // Check if the pulse length is longer than the noise threshold
     if (pulseLengthMicroseconds > TUBE_NOISE_THRESHOLD_MICROSECONDS) {
@@ -135,21 +328,19 @@ void IRAM_ATTR Tube::_countPulse(void *instancePointer) {
       // Use the most precise and fastest method for counting by simply increasing the pulse counter by 1
       #if TOTAL_NUMBER_OF_TUBES <= 2
 
-        // Add one count to the moving average
-        instance->_movingAverage[instance->_movingAverageIndex]++;
-
-        // Add one count to the total number of counts
-        instance->_counts++;
+        // Hand one count to the main loop
+        counts = 1;
+        instance->_pulseBuffer.push(instance->_pulseStartTimeMicroseconds, counts);
 
       // If 3 or more tubes are connected i.e. multiple tubes per pin header
       // Use a counting method that derives the number of counts based on the total pulse length
       #else
 
         // Get the number of full counts by dividing the pulse length by the median single pulse length
-        uint64_t counts = pulseLengthMicroseconds / TUBE_MEDIAN_PULSE_LENGTH_MICROSECONDS;
+        counts = pulseLengthMicroseconds / TUBE_MEDIAN_PULSE_LENGTH_MICROSECONDS;
 
         // Get the remaining part of a count
-        uint64_t remainder = pulseLengthMicroseconds % TUBE_MEDIAN_PULSE_LENGTH_MICROSECONDS;
+        uint32_t remainder = pulseLengthMicroseconds % TUBE_MEDIAN_PULSE_LENGTH_MICROSECONDS;
 
         // If the remaining part of a count is more than the threshold
         if (remainder >= TUBE_PULSE_REMAINDER_THRESHOLD_MICROSECONDS) {
@@ -159,16 +350,18 @@ void IRAM_ATTR Tube::_countPulse(void *instancePointer) {
 
         }
 
-        // Add the calculated number of counts to the moving average
-        instance->_movingAverage[instance->_movingAverageIndex] += counts;
-
-        // Add the calculated number of counts to the total number of counts
-        instance->_counts += counts;
+        // Hand the calculated number of counts to the main loop
+        instance->_pulseBuffer.push(instance->_pulseStartTimeMicroseconds, counts);
 
       #endif
 
     }
 
+    // If the pulse capture is enabled in the main configuration file, record the pulse, a pulse rejected as noise is recorded with 0 counts
+    #if ENABLE_PULSE_CAPTURE == 1
+      pulseCapture.capture((PulseCapture::Source)instance->_source, instance->_pulseStartTimeMicroseconds, pulseLengthMicroseconds, counts);
+    #endif
+
   }
 
 }
\ No newline at end of file
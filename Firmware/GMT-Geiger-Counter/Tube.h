@@ -3,6 +3,21 @@
 
 #include "Arduino.h"
 #include "Configuration.h"
+#include "PulseBuffer.h"
+#include "PulseCapture.h"
+
+#if TUBE_COUNTING_MODE == 1
+#include "driver/pulse_cnt.h"
+
+#if TOTAL_NUMBER_OF_TUBES > 2
+#error "The hardware pulse counter (TUBE_COUNTING_MODE 1) only supports up to 2 tubes!"
+#endif
+
+#endif
+
+#if ENABLE_PULSE_CAPTURE == 1 && TUBE_COUNTING_MODE == 1
+#error "The pulse capture (ENABLE_PULSE_CAPTURE 1) needs the tube ISR counting mode (TUBE_COUNTING_MODE 0)!"
+#endif
 
 class Tube {
 
@@ -12,26 +27,40 @@ class Tube {
   public:
 
     // Constructor
-    Tube(const uint8_t pin, volatile uint16_t *movingAverage, volatile uint8_t &movingAverageIndex);
+    Tube(const uint8_t pin, const PulseCapture::Source source, uint32_t &runningSum, uint32_t *runningSumStart, uint8_t &runningSumIndex, uint32_t &runningSumTickMicroseconds);
 
-    void begin();                        // Initialize everything
-    void enable();                       // Enable the tube
-    void disable();                      // Disable the tube
-    void setTubeState(const bool state); // Set the tube state
-    bool getTubeState();                 // Returns if the tube is enabled
-    uint64_t getCounts();                // Get the total number of counts
+    void     begin();                          // Initialize everything
+    void     update();                         // Move the pulses recorded by the ISR into the running sum and the total counts
+    void     enable();                         // Enable the tube
+    void     disable();                        // Disable the tube
+    void     setTubeState(const bool state);   // Set the tube state
+    bool     getTubeState();                   // Returns if the tube is enabled
+    uint64_t getCounts();                      // Get the total number of counts
+    void     setCounts(const uint64_t counts); // Set the total number of counts, e.g. when restoring them
 
   // ----------------------------------------------------------------------------------------------
   // Private
 
   private:
 
-    const uint8_t     _pin;                        // The pin, the tube is connected to
-    volatile uint16_t *_movingAverage;             // Pointer to the moving average array
-    volatile uint8_t  &_movingAverageIndex;        // Reference to the moving average array index
-    bool              _enabled;                    // Flag for checking if tube is enabled
-    volatile uint64_t _pulseStartTimeMicroseconds; // Timer for measuring the pulse length
-    volatile uint64_t _counts;                     // Total number of counts
+    const uint8_t     _pin;                            // The pin, the tube is connected to
+    const uint8_t     _source;                         // Source the pulses of the tube are captured as
+    uint32_t          &_runningSum;                    // Reference to the running sum of counts
+    uint32_t          *_runningSumStart;               // Pointer to the array of running sums at the start of each second
+    uint8_t           &_runningSumIndex;               // Reference to the index of the current second
+    uint32_t          &_runningSumTickMicroseconds;    // Reference to the time the current second started
+    bool              _enabled;                        // Flag for checking if tube is enabled
+    volatile uint32_t _pulseStartTimeMicroseconds;     // Timer for measuring the pulse length
+    PulseBuffer       _pulseBuffer;                    // Buffer of pulses handed from the ISR to the main loop
+    uint32_t          _overflowCounts;                 // Last seen overflow counts of the pulse buffer
+    uint64_t          _counts;                         // Total number of counts
+
+    #if TUBE_COUNTING_MODE == 1
+
+    pcnt_unit_handle_t _pulseCounter;                  // Handle of the hardware pulse counter unit
+    int                _pulseCount;                    // Last read value of the hardware pulse counter
+
+    #endif
 
     // Interrupt service routine for counting pulses
     static void IRAM_ATTR _countPulse(void *instancePointer);
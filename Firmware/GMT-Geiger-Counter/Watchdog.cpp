@@ -54,6 +54,12 @@ void Watchdog::update() {
 
   ) {
 
+    // Save the total counts and the radiation history, a torn record is discarded by the journal
+    geigerCounter.save();
+
+    // Write the log buffer to the SD card
+    logger.close();
+
     // OH SHIT, OH FUCK, OH SHIT, OH FUCK, NO MORE MEMORY REBOOT NOW!!!!
     ESP.restart();
 
@@ -3,6 +3,7 @@
 
 #include "Arduino.h"
 #include "Configuration.h"
+#include "GeigerCounter.h"
 
 class Watchdog {
 
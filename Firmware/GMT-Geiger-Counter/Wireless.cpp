@@ -6,6 +6,21 @@
 // Initialize global reference
 Wireless& wireless = Wireless::getInstance();
 
+// MIME types of the web app files
+const Wireless::MIMEType Wireless::_MIME_TYPES[] = {
+
+  {".html",  "text/html"             },
+  {".css",   "text/css"              },
+  {".js",    "application/javascript"},
+  {".json",  "application/json"      },
+  {".svg",   "image/svg+xml"         },
+  {".png",   "image/png"             },
+  {".ico",   "image/x-icon"          },
+  {".woff2", "font/woff2"            },
+  {".txt",   "text/plain"            }
+
+};
+
 // ================================================================================================
 // Get the single instance of the class
 // ================================================================================================
@@ -65,6 +80,18 @@ void Wireless::begin() {
     // Handle all HTTP request not previously defined
     server.onNotFound(_handleRequest);
 
+    // Keep the request headers the endpoints need, the web server drops all others
+    const char *headers[] = {"Range", "Accept-Encoding", "If-None-Match"};
+
+    server.collectHeaders(headers, 3);
+
+    // Create the lock shared by the main loop and the request handlers
+    _mutex = xSemaphoreCreateRecursiveMutex();
+
+    // Start the web server task, it handles the HTTP clients from here on
+    // All endpoints have to be assigned before this, the web server doesn't expect them to change while it's running
+    xTaskCreatePinnedToCore(_serverTask, "server", WIRELESS_SERVER_TASK_STACK_SIZE_BYTES, this, 1, &_task, WIRELESS_SERVER_TASK_CORE);
+
   }
 
 }
@@ -74,9 +101,6 @@ void Wireless::begin() {
 // ================================================================================================
 void Wireless::update() {
 
-  // Update HTTP clients
-  server.handleClient();
-
   // Get the current number of hotspot clients
   uint8_t currentHotspotClients = WiFi.softAPgetStationNum();
 
@@ -136,6 +160,42 @@ void Wireless::update() {
 
 }
 
+// ================================================================================================
+// Take the lock that keeps the main loop and the request handlers from using the same data at the same time
+// ================================================================================================
+void Wireless::lock() {
+
+  // Without a lock, e.g. before the wireless interface is initialized, there is only the main loop
+  if (_mutex == NULL) { return; }
+
+  // Count the waiting task, so the main loop knows to let it have the lock
+  _lockWaiters++;
+
+  xSemaphoreTakeRecursive(_mutex, portMAX_DELAY);
+
+  _lockWaiters--;
+
+}
+
+// ================================================================================================
+// Give the lock back
+// ================================================================================================
+void Wireless::unlock() {
+
+  if (_mutex != NULL) { xSemaphoreGiveRecursive(_mutex); }
+
+}
+
+// ================================================================================================
+// Wait until the request handlers waiting for the lock got it (main loop only, after unlock())
+// ================================================================================================
+void Wireless::yieldLock() {
+
+  // The main loop would otherwise take the lock again right away, before a waiting request handler on the other core gets to it
+  while (_lockWaiters > 0) { vTaskDelay(1); }
+
+}
+
 // ================================================================================================
 // Enable the WiFi
 // ================================================================================================
@@ -487,7 +547,11 @@ Wireless::Wireless():
   _wifiPassword(""),
   _ipAddress(""),
   _hotspotClients(0),
-  _wifiConnectionAttemptMilliseconds(0)
+  _wifiConnectionAttemptMilliseconds(0),
+  _mutex(NULL),
+  _task(NULL),
+  _lockWaiters(0),
+  _cache()
 
 {}
 
@@ -499,10 +563,7 @@ void Wireless::_enableServer() {
   // If the HTTP server is disabled
   if (!_serverEnabled) {
 
-    // Start the HTTP server
-    server.begin();
-
-    // Set the enabled flag to true
+    // Set the enabled flag to true, the web server task starts the HTTP server
     _serverEnabled = true;
 
     // Create event data
@@ -528,10 +589,7 @@ void Wireless::_disableServer() {
   // If the HTTP server is enabled
   if (_serverEnabled) {
 
-    // Stop the HTTP server
-    server.stop();
-
-    // Set the enabled flag to false
+    // Set the enabled flag to false, the web server task stops the HTTP server
     _serverEnabled = false;
 
     // Create event data
@@ -554,77 +612,118 @@ void Wireless::_disableServer() {
 // ================================================================================================
 void Wireless::_handleRequest() {
 
+  // Keep the SD card mounted until the resource was sent
+  sdCard.lock();
+
   // If the SD card is mounted
   if (sdCard.getMountState()) {
 
-    // Construct resource path
+    // Construct resource path, a directory is resolved to its "index.html"
     String path  = SD_CARD_WEB_APP_DIRECTORY;
            path += wireless.server.uri();
 
-    // Flag for checking if resource was found
-    bool found = false;
+    if (path.endsWith("/")) { path += "index.html"; }
+
+    // Check if the client accepts precompressed resources and which version of the resource it already has
+    bool   gzip = wireless.server.header("Accept-Encoding").indexOf("gzip") >= 0;
+    String etag = wireless.server.header("If-None-Match");
+
+    // Look for the resource in the cache first, preferring the precompressed version
+    bool       compressed = false;
+    CachedFile *cached    = NULL;
+
+    if (gzip) { cached = wireless._getCachedFile(path + ".gz"); compressed = (cached != NULL); }
+
+    if (cached == NULL) { cached = wireless._getCachedFile(path); }
+
+    // If the resource is not cached, get it from the SD card
+    File file;
 
-    // Check if resource exists
-    if (sdCard.exists(path.c_str())) {
+    if (cached == NULL) {
 
-      // Open path
-      File element = sdCard.open(path.c_str());
+      // Open the resource
+      file = wireless._openWebAppFile(path, gzip, compressed);
 
       // Check if the path element is a directory
-      if (element && element.isDirectory()) {
+      if (file && file.isDirectory()) {
 
-        // Add a generic "index.html" to the end of the path either with or without a leading "/"
-        if (path.endsWith("/")) { path += "index.html";  }
-        else                    { path += "/index.html"; }
+        // Close the directory and open its "index.html" instead
+        file.close();
+
+        path += "/index.html";
+        file  = wireless._openWebAppFile(path, gzip, compressed);
 
       }
 
-      // Close the path element
-      element.close();
+    }
 
-      // Check if the resource path exists
-      if (sdCard.exists(path.c_str())) {
+    // If the resource was found
+    if (cached != NULL || (file && !file.isDirectory())) {
 
-        // Open the resource
-        File file = sdCard.open(path.c_str());
+      // Get the entity tag, it changes whenever the file on the SD card is replaced
+      String currentEtag = (cached != NULL) ? cached->etag : "\"" + String(file.size(), HEX) + "-" + String((uint32_t)file.getLastWrite(), HEX) + (compressed ? "-gz" : "") + "\"";
 
-        // If the resource was successfully accessed
-        if (file) {
+      // Send the caching and encoding headers
+      wireless._sendWebAppHeaders(path, currentEtag, compressed);
 
-          // Data type string
-          String type = "text/html";
+      // If the client already has this version of the resource
+      if (etag == currentEtag) {
 
-          // Depending on the file type change the data type string
-          if      (path.endsWith(".html")) { type = "text/html";              }
-          else if (path.endsWith(".css") ) { type = "text/css";               }
-          else if (path.endsWith(".js")  ) { type = "application/javascript"; }
-          else if (path.endsWith(".json")) { type = "application/json";       }
-          else if (path.endsWith(".svg") ) { type = "image/svg+xml";          }
-          else                             { type = "text/plain";             }
+        // Return with a 304 - Not Modified, without reading the resource
+        wireless.server.send(304, _getMIMEType(path), "");
 
-          // Stream the resource data to the HTTP client
-          wireless.server.streamFile(file, type);
+      } else {
 
-          // Set the resource found flag to true
-          found = true;
+        // If the resource is small enough, keep it in the cache
+        if (cached == NULL) { cached = wireless._cacheFile(compressed ? path + ".gz" : path, file, currentEtag); }
 
-        }
+        // Send the resource data straight from the cache
+        if (cached != NULL) {
 
-        // Close the resource
-        file.close();
+          wireless.server.send_P(200, _getMIMEType(path), (const char*)cached->data, cached->size);
+
+        // Or stream it from the SD card
+        } else {
+
+          // Send the response header, the length is known in advance
+          wireless.server.setContentLength(file.size());
+          wireless.server.send(200, _getMIMEType(path), "");
+
+          // Chunk buffer
+          char buffer[WEB_APP_REQUEST_CHUNK_BYTES];
+
+          // Go to the first byte
+          file.seek(0);
+
+          // Until the whole resource is sent
+          while (true) {
+
+            // Read the next piece of the resource
+            size_t length = file.read((uint8_t*)buffer, sizeof(buffer));
+
+            // If there is nothing left or reading failed, stop
+            if (length == 0) { break; }
+
+            // Send the piece
+            wireless.server.sendContent(buffer, length);
+
+          }
+
+        }
 
       }
 
-    }
-    
     // If resource was not found
-    if (!found) {
-    
+    } else {
+
       // Return with a 404 - Not found!
       wireless.server.send(404, "text/plain", "404 - Not found!");
 
-    } 
-  
+    }
+
+    // Close the resource
+    file.close();
+
   // If the SD card is not mounted
   } else {
 
@@ -633,6 +732,180 @@ void Wireless::_handleRequest() {
 
   }
 
+  sdCard.unlock();
+
+}
+
+// ================================================================================================
+// Open a web app file, preferring its precompressed ".gz" sibling if the client accepts it
+// ================================================================================================
+File Wireless::_openWebAppFile(const String &path, const bool gzip, bool &compressed) {
+
+  // If the client accepts precompressed files and there is one, open that
+  if (gzip && sdCard.exists((path + ".gz").c_str())) {
+
+    compressed = true;
+
+    return sdCard.open((path + ".gz").c_str());
+
+  }
+
+  compressed = false;
+
+  // Otherwise open the file itself, if it exists
+  // Checking first keeps a missing file from being reported as an SD card error
+  if (sdCard.exists(path.c_str())) { return sdCard.open(path.c_str()); }
+
+  return File();
+
+}
+
+// ================================================================================================
+// Get a web app file from the cache, NULL if it's not cached
+// ================================================================================================
+Wireless::CachedFile* Wireless::_getCachedFile(const String &path) {
+
+  // For every cache slot
+  for (uint8_t i = 0; i < WEB_APP_CACHE_FILES; i++) {
+
+    // If the slot holds the file and it was read since the SD card was last mounted
+    if (_cache[i].path == path && _cache[i].mounts == sdCard.getMounts()) {
+
+      // Remember when the file was used, so the least recently used file is replaced first
+      _cache[i].lastUsed = millis();
+
+      return &_cache[i];
+
+    }
+
+  }
+
+  return NULL;
+
+}
+
+// ================================================================================================
+// Read a web app file into the cache, NULL if it can't be cached
+// ================================================================================================
+Wireless::CachedFile* Wireless::_cacheFile(const String &path, File &file, const String &etag) {
+
+  // If the file is too large to be cached, it's sent straight from the SD card
+  if (WEB_APP_CACHE_FILES == 0 || file.size() > WEB_APP_CACHE_MAXIMUM_FILE_BYTES) { return NULL; }
+
+  // Use a free or outdated cache slot, otherwise replace the least recently used file
+  CachedFile *slot = &_cache[0];
+
+  for (uint8_t i = 0; i < WEB_APP_CACHE_FILES; i++) {
+
+    if (_cache[i].path.isEmpty() || _cache[i].mounts != sdCard.getMounts()) { slot = &_cache[i]; break; }
+
+    if (_cache[i].lastUsed < slot->lastUsed) { slot = &_cache[i]; }
+
+  }
+
+  // Free the previous file
+  free(slot->data);
+
+  slot->path = "";
+  slot->data = NULL;
+
+  // Allocate the file content in the PSRAM only, the internal RAM is too small to spare for this
+  slot->data = (uint8_t*)heap_caps_malloc(max((size_t)file.size(), (size_t)1), MALLOC_CAP_SPIRAM);
+
+  if (slot->data == NULL) { return NULL; }
+
+  // Read the whole file
+  file.seek(0);
+
+  slot->size = file.read(slot->data, file.size());
+
+  // If reading failed, free the slot again
+  if (slot->size != file.size()) {
+
+    free(slot->data);
+
+    slot->data = NULL;
+
+    sdCard.reportError();
+
+    return NULL;
+
+  }
+
+  // Fill in the rest of the slot
+  slot->path     = path;
+  slot->etag     = etag;
+  slot->mounts   = sdCard.getMounts();
+  slot->lastUsed = millis();
+
+  return slot;
+
+}
+
+// ================================================================================================
+// Send the caching and encoding headers of a web app file
+// ================================================================================================
+void Wireless::_sendWebAppHeaders(const String &path, const String &etag, const bool compressed) {
+
+  // Let the client check if its copy is still current with the entity tag
+  server.sendHeader("ETag", etag);
+
+  // Files with a content hash in their name never change, so the client can keep them
+  // Everything else is checked with the entity tag on every use, which costs a 304 - Not Modified instead of the whole file
+  if (_isHashedFile(path)) { server.sendHeader("Cache-Control", "public, max-age=31536000, immutable"); }
+  else                     { server.sendHeader("Cache-Control", "no-cache");                            }
+
+  // The response depends on whether the client accepts precompressed files
+  server.sendHeader("Vary", "Accept-Encoding");
+
+  if (compressed) { server.sendHeader("Content-Encoding", "gzip"); }
+
+}
+
+// ================================================================================================
+// Get the MIME type of a web app file
+// ================================================================================================
+const char* Wireless::_getMIMEType(const String &path) {
+
+  // Get the file extension
+  int         dot       = path.lastIndexOf('.');
+  const char *extension = (dot >= 0) ? path.c_str() + dot : "";
+
+  // Look up the MIME type of the file extension
+  for (uint8_t i = 0; i < sizeof(_MIME_TYPES) / sizeof(_MIME_TYPES[0]); i++) {
+
+    if (strcasecmp(extension, _MIME_TYPES[i].extension) == 0) { return _MIME_TYPES[i].type; }
+
+  }
+
+  // Unknown files are sent as plain text
+  return "text/plain";
+
+}
+
+// ================================================================================================
+// Check if a file name contains a content hash, like "app.3f2a9c1d.js"
+// ================================================================================================
+bool Wireless::_isHashedFile(const String &path) {
+
+  // Get the file name
+  String name = path.substring(path.lastIndexOf('/') + 1);
+
+  // Get the part between the first and the last dot of the file name
+  int first = name.indexOf('.');
+  int last  = name.lastIndexOf('.');
+
+  // A content hash is at least 8 hexadecimal digits
+  if (first < 0 || last - first - 1 < 8) { return false; }
+
+  for (int i = first + 1; i < last; i++) {
+
+    if (!isxdigit(name[i])) { return false; }
+
+  }
+
+  return true;
+
 }
 
 // ================================================================================================
@@ -663,9 +936,11 @@ void Wireless::_handleWiFiCredentials() {
       // If the request body contains the WiFi password value
       if (wifiPasswordStart != -1 && wifiPasswordEnd != -1) {
 
-        // Extract and set the WiFi name and password
+        // Extract and set the WiFi name and password, the main loop uses them too
+        wireless.lock();
         wireless.setWiFiName(json.substring(wifiNameStart, wifiNameEnd).c_str());
         wireless.setWiFiPassword(json.substring(wifiPasswordStart, wifiPasswordEnd).c_str());
+        wireless.unlock();
 
         // Set the valid credentials flag to true
         validCredentials = true;
@@ -690,4 +965,46 @@ void Wireless::_handleWiFiCredentials() {
 
   }
 
+}
+
+// ================================================================================================
+// Task for handling the HTTP clients, so the main loop doesn't have to wait for them
+// ================================================================================================
+void Wireless::_serverTask(void *instancePointer) {
+
+  // Cast the generic instance pointer back to a instance pointer of type Wireless
+  Wireless *instance = (Wireless*)instancePointer;
+
+  // Flag for checking if the HTTP server is running
+  bool running = false;
+
+  // Run forever
+  while (true) {
+
+    // Start or stop the HTTP server here, so it never changes while a client is being handled
+    if (instance->_serverEnabled != running) {
+
+      if (instance->_serverEnabled) { instance->server.begin(); }
+      else                          { instance->server.stop();  }
+
+      running = instance->_serverEnabled;
+
+    }
+
+    // If the HTTP server is running, handle the HTTP clients, this waits a millisecond if there are none
+    // The clients are handled one after the other, a request is only taken on once the previous one was answered
+    // Concurrent clients would need a server that keeps the state of every connection apart, every request handler uses the state of this one
+    if (running) {
+
+      instance->server.handleClient();
+
+    // Otherwise check again later
+    } else {
+
+      vTaskDelay(pdMS_TO_TICKS(100));
+
+    }
+
+  }
+
 }
\ No newline at end of file
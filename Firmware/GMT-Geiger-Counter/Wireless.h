@@ -9,6 +9,7 @@
 #include "WiFi.h"
 #include "WebServer.h"
 #include "Preferences.h"
+#include <atomic>
 
 class Wireless {
 
@@ -18,13 +19,17 @@ class Wireless {
   public:
 
     // HTTP webserver for data logging and web-app interface
+    // It is synchronous, the web server task takes the requests off the main loop but still answers one client after the other
     WebServer server;
 
     // Get the single instance of the class
     static Wireless& getInstance();
 
-    void        begin();                                       // Initialize everything
+    void        begin();                                       // Initialize everything and start the web server task
     void        update();                                      // Update the wireless interfaces
+    void        lock();                                        // Take the lock that keeps the main loop and the request handlers from using the same data at the same time
+    void        unlock();                                      // Give the lock back
+    void        yieldLock();                                   // Wait until the request handlers waiting for the lock got it (main loop only, after unlock())
     void        enableWiFi();                                  // Enable the WiFi
     void        disableWiFi();                                 // Disable the WiFi
     void        resetWiFi();                                   // Reset the WiFi
@@ -51,21 +56,58 @@ class Wireless {
     Wireless(const Wireless&) = delete;
     Wireless& operator=(const Wireless&) = delete;
 
-    bool        _initialized;                       // Flag for checking if the wireless interface was initialized
-    bool        _wifiEnabled;                       // Flag for checking if the WiFi is enabled
-    bool        _hotspotEnabled;                    // Flag for checking if the hotspot is enabled
-    bool        _serverEnabled;                     // Flag for checking if the webserver is enabled
-    String      _wifiName;                          // WiFi Name string
-    String      _wifiPassword;                      // WiFi password string
-    String      _ipAddress;                         // WiFi IP address string
-    Preferences _preferences;                       // WiFi preferences stored in non-volatile memory
-    uint8_t     _hotspotClients;                    // Number of connected hotspot clients
-    uint64_t    _wifiConnectionAttemptMilliseconds; // Milliseconds since the last WiFi connection attempt
-
-    void        _enableServer();          // Enable the HTTP server
-    void        _disableServer();         // Disable the HTTP server
-    static void _handleRequest();         // Handle all HTTP requests not previously defined
-    static void _handleWiFiCredentials(); // Handle updates of the WiFi credentials via the web interface
+    bool                 _initialized;                       // Flag for checking if the wireless interface was initialized
+    bool                 _wifiEnabled;                       // Flag for checking if the WiFi is enabled
+    bool                 _hotspotEnabled;                    // Flag for checking if the hotspot is enabled
+    volatile bool        _serverEnabled;                     // Flag for checking if the webserver is enabled, the web server task starts and stops it accordingly
+    String               _wifiName;                          // WiFi Name string
+    String               _wifiPassword;                      // WiFi password string
+    String               _ipAddress;                         // WiFi IP address string
+    Preferences          _preferences;                       // WiFi preferences stored in non-volatile memory
+    uint8_t              _hotspotClients;                    // Number of connected hotspot clients
+    uint64_t             _wifiConnectionAttemptMilliseconds; // Milliseconds since the last WiFi connection attempt
+    SemaphoreHandle_t    _mutex;                             // Recursive mutex shared by the main loop and the request handlers
+    TaskHandle_t         _task;                              // Handle of the web server task
+    std::atomic<uint8_t> _lockWaiters;                       // Number of tasks waiting for the lock
+
+    // Web app file extension and its MIME type
+    struct MIMEType {
+
+      const char *extension; // File extension including the dot
+      const char *type;      // MIME type
+
+    };
+
+    // Web app file kept in the PSRAM
+    struct CachedFile {
+
+      String   path;     // Path of the file on the SD card, empty if the cache slot is free
+      String   etag;     // Entity tag of the file
+      uint8_t  *data;    // File content
+      size_t   size;     // File size in bytes
+      uint32_t mounts;   // SD card mount count the file was read with
+      uint32_t lastUsed; // Milliseconds when the file was last requested
+
+    };
+
+    // MIME types of the web app files
+    static const MIMEType _MIME_TYPES[];
+
+    CachedFile _cache[WEB_APP_CACHE_FILES]; // Web app files kept in the PSRAM
+
+    void        _enableServer();                                                                   // Enable the HTTP server
+    void        _disableServer();                                                                  // Disable the HTTP server
+    File        _openWebAppFile(const String &path, const bool gzip, bool &compressed);            // Open a web app file, preferring its precompressed ".gz" sibling if the client accepts it
+    CachedFile* _getCachedFile(const String &path);                                                // Get a web app file from the cache, NULL if it's not cached
+    CachedFile* _cacheFile(const String &path, File &file, const String &etag);                    // Read a web app file into the cache, NULL if it can't be cached
+    void        _sendWebAppHeaders(const String &path, const String &etag, const bool compressed); // Send the caching and encoding headers of a web app file
+    static void _handleRequest();                                                                  // Handle all HTTP requests not previously defined
+    static void _handleWiFiCredentials();                                                          // Handle updates of the WiFi credentials via the web interface
+    static const char* _getMIMEType(const String &path);                                           // Get the MIME type of a web app file
+    static bool _isHashedFile(const String &path);                                                 // Check if a file name contains a content hash, like "app.3f2a9c1d.js"
+
+    // Task for handling the HTTP clients
+    static void _serverTask(void *instancePointer);
     
 };
 
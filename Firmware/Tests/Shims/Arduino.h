@@ -0,0 +1,273 @@
+#ifndef _ARDUINO_H
+#define _ARDUINO_H
+
+// Host replacement for the parts of the Arduino ESP32 core the firmware uses
+// Time is virtual and only moves when it is advanced, see Shims.h for how the tests control it
+
+#include <stdint.h>
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <math.h>
+#include <string>
+#include <algorithm>
+#include <type_traits>
+
+using std::min;
+using std::max;
+
+// ================================================================================================
+// Attributes, constants and macros
+// ================================================================================================
+
+#define IRAM_ATTR
+#define PROGMEM
+#define PGM_P const char *
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT  0x01
+#define OUTPUT 0x03
+
+#define RISING  0x01
+#define FALLING 0x02
+#define CHANGE  0x03
+
+#define HEX 16
+#define DEC 10
+
+#define RGB_BUILTIN 48
+
+#define constrain(amount, low, high) ((amount) < (low) ? (low) : ((amount) > (high) ? (high) : (amount)))
+
+typedef uint8_t byte;
+
+// ================================================================================================
+// String
+// ================================================================================================
+
+class String {
+
+  public:
+
+    String(const char *text = "")                  : _text(text ? text : "") {}
+    String(const std::string &text)                : _text(text)             {}
+    String(const char character)                   : _text(1, character)     {}
+    String(const double value, const int decimals = 2) { char buffer[64]; snprintf(buffer, sizeof(buffer), "%.*f", decimals, value); _text = buffer; }
+    String(const float value, const int decimals = 2)  : String((double)value, decimals) {}
+
+    template<typename T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, char>::value, int>::type = 0>
+    String(const T value, const int base = DEC) { char buffer[32]; snprintf(buffer, sizeof(buffer), base == HEX ? "%llx" : (std::is_signed<T>::value ? "%lld" : "%llu"), (long long)value); _text = buffer; }
+
+    const char *c_str() const                       { return _text.c_str(); }
+    unsigned int length() const                     { return _text.size(); }
+    bool isEmpty() const                            { return _text.empty(); }
+    bool reserve(const unsigned int size)           { _text.reserve(size); return true; }
+    char charAt(const unsigned int index) const     { return index < _text.size() ? _text[index] : 0; }
+    char operator[](const unsigned int index) const { return charAt(index); }
+
+    bool equals(const String &other) const          { return _text == other._text; }
+    bool operator==(const String &other) const      { return _text == other._text; }
+    bool operator!=(const String &other) const      { return _text != other._text; }
+    bool operator==(const char *other) const        { return _text == other; }
+    bool operator!=(const char *other) const        { return _text != other; }
+    bool operator<(const String &other) const       { return _text < other._text; }
+
+    bool startsWith(const String &prefix) const     { return _text.compare(0, prefix._text.size(), prefix._text) == 0; }
+    bool endsWith(const String &suffix) const       { return _text.size() >= suffix._text.size() && _text.compare(_text.size() - suffix._text.size(), suffix._text.size(), suffix._text) == 0; }
+
+    int indexOf(const char character, const unsigned int from = 0) const    { size_t index = _text.find(character, from); return index == std::string::npos ? -1 : (int)index; }
+    int indexOf(const String &text, const unsigned int from = 0) const      { size_t index = _text.find(text._text, from); return index == std::string::npos ? -1 : (int)index; }
+    int lastIndexOf(const char character) const                             { size_t index = _text.rfind(character); return index == std::string::npos ? -1 : (int)index; }
+    String substring(const unsigned int from) const                         { return from < _text.size() ? String(_text.substr(from)) : String(); }
+    String substring(const unsigned int from, const unsigned int to) const  { return from < _text.size() && from < to ? String(_text.substr(from, to - from)) : String(); }
+
+    long toInt() const                              { return strtol(_text.c_str(), NULL, 10); }
+    double toDouble() const                         { return strtod(_text.c_str(), NULL); }
+    float toFloat() const                           { return (float)toDouble(); }
+    void toLowerCase()                              { for (char &character : _text) { character = tolower(character); } }
+    void toUpperCase()                              { for (char &character : _text) { character = toupper(character); } }
+    void trim()                                     { size_t start = _text.find_first_not_of(" \t\r\n"); size_t end = _text.find_last_not_of(" \t\r\n"); _text = start == std::string::npos ? "" : _text.substr(start, end - start + 1); }
+
+    String &operator+=(const String &other)         { _text += other._text; return *this; }
+    String &operator+=(const char *other)           { _text += other; return *this; }
+    String &operator+=(const char other)            { _text += other; return *this; }
+    template<typename T, typename std::enable_if<std::is_arithmetic<T>::value && !std::is_same<T, char>::value, int>::type = 0>
+    String &operator+=(const T other)               { return *this += String(other); }
+    bool concat(const String &other)                { _text += other._text; return true; }
+
+  private:
+
+    std::string _text;
+
+};
+
+inline String operator+(const String &left, const String &right) { String result(left); result += right; return result; }
+inline String operator+(const String &left, const char *right)   { String result(left); result += right; return result; }
+inline String operator+(const char *left, const String &right)   { String result(left); result += right; return result; }
+template<typename T, typename std::enable_if<std::is_arithmetic<T>::value, int>::type = 0>
+inline String operator+(const String &left, const T right)       { String result(left); result += right; return result; }
+
+// ================================================================================================
+// Print and serial port
+// ================================================================================================
+
+class Print {
+
+  public:
+
+    virtual ~Print() {}
+
+    virtual size_t write(const uint8_t character)                  { return write(&character, 1); }
+    virtual size_t write(const uint8_t *buffer, const size_t size) { (void)buffer; return size; }
+    size_t write(const char *buffer, const size_t size)            { return write((const uint8_t *)buffer, size); }
+    size_t write(const char *text)                                 { return write((const uint8_t *)text, strlen(text)); }
+    virtual int availableForWrite()                                { return 0x7FFFFFFF; }
+    virtual void flush()                                           {}
+
+    size_t print(const String &text)                               { return write(text.c_str()); }
+    size_t print(const char *text)                                 { return write(text); }
+    size_t print(const char character)                             { return write((const uint8_t)character); }
+    size_t print(const double value, const int decimals = 2)       { return print(String(value, decimals)); }
+    template<typename T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, char>::value, int>::type = 0>
+    size_t print(const T value, const int base = DEC)              { return print(String(value, base)); }
+    template<typename T>
+    size_t println(const T value)                                  { size_t size = print(value); return size + write("\r\n"); }
+    size_t println()                                               { return write("\r\n"); }
+    size_t printf(const char *format, ...)                         { char buffer[1024]; va_list arguments; va_start(arguments, format); int size = vsnprintf(buffer, sizeof(buffer), format, arguments); va_end(arguments); return size > 0 ? write((const uint8_t *)buffer, min((size_t)size, sizeof(buffer) - 1)) : 0; }
+
+};
+
+class HardwareSerial : public Print {
+
+  public:
+
+    void begin(const unsigned long baudRate)   { (void)baudRate; }
+    void end()                                 {}
+    void setTxBufferSize(const size_t size)    { (void)size; }
+    void setRxBufferSize(const size_t size)    { (void)size; }
+    int available()                            { return 0; }
+    int read()                                 { return -1; }
+    operator bool()                            { return true; }
+
+};
+
+extern HardwareSerial Serial;
+
+// ================================================================================================
+// Time
+// ================================================================================================
+
+unsigned long millis();
+unsigned long micros();
+int64_t       esp_timer_get_time();
+void          delay(const uint32_t milliseconds);
+void          delayMicroseconds(const uint32_t microseconds);
+void          yield();
+
+// ================================================================================================
+// Pins and pin interrupts
+// ================================================================================================
+
+#define digitalPinToInterrupt(pin) (pin)
+
+void pinMode(const uint8_t pin, const uint8_t mode);
+void digitalWrite(const uint8_t pin, const uint8_t value);
+int  digitalRead(const uint8_t pin);
+void attachInterrupt(const uint8_t pin, void (*function)(), const int mode);
+void attachInterruptArg(const uint8_t pin, void (*function)(void *), void *argument, const int mode);
+void detachInterrupt(const uint8_t pin);
+void rgbLedWrite(const uint8_t pin, const uint8_t red, const uint8_t green, const uint8_t blue);
+
+// ================================================================================================
+// Hardware timers
+// ================================================================================================
+
+struct hw_timer_t;
+
+hw_timer_t *timerBegin(const uint32_t frequency);
+void        timerEnd(hw_timer_t *timer);
+void        timerAttachInterruptArg(hw_timer_t *timer, void (*function)(void *), void *argument);
+void        timerDetachInterrupt(hw_timer_t *timer);
+void        timerAlarm(hw_timer_t *timer, const uint64_t alarmValue, const bool autoReload, const uint64_t reloadCount);
+
+// ================================================================================================
+// System
+// ================================================================================================
+
+uint32_t esp_random();
+bool     psramFound();
+void     *ps_malloc(const size_t size);
+void     *ps_calloc(const size_t count, const size_t size);
+
+#define MALLOC_CAP_SPIRAM  (1 << 10)
+#define MALLOC_CAP_8BIT    (1 << 2)
+#define MALLOC_CAP_DEFAULT (1 << 12)
+
+inline void *heap_caps_malloc(const size_t size, const uint32_t capabilities) { (void)capabilities; return malloc(size); }
+
+class EspClass {
+
+  public:
+
+    uint32_t getHeapSize()     { return 327680; }
+    uint32_t getFreeHeap()     { return 262144; }
+    uint32_t getMinFreeHeap()  { return 262144; }
+    uint32_t getMaxAllocHeap() { return 131072; }
+    uint32_t getPsramSize()    { return 0;      }
+    uint32_t getFreePsram()    { return 0;      }
+    uint32_t getCycleCount()   { return (uint32_t)(esp_timer_get_time() * 240); }
+    void     restart()         {}
+
+};
+
+extern EspClass ESP;
+
+// ================================================================================================
+// FreeRTOS
+// ================================================================================================
+
+typedef void     *TaskHandle_t;
+typedef void     *SemaphoreHandle_t;
+typedef void     *QueueHandle_t;
+typedef int      BaseType_t;
+typedef unsigned UBaseType_t;
+typedef uint32_t TickType_t;
+typedef int      portMUX_TYPE;
+
+#define pdTRUE                      1
+#define pdFALSE                     0
+#define pdPASS                      1
+#define pdFAIL                      0
+#define portMAX_DELAY               0xFFFFFFFF
+#define portTICK_PERIOD_MS          1
+#define pdMS_TO_TICKS(milliseconds) ((TickType_t)(milliseconds))
+#define portMUX_INITIALIZER_UNLOCKED 0
+
+#define portENTER_CRITICAL(mux)     ((void)(mux))
+#define portEXIT_CRITICAL(mux)      ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux) ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux)  ((void)(mux))
+#define portYIELD_FROM_ISR(...)     ((void)0)
+
+BaseType_t        xTaskCreatePinnedToCore(void (*function)(void *), const char *name, const uint32_t stackSize, void *argument, const UBaseType_t priority, TaskHandle_t *handle, const BaseType_t core);
+void              vTaskDelete(TaskHandle_t task);
+void              vTaskDelay(const TickType_t ticks);
+TickType_t        xTaskGetTickCount();
+void              xTaskNotifyGive(TaskHandle_t task);
+void              vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higherPriorityTaskWoken);
+uint32_t          ulTaskNotifyTake(const BaseType_t clearOnExit, const TickType_t ticks);
+SemaphoreHandle_t xSemaphoreCreateMutex();
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex();
+SemaphoreHandle_t xSemaphoreCreateBinary();
+BaseType_t        xSemaphoreTake(SemaphoreHandle_t semaphore, const TickType_t ticks);
+BaseType_t        xSemaphoreGive(SemaphoreHandle_t semaphore);
+BaseType_t        xSemaphoreTakeRecursive(SemaphoreHandle_t semaphore, const TickType_t ticks);
+BaseType_t        xSemaphoreGiveRecursive(SemaphoreHandle_t semaphore);
+BaseType_t        xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore, BaseType_t *higherPriorityTaskWoken);
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef _FS_H
+#define _FS_H
+
+// Host replacement for the Arduino ESP32 file system API, backed by a host directory
+// See Shims::setFileSystemRoot() and Shims::injectFileSystemFault()
+
+#include "Arduino.h"
+#include <memory>
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+enum SeekMode {
+
+  SeekSet,
+  SeekCur,
+  SeekEnd
+
+};
+
+class File : public Print {
+
+  public:
+
+    struct Implementation;
+
+    File() {}
+    File(std::shared_ptr<Implementation> implementation) : _implementation(implementation) {}
+
+    operator bool() const;
+
+    size_t   write(const uint8_t character) override;
+    size_t   write(const uint8_t *buffer, const size_t size) override;
+    void     flush() override;
+    int      available();
+    int      read();
+    size_t   read(uint8_t *buffer, const size_t size);
+    bool     seek(const uint32_t position, const SeekMode mode = SeekSet);
+    size_t   position();
+    size_t   size();
+    void     close();
+    bool     isDirectory();
+    File     openNextFile();
+    const char *name();
+    const char *path();
+    time_t   getLastWrite();
+
+    using Print::write;
+
+  private:
+
+    std::shared_ptr<Implementation> _implementation;
+
+};
+
+class FS {
+
+  public:
+
+    FS(const char *name) : _name(name) {}
+
+    File     open(const char *path, const char *mode = FILE_READ, const bool create = false);
+    File     open(const String &path, const char *mode = FILE_READ, const bool create = false) { return open(path.c_str(), mode, create); }
+    bool     exists(const char *path);
+    bool     exists(const String &path) { return exists(path.c_str()); }
+    bool     remove(const char *path);
+    bool     remove(const String &path) { return remove(path.c_str()); }
+    bool     rename(const char *from, const char *to);
+    bool     rename(const String &from, const String &to) { return rename(from.c_str(), to.c_str()); }
+    bool     mkdir(const char *path);
+    bool     mkdir(const String &path) { return mkdir(path.c_str()); }
+    bool     rmdir(const char *path);
+    uint64_t totalBytes();
+    uint64_t usedBytes();
+
+    std::string getHostPath(const char *path); // Get the host path of a file system path
+
+  protected:
+
+    const char *_name;
+    bool       _mounted = false;
+
+};
+
+#endif
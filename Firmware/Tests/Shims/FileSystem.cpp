@@ -0,0 +1,387 @@
+#include "Shims.h"
+#include "FS.h"
+#include "LittleFS.h"
+#include "SD.h"
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <errno.h>
+
+// ------------------------------------------------------------------------------------------------
+// Global objects
+
+LittleFSFS LittleFS;
+SDFS       SD;
+
+// ------------------------------------------------------------------------------------------------
+// Fault injection
+
+static std::string   _root;
+static Shims::Fault  _fault          = Shims::NO_FAULT;
+static uint32_t      _faultOperation = 0;
+static uint32_t      _operations     = 0;
+
+// ================================================================================================
+// Back the LittleFS and SD file systems with subdirectories of a host directory
+// ================================================================================================
+void Shims::setFileSystemRoot(const char *directory) {
+
+  _root = directory;
+
+}
+
+// ================================================================================================
+// Inject a fault into the n-th modifying file system operation from now on
+// ================================================================================================
+void Shims::injectFileSystemFault(const Fault fault, const uint32_t operation) {
+
+  _fault          = fault;
+  _faultOperation = _operations + operation;
+
+}
+
+// ================================================================================================
+// Get the number of modifying file system operations so far
+// ================================================================================================
+uint32_t Shims::getFileSystemOperations() {
+
+  return _operations;
+
+}
+
+// ================================================================================================
+// Count a modifying operation and get the fault to apply to it
+// ================================================================================================
+static Shims::Fault _countOperation() {
+
+  _operations++;
+
+  if (_fault != Shims::NO_FAULT && _operations == _faultOperation) {
+
+    Shims::Fault fault = _fault;
+
+    _fault = Shims::NO_FAULT;
+
+    return fault;
+
+  }
+
+  return Shims::NO_FAULT;
+
+}
+
+// ================================================================================================
+// Stop the process like a power loss would, nothing after this point reaches the file system
+// ================================================================================================
+static void _losePower() {
+
+  fflush(stdout);
+
+  _exit(Shims::POWER_LOSS_EXIT_CODE);
+
+}
+
+// ------------------------------------------------------------------------------------------------
+// File
+
+struct File::Implementation {
+
+  FILE        *file;      // Open host file, NULL for a directory
+  DIR         *directory; // Open host directory, NULL for a file
+  std::string path;       // File system path
+  std::string hostPath;   // Host path
+  std::string name;       // File name
+  FS          *fs;        // File system the file belongs to
+
+  ~Implementation() {
+
+    if (file != NULL)      { fclose(file);     }
+    if (directory != NULL) { closedir(directory); }
+
+  }
+
+};
+
+File::operator bool() const { return _implementation && (_implementation->file != NULL || _implementation->directory != NULL); }
+
+size_t File::write(const uint8_t character) {
+
+  return write(&character, 1);
+
+}
+
+size_t File::write(const uint8_t *buffer, const size_t size) {
+
+  if (!*this || _implementation->file == NULL) { return 0; }
+
+  Shims::Fault fault = _countOperation();
+
+  // A fault only gets half of the data to the file
+  size_t length = fault == Shims::NO_FAULT ? size : size / 2;
+
+  size_t written = fwrite(buffer, 1, length, _implementation->file);
+
+  // Nothing is cached, whatever was written is on the file system
+  fflush(_implementation->file);
+
+  if (fault == Shims::POWER_LOSS) { _losePower(); }
+
+  return written;
+
+}
+
+void File::flush() {
+
+  if (*this && _implementation->file != NULL) { fflush(_implementation->file); }
+
+}
+
+int File::available() {
+
+  if (!*this || _implementation->file == NULL) { return 0; }
+
+  return (int)(size() - position());
+
+}
+
+int File::read() {
+
+  uint8_t character;
+
+  return read(&character, 1) == 1 ? character : -1;
+
+}
+
+size_t File::read(uint8_t *buffer, const size_t size) {
+
+  if (!*this || _implementation->file == NULL) { return 0; }
+
+  return fread(buffer, 1, size, _implementation->file);
+
+}
+
+bool File::seek(const uint32_t position, const SeekMode mode) {
+
+  if (!*this || _implementation->file == NULL) { return false; }
+
+  int origin = mode == SeekSet ? SEEK_SET : (mode == SeekCur ? SEEK_CUR : SEEK_END);
+
+  // Seeking past the end of a file fails like on the device
+  if (mode == SeekSet && position > size()) { return false; }
+
+  return fseek(_implementation->file, position, origin) == 0;
+
+}
+
+size_t File::position() {
+
+  if (!*this || _implementation->file == NULL) { return 0; }
+
+  return ftell(_implementation->file);
+
+}
+
+size_t File::size() {
+
+  if (!*this || _implementation->file == NULL) { return 0; }
+
+  struct stat status;
+
+  return fstat(fileno(_implementation->file), &status) == 0 ? status.st_size : 0;
+
+}
+
+void File::close() {
+
+  _implementation.reset();
+
+}
+
+bool File::isDirectory() {
+
+  return *this && _implementation->directory != NULL;
+
+}
+
+File File::openNextFile() {
+
+  if (!isDirectory()) { return File(); }
+
+  // Skip the current and parent directory entries
+  struct dirent *entry;
+
+  do { entry = readdir(_implementation->directory); } while (entry != NULL && (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0));
+
+  if (entry == NULL) { return File(); }
+
+  std::string path = _implementation->path + (_implementation->path.back() == '/' ? "" : "/") + entry->d_name;
+
+  return _implementation->fs->open(path.c_str());
+
+}
+
+const char *File::name() { return _implementation ? _implementation->name.c_str() : ""; }
+const char *File::path() { return _implementation ? _implementation->path.c_str() : ""; }
+
+time_t File::getLastWrite() {
+
+  struct stat status;
+
+  return _implementation && stat(_implementation->hostPath.c_str(), &status) == 0 ? status.st_mtime : 0;
+
+}
+
+// ------------------------------------------------------------------------------------------------
+// File systems
+
+std::string FS::getHostPath(const char *path) {
+
+  return _root + "/" + _name + (path[0] == '/' ? "" : "/") + path;
+
+}
+
+File FS::open(const char *path, const char *mode, const bool create) {
+
+  if (!_mounted) { return File(); }
+
+  std::string hostPath = getHostPath(path);
+
+  auto implementation = std::make_shared<File::Implementation>();
+
+  implementation->file      = NULL;
+  implementation->directory = NULL;
+  implementation->path      = path;
+  implementation->hostPath  = hostPath;
+  implementation->name      = strrchr(path, '/') ? strrchr(path, '/') + 1 : path;
+  implementation->fs        = this;
+
+  // Directories can only be opened for reading
+  struct stat status;
+
+  if (strcmp(mode, FILE_READ) == 0 && stat(hostPath.c_str(), &status) == 0 && S_ISDIR(status.st_mode)) {
+
+    implementation->directory = opendir(hostPath.c_str());
+
+    return File(implementation);
+
+  }
+
+  // Opening a file for writing modifies the file system
+  bool modifying = strcmp(mode, FILE_READ) != 0;
+
+  if (modifying) {
+
+    Shims::Fault fault = _countOperation();
+
+    if (fault == Shims::FAILURE)    { return File(); }
+    if (fault == Shims::POWER_LOSS) { _losePower();  }
+
+  }
+
+  // Create the parent directories if requested
+  if (create) {
+
+    for (size_t slash = hostPath.find('/', _root.size() + 1); slash != std::string::npos; slash = hostPath.find('/', slash + 1)) { ::mkdir(hostPath.substr(0, slash).c_str(), 0755); }
+
+  }
+
+  const char *hostMode = strcmp(mode, FILE_READ) == 0 ? "rb" : (strcmp(mode, FILE_WRITE) == 0 ? "wb" : (strcmp(mode, FILE_APPEND) == 0 ? "ab+" : "rb+"));
+
+  implementation->file = fopen(hostPath.c_str(), hostMode);
+
+  // Like on the device, an append handle starts at the end and a read handle at the start
+  if (implementation->file != NULL && strcmp(mode, FILE_APPEND) == 0) { fseek(implementation->file, 0, SEEK_END); }
+
+  return File(implementation);
+
+}
+
+bool FS::exists(const char *path) {
+
+  struct stat status;
+
+  return _mounted && stat(getHostPath(path).c_str(), &status) == 0;
+
+}
+
+bool FS::remove(const char *path) {
+
+  if (!_mounted) { return false; }
+
+  Shims::Fault fault = _countOperation();
+
+  if (fault == Shims::FAILURE)    { return false; }
+  if (fault == Shims::POWER_LOSS) { _losePower(); }
+
+  return ::unlink(getHostPath(path).c_str()) == 0;
+
+}
+
+bool FS::rename(const char *from, const char *to) {
+
+  if (!_mounted) { return false; }
+
+  Shims::Fault fault = _countOperation();
+
+  if (fault == Shims::FAILURE)    { return false; }
+  if (fault == Shims::POWER_LOSS) { _losePower(); }
+
+  // Renaming is atomic, like on LittleFS
+  return ::rename(getHostPath(from).c_str(), getHostPath(to).c_str()) == 0;
+
+}
+
+bool FS::mkdir(const char *path) {
+
+  return _mounted && (::mkdir(getHostPath(path).c_str(), 0755) == 0 || errno == EEXIST);
+
+}
+
+bool FS::rmdir(const char *path) {
+
+  return _mounted && ::rmdir(getHostPath(path).c_str()) == 0;
+
+}
+
+uint64_t FS::totalBytes() { return 1 << 20; }
+uint64_t FS::usedBytes()  { return 0;       }
+
+// ================================================================================================
+// Mount a file system by creating its host directory
+// ================================================================================================
+static bool _mount(const std::string &hostPath) {
+
+  if (_root.empty()) { return false; }
+
+  // Create the root directory and its parents
+  for (size_t slash = _root.find('/', 1); slash != std::string::npos; slash = _root.find('/', slash + 1)) { ::mkdir(_root.substr(0, slash).c_str(), 0755); }
+
+  ::mkdir(_root.c_str(), 0755);
+
+  return ::mkdir(hostPath.c_str(), 0755) == 0 || errno == EEXIST;
+
+}
+
+bool LittleFSFS::begin(const bool formatOnFail, const char *basePath, const uint8_t maxOpenFiles, const char *partitionLabel) {
+
+  (void)formatOnFail; (void)basePath; (void)maxOpenFiles; (void)partitionLabel;
+
+  _mounted = _mount(_root + "/" + _name);
+
+  return _mounted;
+
+}
+
+void LittleFSFS::end() { _mounted = false; }
+
+bool SDFS::begin(const uint8_t ssPin, const uint32_t frequency, const char *mountpoint, const uint8_t maxFiles) {
+
+  (void)ssPin; (void)frequency; (void)mountpoint; (void)maxFiles;
+
+  _mounted = _mount(_root + "/" + _name);
+
+  return _mounted;
+
+}
+
+void SDFS::end() { _mounted = false; }
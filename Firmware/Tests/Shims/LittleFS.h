@@ -0,0 +1,19 @@
+#ifndef _LITTLEFS_H
+#define _LITTLEFS_H
+
+#include "FS.h"
+
+class LittleFSFS : public FS {
+
+  public:
+
+    LittleFSFS() : FS("littlefs") {}
+
+    bool begin(const bool formatOnFail = false, const char *basePath = "/littlefs", const uint8_t maxOpenFiles = 10, const char *partitionLabel = "spiffs");
+    void end();
+
+};
+
+extern LittleFSFS LittleFS;
+
+#endif
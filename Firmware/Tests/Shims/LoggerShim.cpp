@@ -0,0 +1,50 @@
+#include "LoggerShim.h"
+#include <map>
+#include <vector>
+
+// Last log message of each type
+static std::map<std::string, std::vector<Logger::KeyValuePair>> _messages;
+
+// ------------------------------------------------------------------------------------------------
+// Logger
+
+Logger& logger = Logger::getInstance();
+
+Logger& Logger::getInstance() {
+
+  static Logger instance;
+
+  return instance;
+
+}
+
+Logger::Logger() {}
+
+void Logger::begin() {}
+
+void Logger::log(const LogLevel level, const char *type, const KeyValuePair *data, const uint8_t size, const bool sdCardData) {
+
+  (void)level; (void)sdCardData;
+
+  _messages[type].assign(data, data + size);
+
+}
+
+// ================================================================================================
+// Get a value of the last log message of a type
+// ================================================================================================
+bool Shims::getLogValue(const char *type, const char *key, Logger::KeyValuePair &pair) {
+
+  auto message = _messages.find(type);
+
+  if (message == _messages.end()) { return false; }
+
+  for (const Logger::KeyValuePair &value : message->second) {
+
+    if (strcmp(value.key, key) == 0) { pair = value; return true; }
+
+  }
+
+  return false;
+
+}
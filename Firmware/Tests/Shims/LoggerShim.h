@@ -0,0 +1,14 @@
+#ifndef _LOGGER_SHIM_H
+#define _LOGGER_SHIM_H
+
+#include "Logger.h"
+
+// Replacement for the logger in tests that don't build Logger.cpp
+// Nothing is written anywhere, the last log message of each type is kept so that tests can check it
+namespace Shims {
+
+  bool getLogValue(const char *type, const char *key, Logger::KeyValuePair &pair); // Get a value of the last log message of a type
+
+}
+
+#endif
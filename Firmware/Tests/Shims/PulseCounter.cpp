@@ -0,0 +1,197 @@
+#include "Shims.h"
+#include "driver/pulse_cnt.h"
+#include <vector>
+
+// ------------------------------------------------------------------------------------------------
+// Pulse counter units and channels
+
+// Pulse counter unit structure
+struct pcnt_unit_t {
+
+  pcnt_unit_config_t config;            // Unit configuration
+  uint32_t           glitchNanoseconds; // Pulses up to this length are filtered out
+  bool               enabled;           // Flag for checking if the unit is enabled
+  bool               running;           // Flag for checking if the unit is counting
+  bool               watchHighLimit;    // Flag for checking if there is a watch point at the high limit
+  bool               watchLowLimit;     // Flag for checking if there is a watch point at the low limit
+  int                count;             // Count of the hardware counter
+  int                accumulated;       // Overflows accumulated by the driver
+
+};
+
+// Pulse counter channel structure
+struct pcnt_chan_t {
+
+  pcnt_unit_t                *unit;    // Unit the channel counts into
+  int                        pin;      // Pin the edges are counted on
+  pcnt_channel_edge_action_t positive; // Action on the rising edge
+  pcnt_channel_edge_action_t negative; // Action on the falling edge
+
+};
+
+// The ESP32-S3 has 4 pulse counter units
+static uint8_t                    _availableUnits = 4;
+static uint32_t                   _createdUnits   = 0;
+static std::vector<pcnt_chan_t *> _channels;
+
+// ================================================================================================
+// Set the number of pulse counter units that can still be created
+// ================================================================================================
+void Shims::setPulseCounterUnits(const uint8_t units) {
+
+  _availableUnits = units;
+
+}
+
+// ================================================================================================
+// Get the number of pulse counter units that were created
+// ================================================================================================
+uint32_t Shims::getPulseCounterUnits() {
+
+  return _createdUnits;
+
+}
+
+// ================================================================================================
+// Apply an edge action to the count of a unit
+// ================================================================================================
+static void _count(pcnt_unit_t *unit, const pcnt_channel_edge_action_t action) {
+
+  if (action == PCNT_CHANNEL_EDGE_ACTION_HOLD) { return; }
+
+  unit->count += action == PCNT_CHANNEL_EDGE_ACTION_INCREASE ? 1 : -1;
+
+  // At a limit the hardware counter starts over at zero, the driver only accumulates the overflow if it was asked to and watches that limit
+  if (unit->count == unit->config.high_limit) {
+
+    if (unit->config.flags.accum_count && unit->watchHighLimit) { unit->accumulated += unit->config.high_limit; }
+
+    unit->count = 0;
+
+  } else if (unit->count == unit->config.low_limit) {
+
+    if (unit->config.flags.accum_count && unit->watchLowLimit) { unit->accumulated += unit->config.low_limit; }
+
+    unit->count = 0;
+
+  }
+
+}
+
+// ================================================================================================
+// Send a pulse of a given length to the pulse counter channels on a pin
+// ================================================================================================
+void Shims::addPulseCounterPulse(const uint8_t pin, const uint32_t lengthNanoseconds) {
+
+  for (pcnt_chan_t *channel : _channels) {
+
+    pcnt_unit_t *unit = channel->unit;
+
+    if (channel->pin != pin || !unit->running) { continue; }
+
+    // The glitch filter removes both edges of a pulse that is too short
+    if (lengthNanoseconds <= unit->glitchNanoseconds) { continue; }
+
+    _count(unit, channel->positive);
+    _count(unit, channel->negative);
+
+  }
+
+}
+
+// ------------------------------------------------------------------------------------------------
+// Driver
+
+esp_err_t pcnt_new_unit(const pcnt_unit_config_t *config, pcnt_unit_handle_t *unit) {
+
+  if (_availableUnits == 0) { return ESP_ERR_NOT_FOUND; }
+
+  _availableUnits--;
+  _createdUnits++;
+
+  *unit = new pcnt_unit_t{*config, 0, false, false, false, false, 0, 0};
+
+  return ESP_OK;
+
+}
+
+esp_err_t pcnt_del_unit(pcnt_unit_handle_t unit) {
+
+  if (unit->enabled) { return ESP_ERR_INVALID_STATE; }
+
+  for (auto channel = _channels.begin(); channel != _channels.end();) {
+
+    if ((*channel)->unit == unit) { delete *channel; channel = _channels.erase(channel); } else { channel++; }
+
+  }
+
+  delete unit;
+
+  _availableUnits++;
+
+  return ESP_OK;
+
+}
+
+esp_err_t pcnt_unit_set_glitch_filter(pcnt_unit_handle_t unit, const pcnt_glitch_filter_config_t *config) {
+
+  // The filter counts APB clock cycles of 12.5 ns in a 10 bit register
+  if (config->max_glitch_ns > 1023 * 125 / 10) { return ESP_ERR_INVALID_ARG; }
+
+  unit->glitchNanoseconds = config->max_glitch_ns;
+
+  return ESP_OK;
+
+}
+
+esp_err_t pcnt_new_channel(pcnt_unit_handle_t unit, const pcnt_chan_config_t *config, pcnt_channel_handle_t *channel) {
+
+  *channel = new pcnt_chan_t{unit, config->edge_gpio_num, PCNT_CHANNEL_EDGE_ACTION_HOLD, PCNT_CHANNEL_EDGE_ACTION_HOLD};
+
+  _channels.push_back(*channel);
+
+  return ESP_OK;
+
+}
+
+esp_err_t pcnt_channel_set_edge_action(pcnt_channel_handle_t channel, pcnt_channel_edge_action_t positive, pcnt_channel_edge_action_t negative) {
+
+  channel->positive = positive;
+  channel->negative = negative;
+
+  return ESP_OK;
+
+}
+
+esp_err_t pcnt_unit_add_watch_point(pcnt_unit_handle_t unit, int count) {
+
+  if (count > unit->config.high_limit || count < unit->config.low_limit) { return ESP_ERR_INVALID_ARG; }
+
+  if (count == unit->config.high_limit) { unit->watchHighLimit = true; }
+  if (count == unit->config.low_limit)  { unit->watchLowLimit  = true; }
+
+  return ESP_OK;
+
+}
+
+esp_err_t pcnt_unit_enable(pcnt_unit_handle_t unit)  { if (unit->enabled) { return ESP_ERR_INVALID_STATE; } unit->enabled = true;  return ESP_OK; }
+esp_err_t pcnt_unit_disable(pcnt_unit_handle_t unit) { if (!unit->enabled || unit->running) { return ESP_ERR_INVALID_STATE; } unit->enabled = false; return ESP_OK; }
+esp_err_t pcnt_unit_start(pcnt_unit_handle_t unit)   { if (!unit->enabled) { return ESP_ERR_INVALID_STATE; } unit->running = true;  return ESP_OK; }
+esp_err_t pcnt_unit_stop(pcnt_unit_handle_t unit)    { if (!unit->enabled) { return ESP_ERR_INVALID_STATE; } unit->running = false; return ESP_OK; }
+
+esp_err_t pcnt_unit_clear_count(pcnt_unit_handle_t unit) {
+
+  unit->count       = 0;
+  unit->accumulated = 0;
+
+  return ESP_OK;
+
+}
+
+esp_err_t pcnt_unit_get_count(pcnt_unit_handle_t unit, int *count) {
+
+  *count = unit->accumulated + unit->count;
+
+  return ESP_OK;
+
+}
@@ -0,0 +1,105 @@
+#include "freertos/ringbuf.h"
+#include <deque>
+#include <vector>
+
+// ------------------------------------------------------------------------------------------------
+// Ring buffer
+
+// Ring buffer structure
+struct RingBuffer {
+
+  size_t                            size;  // Size of the buffer in bytes
+  size_t                            used;  // Bytes taken up by the items, including their headers
+  std::deque<std::vector<uint8_t>>  items; // Items in the order they were sent
+  bool                              taken; // Flag for checking if the oldest item was received and not returned yet
+
+};
+
+// Like in the ESP-IDF, every item takes up an 8 byte header and its data rounded up to 4 bytes
+static size_t _getItemSize(const size_t size) {
+
+  return 8 + ((size + 3) & ~(size_t)3);
+
+}
+
+// ================================================================================================
+// Create a ring buffer
+// ================================================================================================
+RingbufHandle_t xRingbufferCreate(const size_t size, const RingbufferType_t type) {
+
+  if (type != RINGBUF_TYPE_NOSPLIT) { return NULL; }
+
+  return new RingBuffer{size, 0, {}, false};
+
+}
+
+// ================================================================================================
+// Delete a ring buffer
+// ================================================================================================
+void vRingbufferDelete(RingbufHandle_t buffer) {
+
+  delete (RingBuffer *)buffer;
+
+}
+
+// ================================================================================================
+// Send an item, fails without waiting if it doesn't fit
+// ================================================================================================
+BaseType_t xRingbufferSend(RingbufHandle_t buffer, const void *item, const size_t size, const TickType_t ticks) {
+
+  RingBuffer *ring = (RingBuffer *)buffer;
+
+  (void)ticks;
+
+  if (ring->used + _getItemSize(size) > ring->size) { return pdFALSE; }
+
+  ring->items.emplace_back((const uint8_t *)item, (const uint8_t *)item + size);
+  ring->used += _getItemSize(size);
+
+  return pdTRUE;
+
+}
+
+// ================================================================================================
+// Receive the oldest item without waiting, it stays in the buffer until it is returned
+// ================================================================================================
+void *xRingbufferReceive(RingbufHandle_t buffer, size_t *size, const TickType_t ticks) {
+
+  RingBuffer *ring = (RingBuffer *)buffer;
+
+  (void)ticks;
+
+  if (ring->items.empty() || ring->taken) { return NULL; }
+
+  ring->taken = true;
+  *size       = ring->items.front().size();
+
+  return ring->items.front().data();
+
+}
+
+// ================================================================================================
+// Return a received item, freeing its space
+// ================================================================================================
+void vRingbufferReturnItem(RingbufHandle_t buffer, void *item) {
+
+  RingBuffer *ring = (RingBuffer *)buffer;
+
+  if (!ring->taken || item != ring->items.front().data()) { return; }
+
+  ring->used -= _getItemSize(ring->items.front().size());
+  ring->items.pop_front();
+  ring->taken = false;
+
+}
+
+// ================================================================================================
+// Get the free space of a ring buffer
+// ================================================================================================
+size_t xRingbufferGetCurFreeSize(RingbufHandle_t buffer) {
+
+  RingBuffer *ring = (RingBuffer *)buffer;
+
+  return ring->size - ring->used;
+
+}
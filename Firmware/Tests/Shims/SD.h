@@ -0,0 +1,19 @@
+#ifndef _SD_H
+#define _SD_H
+
+#include "FS.h"
+
+class SDFS : public FS {
+
+  public:
+
+    SDFS() : FS("sd") {}
+
+    bool begin(const uint8_t ssPin = 10, const uint32_t frequency = 4000000, const char *mountpoint = "/sd", const uint8_t maxFiles = 5);
+    void end();
+
+};
+
+extern SDFS SD;
+
+#endif
@@ -0,0 +1,319 @@
+#include "Shims.h"
+#include <vector>
+#include <random>
+
+// ------------------------------------------------------------------------------------------------
+// Global objects
+
+HardwareSerial Serial;
+EspClass       ESP;
+
+// ------------------------------------------------------------------------------------------------
+// Time
+
+// Hardware timer structure
+struct hw_timer_t {
+
+  void     (*function)(void *); // Interrupt service routine
+  void     *argument;           // Argument passed to the interrupt service routine
+  uint64_t periodMicroseconds;  // Time between two alarms
+  uint64_t nextMicroseconds;    // Time of the next alarm
+  bool     autoReload;          // Flag for repeating the alarm
+  bool     armed;               // Flag for checking if the alarm is set
+
+};
+
+// Virtual time in microseconds
+static uint64_t _microseconds = 0;
+
+// Time the clock moves on every read
+static uint32_t _clockStepMicroseconds = 0;
+
+// Flag for checking if a timer interrupt is running, the clock reads of an ISR don't fire other timers
+static bool _firingTimer = false;
+
+// Hardware timers
+static std::vector<hw_timer_t *> _timers;
+
+// ================================================================================================
+// Move the virtual time forward, firing the hardware timers that are due on the way
+// ================================================================================================
+void Shims::advanceMicroseconds(const uint64_t microseconds) {
+
+  uint64_t target = _microseconds + microseconds;
+
+  // Time doesn't stop for an ISR, but it can't fire other timers
+  if (_firingTimer) { _microseconds = target; return; }
+
+  for (;;) {
+
+    // Find the next alarm that is due
+    hw_timer_t *next = NULL;
+
+    for (hw_timer_t *timer : _timers) {
+
+      if (timer->armed && timer->function != NULL && timer->nextMicroseconds <= target && (next == NULL || timer->nextMicroseconds < next->nextMicroseconds)) { next = timer; }
+
+    }
+
+    if (next == NULL) { break; }
+
+    // Move to the alarm time and fire it
+    if (next->nextMicroseconds > _microseconds) { _microseconds = next->nextMicroseconds; }
+
+    next->nextMicroseconds += next->periodMicroseconds;
+    next->armed             = next->autoReload;
+
+    _firingTimer = true;
+    next->function(next->argument);
+    _firingTimer = false;
+
+    // The ISR might have read the clock
+    if (_microseconds > target) { target = _microseconds; }
+
+  }
+
+  _microseconds = target;
+
+}
+
+// ================================================================================================
+// Move the virtual time forward by this much on every clock read
+// ================================================================================================
+void Shims::setClockStepMicroseconds(const uint32_t microseconds) {
+
+  _clockStepMicroseconds = microseconds;
+
+}
+
+// ================================================================================================
+// Get the virtual time without moving it
+// ================================================================================================
+uint64_t Shims::getMicroseconds() {
+
+  return _microseconds;
+
+}
+
+int64_t esp_timer_get_time() {
+
+  if (_clockStepMicroseconds) { Shims::advanceMicroseconds(_clockStepMicroseconds); }
+
+  return (int64_t)_microseconds;
+
+}
+
+unsigned long micros()                               { return (uint32_t)esp_timer_get_time(); }
+unsigned long millis()                               { return (uint32_t)(esp_timer_get_time() / 1000); }
+void delay(const uint32_t milliseconds)              { Shims::advanceMicroseconds((uint64_t)milliseconds * 1000); }
+void delayMicroseconds(const uint32_t microseconds)  { Shims::advanceMicroseconds(microseconds); }
+void yield()                                         {}
+
+hw_timer_t *timerBegin(const uint32_t frequency) {
+
+  // Only the 1 MHz timers the firmware uses are supported
+  if (frequency != 1000000) { return NULL; }
+
+  hw_timer_t *timer = new hw_timer_t{NULL, NULL, 0, 0, false, false};
+
+  _timers.push_back(timer);
+
+  return timer;
+
+}
+
+void timerEnd(hw_timer_t *timer) {
+
+  _timers.erase(std::remove(_timers.begin(), _timers.end(), timer), _timers.end());
+
+  delete timer;
+
+}
+
+void timerAttachInterruptArg(hw_timer_t *timer, void (*function)(void *), void *argument) { timer->function = function; timer->argument = argument; }
+void timerDetachInterrupt(hw_timer_t *timer)                                               { timer->function = NULL; }
+
+void timerAlarm(hw_timer_t *timer, const uint64_t alarmValue, const bool autoReload, const uint64_t reloadCount) {
+
+  (void)reloadCount;
+
+  timer->periodMicroseconds = alarmValue;
+  timer->nextMicroseconds   = _microseconds + alarmValue;
+  timer->autoReload         = autoReload;
+  timer->armed              = true;
+
+}
+
+// ------------------------------------------------------------------------------------------------
+// Pins and pin interrupts
+
+// Pin interrupt structure
+struct PinInterrupt {
+
+  void (*function)(void *); // Interrupt service routine with an argument
+  void (*plainFunction)();  // Interrupt service routine without an argument
+  void *argument;           // Argument passed to the interrupt service routine
+  int  mode;                // Edges the interrupt fires on
+
+};
+
+static uint8_t      _pinLevels[64]     = {};
+static PinInterrupt _pinInterrupts[64] = {};
+static void         (*_pinObserver)(const uint8_t pin, const uint8_t level) = NULL;
+
+void Shims::setPinObserver(void (*observer)(const uint8_t pin, const uint8_t level)) { _pinObserver = observer; }
+
+void pinMode(const uint8_t pin, const uint8_t mode) { (void)pin; (void)mode; }
+int  digitalRead(const uint8_t pin)                 { return pin < 64 ? _pinLevels[pin] : LOW; }
+
+void digitalWrite(const uint8_t pin, const uint8_t value) {
+
+  if (pin >= 64) { return; }
+
+  uint8_t level = value ? HIGH : LOW;
+
+  // Nothing happens if the level doesn't change
+  if (_pinLevels[pin] == level) { return; }
+
+  _pinLevels[pin] = level;
+
+  if (_pinObserver != NULL) { _pinObserver(pin, level); }
+
+  // Fire the pin interrupt on a matching edge
+  PinInterrupt &interrupt = _pinInterrupts[pin];
+
+  bool edge = interrupt.mode == CHANGE || (interrupt.mode == RISING && level == HIGH) || (interrupt.mode == FALLING && level == LOW);
+
+  if (edge && interrupt.function != NULL)      { interrupt.function(interrupt.argument); }
+  if (edge && interrupt.plainFunction != NULL) { interrupt.plainFunction(); }
+
+}
+
+void attachInterrupt(const uint8_t pin, void (*function)(), const int mode)                            { if (pin < 64) { _pinInterrupts[pin] = {NULL, function, NULL, mode}; } }
+void attachInterruptArg(const uint8_t pin, void (*function)(void *), void *argument, const int mode)    { if (pin < 64) { _pinInterrupts[pin] = {function, NULL, argument, mode}; } }
+void detachInterrupt(const uint8_t pin)                                                                { if (pin < 64) { _pinInterrupts[pin] = {}; } }
+void rgbLedWrite(const uint8_t pin, const uint8_t red, const uint8_t green, const uint8_t blue)         { (void)pin; (void)red; (void)green; (void)blue; }
+
+// ------------------------------------------------------------------------------------------------
+// Random numbers
+
+static std::mt19937 _random(1);
+
+void     Shims::seedRandom(const uint32_t seed) { _random.seed(seed); }
+uint32_t esp_random()                           { return _random(); }
+
+// ------------------------------------------------------------------------------------------------
+// Memory
+
+bool psramFound()                                     { return false; }
+void *ps_malloc(const size_t size)                    { return malloc(size); }
+void *ps_calloc(const size_t count, const size_t size) { return calloc(count, size); }
+
+// ------------------------------------------------------------------------------------------------
+// Tasks
+
+// Task structure
+struct Task {
+
+  std::string name;               // Task name
+  void        (*function)(void *); // Task function
+  void        *argument;          // Argument passed to the task function
+  bool        deleted;            // Flag for checking if the task was deleted
+
+};
+
+static std::vector<Task *> _tasks;
+static void                (*_delayHook)() = NULL;
+static uint64_t            _taskDeadlineMicroseconds = UINT64_MAX;
+
+// ================================================================================================
+// Run a task created with xTaskCreatePinnedToCore() until its deadline in virtual time
+// ================================================================================================
+void Shims::runTask(const char *name, const uint64_t durationMicroseconds) {
+
+  for (Task *task : _tasks) {
+
+    if (!task->deleted && task->name == name) {
+
+      _taskDeadlineMicroseconds = _microseconds + durationMicroseconds;
+
+      try { task->function(task->argument); } catch (const Shims::TaskStop &) {}
+
+      _taskDeadlineMicroseconds = UINT64_MAX;
+
+      return;
+
+    }
+
+  }
+
+}
+
+// ================================================================================================
+// Set a function called on every vTaskDelay()
+// ================================================================================================
+void Shims::setDelayHook(void (*hook)()) {
+
+  _delayHook = hook;
+
+}
+
+// ================================================================================================
+// Get if a task with this name exists
+// ================================================================================================
+bool Shims::getTaskState(const char *name) {
+
+  for (Task *task : _tasks) { if (!task->deleted && task->name == name) { return true; } }
+
+  return false;
+
+}
+
+BaseType_t xTaskCreatePinnedToCore(void (*function)(void *), const char *name, const uint32_t stackSize, void *argument, const UBaseType_t priority, TaskHandle_t *handle, const BaseType_t core) {
+
+  (void)stackSize; (void)priority; (void)core;
+
+  Task *task = new Task{name, function, argument, false};
+
+  _tasks.push_back(task);
+
+  if (handle != NULL) { *handle = task; }
+
+  return pdPASS;
+
+}
+
+void vTaskDelete(TaskHandle_t task) {
+
+  if (task != NULL) { ((Task *)task)->deleted = true; }
+
+}
+
+void vTaskDelay(const TickType_t ticks) {
+
+  Shims::advanceMicroseconds((uint64_t)ticks * portTICK_PERIOD_MS * 1000);
+
+  if (_delayHook != NULL) { _delayHook(); }
+
+  if (_microseconds >= _taskDeadlineMicroseconds) { throw Shims::TaskStop(); }
+
+}
+
+TickType_t xTaskGetTickCount()                                                               { return (TickType_t)(_microseconds / 1000 / portTICK_PERIOD_MS); }
+void       xTaskNotifyGive(TaskHandle_t task)                                                { (void)task; }
+void       vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higherPriorityTaskWoken)    { (void)task; (void)higherPriorityTaskWoken; }
+uint32_t   ulTaskNotifyTake(const BaseType_t clearOnExit, const TickType_t ticks)            { (void)clearOnExit; (void)ticks; return 0; }
+
+// ------------------------------------------------------------------------------------------------
+// Semaphores, everything runs on one thread so they are always free
+
+static int _semaphore;
+
+SemaphoreHandle_t xSemaphoreCreateMutex()                                                                { return &_semaphore; }
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex()                                                       { return &_semaphore; }
+SemaphoreHandle_t xSemaphoreCreateBinary()                                                               { return &_semaphore; }
+BaseType_t        xSemaphoreTake(SemaphoreHandle_t semaphore, const TickType_t ticks)                    { (void)semaphore; (void)ticks; return pdTRUE; }
+BaseType_t        xSemaphoreGive(SemaphoreHandle_t semaphore)                                            { (void)semaphore; return pdTRUE; }
+BaseType_t        xSemaphoreTakeRecursive(SemaphoreHandle_t semaphore, const TickType_t ticks)           { (void)semaphore; (void)ticks; return pdTRUE; }
+BaseType_t        xSemaphoreGiveRecursive(SemaphoreHandle_t semaphore)                                   { (void)semaphore; return pdTRUE; }
+BaseType_t        xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore, BaseType_t *higherPriorityTaskWoken) { (void)semaphore; (void)higherPriorityTaskWoken; return pdTRUE; }
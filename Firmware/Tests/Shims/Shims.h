@@ -0,0 +1,65 @@
+#ifndef _SHIMS_H
+#define _SHIMS_H
+
+#include "Arduino.h"
+
+// Control over the host replacements of the Arduino core, FreeRTOS and the ESP-IDF drivers
+// Nothing here runs on its own: time only moves when a test advances it, hardware timers and pin interrupts fire synchronously while it does
+namespace Shims {
+
+  // Thrown by vTaskDelay() once the task deadline is reached, ends a task function that would otherwise run forever
+  struct TaskStop {};
+
+  // File system fault enumerator
+  enum Fault {
+
+    NO_FAULT,   // The operation succeeds
+    FAILURE,    // The operation fails, a write only writes half of the data
+    POWER_LOSS  // The process exits in the middle of the operation, a write only writes half of the data
+
+  };
+
+  // Exit code of a process that was stopped by an injected power loss
+  const int POWER_LOSS_EXIT_CODE = 86;
+
+  // ----------------------------------------------------------------------------------------------
+  // Time
+
+  void     advanceMicroseconds(const uint64_t microseconds);          // Move the virtual time forward, firing the hardware timers that are due on the way
+  void     setClockStepMicroseconds(const uint32_t microseconds);     // Move the virtual time forward by this much on every clock read, for code that busy waits on the clock
+  uint64_t getMicroseconds();                                         // Get the virtual time without moving it
+
+  // ----------------------------------------------------------------------------------------------
+  // Tasks
+
+  void runTask(const char *name, const uint64_t durationMicroseconds); // Run a task created with xTaskCreatePinnedToCore() until its deadline in virtual time
+  void setDelayHook(void (*hook)());                                   // Set a function called on every vTaskDelay(), e.g. to run the main loop next to a task
+  bool getTaskState(const char *name);                                 // Get if a task with this name exists
+
+  // ----------------------------------------------------------------------------------------------
+  // Pins
+
+  void setPinObserver(void (*observer)(const uint8_t pin, const uint8_t level)); // Set a function called on every pin level change, before the pin interrupt
+
+  // ----------------------------------------------------------------------------------------------
+  // Hardware pulse counter
+
+  void     setPulseCounterUnits(const uint8_t units);                                 // Set the number of pulse counter units that can still be created
+  void     addPulseCounterPulse(const uint8_t pin, const uint32_t lengthNanoseconds); // Send a pulse of a given length to the pulse counter channels on a pin
+  uint32_t getPulseCounterUnits();                                                    // Get the number of pulse counter units that were created
+
+  // ----------------------------------------------------------------------------------------------
+  // Random numbers
+
+  void seedRandom(const uint32_t seed); // Restart the esp_random() sequence
+
+  // ----------------------------------------------------------------------------------------------
+  // File systems
+
+  void     setFileSystemRoot(const char *directory);                        // Back the LittleFS and SD file systems with subdirectories of a host directory
+  void     injectFileSystemFault(const Fault fault, const uint32_t operation); // Inject a fault into the n-th modifying file system operation from now on, counting from 1
+  uint32_t getFileSystemOperations();                                       // Get the number of modifying file system operations (open for writing, write, rename, remove) so far
+
+}
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef _PULSE_CNT_H
+#define _PULSE_CNT_H
+
+// Host replacement for the ESP-IDF pulse counter (PCNT) driver
+// Pulses are sent with Shims::addPulseCounterPulse(), the units behave like the hardware:
+// pulses shorter than the glitch filter are ignored, and the count starts over at the high limit unless the overflows are accumulated
+
+typedef int esp_err_t;
+
+#define ESP_OK                0
+#define ESP_FAIL              -1
+#define ESP_ERR_INVALID_ARG   0x102
+#define ESP_ERR_INVALID_STATE 0x103
+#define ESP_ERR_NOT_FOUND     0x105
+
+typedef struct pcnt_unit_t *pcnt_unit_handle_t;
+typedef struct pcnt_chan_t *pcnt_channel_handle_t;
+
+typedef struct {
+
+  int low_limit;
+  int high_limit;
+  int intr_priority;
+
+  struct {
+
+    unsigned accum_count : 1;
+
+  } flags;
+
+} pcnt_unit_config_t;
+
+typedef struct {
+
+  unsigned max_glitch_ns;
+
+} pcnt_glitch_filter_config_t;
+
+typedef struct {
+
+  int edge_gpio_num;
+  int level_gpio_num;
+
+  struct {
+
+    unsigned invert_edge_input  : 1;
+    unsigned invert_level_input : 1;
+
+  } flags;
+
+} pcnt_chan_config_t;
+
+typedef enum {
+
+  PCNT_CHANNEL_EDGE_ACTION_HOLD,
+  PCNT_CHANNEL_EDGE_ACTION_INCREASE,
+  PCNT_CHANNEL_EDGE_ACTION_DECREASE
+
+} pcnt_channel_edge_action_t;
+
+esp_err_t pcnt_new_unit(const pcnt_unit_config_t *config, pcnt_unit_handle_t *unit);
+esp_err_t pcnt_del_unit(pcnt_unit_handle_t unit);
+esp_err_t pcnt_unit_set_glitch_filter(pcnt_unit_handle_t unit, const pcnt_glitch_filter_config_t *config);
+esp_err_t pcnt_new_channel(pcnt_unit_handle_t unit, const pcnt_chan_config_t *config, pcnt_channel_handle_t *channel);
+esp_err_t pcnt_channel_set_edge_action(pcnt_channel_handle_t channel, pcnt_channel_edge_action_t positive, pcnt_channel_edge_action_t negative);
+esp_err_t pcnt_unit_add_watch_point(pcnt_unit_handle_t unit, int count);
+esp_err_t pcnt_unit_enable(pcnt_unit_handle_t unit);
+esp_err_t pcnt_unit_disable(pcnt_unit_handle_t unit);
+esp_err_t pcnt_unit_start(pcnt_unit_handle_t unit);
+esp_err_t pcnt_unit_stop(pcnt_unit_handle_t unit);
+esp_err_t pcnt_unit_clear_count(pcnt_unit_handle_t unit);
+esp_err_t pcnt_unit_get_count(pcnt_unit_handle_t unit, int *count);
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef _RINGBUF_H
+#define _RINGBUF_H
+
+// Host replacement for the FreeRTOS ring buffer, only the no-split item buffer is supported
+
+#include "Arduino.h"
+
+typedef void *RingbufHandle_t;
+
+typedef enum {
+
+  RINGBUF_TYPE_NOSPLIT,
+  RINGBUF_TYPE_ALLOWSPLIT,
+  RINGBUF_TYPE_BYTEBUF
+
+} RingbufferType_t;
+
+RingbufHandle_t xRingbufferCreate(const size_t size, const RingbufferType_t type);
+void            vRingbufferDelete(RingbufHandle_t buffer);
+BaseType_t      xRingbufferSend(RingbufHandle_t buffer, const void *item, const size_t size, const TickType_t ticks);
+void            *xRingbufferReceive(RingbufHandle_t buffer, size_t *size, const TickType_t ticks);
+void            vRingbufferReturnItem(RingbufHandle_t buffer, void *item);
+size_t          xRingbufferGetCurFreeSize(RingbufHandle_t buffer);
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef _TEST_H
+#define _TEST_H
+
+#include <stdio.h>
+
+// Minimal test helpers, a test executable returns the number of failed checks so that CTest sees the failure
+
+namespace Test {
+
+  // Number of failed checks
+  inline int &failures() { static int count = 0; return count; }
+
+  // Record the result of a check and print it if it failed
+  inline bool check(const bool condition, const char *expression, const char *file, const int line) {
+
+    if (!condition) {
+
+      printf("%s:%d: check failed: %s\n", file, line, expression);
+
+      failures()++;
+
+    }
+
+    return condition;
+
+  }
+
+  // Print the summary and get the exit code
+  inline int result(const char *name) {
+
+    printf("%s: %s (%d failed checks)\n", name, failures() ? "FAILED" : "passed", failures());
+
+    return failures() ? 1 : 0;
+
+  }
+
+}
+
+// Check a condition
+#define CHECK(condition) Test::check((condition), #condition, __FILE__, __LINE__)
+
+// Check that a value is within a tolerance of the expected value
+#define CHECK_NEAR(value, expected, tolerance) Test::check(fabs((double)(value) - (double)(expected)) <= (tolerance), #value " is within " #tolerance " of " #expected, __FILE__, __LINE__)
+
+#endif
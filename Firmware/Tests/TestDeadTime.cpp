@@ -0,0 +1,134 @@
+// Validation of the dead time correction against a tube with a known true count rate
+// True Poisson arrivals are passed through a dead time of TUBE_DEAD_TIME_MICROSECONDS, the recorded pulses drive the unchanged tube ISR
+// For every true rate, the recorded and the dead time corrected counts per minute are compared with the true counts per minute
+// The tube follows the model selected by TUBE_DEAD_TIME_MODEL, with no correction (0) it follows the non-paralyzable model and nothing may be corrected
+
+#include "Test.h"
+#include "Shims.h"
+#include "LoggerShim.h"
+#include "GeigerCounter.h"
+#include <random>
+
+// True count rates of the tube in counts per second
+static const double TRUE_RATES_CPS[] = {50.0, 500.0, 1500.0, 3000.0};
+
+// ================================================================================================
+// Run the tube at a true count rate for a bit more than the 60 second integration time
+// Returns the number of recorded pulses
+// ================================================================================================
+static uint32_t runTube(const double rate, std::mt19937 &random) {
+
+  std::exponential_distribution<double> interval(rate);
+
+  const double deadTime = TUBE_DEAD_TIME_MICROSECONDS;
+
+  // Start at the next full second and stop just before the 61st second after that
+  // The 60 second window then spans the 59 completed seconds and almost all of the current one
+  uint64_t start = (Shims::getMicroseconds() / 1000000 + 1) * 1000000;
+  uint64_t end   = start + 61 * 1000000 - 1000;
+
+  Shims::advanceMicroseconds(start - Shims::getMicroseconds());
+
+  geigerCounter.enable();
+
+  // Time the tube can record the next particle, and the time of the next main loop run
+  double   time          = (double)start;
+  double   deadUntil     = 0.0;
+  uint64_t nextUpdate    = start + 10000;
+  uint32_t recorded      = 0;
+
+  for (;;) {
+
+    time += interval(random) * 1000000.0;
+
+    if (time >= end) { break; }
+
+    // A particle during the dead time is missed, in the paralyzable model it restarts the dead time
+    if (time < deadUntil) {
+
+      #if TUBE_DEAD_TIME_MODEL == 2
+        deadUntil = time + deadTime;
+      #endif
+
+      continue;
+
+    }
+
+    deadUntil = time + deadTime;
+
+    // Run the main loop every 10 ms, like it would between the pulses
+    while (nextUpdate <= (uint64_t)time) {
+
+      Shims::advanceMicroseconds(nextUpdate - Shims::getMicroseconds());
+      geigerCounter.update();
+      nextUpdate += 10000;
+
+    }
+
+    // Record the pulse, it is shorter than the dead time so it can't overlap with the next one
+    Shims::advanceMicroseconds((uint64_t)time - Shims::getMicroseconds());
+
+    digitalWrite(MAIN_TRG_PIN, HIGH);
+    Shims::advanceMicroseconds(TUBE_MEDIAN_PULSE_LENGTH_MICROSECONDS);
+    digitalWrite(MAIN_TRG_PIN, LOW);
+
+    recorded++;
+
+  }
+
+  Shims::advanceMicroseconds(end - Shims::getMicroseconds());
+  geigerCounter.update();
+
+  return recorded;
+
+}
+
+int main() {
+
+  std::mt19937 random(20261017);
+
+  const double deadTime = TUBE_DEAD_TIME_MICROSECONDS / 1000000.0;
+
+  printf("%10s %14s %14s %14s %12s %12s\n", "rate cps", "true cpm", "recorded cpm", "corrected cpm", "recorded %", "corrected %");
+
+  for (double rate : TRUE_RATES_CPS) {
+
+    uint32_t recorded = runTube(rate, random);
+
+    double trueCpm      = rate * 60.0;
+    double recordedCpm  = geigerCounter.getCountsPerMinute(60);
+    double correctedCpm = geigerCounter.getCorrectedCountsPerMinute(60);
+
+    double recordedError  = (recordedCpm - trueCpm) / trueCpm * 100.0;
+    double correctedError = (correctedCpm - trueCpm) / trueCpm * 100.0;
+
+    printf("%10.0f %14.0f %14.0f %14.0f %12.2f %12.2f\n", rate, trueCpm, recordedCpm, correctedCpm, recordedError, correctedError);
+
+    // The relative standard error of the recorded counts is 1 / sqrt(counts)
+    // The correction amplifies it by d ln(true rate) / d ln(recorded rate), which is 1 / (1 - busy fraction) for both models
+    double recordedRate = recordedCpm / 60.0;
+    double busyFraction = TUBE_DEAD_TIME_MODEL == 2 ? rate * deadTime : recordedRate * deadTime;
+    double tolerance    = 4.0 / sqrt((double)recorded) / (1.0 - busyFraction) * 100.0;
+
+    #if TUBE_DEAD_TIME_MODEL == 0
+
+      // Without a correction the corrected value is the recorded value
+      CHECK(correctedCpm == recordedCpm);
+
+    #else
+
+      // The corrected rate matches the true rate within the statistical error
+      CHECK(fabs(correctedError) <= tolerance);
+
+    #endif
+
+    // At the higher rates the recorded rate doesn't match the true rate, with any model, that's what the correction is for
+    if (rate * deadTime >= 0.1) { CHECK(fabs(recordedError) > tolerance); }
+
+    geigerCounter.disable();
+
+  }
+
+  return Test::result("TestDeadTime");
+
+}
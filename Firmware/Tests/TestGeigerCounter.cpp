@@ -0,0 +1,117 @@
+// Check of how the Geiger counter assigns pulses to seconds when the main loop is late
+// Pulses are driven on the main tube pin at known times while the main loop doesn't run, then a single update has to put them into the right seconds
+
+#include "Test.h"
+#include "Shims.h"
+#include "LoggerShim.h"
+#include "GeigerCounter.h"
+
+// ================================================================================================
+// Drive a pulse of the median length on the main tube pin at a time in virtual seconds
+// ================================================================================================
+static void pulse(const double timeSeconds) {
+
+  Shims::advanceMicroseconds((uint64_t)(timeSeconds * 1000000.0) - Shims::getMicroseconds());
+
+  digitalWrite(MAIN_TRG_PIN, HIGH);
+  Shims::advanceMicroseconds(TUBE_MEDIAN_PULSE_LENGTH_MICROSECONDS);
+  digitalWrite(MAIN_TRG_PIN, LOW);
+
+}
+
+// ================================================================================================
+// Move the virtual time to a time in seconds and run the main loop once
+// ================================================================================================
+static void updateAt(const double timeSeconds) {
+
+  Shims::advanceMicroseconds((uint64_t)(timeSeconds * 1000000.0) - Shims::getMicroseconds());
+
+  geigerCounter.update();
+
+}
+
+// ================================================================================================
+// Get the counts of the second that is a number of seconds before the current one
+// ================================================================================================
+static double getSecondCounts(const uint8_t secondsBack) {
+
+  double counts = geigerCounter.getCountsPerMinute(secondsBack + 1) * (secondsBack + 1) / 60.0;
+
+  if (secondsBack > 0) { counts -= geigerCounter.getCountsPerMinute(secondsBack) * secondsBack / 60.0; }
+
+  return counts;
+
+}
+
+int main() {
+
+  geigerCounter.enable();
+
+  // ----------------------------------------------------------------------------------------------
+  // The main loop is late by several seconds
+
+  // 1 pulse in second 0, 2 in second 1, 3 in second 2 and 4 in second 3
+  for (uint8_t second = 0; second < 4; second++) {
+
+    for (uint8_t i = 0; i <= second; i++) { pulse(second + 0.1 + 0.2 * i); }
+
+  }
+
+  // The first update happens in the middle of second 4
+  updateAt(4.5);
+
+  CHECK(geigerCounter.getCounts() == 10);
+  CHECK_NEAR(getSecondCounts(0), 0, 1e-9);
+  CHECK_NEAR(getSecondCounts(1), 4, 1e-9);
+  CHECK_NEAR(getSecondCounts(2), 3, 1e-9);
+  CHECK_NEAR(getSecondCounts(3), 2, 1e-9);
+  CHECK_NEAR(getSecondCounts(4), 1, 1e-9);
+
+  // ----------------------------------------------------------------------------------------------
+  // The main loop is late by more than the 60 seconds the running sum array holds
+
+  // 1 pulse in each of the seconds 5 to 94
+  for (uint32_t second = 5; second < 95; second++) { pulse(second + 0.5); }
+
+  updateAt(95.5);
+
+  // Only the latest 59 completed seconds are kept, each with its pulse, none of the older pulses leak into them
+  CHECK(geigerCounter.getCounts() == 100);
+  CHECK_NEAR(geigerCounter.getCountsPerMinute(60), 59, 1e-9);
+  CHECK_NEAR(getSecondCounts(0), 0, 1e-9);
+  CHECK_NEAR(getSecondCounts(1), 1, 1e-9);
+  CHECK_NEAR(getSecondCounts(59), 1, 1e-9);
+
+  // ----------------------------------------------------------------------------------------------
+  // The main loop is late by exactly 60 seconds, the index of the current second is the same as before
+
+  // 1 pulse in each of the seconds 96 to 155, 2 in second 155
+  for (uint32_t second = 96; second < 156; second++) { pulse(second + 0.5); }
+
+  pulse(155.7);
+
+  updateAt(155.9);
+
+  CHECK(geigerCounter.getCounts() == 161);
+  CHECK_NEAR(getSecondCounts(0), 2, 1e-9);
+  CHECK_NEAR(getSecondCounts(1), 1, 1e-9);
+  CHECK_NEAR(geigerCounter.getCountsPerMinute(60), 61, 1e-9);
+
+  // ----------------------------------------------------------------------------------------------
+  // The main loop runs on time again
+
+  pulse(156.2);
+  updateAt(156.3);
+  pulse(156.8);
+  updateAt(157.1);
+
+  CHECK(geigerCounter.getCounts() == 163);
+  CHECK_NEAR(getSecondCounts(0), 0, 1e-9);
+  CHECK_NEAR(getSecondCounts(1), 2, 1e-9);
+  CHECK_NEAR(getSecondCounts(2), 2, 1e-9);
+
+  geigerCounter.disable();
+
+  return Test::result("TestGeigerCounter");
+
+}
@@ -0,0 +1,165 @@
+// Step response benchmark of the automatic integration time, for the estimator selected by INTEGRATION_TIME_ESTIMATOR
+// Poisson pulses drive the unchanged tube ISR, the count rate steps once in the middle of every trial
+// For every step, the noise before the step, the time until the counts per minute settle at the new rate and the error after the step are printed
+// Run both builds to compare the estimators: ctest -L benchmark -V
+
+#include "Test.h"
+#include "Shims.h"
+#include "LoggerShim.h"
+#include "GeigerCounter.h"
+#include <random>
+#include <vector>
+
+// Rate steps in counts per minute
+struct Step {
+
+  double before; // Counts per minute before the step
+  double after;  // Counts per minute after the step
+
+};
+
+static const Step STEPS[] = {{20.0, 200.0}, {200.0, 20.0}, {30.0, 60.0}, {60.0, 30.0}, {600.0, 6000.0}};
+
+// Trials for every step, length of a trial and time of the step in seconds
+static const uint32_t TRIALS         = 40;
+static const uint32_t TRIAL_SECONDS  = 300;
+static const uint32_t STEP_SECONDS   = 150;
+
+// A value is settled once it stays within this fraction of the true rate for this many seconds
+// At low rates not even a 60 second count gets that close, there it is two standard deviations of a 60 second count instead
+static const double   SETTLED_FRACTION = 0.2;
+static const uint32_t SETTLED_SECONDS  = 10;
+
+// ================================================================================================
+// Run one trial and record the counts per minute of every second
+// ================================================================================================
+static void runTrial(const Step &step, std::mt19937 &random, std::vector<double> &values) {
+
+  // Start at the next full second with a freshly enabled Geiger counter
+  uint64_t start = (Shims::getMicroseconds() / 1000000 + 1) * 1000000;
+
+  Shims::advanceMicroseconds(start - Shims::getMicroseconds());
+
+  geigerCounter.enable();
+  geigerCounter.setAutoIntegrateState(true);
+
+  double   time       = (double)start;
+  uint64_t nextUpdate = start + 10000;
+
+  values.clear();
+
+  for (;;) {
+
+    // Time of the next pulse at the rate of the current part of the trial
+    double rate = (time - start < STEP_SECONDS * 1000000.0 ? step.before : step.after) / 60.0;
+
+    time += std::exponential_distribution<double>(rate)(random) * 1000000.0;
+
+    // Pulses before the step that would fall after it are drawn again at the new rate from the step on
+    if (time - start >= STEP_SECONDS * 1000000.0 && rate == step.before / 60.0 && step.before != step.after) {
+
+      time = start + STEP_SECONDS * 1000000.0;
+
+      continue;
+
+    }
+
+    // Run the main loop every 10 ms and read the counts per minute in the middle of every second, like the display does
+    while (nextUpdate <= (uint64_t)time && nextUpdate < start + TRIAL_SECONDS * 1000000ULL) {
+
+      Shims::advanceMicroseconds(nextUpdate - Shims::getMicroseconds());
+      geigerCounter.update();
+
+      if ((nextUpdate - start) % 1000000 == 500000) { values.push_back(geigerCounter.getCountsPerMinute()); }
+
+      nextUpdate += 10000;
+
+    }
+
+    if (time >= start + TRIAL_SECONDS * 1000000.0) { break; }
+
+    Shims::advanceMicroseconds((uint64_t)time - Shims::getMicroseconds());
+
+    digitalWrite(MAIN_TRG_PIN, HIGH);
+    Shims::advanceMicroseconds(TUBE_MEDIAN_PULSE_LENGTH_MICROSECONDS);
+    digitalWrite(MAIN_TRG_PIN, LOW);
+
+  }
+
+  geigerCounter.disable();
+
+}
+
+int main() {
+
+  std::mt19937        random(20261017);
+  std::vector<double> values;
+
+  printf("Estimator %d (%s), %u trials of %u s per step\n", INTEGRATION_TIME_ESTIMATOR, INTEGRATION_TIME_ESTIMATOR == 1 ? "Kalman" : "step-wise", (unsigned)TRIALS, (unsigned)TRIAL_SECONDS);
+  printf("%8s %8s %16s %16s %16s %16s\n", "before", "after", "noise before %", "settle mean s", "settle max s", "error 60 s %");
+
+  for (const Step &step : STEPS) {
+
+    double   noiseSquares  = 0.0;
+    uint32_t noiseSamples  = 0;
+    double   settleSum     = 0.0;
+    uint32_t settleMaximum = 0;
+    double   errorSquares  = 0.0;
+    uint32_t errorSamples  = 0;
+    double   finalSum      = 0.0;
+    double   tolerance     = max(SETTLED_FRACTION, 2.0 / sqrt(step.after));
+
+    for (uint32_t trial = 0; trial < TRIALS; trial++) {
+
+      runTrial(step, random, values);
+
+      // Relative noise in the last minute before the step, when every estimator has settled
+      for (uint32_t second = STEP_SECONDS - 60; second < STEP_SECONDS; second++) {
+
+        double error = values[second] / step.before - 1.0;
+
+        noiseSquares += error * error;
+        noiseSamples++;
+
+      }
+
+      // Seconds after the step until the value stays settled, the trial length if it never does
+      uint32_t settle = TRIAL_SECONDS - STEP_SECONDS;
+
+      for (uint32_t second = STEP_SECONDS; second + SETTLED_SECONDS <= values.size(); second++) {
+
+        bool settled = true;
+
+        for (uint32_t i = second; i < second + SETTLED_SECONDS; i++) { settled = settled && fabs(values[i] / step.after - 1.0) <= tolerance; }
+
+        if (settled) { settle = second - STEP_SECONDS; break; }
+
+      }
+
+      settleSum     += settle;
+      settleMaximum  = max(settleMaximum, settle);
+
+      // Relative error in the minute after the step
+      for (uint32_t second = STEP_SECONDS; second < STEP_SECONDS + 60; second++) {
+
+        double error = values[second] / step.after - 1.0;
+
+        errorSquares += error * error;
+        errorSamples++;
+
+      }
+
+      finalSum += values.back();
+
+    }
+
+    // Every estimator ends up at the new rate, on average over the trials
+    CHECK_NEAR(finalSum / TRIALS, step.after, 0.15 * step.after);
+
+    printf("%8.0f %8.0f %16.1f %16.1f %16u %16.1f\n", step.before, step.after, sqrt(noiseSquares / noiseSamples) * 100.0, settleSum / TRIALS, (unsigned)settleMaximum, sqrt(errorSquares / errorSamples) * 100.0);
+
+  }
+
+  return Test::result("TestIntegrationTime");
+
+}
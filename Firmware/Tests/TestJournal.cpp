@@ -0,0 +1,204 @@
+// Power loss and failure check of the journal
+// A workload of records that compacts the journal several times is run once for every file system operation it makes
+// Every run either loses the power or fails at that operation, then the journal is booted again and has to hold the latest record of each type
+// A boot is a child process, so the journal starts from nothing but the files, like after a reset
+
+#include "Test.h"
+#include "Shims.h"
+#include "LoggerShim.h"
+#include "Journal.h"
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Records of two types and sizes, the value is the number of the write
+struct CountsRecord  { uint64_t value; uint64_t check;       };
+struct HistoryRecord { uint64_t value; uint8_t  padding[92]; };
+
+// Number of counts records the workload writes, one history record is written before and in the middle of them
+static const uint32_t WORKLOAD_RECORDS = 24;
+
+// File descriptor the workload reports the acknowledged writes to
+static int reportPipe = -1;
+
+// ================================================================================================
+// Report an acknowledged write to the parent process
+// ================================================================================================
+static void report(const char type, const uint64_t value) {
+
+  char message[32];
+  int  length = snprintf(message, sizeof(message), "%c%llu\n", type, (unsigned long long)value);
+
+  if (write(reportPipe, message, length) != length) { _exit(99); }
+
+}
+
+// ================================================================================================
+// Write a history record and report it if the journal acknowledged it
+// ================================================================================================
+static void writeHistory(const uint64_t value) {
+
+  HistoryRecord record = {value, {}};
+
+  if (journal.write(Journal::HISTORY, &record, sizeof(record))) { report('h', value); }
+
+}
+
+// ================================================================================================
+// Boot the journal and run the workload, reporting every acknowledged write
+// ================================================================================================
+static void runWorkload(const Shims::Fault fault, const uint32_t operation) {
+
+  journal.begin();
+
+  if (fault != Shims::NO_FAULT) { Shims::injectFileSystemFault(fault, operation); }
+
+  writeHistory(1);
+
+  for (uint64_t value = 1; value <= WORKLOAD_RECORDS; value++) {
+
+    CountsRecord record = {value, ~value};
+
+    if (journal.write(Journal::COUNTS, &record, sizeof(record))) { report('c', value); }
+
+    if (value == WORKLOAD_RECORDS / 2) { writeHistory(2); }
+
+  }
+
+  report('o', Shims::getFileSystemOperations());
+
+}
+
+// ================================================================================================
+// Boot the journal again and check it against the acknowledged writes, returns the number of failed checks
+// ================================================================================================
+static int checkJournal(const uint64_t counts, const uint64_t history, const bool faulted) {
+
+  journal.begin();
+
+  CountsRecord  countsRecord;
+  HistoryRecord historyRecord;
+
+  bool countsFound  = journal.read(Journal::COUNTS, &countsRecord, sizeof(countsRecord));
+  bool historyFound = journal.read(Journal::HISTORY, &historyRecord, sizeof(historyRecord));
+
+  // An acknowledged record is never lost, the record that was being written when the fault happened might have made it
+  // Without a fault, the latest record is exactly the last acknowledged one
+  uint64_t maximumCounts  = faulted ? counts + 1 : counts;
+  uint64_t maximumHistory = faulted ? history + 1 : history;
+
+  if (counts > 0)  { CHECK(countsFound); }
+  if (history > 0) { CHECK(historyFound); }
+
+  if (countsFound)  { CHECK(countsRecord.value >= counts && countsRecord.value <= maximumCounts && countsRecord.check == ~countsRecord.value); }
+  if (historyFound) { CHECK(historyRecord.value >= history && historyRecord.value <= maximumHistory); }
+
+  // The journal still takes new records
+  CountsRecord next = {1000, ~1000ULL};
+
+  CHECK(journal.write(Journal::COUNTS, &next, sizeof(next)));
+  CHECK(journal.read(Journal::COUNTS, &countsRecord, sizeof(countsRecord)) && countsRecord.value == 1000);
+
+  return Test::failures();
+
+}
+
+// ================================================================================================
+// Run the workload in a boot with a fault and check the journal in the next boot
+// Returns the number of file system operations the workload made
+// ================================================================================================
+static uint32_t runBoots(const std::string &root, const Shims::Fault fault, const uint32_t operation) {
+
+  // Start from an empty file system
+  system(("rm -rf '" + root + "'").c_str());
+
+  int descriptors[2];
+
+  if (pipe(descriptors) != 0) { return 0; }
+
+  // First boot, running the workload until it ends or loses the power
+  pid_t child = fork();
+
+  if (child == 0) {
+
+    close(descriptors[0]);
+
+    reportPipe = descriptors[1];
+
+    Shims::setFileSystemRoot(root.c_str());
+
+    runWorkload(fault, operation);
+
+    _exit(0);
+
+  }
+
+  close(descriptors[1]);
+
+  // Collect the acknowledged writes
+  uint64_t counts     = 0;
+  uint64_t history    = 0;
+  uint32_t operations = 0;
+
+  FILE *reports = fdopen(descriptors[0], "r");
+  char line[32];
+
+  while (fgets(line, sizeof(line), reports) != NULL) {
+
+    uint64_t value = strtoull(line + 1, NULL, 10);
+
+    if (line[0] == 'c') { counts     = value; }
+    if (line[0] == 'h') { history    = value; }
+    if (line[0] == 'o') { operations = value; }
+
+  }
+
+  fclose(reports);
+
+  int status = 0;
+
+  waitpid(child, &status, 0);
+
+  // The workload either ends or loses the power as injected
+  int expected = fault == Shims::POWER_LOSS ? Shims::POWER_LOSS_EXIT_CODE : 0;
+
+  if (!CHECK(WIFEXITED(status) && WEXITSTATUS(status) == expected)) { printf("%s at operation %u\n", fault == Shims::POWER_LOSS ? "power loss" : "failure", (unsigned)operation); }
+
+  // Second boot, checking the journal
+  child = fork();
+
+  if (child == 0) {
+
+    Shims::setFileSystemRoot(root.c_str());
+
+    _exit(checkJournal(counts, history, fault != Shims::NO_FAULT));
+
+  }
+
+  waitpid(child, &status, 0);
+
+  if (!CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0)) { printf("%s at operation %u: acknowledged counts %llu, history %llu\n", fault == Shims::POWER_LOSS ? "power loss" : "failure", (unsigned)operation, (unsigned long long)counts, (unsigned long long)history); }
+
+  return operations;
+
+}
+
+int main() {
+
+  const char  *directory = getenv("TEST_DIRECTORY");
+  std::string root       = directory != NULL ? directory : "TestJournal.data";
+
+  // Count the file system operations of the workload without a fault
+  uint32_t operations = runBoots(root, Shims::NO_FAULT, 0);
+
+  CHECK(operations > 0);
+
+  // Lose the power at every operation, then let every operation fail once
+  for (uint32_t operation = 1; operation <= operations; operation++) { runBoots(root, Shims::POWER_LOSS, operation); }
+  for (uint32_t operation = 1; operation <= operations; operation++) { runBoots(root, Shims::FAILURE, operation); }
+
+  printf("%u file system operations, each interrupted by a power loss and by a failure\n", (unsigned)operations);
+
+  return Test::result("TestJournal");
+
+}
@@ -0,0 +1,173 @@
+// Round trip check of the binary log format
+// Log messages of more types than there are binary log schemas are written to a binary log file, which is opened again in between
+// Converting the binary log file has to give the same log messages as the JSON log format, down to the last character
+// A log file that is cut off or damaged is converted up to the last complete log message
+
+#include "Test.h"
+#include "Shims.h"
+#include "Logger.h"
+#include "SDCard.h"
+#include <string>
+
+// Number of log messages
+static const uint32_t MESSAGES = 300;
+
+// Converted log file
+static std::string converted;
+
+// ================================================================================================
+// Collect the converted log file
+// ================================================================================================
+static void output(const char *data, const size_t size) {
+
+  converted.append(data, size);
+
+}
+
+// ================================================================================================
+// Convert a log file
+// ================================================================================================
+static bool convert(const char *path) {
+
+  converted.clear();
+
+  File file = SD.open(path, FILE_READ);
+
+  bool complete = logger.convertLogFile(file, output);
+
+  file.close();
+
+  return complete;
+
+}
+
+// ================================================================================================
+// Write part of a log file to another file
+// ================================================================================================
+static void copyLogFile(const char *path, const char *copy, const size_t size) {
+
+  std::string data(size, '\0');
+
+  File file = SD.open(path, FILE_READ);
+
+  file.read((uint8_t*)&data[0], size);
+  file.close();
+
+  file = SD.open(copy, FILE_WRITE);
+
+  file.write((const uint8_t*)data.data(), size);
+  file.close();
+
+}
+
+int main() {
+
+  const char  *directory = getenv("TEST_DIRECTORY");
+  std::string root       = directory != NULL ? directory : "TestLogConversion.data";
+
+  system(("rm -rf '" + root + "'").c_str());
+
+  Shims::setFileSystemRoot(root.c_str());
+
+  // Only the log messages of the test go into the binary log file
+  logger.begin();
+  logger.setSerialLoggingState(false);
+  logger.setSDCardLoggingState(true);
+  logger.setLogLevelState(Logger::EVENT, false);
+  logger.setLogFormat(Logger::BINARY);
+
+  sdCard.begin();
+  sdCard.mount();
+
+  CHECK(sdCard.getMountState());
+
+  // Log messages as they are in the JSON log format
+  std::string expected;
+
+  for (uint32_t message = 0; message < MESSAGES; message++) {
+
+    // Let some time pass, sometimes none at all
+    Shims::advanceMicroseconds((message % 5) * 1234567);
+
+    // Measurement with every value type, counters that go up and floating point numbers that go up and down
+    Logger::KeyValuePair measurement[6] = {
+
+      {"counts",    Logger::UINT64_T, {.uint64_v = 10000000000ULL + message * 37}            },
+      {"rate",      Logger::DOUBLE_T, {.double_v = (message % 11) * 1.234567 - 6.5}          },
+      {"sequence",  Logger::UINT32_T, {.uint32_v = 4294967000U + message * 3}                },
+      {"rating",    Logger::UINT8_T,  {.uint8_v  = (uint8_t)(message % 4)}                   },
+      {"tubeType",  Logger::STRING_T, {.string_v = (message % 2) ? "J305" : "M4011"}         },
+      {"enabled",   Logger::BOOL_T,   {.bool_v   = (message % 3) == 0}                       }
+
+    };
+
+    // Messages of other types, more types than there are binary log schemas
+    Logger::KeyValuePair event[1]  = {{"event",  Logger::STRING_T, {.string_v = ""}}};
+    Logger::KeyValuePair other[1]  = {{"value",  Logger::DOUBLE_T, {.double_v = -0.00001 * message}}};
+    Logger::KeyValuePair empty[1]  = {};
+
+    // Pick the type of the message
+    const char           *type = "measurement";
+    Logger::KeyValuePair *data = measurement;
+    uint8_t              size  = 6;
+
+    if      (message % 7 == 3) { type = "event"; data = event; size = 1; }
+    else if (message % 7 == 5) { type = "other"; data = other; size = 1; }
+    else if (message % 7 == 6) { type = "empty"; data = empty; size = 0; }
+
+    // Construct the log message the JSON log format would have
+    char   buffer[LOG_MESSAGE_MAXIMUM_SIZE_BYTES];
+    size_t length = logger.getLogMessage(millis(), type, data, size, buffer, sizeof(buffer));
+
+    expected.append(buffer, length);
+    expected += ",";
+
+    logger.log(Logger::DATA, type, data, size);
+
+    // The logging task doesn't run here, so the log queue is drained before it overflows
+    if (message % 10 == 9) { logger.flush(); }
+
+    // Open the log file again in the middle, which adds another header
+    if (message == MESSAGES / 2) {
+
+      logger.close();
+
+    }
+
+  }
+
+  logger.flush();
+
+  String path = logger.getLogFilePath();
+
+  CHECK(path.endsWith(".bin"));
+
+  // The whole log file gives the same log messages as the JSON log format
+  CHECK(convert(path.c_str()));
+  CHECK(converted == expected);
+
+  // Get the log file size
+  File file = SD.open(path.c_str(), FILE_READ);
+  size_t size = file.size();
+  file.close();
+
+  // A log file that is cut off is converted up to the last complete log message
+  String copy = String(SD_CARD_LOG_DIRECTORY) + "/Copy.bin";
+
+  copyLogFile(path.c_str(), copy.c_str(), size - 3);
+
+  CHECK(!convert(copy.c_str()));
+  CHECK(!converted.empty() && converted.size() < expected.size() && expected.compare(0, converted.size(), converted) == 0);
+  CHECK(converted.back() == ',');
+
+  // A log file with an unknown header can't be converted
+  file = SD.open(copy.c_str(), FILE_WRITE);
+  file.write((const uint8_t*)"\x00GMTX\x01", 6);
+  file.close();
+
+  CHECK(!convert(copy.c_str()));
+  CHECK(converted.empty());
+
+  return Test::result("TestLogConversion");
+
+}
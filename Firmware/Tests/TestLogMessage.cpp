@@ -0,0 +1,153 @@
+// Heap allocation and time benchmark of the log message serializer
+// The serializer of the logger is compared with the String concatenation it replaced, on the Geiger counter message of /data/geiger-counter
+// For both, the heap allocations, the allocated bytes and the time per message are printed
+// The host String is backed by std::string, which grows geometrically, while the Arduino String reallocates to the exact length on most concatenations
+// The baseline therefore allocates far less often here than it did on the device
+// Run on its own: ctest -L benchmark -V
+
+#include "Test.h"
+#include "Shims.h"
+#include "Logger.h"
+#include <chrono>
+#include <new>
+
+// Number of messages per measurement
+static const uint32_t MESSAGES = 100000;
+
+// Heap allocations and allocated bytes while counting
+static bool     counting    = false;
+static uint64_t allocations = 0;
+static uint64_t bytes       = 0;
+
+// ================================================================================================
+// Count every heap allocation of the process
+// ================================================================================================
+void *operator new(size_t size) {
+
+  if (counting) { allocations++; bytes += size; }
+
+  void *pointer = malloc(size > 0 ? size : 1);
+
+  if (pointer == NULL) { throw std::bad_alloc(); }
+
+  return pointer;
+
+}
+
+void operator delete(void *pointer) noexcept              { free(pointer); }
+void operator delete(void *pointer, size_t size) noexcept { (void)size; free(pointer); }
+
+// ================================================================================================
+// Construct a log message by String concatenation, like the logger did before its serializer
+// ================================================================================================
+static void getStringLogMessage(const uint32_t time, const char *type, const Logger::KeyValuePair *data, const uint8_t size, String &message) {
+
+  message = "";
+
+  message += "{\"type\":\"";
+  message += type;
+  message += "\",\"time\":";
+  message += time;
+  message += ",\"data\":{";
+
+  for (uint8_t pair = 0; pair < size; pair++) {
+
+    message += "\"";
+    message += data[pair].key;
+    message += "\":";
+
+    switch (data[pair].type) {
+
+      case Logger::UINT8_T:  message += data[pair].value.uint8_v;  break;
+      case Logger::UINT32_T: message += data[pair].value.uint32_v; break;
+      case Logger::UINT64_T: message += data[pair].value.uint64_v; break;
+      case Logger::DOUBLE_T: message += String(data[pair].value.double_v, 5); break;
+      case Logger::STRING_T: message += "\""; message += data[pair].value.string_v; message += "\""; break;
+      case Logger::BOOL_T:   message += data[pair].value.bool_v ? "true" : "false"; break;
+
+    }
+
+    if (pair < size - 1) { message += ","; }
+
+  }
+
+  message += "}}";
+
+}
+
+int main() {
+
+  // The Geiger counter message, with values of a few days of counting
+  Logger::KeyValuePair data[16] = {
+
+    {"enabled",                       Logger::BOOL_T,   {.bool_v   = true}       },
+    {"counts",                        Logger::UINT64_T, {.uint64_v = 9876543}    },
+    {"mainCounts",                    Logger::UINT64_T, {.uint64_v = 4938272}    },
+    {"followerCounts",                Logger::UINT64_T, {.uint64_v = 4938271}    },
+    {"countsPerMinute",               Logger::DOUBLE_T, {.double_v = 23.5}       },
+    {"correctedCountsPerMinute",      Logger::DOUBLE_T, {.double_v = 23.50012}   },
+    {"autoCountsPerMinute",           Logger::DOUBLE_T, {.double_v = 24.125}     },
+    {"autoConfidence",                Logger::DOUBLE_T, {.double_v = 0.87654}    },
+    {"totalMicrosieverts",            Logger::DOUBLE_T, {.double_v = 432.10987}  },
+    {"mainMicrosieverts" ,            Logger::DOUBLE_T, {.double_v = 216.05494}  },
+    {"followerMicrosieverts",         Logger::DOUBLE_T, {.double_v = 216.05493}  },
+    {"microsievertsPerHour",          Logger::DOUBLE_T, {.double_v = 0.12345}    },
+    {"correctedMicrosievertsPerHour", Logger::DOUBLE_T, {.double_v = 0.12346}    },
+    {"rating",                        Logger::UINT8_T,  {.uint8_v  = 1}          },
+    {"tubes",                         Logger::UINT8_T,  {.uint8_v  = 2}          },
+    {"tubeType",                      Logger::STRING_T, {.string_v = "J305"}     }
+
+  };
+
+  char   buffer[LOG_MESSAGE_MAXIMUM_SIZE_BYTES];
+  String message;
+
+  // Both produce the same message
+  size_t length = logger.getLogMessage(123456789, "geigerCounter", data, 16, buffer, sizeof(buffer));
+
+  getStringLogMessage(123456789, "geigerCounter", data, 16, message);
+
+  CHECK(length > 0 && length == message.length() && strcmp(buffer, message.c_str()) == 0);
+
+  // A message that doesn't fit is not cut off
+  CHECK(logger.getLogMessage(123456789, "geigerCounter", data, 16, buffer, length) == 0 && buffer[0] == '\0');
+
+  printf("%u messages of %u bytes\n", (unsigned)MESSAGES, (unsigned)length);
+  printf("%-22s %16s %16s %16s\n", "", "allocations", "bytes", "ns per message");
+
+  // Serializer into a fixed buffer
+  allocations = 0;
+  bytes       = 0;
+  counting    = true;
+
+  auto start = std::chrono::steady_clock::now();
+
+  for (uint32_t i = 0; i < MESSAGES; i++) { length = logger.getLogMessage(i, "geigerCounter", data, 16, buffer, sizeof(buffer)); }
+
+  auto end = std::chrono::steady_clock::now();
+
+  counting = false;
+
+  printf("%-22s %16.1f %16.1f %16.1f\n", "fixed buffer", (double)allocations / MESSAGES, (double)bytes / MESSAGES, std::chrono::duration<double, std::nano>(end - start).count() / MESSAGES);
+
+  // The serializer never allocates
+  CHECK(allocations == 0);
+
+  // String concatenation, with a new String for every message like the logger had
+  allocations = 0;
+  bytes       = 0;
+  counting    = true;
+
+  start = std::chrono::steady_clock::now();
+
+  for (uint32_t i = 0; i < MESSAGES; i++) { String concatenated; getStringLogMessage(i, "geigerCounter", data, 16, concatenated); }
+
+  end = std::chrono::steady_clock::now();
+
+  counting = false;
+
+  printf("%-22s %16.1f %16.1f %16.1f\n", "String concatenation", (double)allocations / MESSAGES, (double)bytes / MESSAGES, std::chrono::duration<double, std::nano>(end - start).count() / MESSAGES);
+
+  return Test::result("TestLogMessage");
+
+}
@@ -0,0 +1,175 @@
+// Poisson statistics check of the pulse simulator
+// The simulator task runs against the virtual clock and drives the unchanged tube ISR, the main loop is run on every task delay
+// Checks that the intervals between pulses are exponentially distributed, that the counts per second follow a Poisson distribution,
+// and that the counting path counts every generated pulse
+
+#include "Test.h"
+#include "Shims.h"
+#include "LoggerShim.h"
+#include "PulseSimulator.h"
+#include <vector>
+
+// Duration of the simulated pulse train in seconds
+static const uint32_t DURATION_SECONDS = 600;
+
+// Rising edge times of the simulated pulses
+static std::vector<uint64_t> pulseTimes;
+
+// ================================================================================================
+// Record the rising edges on the simulated pin
+// ================================================================================================
+static void observePin(const uint8_t pin, const uint8_t level) {
+
+  if (pin == PULSE_SIMULATOR_PIN && level == HIGH) { pulseTimes.push_back(Shims::getMicroseconds()); }
+
+}
+
+// ================================================================================================
+// Run the main loop whenever the simulator task gives up the core
+// ================================================================================================
+static void runLoop() {
+
+  geigerCounter.update();
+
+}
+
+// ================================================================================================
+// Get the Poisson probability of a number of counts
+// ================================================================================================
+static double getPoissonProbability(const uint32_t counts, const double mean) {
+
+  return exp(counts * log(mean) - mean - lgamma(counts + 1.0));
+
+}
+
+int main() {
+
+  const double rate = PULSE_SIMULATOR_RATE_CPS;
+
+  Shims::seedRandom(20261017);
+  Shims::setClockStepMicroseconds(2);
+  Shims::setPinObserver(observePin);
+  Shims::setDelayHook(runLoop);
+
+  pulseSimulator.begin();
+  geigerCounter.enable();
+  pulseSimulator.enable();
+
+  CHECK(Shims::getTaskState("pulseSimulator"));
+
+  Shims::runTask("pulseSimulator", DURATION_SECONDS * 1000000ULL);
+
+  // Collect the last pulses and stop the simulator
+  geigerCounter.update();
+  pulseSimulator.log();
+  pulseSimulator.disable();
+
+  CHECK(!Shims::getTaskState("pulseSimulator"));
+
+  // ----------------------------------------------------------------------------------------------
+  // Intervals between pulses
+
+  double   intervalSum     = 0.0;
+  double   intervalSquares = 0.0;
+  uint32_t intervals       = pulseTimes.size() - 1;
+
+  for (uint32_t i = 1; i < pulseTimes.size(); i++) {
+
+    double interval = (pulseTimes[i] - pulseTimes[i - 1]) / 1000000.0;
+
+    intervalSum     += interval;
+    intervalSquares += interval * interval;
+
+  }
+
+  double intervalMean      = intervalSum / intervals;
+  double intervalDeviation = sqrt(intervalSquares / intervals - intervalMean * intervalMean);
+
+  // The exponential distribution has the mean 1 / rate and the same standard deviation
+  // The relative standard error of the mean is 1 / sqrt(n), allow 4 of them
+  CHECK_NEAR(intervalMean * rate, 1.0, 4.0 / sqrt(intervals));
+  CHECK_NEAR(intervalDeviation / intervalMean, 1.0, 0.05);
+
+  // A fraction of e^-x of the intervals is longer than x mean intervals
+  for (double multiple = 0.5; multiple <= 3.0; multiple += 0.5) {
+
+    uint32_t longer = 0;
+
+    for (uint32_t i = 1; i < pulseTimes.size(); i++) { if ((pulseTimes[i] - pulseTimes[i - 1]) / 1000000.0 > multiple / rate) { longer++; } }
+
+    double expected = exp(-multiple);
+
+    CHECK_NEAR((double)longer / intervals, expected, 4.0 * sqrt(expected * (1.0 - expected) / intervals));
+
+  }
+
+  // ----------------------------------------------------------------------------------------------
+  // Counts per second
+
+  std::vector<uint32_t> countsPerSecond(DURATION_SECONDS, 0);
+
+  for (uint64_t time : pulseTimes) { if (time / 1000000 < DURATION_SECONDS) { countsPerSecond[time / 1000000]++; } }
+
+  double countsSum     = 0.0;
+  double countsSquares = 0.0;
+
+  for (uint32_t counts : countsPerSecond) { countsSum += counts; countsSquares += (double)counts * counts; }
+
+  double countsMean     = countsSum / DURATION_SECONDS;
+  double countsVariance = (countsSquares - countsSum * countsMean) / (DURATION_SECONDS - 1);
+
+  // For a Poisson distribution the variance equals the mean, the index of dispersion has the standard error sqrt(2 / (n - 1))
+  CHECK_NEAR(countsMean, rate, 4.0 * sqrt(rate / DURATION_SECONDS));
+  CHECK_NEAR(countsVariance / countsMean, 1.0, 4.0 * sqrt(2.0 / (DURATION_SECONDS - 1)));
+
+  // Chi-squared goodness of fit against the Poisson distribution, bins with less than 5 expected seconds are pooled
+  double   chiSquared    = 0.0;
+  uint32_t bins          = 0;
+  double   pooledObserved = 0.0;
+  double   pooledExpected = 0.0;
+
+  for (uint32_t counts = 0; counts < 2 * rate; counts++) {
+
+    pooledObserved += std::count(countsPerSecond.begin(), countsPerSecond.end(), counts);
+    pooledExpected += getPoissonProbability(counts, countsMean) * DURATION_SECONDS;
+
+    if (pooledExpected >= 5.0) {
+
+      chiSquared     += (pooledObserved - pooledExpected) * (pooledObserved - pooledExpected) / pooledExpected;
+      bins           += 1;
+      pooledObserved  = 0.0;
+      pooledExpected  = 0.0;
+
+    }
+
+  }
+
+  // With k degrees of freedom the chi-squared statistic has the mean k and the standard deviation sqrt(2k)
+  uint32_t degrees = bins - 2;
+
+  CHECK(chiSquared < degrees + 4.0 * sqrt(2.0 * degrees));
+
+  // ----------------------------------------------------------------------------------------------
+  // Counting path
+
+  // Every generated pulse is counted
+  CHECK(pulseSimulator.getGeneratedPulses() == pulseTimes.size());
+  CHECK(geigerCounter.getCounts() == pulseTimes.size());
+
+  Logger::KeyValuePair lost;
+
+  CHECK(Shims::getLogValue("pulseSimulator", "lost", lost) && lost.value.uint64_v == 0);
+
+  // The counts per minute of the last 60 seconds match the counted pulses
+  uint32_t lastMinute = 0;
+
+  for (uint32_t second = DURATION_SECONDS - 60; second < DURATION_SECONDS; second++) { lastMinute += countsPerSecond[second]; }
+
+  CHECK_NEAR(geigerCounter.getCountsPerMinute(60), lastMinute, 0.05 * lastMinute);
+
+  printf("%u pulses in %u s, mean interval %.3f ms (expected %.3f ms), counts per second mean %.2f variance %.2f, chi-squared %.1f with %u degrees of freedom\n",
+         (unsigned)pulseTimes.size(), (unsigned)DURATION_SECONDS, intervalMean * 1000.0, 1000.0 / rate, countsMean, countsVariance, chiSquared, (unsigned)degrees);
+
+  return Test::result("TestPulseSimulator");
+
+}
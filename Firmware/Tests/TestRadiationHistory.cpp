@@ -0,0 +1,113 @@
+// Check of the radiation history consolidation
+// Covers the extremes of the coarser buckets, which have to be the extremes of the one minute means, and gaps of any length
+
+#include "Test.h"
+#include "Shims.h"
+#include "RadiationHistory.h"
+
+static RadiationHistory history;
+
+// ================================================================================================
+// Check that every resolution is at the position a number of seconds after clearing the history
+// ================================================================================================
+static void checkPosition(const uint64_t seconds) {
+
+  const uint32_t intervals[4] = {1, 60, 3600, 86400};
+
+  for (uint8_t i = RadiationHistory::SECONDS; i <= RadiationHistory::DAYS; i++) {
+
+    RadiationHistory::Resolution resolution = (RadiationHistory::Resolution)i;
+
+    // Completed buckets of the resolution and samples of the bucket that is being recorded
+    uint64_t buckets = seconds / intervals[i];
+    uint64_t samples = i == RadiationHistory::SECONDS ? 0 : (seconds % intervals[i]) / intervals[i - 1];
+
+    CHECK(history.getIndex(resolution) == buckets % history.getLength(resolution));
+    CHECK(history.getArchive().consolidations[i].samples == samples);
+
+  }
+
+  CHECK(history.isValid());
+
+}
+
+int main() {
+
+  // ----------------------------------------------------------------------------------------------
+  // Extremes
+
+  // Two minutes, the first one alternating between 0 and 120 counts per minute, the second one a constant 30
+  for (uint32_t second = 0; second < 60; second++) { history.add(second % 2 ? 120 : 0); }
+  for (uint32_t second = 0; second < 60; second++) { history.add(30); }
+
+  // The seconds keep the one second samples
+  CHECK(history.getBucket(RadiationHistory::SECONDS, 0).mean == 30);
+
+  // A minute bucket has its mean as its extremes, not the noise of the one second samples
+  const RadiationHistory::Bucket &first = history.getBucket(RadiationHistory::MINUTES, 1);
+
+  CHECK(first.minimum == 60 && first.maximum == 60 && first.mean == 60);
+
+  // The rest of the hour
+  for (uint32_t second = 120; second < 3600; second++) { history.add(45); }
+
+  // The hour has the extremes of its one minute means
+  const RadiationHistory::Bucket &hour = history.getBucket(RadiationHistory::HOURS, 0);
+
+  CHECK(hour.minimum == 30 && hour.maximum == 60);
+  CHECK(hour.mean == 45);
+
+  checkPosition(3600);
+
+  // ----------------------------------------------------------------------------------------------
+  // Gaps
+
+  history.clear();
+
+  // Half a minute with samples, then two minutes without
+  for (uint32_t second = 0; second < 30; second++) { history.add(90); }
+
+  history.addGap(120);
+
+  checkPosition(150);
+
+  // The first minute is the mean of its recorded part, the second minute was not recorded
+  CHECK(history.getBucket(RadiationHistory::MINUTES, 1).mean == 90);
+  CHECK(history.getBucket(RadiationHistory::MINUTES, 0).mean == UINT32_MAX);
+  CHECK(history.getBucket(RadiationHistory::SECONDS, 0).mean == UINT32_MAX);
+
+  // Samples after the gap continue at the right position
+  for (uint32_t second = 150; second < 180; second++) { history.add(15); }
+
+  checkPosition(180);
+
+  CHECK(history.getBucket(RadiationHistory::MINUTES, 0).mean == 15);
+
+  // A gap over several hour and day boundaries
+  history.addGap(3 * 86400 + 5 * 3600 + 7 * 60 + 11);
+
+  checkPosition(180 + 3 * 86400 + 5 * 3600 + 7 * 60 + 11);
+
+  // The day with the samples is the mean of its two recorded minutes, the days after it were not recorded at all
+  CHECK(history.getBucket(RadiationHistory::DAYS, 2).mean == 53);
+  CHECK(history.getBucket(RadiationHistory::DAYS, 1).mean == UINT32_MAX);
+  CHECK(history.getBucket(RadiationHistory::DAYS, 0).mean == UINT32_MAX);
+  CHECK(history.getBucket(RadiationHistory::HOURS, 0).mean == UINT32_MAX);
+
+  // A gap longer than the whole history clears every bucket and doesn't take long
+  history.add(30);
+  history.addGap(4000000000UL);
+
+  for (uint8_t i = RadiationHistory::SECONDS; i <= RadiationHistory::DAYS; i++) {
+
+    RadiationHistory::Resolution resolution = (RadiationHistory::Resolution)i;
+
+    for (uint16_t age = 0; age < history.getLength(resolution); age++) { CHECK(history.getBucket(resolution, age).mean == UINT32_MAX); }
+
+  }
+
+  CHECK(history.isValid());
+
+  return Test::result("TestRadiationHistory");
+
+}
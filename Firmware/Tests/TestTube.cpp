@@ -0,0 +1,125 @@
+// Check of the hardware pulse counter path of the tube (TUBE_COUNTING_MODE 1) against the mock of the ESP-IDF PCNT driver
+// Covers the glitch filter, counting past the 16 bit limit of the hardware counter, collecting the counts on disable and running out of units
+
+#include "Test.h"
+#include "Shims.h"
+#include "Tube.h"
+
+// Running sum the tubes count into, like the Geiger counter provides it
+static uint32_t runningSum                 = 0;
+static uint32_t runningSumStart[60]        = {};
+static uint8_t  runningSumIndex            = 0;
+static uint32_t runningSumTickMicroseconds = 0;
+
+// ================================================================================================
+// Send a number of pulses of a given length to a pin
+// ================================================================================================
+static void sendPulses(const uint8_t pin, const uint32_t pulses, const uint32_t lengthNanoseconds) {
+
+  for (uint32_t i = 0; i < pulses; i++) { Shims::addPulseCounterPulse(pin, lengthNanoseconds); }
+
+}
+
+int main() {
+
+  // Only one unit is left for the two tubes
+  Shims::setPulseCounterUnits(1);
+
+  Tube mainTube(MAIN_TRG_PIN, PulseCapture::MAIN_TUBE, runningSum, runningSumStart, runningSumIndex, runningSumTickMicroseconds);
+  Tube followerTube(FOLLOWER_TRG_PIN, PulseCapture::FOLLOWER_TUBE, runningSum, runningSumStart, runningSumIndex, runningSumTickMicroseconds);
+
+  mainTube.begin();
+  followerTube.begin();
+
+  // Beginning again doesn't create another unit
+  mainTube.begin();
+
+  CHECK(Shims::getPulseCounterUnits() == 1);
+
+  mainTube.enable();
+  followerTube.enable();
+
+  CHECK(mainTube.getTubeState());
+  CHECK(followerTube.getTubeState());
+
+  // ----------------------------------------------------------------------------------------------
+  // Glitch filter
+
+  // Tube pulses are counted, pulses shorter than the glitch filter are not
+  sendPulses(MAIN_TRG_PIN, 10, TUBE_MEDIAN_PULSE_LENGTH_MICROSECONDS * 1000);
+  sendPulses(MAIN_TRG_PIN, 5, TUBE_PULSE_COUNTER_GLITCH_FILTER_NANOSECONDS / 2);
+
+  mainTube.update();
+
+  CHECK(mainTube.getCounts() == 10);
+  CHECK(runningSum == 10);
+
+  // Updating without new pulses changes nothing
+  mainTube.update();
+
+  CHECK(mainTube.getCounts() == 10);
+
+  // ----------------------------------------------------------------------------------------------
+  // Running out of units
+
+  // The follower tube got no unit, it doesn't count and doesn't fail
+  sendPulses(FOLLOWER_TRG_PIN, 7, TUBE_MEDIAN_PULSE_LENGTH_MICROSECONDS * 1000);
+
+  followerTube.update();
+
+  CHECK(followerTube.getCounts() == 0);
+  CHECK(runningSum == 10);
+
+  // ----------------------------------------------------------------------------------------------
+  // Counting past the limit of the hardware counter
+
+  // More than twice the 16 bit limit between two updates
+  sendPulses(MAIN_TRG_PIN, 70000, TUBE_MEDIAN_PULSE_LENGTH_MICROSECONDS * 1000);
+
+  mainTube.update();
+
+  CHECK(mainTube.getCounts() == 70010);
+  CHECK(runningSum == 70010);
+
+  // Exactly at the limit
+  sendPulses(MAIN_TRG_PIN, INT16_MAX, TUBE_MEDIAN_PULSE_LENGTH_MICROSECONDS * 1000);
+
+  mainTube.update();
+
+  CHECK(mainTube.getCounts() == 70010 + INT16_MAX);
+
+  // ----------------------------------------------------------------------------------------------
+  // Disabling and enabling
+
+  uint64_t counts = mainTube.getCounts();
+
+  // The counts since the last update are collected when the tube is disabled
+  sendPulses(MAIN_TRG_PIN, 3, TUBE_MEDIAN_PULSE_LENGTH_MICROSECONDS * 1000);
+
+  mainTube.disable();
+
+  CHECK(!mainTube.getTubeState());
+  CHECK(mainTube.getCounts() == counts + 3);
+
+  // A disabled tube doesn't count
+  sendPulses(MAIN_TRG_PIN, 4, TUBE_MEDIAN_PULSE_LENGTH_MICROSECONDS * 1000);
+
+  // After enabling again, the hardware counter starts over without losing the total counts
+  mainTube.enable();
+
+  sendPulses(MAIN_TRG_PIN, 2, TUBE_MEDIAN_PULSE_LENGTH_MICROSECONDS * 1000);
+
+  mainTube.update();
+
+  CHECK(mainTube.getCounts() == counts + 5);
+  CHECK(runningSum == counts + 5);
+
+  // The tubes count without timestamps, nothing is moved into an earlier second
+  for (uint8_t i = 0; i < 60; i++) { CHECK(runningSumStart[i] == 0); }
+
+  mainTube.disable();
+  followerTube.disable();
+
+  return Test::result("TestTube");
+
+}
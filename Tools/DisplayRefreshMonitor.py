@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+
+import argparse
+import sys
+import requests
+import time
+from datetime import datetime
+
+# Pixel data of a full frame in bytes (240 x 320 pixels, 2 bytes per pixel)
+FULL_FRAME_BYTES = 240 * 320 * 2
+
+# =================================================================================================
+# Get the scripts launch arguments
+# =================================================================================================
+def getLaunchArguments():
+
+    # Launch argument parser
+    parser = argparse.ArgumentParser(description="A python script for monitoring how long a GMT Geiger Counter takes to refresh its display and how much pixel data it writes. (https://github.com/median-dispersion/GMT-Geiger-Counter)")
+
+    # Add arguments
+    parser.add_argument("--address",  type=str, required=True,              help="Address of the GMT Geiger counter.")
+    parser.add_argument("--interval", type=int, required=False, default=10, help="Reporting interval in seconds. The default is 10 seconds.")
+
+    # Parse arguments
+    return parser.parse_args()
+
+# =================================================================================================
+# Print a log message
+# =================================================================================================
+def log(level = "DEBUG", message = "Invalid log message!"):
+
+    # Get the current date and time in ISO form
+    date  = datetime.now().astimezone().isoformat()
+
+    # Depending on the log level color in the level text
+    match level:
+
+        case "DEBUG":   level = f"\033[92m[{level}]\033[0m"
+        case "INFO":    level = f"\033[96m[{level}]\033[0m"
+        case "WARNING": level = f"\033[93m[{level}]\033[0m"
+        case "ERROR":   level = f"\033[91m[{level}]\033[0m"
+        case _:         level = f"\033[95m[UNKNOWN]\033[0m"
+
+    # Print log message
+    print(f"{date} {level} >> {message}")
+
+# =================================================================================================
+# Get the request address
+# =================================================================================================
+def getRequestAddress(address):
+
+    # Make address lowercase
+    address = address.lower()
+
+    # If the string contains "://" remove everything in front of it
+    if "://" in address: address = address.split("://", 1)[1]
+
+    # Add the leading "http://" to the address
+    address = f"http://{address}"
+
+    # Return the updated address
+    return address
+
+# =================================================================================================
+# Get the display counters from the metrics endpoint
+# =================================================================================================
+def getDisplayCounters(address):
+
+    # Request the metrics
+    response = requests.get(f"{address}/metrics", timeout=10)
+
+    # If the response code is not 200 OK raise an exception
+    if response.status_code != 200: raise ValueError(f"HTTP Response: {response.status_code}")
+
+    # Collect the display samples by name
+    counters = {}
+
+    for line in response.text.splitlines():
+
+        # Skip the type and help lines
+        if line.startswith("gmt_display_"):
+
+            name, value    = line.rsplit(" ", 1)
+            counters[name] = float(value)
+
+    # Return the frames, the frame time in seconds and the transferred bytes
+    return (
+        counters["gmt_display_frame_duration_seconds_count"],
+        counters["gmt_display_frame_duration_seconds_sum"],
+        counters["gmt_display_transferred_bytes_total"]
+    )
+
+# =================================================================================================
+# Main
+# =================================================================================================
+def main():
+
+    # Get launch arguments
+    arguments = getLaunchArguments()
+
+    # Get the request address
+    address = getRequestAddress(arguments.address)
+
+    # Print log message
+    log("INFO", f"Reporting the display refresh every {arguments.interval} seconds...")
+
+    # Handle keyboard interrupts
+    try:
+
+        # Counters at the start of the interval
+        previous = getDisplayCounters(address)
+
+        while True:
+
+            # Wait for the reporting interval
+            time.sleep(arguments.interval)
+
+            # Counters at the end of the interval
+            current = getDisplayCounters(address)
+
+            # Difference over the interval
+            frames  = current[0] - previous[0]
+            seconds = current[1] - previous[1]
+            written = current[2] - previous[2]
+
+            previous = current
+
+            # If the display didn't refresh, e.g. because it is turned off
+            if frames <= 0:
+
+                # Print log message
+                log("WARNING", "No frames drawn!")
+
+            # Otherwise print the averages of the interval
+            else:
+
+                # Print log message
+                log("INFO", f"{frames:.0f} frames, {seconds / frames * 1000:.1f} ms per frame, {written / frames / 1024:.1f} KiB per frame ({written / frames / FULL_FRAME_BYTES * 100:.1f}% of a full frame)!")
+
+    # On keyboard interrupt stop monitoring
+    except KeyboardInterrupt: pass
+
+    # If a request fails
+    except Exception as exception:
+
+        # Print log message
+        log("ERROR", f"Requesting the metrics failed! ({exception})")
+
+    # Print log message
+    log("INFO", f"Exiting!")
+
+    # Exit
+    sys.exit()
+
+# Start the main function
+if __name__ == "__main__": main()
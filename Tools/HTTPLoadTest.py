@@ -0,0 +1,176 @@
+#!/usr/bin/env python3
+
+import argparse
+import sys
+import requests
+import threading
+import time
+from datetime import datetime
+
+# =================================================================================================
+# Get the scripts launch arguments
+# =================================================================================================
+def getLaunchArguments():
+
+    # Launch argument parser
+    parser = argparse.ArgumentParser(description="A python script for measuring how a GMT Geiger Counter handles concurrent HTTP clients. (https://github.com/median-dispersion/GMT-Geiger-Counter)")
+
+    # Add arguments
+    parser.add_argument("--address",   type=str, required=True,                                    help="Address of the GMT Geiger counter.")
+    parser.add_argument("--clients",   type=int, required=False, default=4,                        help="Number of concurrent clients. The default is 4 clients.")
+    parser.add_argument("--duration",  type=int, required=False, default=30,                       help="Measuring time in seconds. The default is 30 seconds.")
+    parser.add_argument("--endpoints", type=str, required=False, default="/data/geiger-counter,/", help="Comma separated list of requested paths, requested in turn by every client. The default is '/data/geiger-counter,/'.")
+
+    # Parse arguments
+    return parser.parse_args()
+
+# =================================================================================================
+# Print a log message
+# =================================================================================================
+def log(level = "DEBUG", message = "Invalid log message!"):
+
+    # Get the current date and time in ISO form
+    date  = datetime.now().astimezone().isoformat()
+
+    # Depending on the log level color in the level text
+    match level:
+
+        case "DEBUG":   level = f"\033[92m[{level}]\033[0m"
+        case "INFO":    level = f"\033[96m[{level}]\033[0m"
+        case "WARNING": level = f"\033[93m[{level}]\033[0m"
+        case "ERROR":   level = f"\033[91m[{level}]\033[0m"
+        case _:         level = f"\033[95m[UNKNOWN]\033[0m"
+
+    # Print log message
+    print(f"{date} {level} >> {message}")
+
+# =================================================================================================
+# Get the request address
+# =================================================================================================
+def getRequestAddress(address):
+
+    # Make address lowercase
+    address = address.lower()
+
+    # If the string contains "://" remove everything in front of it
+    if "://" in address: address = address.split("://", 1)[1]
+
+    # Add the leading "http://" to the address
+    address = f"http://{address}"
+
+    # Return the updated address
+    return address
+
+# =================================================================================================
+# Client that requests the endpoints in turn and records the latency of every request
+# =================================================================================================
+def client(address, endpoints, latencies, failures, stop):
+
+    # Index of the next endpoint
+    index = 0
+
+    # Until the measurement is over
+    while not stop.is_set():
+
+        # Get the next endpoint
+        endpoint = endpoints[index % len(endpoints)]
+        index   += 1
+
+        # Try requesting the endpoint
+        try:
+
+            # Time the request including the whole response body
+            start    = time.perf_counter()
+            response = requests.get(f"{address}{endpoint}", timeout=30)
+            end      = time.perf_counter()
+
+            # If the response code is not 200 OK raise an exception
+            if response.status_code != 200: raise ValueError(f"HTTP Response: {response.status_code}")
+
+            # Record the latency in milliseconds
+            latencies.append((end - start) * 1000)
+
+        # If the request fails count the failure
+        except Exception as exception:
+
+            failures.append(str(exception))
+
+# =================================================================================================
+# Get a percentile of the sorted latencies
+# =================================================================================================
+def getPercentile(latencies, percentile):
+
+    # Nearest rank
+    return latencies[min(len(latencies) - 1, int(len(latencies) * percentile / 100))]
+
+# =================================================================================================
+# Main
+# =================================================================================================
+def main():
+
+    # Get launch arguments
+    arguments = getLaunchArguments()
+
+    # Get the request address
+    address = getRequestAddress(arguments.address)
+
+    # Get the endpoints
+    endpoints = [endpoint.strip() for endpoint in arguments.endpoints.split(",") if endpoint.strip() != ""]
+
+    # Latencies and failures of all clients and the event to stop them
+    latencies = []
+    failures  = []
+    stop      = threading.Event()
+
+    # Start the clients
+    clients = [threading.Thread(target=client, args=(address, endpoints, latencies, failures, stop), daemon=True) for _ in range(arguments.clients)]
+
+    for thread in clients: thread.start()
+
+    # Print log message
+    log("INFO", f"Measuring with {arguments.clients} concurrent clients for {arguments.duration} seconds...")
+
+    # Start time of the measurement
+    start = time.perf_counter()
+
+    # Handle keyboard interrupts
+    try:
+
+        # Wait for the measuring time
+        time.sleep(arguments.duration)
+
+    # On keyboard interrupt stop measuring
+    except KeyboardInterrupt: pass
+
+    # Stop the clients and wait for their last request
+    stop.set()
+
+    for thread in clients: thread.join(timeout=30)
+
+    # Measured time in seconds
+    duration = time.perf_counter() - start
+
+    # If there are no successful requests
+    if len(latencies) == 0:
+
+        # Print log message
+        log("ERROR", f"No request succeeded! ({failures[0] if len(failures) > 0 else 'No requests'})")
+
+    # Otherwise print the results
+    else:
+
+        # Sort the latencies for the percentiles
+        latencies.sort()
+
+        # Print log messages
+        log("INFO", f"{len(latencies)} requests in {duration:.1f} seconds, {len(latencies) / duration:.1f} requests per second, {len(failures)} failed!")
+        log("INFO", f"Latency: p50 {getPercentile(latencies, 50):.0f} ms, p90 {getPercentile(latencies, 90):.0f} ms, p99 {getPercentile(latencies, 99):.0f} ms, max {latencies[-1]:.0f} ms!")
+
+    # Print log message
+    log("INFO", f"Exiting!")
+
+    # Exit
+    sys.exit()
+
+# Start the main function
+if __name__ == "__main__": main()
\ No newline at end of file
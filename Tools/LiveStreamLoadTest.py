@@ -0,0 +1,214 @@
+#!/usr/bin/env python3
+
+import argparse
+import sys
+import requests
+import threading
+import time
+from datetime import datetime
+
+# =================================================================================================
+# Get the scripts launch arguments
+# =================================================================================================
+def getLaunchArguments():
+
+    # Launch argument parser
+    parser = argparse.ArgumentParser(description="A python script for measuring what each subscriber of the live stream costs a GMT Geiger Counter. (https://github.com/median-dispersion/GMT-Geiger-Counter)")
+
+    # Add arguments
+    parser.add_argument("--address",  type=str, required=True,             help="Address of the GMT Geiger counter.")
+    parser.add_argument("--clients",  type=int, required=False, default=4,  help="Maximum number of stand-in clients. The default is 4 clients, the default maximum number of subscribers.")
+    parser.add_argument("--duration", type=int, required=False, default=30, help="Measuring time per number of clients in seconds. The default is 30 seconds.")
+
+    # Parse arguments
+    return parser.parse_args()
+
+# =================================================================================================
+# Print a log message
+# =================================================================================================
+def log(level = "DEBUG", message = "Invalid log message!"):
+
+    # Get the current date and time in ISO form
+    date  = datetime.now().astimezone().isoformat()
+
+    # Depending on the log level color in the level text
+    match level:
+
+        case "DEBUG":   level = f"\033[92m[{level}]\033[0m"
+        case "INFO":    level = f"\033[96m[{level}]\033[0m"
+        case "WARNING": level = f"\033[93m[{level}]\033[0m"
+        case "ERROR":   level = f"\033[91m[{level}]\033[0m"
+        case _:         level = f"\033[95m[UNKNOWN]\033[0m"
+
+    # Print log message
+    print(f"{date} {level} >> {message}")
+
+# =================================================================================================
+# Get the request address
+# =================================================================================================
+def getRequestAddress(address):
+
+    # Make address lowercase
+    address = address.lower()
+
+    # If the string contains "://" remove everything in front of it
+    if "://" in address: address = address.split("://", 1)[1]
+
+    # Add the leading "http://" to the address
+    address = f"http://{address}"
+
+    # Return the updated address
+    return address
+
+# =================================================================================================
+# Stand-in client that subscribes to the live stream and counts the received messages
+# =================================================================================================
+def standInClient(address, counter, stop):
+
+    # Try subscribing to the live stream
+    try:
+
+        # Open the live stream
+        with requests.get(f"{address}/data/stream", stream=True, timeout=30) as response:
+
+            # If the response code is not 200 OK raise an exception
+            if response.status_code != 200: raise ValueError(f"HTTP Response: {response.status_code}")
+
+            # Count every message until the measurement is over
+            for line in response.iter_lines(decode_unicode=True):
+
+                if line.startswith("data: "): counter[0] += 1
+
+                if stop.is_set(): break
+
+    # If the live stream fails
+    except Exception as exception:
+
+        # Print log message
+        log("WARNING", f"Stand-in client failed! ({exception})")
+
+# =================================================================================================
+# Sample the frame time the Geiger counter reports
+# =================================================================================================
+def getFrameTimes(address, duration):
+
+    # Frame times in microseconds and the number of subscribers they were measured with
+    frameTimes  = []
+    subscribers = 0
+
+    # For the measuring time, once a second
+    for _ in range(duration):
+
+        # Try getting the system info
+        try:
+
+            data = requests.get(f"{address}/data/system", timeout=10).json()["data"]
+
+            # Frames are only sent with subscribers
+            if data["streamSubscribers"] > 0: frameTimes.append(data["streamFrameMicros"])
+
+            subscribers = data["streamSubscribers"]
+
+        # If that failed skip the sample
+        except Exception as exception:
+
+            # Print log message
+            log("WARNING", f"Requesting the system info failed! ({exception})")
+
+        # Wait for the next frame
+        time.sleep(1)
+
+    # Return the frame times and the number of subscribers
+    return frameTimes, subscribers
+
+# =================================================================================================
+# Main
+# =================================================================================================
+def main():
+
+    # Get launch arguments
+    arguments = getLaunchArguments()
+
+    # Get the request address
+    address = getRequestAddress(arguments.address)
+
+    # Stand-in clients, their message counters and the event to stop them
+    clients  = []
+    counters = []
+    stop     = threading.Event()
+
+    # Results as (clients, mean frame time)
+    results = []
+
+    # Handle keyboard interrupts
+    try:
+
+        # For every number of clients
+        for number in range(1, arguments.clients + 1):
+
+            # Start another stand-in client
+            counter = [0]
+            client  = threading.Thread(target=standInClient, args=(address, counter, stop), daemon=True)
+
+            client.start()
+
+            clients.append(client)
+            counters.append(counter)
+
+            # Print log message
+            log("INFO", f"Measuring with {number} stand-in clients for {arguments.duration} seconds...")
+
+            # Sample the frame time
+            frameTimes, subscribers = getFrameTimes(address, arguments.duration)
+
+            # If there are no samples, stop
+            if len(frameTimes) == 0:
+
+                # Print log message
+                log("ERROR", f"No live stream frames were sent!")
+
+                break
+
+            # Mean frame time
+            mean = sum(frameTimes) / len(frameTimes)
+
+            results.append((subscribers, mean))
+
+            # Print log message
+            log("INFO", f"{subscribers} subscribers: {mean:.0f} us per frame, messages received per client: {[counter[0] for counter in counters]}")
+
+    # On keyboard interrupt stop measuring
+    except KeyboardInterrupt: pass
+
+    # Stop the stand-in clients
+    stop.set()
+
+    # If there are at least two measurements, get the cost of each additional subscriber with a least squares fit
+    if len(results) > 1:
+
+        # Means of the number of subscribers and the frame time
+        meanSubscribers = sum(result[0] for result in results) / len(results)
+        meanFrameTime   = sum(result[1] for result in results) / len(results)
+
+        # Variance of the number of subscribers and covariance with the frame time
+        variance   = sum((result[0] - meanSubscribers) ** 2 for result in results)
+        covariance = sum((result[0] - meanSubscribers) * (result[1] - meanFrameTime) for result in results)
+
+        # If the number of subscribers changed
+        if variance > 0:
+
+            # Slope and intercept of the fit
+            slope     = covariance / variance
+            intercept = meanFrameTime - slope * meanSubscribers
+
+            # Print log message
+            log("INFO", f"Each subscriber costs {slope:.0f} us per frame, the shared part of a frame costs {intercept:.0f} us!")
+
+    # Print log message
+    log("INFO", f"Exiting!")
+
+    # Exit
+    sys.exit()
+
+# Start the main function
+if __name__ == "__main__": main()
\ No newline at end of file
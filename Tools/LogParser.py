@@ -9,6 +9,13 @@ from datetime import datetime, timedelta
 from dateutil import parser
 from pathlib import Path
 
+# Binary log format, see Logger.h
+BINARY_HEADER  = b"\x00GMTL"
+BINARY_VERSION = 1
+
+# Binary log value types in the order of the value type enumerator
+UINT8_T, UINT32_T, UINT64_T, DOUBLE_T, STRING_T, BOOL_T = range(6)
+
 # =================================================================================================
 # Get launch arguments
 # =================================================================================================
@@ -18,7 +25,7 @@ def getLaunchArguments():
     parser = argparse.ArgumentParser(description="A python script for parsing log files from a GMT Geiger Counter into CSV tables. (https://github.com/median-dispersion/GMT-Geiger-Counter)")
     
     # Add arguments
-    parser.add_argument("--files",  type=str, required=True,  nargs="+",                                         help="A list of log file paths separated by spaces that will be parsed into CSV tables. Additional '.part' files should be added to this list to combine them into one output. The list will be sorted by filename.")
+    parser.add_argument("--files",  type=str, required=True,  nargs="+",                                         help="A list of JSON or binary log file paths separated by spaces that will be parsed into CSV tables. Additional '.part' files should be added to this list to combine them into one output. The list will be sorted by filename.")
     parser.add_argument("--date",   type=str, required=False, default=datetime(1970, 1, 1, 0, 0, 0).isoformat(), help="Start date of the log file recording. If the log file already contains date information, this will be ignored.")
     parser.add_argument("--output", type=str, required=False,                                                    help="Path of the output directory.")
     
@@ -69,8 +76,8 @@ def getNaturalKey(values):
 # =================================================================================================
 def readLogFiles(files):
 
-    # Raw log file data
-    data = ""
+    # Raw log file data of every file
+    data = []
 
     # Try reading log files
     try:
@@ -79,10 +86,10 @@ def readLogFiles(files):
         for file in sorted(files, key=getNaturalKey):
 
             # Open the file
-            with open(file, "r") as logFile:
+            with open(file, "rb") as logFile:
 
                 # Read the log file content into data
-                data += logFile.read()
+                data.append(logFile.read())
 
             # Print log message
             log("INFO", f"Loaded '{file}'")
@@ -201,6 +208,205 @@ def getJSONData(raw, date):
     # Return the JSON data
     return data
 
+# =================================================================================================
+# Read a varint from binary log data
+# =================================================================================================
+def readVarint(raw, position):
+
+    # Value and bit shift of the next 7 bits
+    value = 0
+    shift = 0
+
+    # While the highest bit is set another byte follows
+    while True:
+
+        byte      = raw[position]
+        value    |= (byte & 0x7F) << shift
+        position += 1
+
+        if byte < 0x80: return value, position
+
+        shift += 7
+
+# =================================================================================================
+# Read a schema name from binary log data
+# =================================================================================================
+def readName(raw, position):
+
+    # A single byte length followed by the characters
+    end = position + 1 + raw[position]
+
+    # The length is checked because slicing past the end of the data doesn't raise an exception
+    if end > len(raw): raise IndexError("Name exceeds the log data!")
+
+    return raw[position + 1:end].decode("utf-8"), end
+
+# =================================================================================================
+# Parse raw binary log file data into JSON data
+# =================================================================================================
+def getBinaryData(raw):
+
+    # JSON data
+    data = []
+
+    # Schemas of the current log file section
+    schemas = {}
+
+    # Time of the previous record
+    time = 0
+
+    # Position in the raw data
+    position = 0
+
+    # Until the end of the raw data
+    while position < len(raw):
+
+        # Start of the current record
+        start = position
+
+        # Try decoding the record
+        try:
+
+            # Record tag
+            tag = raw[position]
+
+            # A header resets all schemas
+            if tag == 0x00:
+
+                if raw[position:position + len(BINARY_HEADER)] != BINARY_HEADER: raise ValueError("Invalid header!")
+                if raw[position + len(BINARY_HEADER)] != BINARY_VERSION:         raise ValueError(f"Unsupported version {raw[position + len(BINARY_HEADER)]}!")
+
+                schemas  = {}
+                time     = 0
+                position = position + len(BINARY_HEADER) + 1
+
+            # A schema defines the message type, the keys and the value types of the records with its ID
+            elif tag == 0x01:
+
+                # Schema ID and message type
+                identifier     = raw[position + 1]
+                type, position = readName(raw, position + 2)
+
+                # Keys and value types
+                fields    = []
+                count     = raw[position]
+                position += 1
+
+                for _ in range(count):
+
+                    valueType     = raw[position]
+                    key, position = readName(raw, position + 1)
+
+                    fields.append((key, valueType))
+
+                schemas[identifier] = {"type": type, "fields": fields, "values": [0] * count}
+
+            # A record holds the values of a message
+            elif tag & 0x80 and tag & 0x7F in schemas:
+
+                # Get the schema of the record and the previous values its differences are added to
+                schema   = schemas[tag & 0x7F]
+                previous = schema["values"]
+
+                # Add the time since the previous record
+                difference, position = readVarint(raw, position + 1)
+
+                # Message data
+                values = {}
+
+                # For every value of the schema
+                for index, (key, valueType) in enumerate(schema["fields"]):
+
+                    # Zigzag encoded differences to the previous value, these are the most common values
+                    if valueType == UINT32_T or valueType == UINT64_T or valueType == DOUBLE_T:
+
+                        # Short differences fit into a single byte, which is read without a function call
+                        zigzag = raw[position]
+
+                        if zigzag < 0x80: position += 1
+                        else:             zigzag, position = readVarint(raw, position)
+
+                        value = previous[index] = (previous[index] + ((zigzag >> 1) ^ -(zigzag & 1))) & 0xFFFFFFFFFFFFFFFF
+
+                        # Floating point numbers are signed fixed point numbers with 5 decimal places
+                        values[key] = value if valueType != DOUBLE_T else (value - (1 << 64) if value >= (1 << 63) else value) / 100000
+
+                    # Single byte values
+                    elif valueType == UINT8_T or valueType == BOOL_T:
+
+                        values[key] = raw[position] if valueType == UINT8_T else raw[position] != 0
+                        position   += 1
+
+                    # Strings with their length
+                    elif valueType == STRING_T:
+
+                        length, position = readVarint(raw, position)
+
+                        if position + length > len(raw): raise IndexError("String exceeds the log data!")
+
+                        values[key] = raw[position:position + length].decode("utf-8")
+                        position   += length
+
+                    # Unknown value types can't be skipped
+                    else: raise ValueError(f"Unknown value type {valueType}!")
+
+                # The record is complete, the time is millis() on the device and wraps around at 32 bits like it does
+                time = (time + difference) & 0xFFFFFFFF
+
+                data.append({"type": schema["type"], "time": time, "data": values})
+
+            # Anything else is not part of the binary log data
+            else: raise ValueError(f"Unknown record tag {tag}!")
+
+        # If the record is incomplete or invalid, e.g. because a write to the SD card failed
+        except (IndexError, ValueError, UnicodeDecodeError) as exception:
+
+            # Continue with the next header, which follows whenever the log file was opened again
+            following = raw.find(BINARY_HEADER, start + 1)
+            following = len(raw) if following < 0 else following
+
+            # Print a warning message
+            log("WARNING", f"Skipped {following - start} bytes of binary log data! ({exception})")
+
+            position = following
+
+    # Return the JSON data
+    return data
+
+# =================================================================================================
+# Parse the raw data of all log files into JSON data
+# =================================================================================================
+def getLogData(raw, date):
+
+    # JSON data
+    data = []
+
+    # JSON log files are joined first, a message can be split across two parts
+    text = ""
+
+    # For the content of every log file in order
+    for content in raw:
+
+        # If it is a binary log file
+        if content.startswith(BINARY_HEADER):
+
+            # Parse the JSON log files before it
+            if text != "": data += getJSONData(text, date)
+
+            text = ""
+
+            # Parse the binary log file
+            data += getBinaryData(content)
+
+        # If it is a JSON log file, add it to the JSON log files before it
+        else: text += content.decode("utf-8", errors="replace")
+
+    # Parse the remaining JSON log files
+    if text != "": data += getJSONData(text, date)
+
+    # Return the JSON data
+    return data
+
 # =================================================================================================
 # Get all log messages in the JSON data
 # =================================================================================================
@@ -212,7 +418,8 @@ def getLogMessages(data):
         "geigerCounter":     [],
         "cosmicRayDetector": [],
         "systemInfo":        [],
-        "systemEvents":      []
+        "systemEvents":      [],
+        "pulseSimulator":    []
 
     }
 
@@ -226,6 +433,7 @@ def getLogMessages(data):
             case "cosmicRayDetector": messages["cosmicRayDetector"].append(message)
             case "system":            messages["systemInfo"].append(message)
             case "event":             messages["systemEvents"].append(message)
+            case "pulseSimulator":    messages["pulseSimulator"].append(message)
 
     # Return log messages
     return messages
@@ -331,7 +539,7 @@ def main():
     date = getStartDate(arguments.date)
 
     # Parse raw data as JSON
-    data = getJSONData(raw, date)
+    data = getLogData(raw, date)
 
     # Sort JSON data into message data
     messages = getLogMessages(data)
@@ -341,6 +549,7 @@ def main():
     cosmicRayDetector = getMessageData(messages["cosmicRayDetector"], date)
     systemInfo        = getMessageData(messages["systemInfo"],        date)
     systemEvents      = getMessageData(messages["systemEvents"],      date)
+    pulseSimulator    = getMessageData(messages["pulseSimulator"],    date)
 
     # Write geiger counter data to a CSV file
     writeMessageData(
@@ -352,16 +561,18 @@ def main():
 
         # Output fieldname mapping
         {
-            "index":                "Index",
-            "date":                 "Date",
-            "time":                 "System time [Milliseconds]",
-            "counts":               "Total number of counts",
-            "mainCounts":           "Main tube counts",
-            "followerCounts":       "Follower tube counts",
-            "countsPerMinute":      "Counts per minute",
-            "microsievertsPerHour": "Microsieverts per hour",
-            "tubes":                "Number of tubes",
-            "tubeType":             "Tube type" 
+            "index":                         "Index",
+            "date":                          "Date",
+            "time":                          "System time [Milliseconds]",
+            "counts":                        "Total number of counts",
+            "mainCounts":                    "Main tube counts",
+            "followerCounts":                "Follower tube counts",
+            "countsPerMinute":               "Counts per minute",
+            "correctedCountsPerMinute":      "Dead time corrected counts per minute",
+            "microsievertsPerHour":          "Microsieverts per hour",
+            "correctedMicrosievertsPerHour": "Dead time corrected microsieverts per hour",
+            "tubes":                         "Number of tubes",
+            "tubeType":                      "Tube type" 
         }
     )
 
@@ -425,5 +636,29 @@ def main():
         }
     )
 
+    # Write pulse simulator benchmark data to a CSV file
+    writeMessageData(
+        # Data
+        pulseSimulator,
+
+        # Output file
+        f"{str(output)}/Pulse_Simulator_{Path(arguments.files[0]).stem}.csv",
+
+        # Output fieldname mapping
+        {
+            "index":                   "Index",
+            "date":                    "Date",
+            "time":                    "System time [Milliseconds]",
+            "rate":                    "Configured rate [Pulses per second]",
+            "generated":               "Generated pulses",
+            "counted":                 "Counted pulses",
+            "lost":                    "Lost pulses",
+            "countedPerSecond":        "Counted pulses per second",
+            "expectedCountsPerMinute": "Expected counts per minute",
+            "countsPerMinute":         "Measured counts per minute",
+            "windowMicroseconds":      "Counts per minute call time [Microseconds]",
+        }
+    )
+
 # Start the main function
 if __name__ == "__main__": main()
\ No newline at end of file
@@ -0,0 +1,360 @@
+#!/usr/bin/env python3
+
+import argparse
+import sys
+import struct
+import csv
+import time
+import requests
+from datetime import datetime
+from pathlib import Path
+
+# Binary frame layout, see PulseCapture.h
+FRAME_MAGIC  = 0x50544D47
+FRAME_HEADER = struct.Struct("<IHHII")
+FRAME_PULSE  = struct.Struct("<IHBB")
+
+# Pulse source names in the order of the pulse source enumerator
+SOURCES = ["main", "follower", "coincidence"]
+
+# =================================================================================================
+# Get launch arguments
+# =================================================================================================
+def getLaunchArguments():
+
+    # Launch argument parser
+    parser = argparse.ArgumentParser(description="A python script for recording and decoding pulse captures from a GMT Geiger Counter into CSV tables. (https://github.com/median-dispersion/GMT-Geiger-Counter)")
+
+    # Add arguments
+    parser.add_argument("--files",    type=str, required=False, nargs="+",          help="A list of binary capture files separated by spaces that will be decoded into one CSV table. These can be recorded with --address or from the serial interface, log messages in between the frames are skipped.")
+    parser.add_argument("--address",  type=str, required=False,                     help="Address of the GMT Geiger counter to record a binary capture file from, instead of decoding files.")
+    parser.add_argument("--interval", type=int, required=False, default=1,          help="Request interval in seconds when recording. The default is 1 second.")
+    parser.add_argument("--output",   type=str, required=False, default="./Pulses", help="Path of the output directory. The default output directory is './Pulses'.")
+
+    # Parse arguments
+    arguments = parser.parse_args()
+
+    # Either files or an address is needed
+    if arguments.files is None and arguments.address is None: parser.error("Either --files or --address is required!")
+
+    # Return arguments
+    return arguments
+
+# =================================================================================================
+# Print a log message
+# =================================================================================================
+def log(level = "DEBUG", message = "Invalid log message!"):
+
+    # Get the current date and time in ISO form
+    date = datetime.now().astimezone().isoformat()
+
+    # Depending on the log level color in the level text
+    match level:
+
+        case "DEBUG":   level = f"\033[92m[{level}]\033[0m"
+        case "INFO":    level = f"\033[96m[{level}]\033[0m"
+        case "WARNING": level = f"\033[93m[{level}]\033[0m"
+        case "ERROR":   level = f"\033[91m[{level}]\033[0m"
+        case _:         level = f"\033[95m[UNKNOWN]\033[0m"
+
+    # Print log message
+    print(f"{date} {level} >> {message}")
+
+# =================================================================================================
+# Terminate script execution
+# =================================================================================================
+def terminate():
+
+    # Print log message
+    log("INFO", f"Exiting!")
+
+    # Exit
+    sys.exit()
+
+# =================================================================================================
+# Get the output directory path
+# =================================================================================================
+def getOutputPath(output):
+
+    # Try getting the output path
+    try:
+
+        # Create path element
+        path = Path(output)
+
+        # If path is a file raise an exception
+        if path.is_file(): raise ValueError(f"Output path '{path}' is not a directory!")
+
+        # Create directory if it doesn't exists
+        path.mkdir(parents=True, exist_ok=True)
+
+        # Return the output path
+        return path
+
+    # If an exception occurs
+    except Exception as exception:
+
+        # Print error message
+        log("ERROR", f"Failed to initialize the output directory! ({exception})")
+
+        # Exit
+        terminate()
+
+# =================================================================================================
+# Get the request address
+# =================================================================================================
+def getRequestAddress(address):
+
+    # Make address lowercase
+    address = address.lower()
+
+    # If the string contains "://" remove everything in front of it
+    if "://" in address: address = address.split("://", 1)[1]
+
+    # Add the leading "http://" to the address
+    address = f"http://{address}"
+
+    # Return the updated address
+    return address
+
+# =================================================================================================
+# Decode all frames in binary data
+# =================================================================================================
+def getFrames(data):
+
+    # Frames
+    frames = []
+
+    # Position in the data
+    position = 0
+
+    # Skipped bytes, e.g. log messages in between the frames of a serial capture
+    skipped = 0
+
+    # While there is room for a frame header
+    while position + FRAME_HEADER.size <= len(data):
+
+        # Read the frame header
+        magic, version, pulses, captured, dropped = FRAME_HEADER.unpack_from(data, position)
+
+        # Get the end of the frame
+        end = position + FRAME_HEADER.size + pulses * FRAME_PULSE.size
+
+        # If this is not the start of a complete frame, move on to the next frame magic value
+        if magic != FRAME_MAGIC or version != 1 or end > len(data):
+
+            # Find the next frame magic value, if there is none, skip the rest
+            following = data.find(struct.pack("<I", FRAME_MAGIC), position + 1)
+            following = len(data) if following < 0 else following
+
+            skipped  += following - position
+            position  = following
+
+            continue
+
+        # Decode the pulses of the frame
+        frames.append({
+            "captured": captured,
+            "dropped":  dropped,
+            "pulses":   [FRAME_PULSE.unpack_from(data, position + FRAME_HEADER.size + i * FRAME_PULSE.size) for i in range(pulses)]
+        })
+
+        # Move on to the next frame
+        position = end
+
+    # If anything was skipped
+    if skipped > 0: log("INFO", f"Skipped {skipped} bytes that were not part of a frame!")
+
+    # Return the frames
+    return frames
+
+# =================================================================================================
+# Get the pulse table from the frames
+# =================================================================================================
+def getPulses(frames):
+
+    # Pulse table
+    pulses = []
+
+    # Start time of the last counted pulse of every source
+    last = {}
+
+    # Running total of captured pulses at the end of the previous frame
+    captured = None
+
+    # For every frame
+    for frame in frames:
+
+        # If pulses are missing between the previous frame and this one, e.g. because a request was interrupted
+        if captured is not None and (frame["captured"] - len(frame["pulses"]) - captured) & 0xFFFFFFFF != 0:
+
+            # Print log message
+            log("WARNING", f"{(frame['captured'] - len(frame['pulses']) - captured) & 0xFFFFFFFF} pulses are missing in between two frames!")
+
+            # The intervals across the gap are unknown
+            last = {}
+
+        # Remember the running total of captured pulses
+        captured = frame["captured"]
+
+        # For every pulse of the frame
+        for start, width, source, counts in frame["pulses"]:
+
+            # Interval since the last counted pulse of the same source, the microsecond timer wraps around after 32 bits
+            interval = (start - last[source]) & 0xFFFFFFFF if source in last and counts > 0 else ""
+
+            # Remember the start time of the pulse if it was counted
+            if counts > 0: last[source] = start
+
+            # Add the pulse to the table
+            pulses.append({
+                "index":    len(pulses),
+                "source":   SOURCES[source] if source < len(SOURCES) else source,
+                "start":    start,
+                "width":    width,
+                "counts":   counts,
+                "interval": interval
+            })
+
+    # If there are any frames, report the dropped pulses of the last one
+    if len(frames) > 0: log("INFO", f"Decoded {len(pulses)} pulses, {frames[-1]['dropped']} pulses were dropped by the Geiger counter!")
+
+    # Return the pulse table
+    return pulses
+
+# =================================================================================================
+# Write the pulse table to a CSV file
+# =================================================================================================
+def writePulses(pulses, file):
+
+    # Output fieldname mapping
+    fieldnames = {
+        "index":    "Index",
+        "source":   "Tube",
+        "start":    "Start time [Microseconds]",
+        "width":    "Pulse length [Microseconds]",
+        "counts":   "Counts",
+        "interval": "Interval since the last counted pulse [Microseconds]"
+    }
+
+    # Try writing to file
+    try:
+
+        # Open output file
+        with open(file, "w") as output:
+
+            # Initialize CSV writer
+            writer = csv.writer(output)
+
+            # Write CSV header
+            writer.writerow(fieldnames.values())
+
+            # Write data rows
+            for pulse in pulses: writer.writerow([pulse[key] for key in fieldnames])
+
+        log("INFO", f"Created '{file}'!")
+
+    # If an error occurs writing to the output file
+    except Exception as exception:
+
+        # Log error message
+        log("ERROR", f"Writing to the output file '{file}' failed! ({exception})")
+
+# =================================================================================================
+# Record a binary capture file
+# =================================================================================================
+def record(address, interval, path):
+
+    # Capture endpoint
+    url = f"{address}/data/pulses"
+
+    # Output file
+    file = path / f"Pulses_{datetime.now().astimezone().isoformat()}.bin"
+
+    # Print log message
+    log("INFO", f"Recording pulses from '{url}' to '{file}'...")
+
+    # Handle keyboard interrupts
+    try:
+
+        # Main loop
+        while True:
+
+            # Try requesting the captured pulses
+            try:
+
+                # Make request
+                response = requests.get(url, timeout=30)
+
+                # If the response code is not 200 OK raise an exception
+                if response.status_code != 200: raise ValueError(f"HTTP Response: {response.status_code}")
+
+                # Append the frames to the capture file as they are
+                with open(file, "ab") as output: output.write(response.content)
+
+                # Decode the frames for the status message
+                frames = [FRAME_HEADER.unpack_from(response.content, 0)] if len(response.content) >= FRAME_HEADER.size else []
+
+                # Print log message
+                log("INFO", f"Received {len(response.content)} bytes{f', {frames[0][4]} pulses dropped so far' if frames else ''}!")
+
+            # If the request fails
+            except Exception as exception:
+
+                # Print log message
+                log("WARNING", f"Requesting pulses from '{url}' failed! ({exception})")
+
+            # Wait until the next request
+            time.sleep(interval)
+
+    # On keyboard interrupt terminate script
+    except KeyboardInterrupt: terminate()
+
+# =================================================================================================
+# Main
+# =================================================================================================
+def main():
+
+    # Get launch arguments
+    arguments = getLaunchArguments()
+
+    # Get the output directory path
+    path = getOutputPath(arguments.output)
+
+    # If an address is provided, record a capture file
+    if arguments.address is not None:
+
+        record(getRequestAddress(arguments.address), arguments.interval, path)
+
+    # Otherwise decode the capture files
+    else:
+
+        # Binary data
+        data = b""
+
+        # Try reading the capture files
+        try:
+
+            # For each file in order
+            for file in arguments.files:
+
+                # Read the file content into data
+                with open(file, "rb") as capture: data += capture.read()
+
+                # Print log message
+                log("INFO", f"Loaded '{file}'")
+
+        # If an exception occurs
+        except Exception as exception:
+
+            # Print log message
+            log("ERROR", f"Reading capture file failed! ({exception})")
+
+            # Exit
+            terminate()
+
+        # Decode the frames and write the pulse table
+        writePulses(getPulses(getFrames(data)), path / f"Pulses_{Path(arguments.files[0]).stem}.csv")
+
+# Start the main function
+if __name__ == "__main__": main()
@@ -20,6 +20,8 @@ def getLaunchArguments():
     parser.add_argument("--address",  type=str, required=True,                    help="Address of the GMT Geiger counter.")
     parser.add_argument("--interval", type=int, required=False, default=60,       help="Request interval in seconds. The default is 60 seconds.")
     parser.add_argument("--output",   type=str, required=False, default="./Logs", help="Path to output file or directory. The default output directory is './Logs'.")
+    parser.add_argument("--mirror",   action="store_true",                        help="Mirror the log files of the Geiger counter into the output directory instead of polling the data endpoints. Only new log data is requested.")
+    parser.add_argument("--stream",   action="store_true",                        help="Log the live stream of the Geiger counter, one message per second, instead of polling the data endpoints.")
     
     # Parse arguments
     return parser.parse_args()
@@ -173,6 +175,161 @@ def writeToLogFile(path, data):
         # Exit
         terminate()
 
+# =================================================================================================
+# Request the log file data after an offset
+# =================================================================================================
+def getLogFileData(address, name, offset):
+
+    # Request parameters, without a log file name the current log file is requested
+    parameters = {"since": offset}
+
+    if name != None: parameters["file"] = name
+
+    # Try fetching log file data
+    try:
+
+        # Make request
+        response = requests.get(f"{address}/data/log", params=parameters, timeout=30)
+
+        # If response code is not 200 OK raise an exception
+        if response.status_code != 200: raise ValueError(f"HTTP Response: {response.status_code}")
+
+        # Return the log file name, the log file size and the new data
+        return response.headers.get("X-Log-File"), int(response.headers.get("X-Log-Size", 0)), response.content
+
+    # If request fails
+    except Exception as exception:
+
+        # Print log message
+        log("WARNING", f"Requesting log file data from '{address}' failed! ({exception})")
+
+        # Return no data
+        return None, 0, None
+
+# =================================================================================================
+# Append new log file data to the mirrored log files
+# =================================================================================================
+def mirrorLogFiles(address, directory, state):
+
+    # Until there is no new log file data
+    while True:
+
+        # Get the new data of the log file that is being mirrored, or of the current log file when starting
+        name, size, data = getLogFileData(address, state["file"], state["offset"])
+
+        # If the request failed, try again with the next interval
+        if data == None: return
+
+        # If the log file is smaller than what was already mirrored, it was replaced, e.g. after formatting the SD card
+        if size < state["offset"]:
+
+            # Print log message
+            log("WARNING", f"Log file '{name}' shrank, starting over!")
+
+            # Start over with the current log file
+            state["file"]   = None
+            state["offset"] = 0
+
+            continue
+
+        # Try writing to the mirrored log file
+        try:
+
+            # Append the new data
+            with open(directory / name, "ab") as file: file.write(data)
+
+        except Exception as exception:
+
+            # Print log message
+            log("ERROR", f"Unable to write to the output file! ({exception})")
+
+            # Exit
+            terminate()
+
+        # Continue after the new data
+        state["file"]    = name
+        state["offset"] += len(data)
+
+        # If the log file was sent completely
+        if state["offset"] >= size:
+
+            # Check if the Geiger counter has moved on to another log file
+            current, _, _ = getLogFileData(address, None, size)
+
+            # If it has
+            if current != None and current != name:
+
+                # Check if anything was added to the mirrored log file before it was finished
+                _, size, _ = getLogFileData(address, name, state["offset"])
+
+                # If so, mirror that first
+                if size > state["offset"]: continue
+
+                # Otherwise mirror the new log file from the start, print log message
+                log("INFO", f"Switching to log file '{current}'!")
+
+                state["file"]   = current
+                state["offset"] = 0
+
+                continue
+
+            # Otherwise everything is mirrored
+            log("INFO", f"Mirrored {state['offset']} bytes of log file '{name}'!")
+
+            return
+
+# =================================================================================================
+# Write the messages of the live stream to the log file
+# =================================================================================================
+def logLiveStream(address, path):
+
+    # Try subscribing to the live stream
+    try:
+
+        # Print log message
+        log("INFO", f"Subscribing to '{address}/data/stream'...")
+
+        # Open the live stream, it doesn't end, so there is only a timeout for the time between two messages
+        with requests.get(f"{address}/data/stream", stream=True, timeout=30) as response:
+
+            # If the response code is not 200 OK raise an exception
+            if response.status_code != 200: raise ValueError(f"HTTP Response: {response.status_code}")
+
+            # Previous event ID
+            previous = None
+
+            # For every line of the live stream
+            for line in response.iter_lines(decode_unicode=True):
+
+                # Remember the event ID
+                if line.startswith("id: "):
+
+                    # Get the event ID
+                    current = int(line[4:])
+
+                    # If events are missing, e.g. because the Geiger counter was busy, print a log message
+                    if previous != None and current != previous + 1: log("WARNING", f"Missed {current - previous - 1} live stream messages!")
+
+                    previous = current
+
+                # Write the event data to the log file
+                elif line.startswith("data: "):
+
+                    # Parse the event data as JSON
+                    data = json.loads(line[6:])
+
+                    # Add the current date in ISO form
+                    data["date"] = datetime.now().astimezone().isoformat()
+
+                    # Write data to log file
+                    writeToLogFile(path, data)
+
+    # If the live stream ends or fails
+    except Exception as exception:
+
+        # Print log message
+        log("WARNING", f"Live stream from '{address}' ended! ({exception})")
+
 # =================================================================================================
 # Main
 # =================================================================================================
@@ -181,11 +338,57 @@ def main():
     # Get launch arguments
     arguments = getLaunchArguments()
 
+    # Get the request address
+    address = getRequestAddress(arguments.address)
+
+    # If the log files are mirrored
+    if arguments.mirror:
+
+        # Create output directory if it doesn't already exist
+        directory = Path(arguments.output)
+        directory.mkdir(parents=True, exist_ok=True)
+
+        # Mirrored log file and how much of it was mirrored
+        state = {"file": None, "offset": 0}
+
+        # Handle keyboard interrupts
+        try:
+
+            # Main Loop
+            while True:
+
+                # Fetch the new log file data
+                mirrorLogFiles(address, directory, state)
+
+                # Go to sleep until next interval
+                time.sleep(arguments.interval)
+
+        # On keyboard interrupt terminate script
+        except KeyboardInterrupt: terminate()
+
     # Get log file output path
     path = getOutputPath(arguments.output)
 
-    # Get the request address
-    address = getRequestAddress(arguments.address)
+    # If the live stream is logged
+    if arguments.stream:
+
+        # Handle keyboard interrupts
+        try:
+
+            # Main Loop
+            while True:
+
+                # Log the live stream until it ends
+                logLiveStream(address, path)
+
+                # Print log message
+                log("INFO", f"Subscribing again in {arguments.interval} seconds...")
+
+                # Wait before subscribing again
+                time.sleep(arguments.interval)
+
+        # On keyboard interrupt terminate script
+        except KeyboardInterrupt: terminate()
 
     # Get API endpoints
     endpoints = [